@@ -97,6 +97,7 @@ static struct {
 	uint32_t	nb_routes_per_depth[128 + 1];
 	uint32_t	flags;
 	uint32_t	tbl8;
+	uint32_t	bulk_sz;
 	uint8_t		ent_sz;
 	uint8_t		rnd_lookup_ips_ratio;
 	uint8_t		print_fract;
@@ -110,6 +111,7 @@ static struct {
 	.nb_routes_per_depth = {0},
 	.flags = FIB_V4_DIR_TYPE,
 	.tbl8 = DEFAULT_LPM_TBL8,
+	.bulk_sz = 0,
 	.ent_sz = 4,
 	.rnd_lookup_ips_ratio = 0,
 	.print_fract = 10,
@@ -642,6 +644,8 @@ print_usage(void)
 		"[-g <number of tbl8's for dir24_8 or trie FIBs>]\n"
 		"[-w <path to the file to dump routing table>]\n"
 		"[-u <path to the file to dump ip's for lookup>]\n"
+		"[-k <number of routes per rte_fib_bulk_modify() call, "
+		"also measures bulk updates (ipv4 only)>]\n"
 		"[-v <type of lookup function:"
 		"\ts1, s2, s3 (3 types of scalar), v (vector) -"
 		" for DIR24_8 based FIB\n"
@@ -688,7 +692,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:k:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -780,6 +784,14 @@ parse_opts(int argc, char **argv)
 				rte_exit(-EINVAL, "Invalid option -g\n");
 			}
 			break;
+		case 'k':
+			errno = 0;
+			config.bulk_sz = strtoul(optarg, &endptr, 10);
+			if ((errno != 0) || (config.bulk_sz == 0)) {
+				print_usage();
+				rte_exit(-EINVAL, "Invalid option -k\n");
+			}
+			break;
 		case 'v':
 			if ((strcmp(optarg, "s1") == 0) ||
 					(strcmp(optarg, "s") == 0)) {
@@ -831,10 +843,106 @@ print_depth_err(void)
 		"-d 0:0 option or remove /0 prefix from routes file\n");
 }
 
+static void
+print_load_rate(const char *name, uint64_t cycles)
+{
+	printf("%s %"PRIu64" cycles, %.0f updates/sec\n", name, cycles,
+		(double)config.nb_routes * rte_get_tsc_hz() / (double)cycles);
+}
+
 static int
-run_v4(void)
+cmp_fib_lpm_v4(struct rte_fib *fib, struct rte_lpm *lpm, uint64_t def_nh)
 {
+	uint32_t *tbl4 = config.lookup_tbl;
+	uint64_t fib_nh[BURST_SZ];
+	uint32_t lpm_nh[BURST_SZ];
+	uint32_t i, j;
+
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
+		rte_lpm_lookup_bulk(lpm, tbl4 + i, lpm_nh, BURST_SZ);
+		for (j = 0; j < BURST_SZ; j++) {
+			struct rte_lpm_tbl_entry *tbl;
+			tbl = (struct rte_lpm_tbl_entry *)&lpm_nh[j];
+			if ((fib_nh[j] != tbl->next_hop) &&
+					!((tbl->valid == 0) &&
+					(fib_nh[j] == def_nh))) {
+				printf("FAIL\n");
+				return -1;
+			}
+		}
+	}
+	printf("FIB and LPM lookup returns same values\n");
+	return 0;
+}
+
+/*
+ * Load and flush the whole table with rte_fib_bulk_modify()
+ * in batches of config.bulk_sz routes
+ */
+static int
+run_v4_bulk(struct rte_fib *fib, struct rte_lpm *lpm, uint64_t def_nh)
+{
+	struct rt_rule_4 *rt = (struct rt_rule_4 *)config.rt;
+	struct rte_fib_bulk_op *ops;
 	uint64_t start, acc;
+	uint32_t i, j, n;
+	int ret;
+
+	ops = rte_malloc(NULL, sizeof(*ops) * config.bulk_sz, 0);
+	if (ops == NULL) {
+		printf("Can not alloc bulk ops\n");
+		return -ENOMEM;
+	}
+
+	acc = 0;
+	for (i = 0; i < config.nb_routes; i += n) {
+		n = RTE_MIN(config.bulk_sz, config.nb_routes - i);
+		for (j = 0; j < n; j++) {
+			ops[j].ip = rt[i + j].addr;
+			ops[j].depth = rt[i + j].depth;
+			ops[j].op = RTE_FIB_ADD;
+			ops[j].next_hop = rt[i + j].nh;
+		}
+		start = rte_rdtsc_precise();
+		ret = rte_fib_bulk_modify(fib, ops, n);
+		acc += rte_rdtsc_precise() - start;
+		if (unlikely(ret != 0)) {
+			printf("Can not add routes to FIB, err %d\n", ret);
+			rte_free(ops);
+			return -ret;
+		}
+	}
+	print_load_rate("FIB bulk full table load", acc);
+
+	if ((lpm != NULL) && (cmp_fib_lpm_v4(fib, lpm, def_nh) != 0)) {
+		rte_free(ops);
+		return -1;
+	}
+
+	acc = 0;
+	for (i = 0; i < config.nb_routes; i += n) {
+		n = RTE_MIN(config.bulk_sz, config.nb_routes - i);
+		for (j = 0; j < n; j++) {
+			ops[j].ip = rt[i + j].addr;
+			ops[j].depth = rt[i + j].depth;
+			ops[j].op = RTE_FIB_DEL;
+		}
+		start = rte_rdtsc_precise();
+		/* duplicated routes fail to delete as with rte_fib_delete() */
+		rte_fib_bulk_modify(fib, ops, n);
+		acc += rte_rdtsc_precise() - start;
+	}
+	print_load_rate("FIB bulk full table flush", acc);
+
+	rte_free(ops);
+	return 0;
+}
+
+static int
+run_v4(void)
+{
+	uint64_t start, acc, load;
 	uint64_t def_nh = 0;
 	struct rte_fib *fib;
 	struct rte_fib_conf conf = {0};
@@ -896,7 +1004,7 @@ run_v4(void)
 		}
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
+	for (k = config.print_fract, i = 0, load = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++) {
 			ret = rte_fib_add(fib, rt[i + j].addr, rt[i + j].depth,
@@ -907,10 +1015,12 @@ run_v4(void)
 				return -ret;
 			}
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
+		acc = rte_rdtsc_precise() - start;
+		load += acc;
+		printf("AVG FIB add %"PRIu64"\n", acc / j);
 		i += j;
 	}
+	print_load_rate("FIB full table load", load);
 
 	if (config.flags & CMP_FLAG) {
 		lpm_conf.max_rules = config.nb_routes * 2;
@@ -967,32 +1077,27 @@ run_v4(void)
 		}
 		printf("AVG LPM lookup %.1f\n", (double)acc / (double)i);
 
-		for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
-			rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
-			rte_lpm_lookup_bulk(lpm, tbl4 + i, lpm_nh, BURST_SZ);
-			for (j = 0; j < BURST_SZ; j++) {
-				struct rte_lpm_tbl_entry *tbl;
-				tbl = (struct rte_lpm_tbl_entry *)&lpm_nh[j];
-				if ((fib_nh[j] != tbl->next_hop) &&
-						!((tbl->valid == 0) &&
-						(fib_nh[j] == def_nh))) {
-					printf("FAIL\n");
-					return -1;
-				}
-			}
-		}
-		printf("FIB and LPM lookup returns same values\n");
+		if (cmp_fib_lpm_v4(fib, lpm, def_nh) != 0)
+			return -1;
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
+	for (k = config.print_fract, i = 0, load = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++)
 			rte_fib_delete(fib, rt[i + j].addr, rt[i + j].depth);
 
-		printf("AVG FIB delete %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
+		acc = rte_rdtsc_precise() - start;
+		load += acc;
+		printf("AVG FIB delete %"PRIu64"\n", acc / j);
 		i += j;
 	}
+	print_load_rate("FIB full table flush", load);
+
+	if (config.bulk_sz != 0) {
+		ret = run_v4_bulk(fib, lpm, def_nh);
+		if (ret != 0)
+			return ret;
+	}
 
 	if (config.flags & CMP_FLAG) {
 		for (k = config.print_fract, i = 0; k > 0; k--) {
@@ -655,6 +655,7 @@ extern uint32_t burst_tx_delay_time; /**< Burst tx delay time(us) for mac-retry.
 extern uint32_t burst_tx_retry_num;  /**< Burst tx retry number for mac-retry. */
 
 #ifdef RTE_LIB_GRO
+#define GRO_DEFAULT_TYPES (RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6)
 #define GRO_DEFAULT_ITEM_NUM_PER_FLOW 32
 #define GRO_DEFAULT_FLOW_NUM (RTE_GRO_MAX_BURST_ITEM_NUM / \
 		GRO_DEFAULT_ITEM_NUM_PER_FLOW)
@@ -16,6 +16,7 @@
 #include <unistd.h> /* readlink */
 #include <dirent.h>
 
+#include <rte_common.h> /* __rte_unused */
 #include <rte_string_fns.h> /* strlcpy */
 
 #ifdef RTE_EXEC_ENV_FREEBSD
@@ -162,7 +163,7 @@ process_dup(const char *const argv[], int numargs, const char *env_value)
  * tests attempting to use this function on FreeBSD.
  */
 #ifdef RTE_EXEC_ENV_LINUX
-static char *
+static __rte_unused char *
 get_current_prefix(char *prefix, int size)
 {
 	char path[PATH_MAX] = {0};
@@ -22,8 +22,10 @@ test_acl(void)
 
 #else
 #include <rte_acl.h>
+#include <rte_random.h>
 #include <rte_common.h>
 
+#include "acl.h"
 #include "test_acl.h"
 
 #define	BIT_SIZEOF(x) (sizeof(x) * CHAR_BIT)
@@ -1722,6 +1724,485 @@ test_u32_range(void)
 	return rc;
 }
 
+#define	TEST_INCR_MAX_RULES	512
+#define	TEST_INCR_ROUNDS	12
+#define	TEST_INCR_UPDATES	16
+#define	TEST_INCR_DATA		256
+#define	TEST_INCR_CATEGORIES	RTE_ACL_RESULTS_MULTIPLIER
+
+/*
+ * Generate a rule within a small space of addresses and ports,
+ * so that the rules overlap each other.
+ * Priorities are unique, to get a single best match.
+ */
+static void
+test_incr_gen_rule(struct acl_ipv4vlan_rule *rule, uint32_t seq)
+{
+	struct rte_acl_ipv4vlan_rule r;
+	uint16_t port;
+
+	memset(&r, 0, sizeof(r));
+	r.data.userdata = seq + 1;
+	r.data.priority = (seq * 7919) % 1021 + 1;
+	r.data.category_mask = rte_rand_max(
+		RTE_LEN2MASK(TEST_INCR_CATEGORIES, uint32_t)) + 1;
+
+	if (rte_rand_max(2) != 0) {
+		r.proto = (rte_rand_max(2) != 0) ? IPPROTO_TCP : IPPROTO_UDP;
+		r.proto_mask = UINT8_MAX;
+	}
+
+	r.src_addr = RTE_IPV4(10, 0, 0, rte_rand_max(UINT8_MAX + 1));
+	r.src_mask_len = 24 + rte_rand_max(9);
+	r.dst_addr = RTE_IPV4(192, 168, 0, rte_rand_max(UINT8_MAX + 1));
+	r.dst_mask_len = 24 + rte_rand_max(9);
+
+	port = rte_rand_max(64);
+	r.src_port_low = port;
+	r.src_port_high = port + rte_rand_max(64 - port);
+	r.dst_port_low = 0;
+	r.dst_port_high = UINT16_MAX;
+
+	memset(rule, 0, sizeof(*rule));
+	acl_ipv4vlan_convert_rule(&r, rule);
+}
+
+/*
+ * Compare the results of the ACL context in incremental mode
+ * with the ones of the reference context, for all the classify methods.
+ */
+static int
+test_incr_check(struct rte_acl_ctx *acx, struct rte_acl_ctx *ref)
+{
+	static const enum rte_acl_classify_alg alg[] = {
+		RTE_ACL_CLASSIFY_SCALAR,
+		RTE_ACL_CLASSIFY_SSE,
+		RTE_ACL_CLASSIFY_AVX2,
+		RTE_ACL_CLASSIFY_NEON,
+		RTE_ACL_CLASSIFY_ALTIVEC,
+		RTE_ACL_CLASSIFY_AVX512X16,
+		RTE_ACL_CLASSIFY_AVX512X32,
+	};
+	static struct ipv4_7tuple test_data[TEST_INCR_DATA];
+	static uint32_t res[TEST_INCR_DATA * TEST_INCR_CATEGORIES];
+	static uint32_t ref_res[TEST_INCR_DATA * TEST_INCR_CATEGORIES];
+	const uint8_t *data[TEST_INCR_DATA];
+	uint32_t i, k;
+	int32_t ret;
+
+	for (i = 0; i != RTE_DIM(test_data); i++) {
+		memset(&test_data[i], 0, sizeof(test_data[i]));
+		test_data[i].proto = (rte_rand_max(2) != 0) ?
+			IPPROTO_TCP : IPPROTO_UDP;
+		test_data[i].ip_src = RTE_IPV4(10, 0, 0,
+			rte_rand_max(UINT8_MAX + 1));
+		test_data[i].ip_dst = RTE_IPV4(192, 168, 0,
+			rte_rand_max(UINT8_MAX + 1));
+		test_data[i].port_src = rte_rand_max(64);
+		test_data[i].port_dst = rte_rand();
+		data[i] = (uint8_t *)&test_data[i];
+	}
+	bswap_test_data(test_data, RTE_DIM(test_data), 1);
+
+	ret = rte_acl_classify(ref, data, ref_res, RTE_DIM(test_data),
+		TEST_INCR_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: reference classify failed, error code: %d\n",
+			__LINE__, ret);
+		return ret;
+	}
+
+	for (k = 0; k != RTE_DIM(alg); k++) {
+		ret = rte_acl_set_ctx_classify(acx, alg[k]);
+		if (ret == -ENOTSUP)
+			continue;
+
+		ret = rte_acl_classify(acx, data, res, RTE_DIM(test_data),
+			TEST_INCR_CATEGORIES);
+		if (ret != 0) {
+			printf("Line %i: classify(alg=%d) failed, "
+				"error code: %d\n", __LINE__, alg[k], ret);
+			return ret;
+		}
+
+		for (i = 0; i != RTE_DIM(res); i++) {
+			if (res[i] != ref_res[i]) {
+				printf("Line %i: classify(alg=%d) mismatch "
+					"at %u (expected %u got %u)\n",
+					__LINE__, alg[k], i, ref_res[i],
+					res[i]);
+				return -EINVAL;
+			}
+		}
+	}
+
+	return rte_acl_set_ctx_classify(acx, RTE_ACL_CLASSIFY_DEFAULT);
+}
+
+/*
+ * Test incremental updates: after each batch of rule additions and
+ * deletions, the ACL context in incremental mode has to classify as
+ * a context built from scratch with the same rules.
+ */
+static int
+test_incr(void)
+{
+	static struct acl_ipv4vlan_rule rules[TEST_INCR_MAX_RULES];
+	struct acl_ipv4vlan_rule upd[TEST_INCR_UPDATES];
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_acl_incr_stats st;
+	struct rte_acl_config cfg;
+	struct rte_acl_param prm;
+	uint32_t i, j, k, num, seq;
+	int32_t ret;
+
+	prm = acl_param;
+	prm.name = "acl_incr";
+	prm.max_rule_num = TEST_INCR_MAX_RULES;
+	acx = rte_acl_create(&prm);
+	prm.name = "acl_incr_ref";
+	ref = rte_acl_create(&prm);
+	if (acx == NULL || ref == NULL) {
+		printf("Line %i: Error creating ACL contexts!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, TEST_INCR_CATEGORIES);
+
+	for (num = 0; num != TEST_INCR_MAX_RULES / 4; num++)
+		test_incr_gen_rule(&rules[num], num);
+	seq = num;
+
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules, num);
+	if (ret == 0)
+		ret = rte_acl_add_rules(ref, (struct rte_acl_rule *)rules, num);
+	if (ret == 0)
+		ret = rte_acl_incr_build(acx, &cfg, NULL);
+	if (ret == 0)
+		ret = rte_acl_build(ref, &cfg);
+	if (ret == 0)
+		ret = test_incr_check(acx, ref);
+	if (ret != 0) {
+		printf("Line %i: initial build failed, error code: %d\n",
+			__LINE__, ret);
+		goto err;
+	}
+
+	for (i = 0; i != TEST_INCR_ROUNDS; i++) {
+
+		/* add new rules. */
+		for (j = 0; j != RTE_DIM(upd); j++)
+			test_incr_gen_rule(&rules[num + j], seq++);
+		ret = rte_acl_add_rules(acx,
+			(struct rte_acl_rule *)(rules + num), RTE_DIM(upd));
+		if (ret == 0)
+			ret = rte_acl_add_rules(ref,
+				(struct rte_acl_rule *)(rules + num),
+				RTE_DIM(upd));
+		if (ret != 0) {
+			printf("Line %i: round %u: adding rules failed, "
+				"error code: %d\n", __LINE__, i, ret);
+			goto err;
+		}
+		num += RTE_DIM(upd);
+
+		/* delete random rules, either old or just added. */
+		for (j = 0; j != RTE_DIM(upd); j++) {
+			k = rte_rand_max(num);
+			upd[j] = rules[k];
+			rules[k] = rules[--num];
+		}
+		ret = rte_acl_del_rules(acx, (struct rte_acl_rule *)upd,
+			RTE_DIM(upd));
+		if (ret == 0)
+			ret = rte_acl_del_rules(ref, (struct rte_acl_rule *)upd,
+				RTE_DIM(upd));
+		if (ret != 0) {
+			printf("Line %i: round %u: deleting rules failed, "
+				"error code: %d\n", __LINE__, i, ret);
+			goto err;
+		}
+
+		/* a rule which is not there anymore can't be deleted. */
+		ret = rte_acl_del_rules(acx, (struct rte_acl_rule *)upd, 1);
+		if (ret != -ENOENT) {
+			printf("Line %i: round %u: deleting a deleted rule "
+				"returned %d\n", __LINE__, i, ret);
+			ret = -1;
+			goto err;
+		}
+
+		if (i % 4 == 3) {
+			ret = rte_acl_incr_compact(acx);
+			if (ret == 0)
+				ret = rte_acl_incr_stats_get(acx, &st);
+			if (ret != 0 || st.main_rules != num ||
+					st.delta_rules != 0 ||
+					st.added_rules != 0 ||
+					st.deleted_rules != 0) {
+				printf("Line %i: round %u: compaction failed, "
+					"error code: %d\n", __LINE__, i, ret);
+				ret = -1;
+				goto err;
+			}
+		}
+
+		ret = rte_acl_build(ref, &cfg);
+		if (ret == 0)
+			ret = test_incr_check(acx, ref);
+		if (ret != 0) {
+			printf("Line %i: round %u: check failed, "
+				"error code: %d\n", __LINE__, i, ret);
+			goto err;
+		}
+	}
+
+	/* a full build leaves the incremental mode with the live rules. */
+	ret = rte_acl_build(acx, &cfg);
+	if (ret == 0)
+		ret = test_incr_check(acx, ref);
+	if (ret == 0 && rte_acl_incr_stats_get(acx, &st) != -EINVAL)
+		ret = -1;
+	if (ret != 0) {
+		printf("Line %i: full build failed, error code: %d\n",
+			__LINE__, ret);
+		goto err;
+	}
+
+err:
+	rte_acl_free(acx);
+	rte_acl_free(ref);
+	return ret;
+}
+
+#define	TEST_PARALLEL_RULES	1024
+#define	TEST_PARALLEL_DATA	1024
+#define	TEST_PARALLEL_WORKERS	4
+
+/*
+ * Generate a rule with random addresses and port ranges,
+ * to get a rule set which is split into several tries.
+ */
+static void
+test_parallel_gen_rule(struct acl_ipv4vlan_rule *rule, uint32_t seq)
+{
+	struct rte_acl_ipv4vlan_rule r;
+	uint16_t lo, hi;
+
+	memset(&r, 0, sizeof(r));
+	r.data.userdata = seq + 1;
+	r.data.priority = seq + 1;
+	r.data.category_mask = rte_rand_max(
+		RTE_LEN2MASK(TEST_INCR_CATEGORIES, uint32_t)) + 1;
+
+	if (rte_rand_max(2) != 0) {
+		r.proto = (rte_rand_max(2) != 0) ? IPPROTO_TCP : IPPROTO_UDP;
+		r.proto_mask = UINT8_MAX;
+	}
+
+	/* rules on either address only, which intersect each other. */
+	if (seq % 2 == 0) {
+		r.src_mask_len = 16 + rte_rand_max(17);
+		r.src_addr = rte_rand() & RTE_ACL_MASKLEN_TO_BITMASK(
+			r.src_mask_len, sizeof(uint32_t));
+	} else {
+		r.dst_mask_len = 16 + rte_rand_max(17);
+		r.dst_addr = rte_rand() & RTE_ACL_MASKLEN_TO_BITMASK(
+			r.dst_mask_len, sizeof(uint32_t));
+	}
+
+	lo = rte_rand();
+	hi = lo + rte_rand_max(UINT16_MAX - lo + 1);
+	r.src_port_low = lo;
+	r.src_port_high = hi;
+	lo = rte_rand();
+	hi = lo + rte_rand_max(UINT16_MAX - lo + 1);
+	r.dst_port_low = lo;
+	r.dst_port_high = hi;
+
+	memset(rule, 0, sizeof(*rule));
+	acl_ipv4vlan_convert_rule(&r, rule);
+}
+
+/*
+ * Build the rules with the given workers, and compare the results
+ * with the ones of the context built on a single thread.
+ */
+static int
+test_parallel_check(struct rte_acl_ctx *acx, struct rte_acl_ctx *ref,
+	const struct rte_acl_config *cfg, const struct rte_acl_build_param *prm,
+	const uint8_t *data[])
+{
+	static uint32_t res[TEST_PARALLEL_DATA * TEST_INCR_CATEGORIES];
+	static uint32_t ref_res[TEST_PARALLEL_DATA * TEST_INCR_CATEGORIES];
+	uint32_t i;
+	int32_t ret;
+
+	ret = rte_acl_build_parallel(acx, cfg, prm);
+	if (ret != 0) {
+		printf("Line %i: parallel build with %u lcores and %u threads "
+			"failed, error code: %d\n", __LINE__,
+			prm->num_lcores, prm->num_threads, ret);
+		return ret;
+	}
+
+	/* the workers only get tries split from the rule set to build. */
+	if (acx->num_tries < 2) {
+		printf("Line %i: parallel build with %u lcores and %u threads "
+			"did not split the rules, got %u trie(s)\n", __LINE__,
+			prm->num_lcores, prm->num_threads, acx->num_tries);
+		return -ERANGE;
+	}
+
+	ret = rte_acl_classify(acx, data, res, TEST_PARALLEL_DATA,
+		TEST_INCR_CATEGORIES);
+	if (ret == 0)
+		ret = rte_acl_classify(ref, data, ref_res, TEST_PARALLEL_DATA,
+			TEST_INCR_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: classify failed, error code: %d\n",
+			__LINE__, ret);
+		return ret;
+	}
+
+	for (i = 0; i != RTE_DIM(res); i++) {
+		if (res[i] != ref_res[i]) {
+			printf("Line %i: parallel build with %u lcores and "
+				"%u threads: mismatch at %u "
+				"(expected %u got %u)\n", __LINE__,
+				prm->num_lcores, prm->num_threads, i,
+				ref_res[i], res[i]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Test that a build spread over several threads gives
+ * the same results as a single threaded one.
+ */
+static int
+test_build_parallel(void)
+{
+	static struct acl_ipv4vlan_rule rules[TEST_PARALLEL_RULES];
+	static struct ipv4_7tuple test_data[TEST_PARALLEL_DATA];
+	const uint8_t *data[TEST_PARALLEL_DATA];
+	const struct rte_acl_field *f;
+	struct rte_acl_build_param prm;
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_acl_config cfg;
+	struct rte_acl_param param;
+	unsigned int lcores[TEST_PARALLEL_WORKERS];
+	uint32_t i, lcore_id;
+	int32_t ret;
+
+	param = acl_param;
+	param.name = "acl_parallel";
+	param.max_rule_num = TEST_PARALLEL_RULES;
+	acx = rte_acl_create(&param);
+	param.name = "acl_parallel_ref";
+	ref = rte_acl_create(&param);
+	if (acx == NULL || ref == NULL) {
+		printf("Line %i: Error creating ACL contexts!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	for (i = 0; i != RTE_DIM(rules); i++)
+		test_parallel_gen_rule(&rules[i], i);
+
+	/* half of the inputs hit a rule. */
+	for (i = 0; i != RTE_DIM(test_data); i++) {
+		memset(&test_data[i], 0, sizeof(test_data[i]));
+		test_data[i].proto = (rte_rand_max(2) != 0) ?
+			IPPROTO_TCP : IPPROTO_UDP;
+		test_data[i].ip_src = rte_rand();
+		test_data[i].ip_dst = rte_rand();
+		test_data[i].port_src = rte_rand();
+		test_data[i].port_dst = rte_rand();
+		if (i % 2 == 0) {
+			f = rules[rte_rand_max(RTE_DIM(rules))].field;
+			if (f[RTE_ACL_IPV4VLAN_PROTO_FIELD].mask_range.u8 != 0)
+				test_data[i].proto =
+					f[RTE_ACL_IPV4VLAN_PROTO_FIELD].value.u8;
+			test_data[i].ip_src =
+				f[RTE_ACL_IPV4VLAN_SRC_FIELD].value.u32;
+			test_data[i].ip_dst =
+				f[RTE_ACL_IPV4VLAN_DST_FIELD].value.u32;
+			test_data[i].port_src =
+				f[RTE_ACL_IPV4VLAN_SRCP_FIELD].value.u16;
+			test_data[i].port_dst =
+				f[RTE_ACL_IPV4VLAN_DSTP_FIELD].value.u16;
+		}
+		data[i] = (uint8_t *)&test_data[i];
+	}
+	bswap_test_data(test_data, RTE_DIM(test_data), 1);
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, TEST_INCR_CATEGORIES);
+
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules,
+		RTE_DIM(rules));
+	if (ret == 0)
+		ret = rte_acl_add_rules(ref, (struct rte_acl_rule *)rules,
+			RTE_DIM(rules));
+	if (ret == 0)
+		ret = rte_acl_build(ref, &cfg);
+	if (ret != 0) {
+		printf("Line %i: reference build failed, error code: %d\n",
+			__LINE__, ret);
+		goto err;
+	}
+
+	/* control threads only. */
+	memset(&prm, 0, sizeof(prm));
+	for (i = 1; i <= TEST_PARALLEL_WORKERS; i *= 2) {
+		prm.num_threads = i;
+		ret = test_parallel_check(acx, ref, &cfg, &prm, data);
+		if (ret != 0)
+			goto err;
+	}
+
+	/* worker lcores, along with a control thread. */
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (i == RTE_DIM(lcores) - 1 ||
+				rte_eal_get_lcore_state(lcore_id) != WAIT)
+			continue;
+		lcores[i++] = lcore_id;
+	}
+	if (i != 0) {
+		prm.lcores = lcores;
+		prm.num_lcores = i;
+		prm.num_threads = 1;
+		ret = test_parallel_check(acx, ref, &cfg, &prm, data);
+		if (ret != 0)
+			goto err;
+	}
+
+	/* the calling lcore can't be a worker. */
+	lcores[0] = rte_lcore_id();
+	prm.lcores = lcores;
+	prm.num_lcores = 1;
+	ret = rte_acl_build_parallel(acx, &cfg, &prm);
+	if (ret != -EINVAL) {
+		printf("Line %i: build with the calling lcore as worker "
+			"returned %d\n", __LINE__, ret);
+		ret = -1;
+		goto err;
+	}
+	ret = 0;
+
+err:
+	rte_acl_free(acx);
+	rte_acl_free(ref);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1743,6 +2224,10 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_incr() < 0)
+		return -1;
+	if (test_build_parallel() < 0)
+		return -1;
 
 	return 0;
 }
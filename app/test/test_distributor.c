@@ -11,6 +11,8 @@
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
+#include <rte_memzone.h>
+#include <rte_pause.h>
 
 #ifdef RTE_EXEC_ENV_WINDOWS
 static int
@@ -51,6 +53,22 @@ static volatile int zero_quit; /**< var for when we just want thr0 to quit*/
 static volatile int zero_sleep; /**< thr0 has quit basic loop and is sleeping*/
 static volatile unsigned worker_idx;
 static volatile unsigned zero_idx;
+static volatile unsigned int multi_ready; /**< workers polling all dists */
+static volatile unsigned int multi_done; /**< workers which left all dists */
+static volatile unsigned int multi_dist_done; /**< dists done with pkts */
+
+#define MULTI_DIST_NUM 2 /* distributors sharing the workers */
+#define MULTI_DIST_FLOWS 32
+static struct rte_distributor *multi_dist[MULTI_DIST_NUM];
+
+struct multi_dist_params {
+	struct rte_distributor *dist;
+	unsigned int num_workers;
+	unsigned int num_bufs;
+	unsigned int num_returned;
+	struct rte_mbuf **bufs;
+	struct rte_mbuf **returns;
+};
 
 struct worker_stats {
 	volatile unsigned handled_packets;
@@ -781,6 +799,242 @@ int test_error_distributor_create_numworkers(void)
 }
 
 
+/* worker function serving all the distributors of the multi-distributor
+ * test. It polls them in turn and marks each packet with its worker id.
+ */
+static int
+handle_work_multi(void *arg)
+{
+	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_distributor **d = arg;
+	unsigned int id = __atomic_fetch_add(&worker_idx, 1, __ATOMIC_RELAXED);
+	unsigned int i, k;
+	int num;
+
+	for (k = 0; k < MULTI_DIST_NUM; k++)
+		rte_distributor_request_pkt(d[k], id, NULL, 0);
+	__atomic_fetch_add(&multi_ready, 1, __ATOMIC_RELEASE);
+
+	while (!quit) {
+		for (k = 0; k < MULTI_DIST_NUM; k++) {
+			num = rte_distributor_poll_pkt(d[k], id, buf);
+			if (num < 0)
+				continue;
+			__atomic_fetch_add(&worker_stats[id].handled_packets,
+					num, __ATOMIC_RELAXED);
+			for (i = 0; i < (unsigned int)num; i++)
+				*seq_field(buf[i]) = id + 1;
+			rte_distributor_request_pkt(d[k], id, buf, num);
+		}
+	}
+
+	for (k = 0; k < MULTI_DIST_NUM; k++)
+		rte_distributor_return_pkt(d[k], id, NULL, 0);
+	__atomic_fetch_add(&multi_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/* Distributor side of the multi-distributor test, run on one lcore per
+ * distributor. It sends its share of the packets and gathers them back,
+ * then serves the workers until they all leave.
+ */
+static int
+run_multi_distributor(void *arg)
+{
+	const unsigned int return_buffer_capacity = 127;
+	struct multi_dist_params *mp = arg;
+	struct rte_distributor *d = mp->dist;
+	unsigned int num_being_processed = 0;
+	unsigned int i, count, processed, retries;
+
+	/* Let the distributor see all the workers active, so that the
+	 * worker of a flow doesn't change during the test.
+	 */
+	while (__atomic_load_n(&multi_ready, __ATOMIC_ACQUIRE) <
+			mp->num_workers)
+		rte_pause();
+	rte_distributor_process(d, NULL, 0);
+
+	for (i = 0; i < mp->num_bufs / BURST; i++) {
+		processed = 0;
+		while (processed < BURST)
+			processed += rte_distributor_process(d,
+					&mp->bufs[i * BURST + processed],
+					BURST - processed);
+		num_being_processed += BURST;
+		do {
+			count = rte_distributor_returned_pkts(d,
+					&mp->returns[mp->num_returned],
+					mp->num_bufs - mp->num_returned);
+			num_being_processed -= count;
+			mp->num_returned += count;
+			rte_distributor_flush(d);
+		} while (num_being_processed + BURST > return_buffer_capacity);
+	}
+	retries = 0;
+	do {
+		rte_distributor_flush(d);
+		mp->num_returned += rte_distributor_returned_pkts(d,
+				&mp->returns[mp->num_returned],
+				mp->num_bufs - mp->num_returned);
+		retries++;
+	} while (mp->num_returned < mp->num_bufs && retries < 100);
+
+	/* The workers leave once all the distributors are done */
+	__atomic_fetch_add(&multi_dist_done, 1, __ATOMIC_RELEASE);
+	while (__atomic_load_n(&multi_done, __ATOMIC_ACQUIRE) <
+			mp->num_workers) {
+		if (__atomic_load_n(&multi_dist_done, __ATOMIC_ACQUIRE) ==
+				MULTI_DIST_NUM)
+			quit = 1;
+		rte_distributor_process(d, NULL, 0);
+	}
+	rte_distributor_clear_returns(d);
+
+	return 0;
+}
+
+/* test_multi_distributor sends the packets of a set of flows through
+ * several distributors with static affinity, each one on its own lcore,
+ * which share the same workers. The returned packets are verified to be
+ * handled by one worker per flow, whatever distributor they went through.
+ */
+static int
+test_multi_distributor(struct rte_mempool *p)
+{
+	const unsigned int num_workers = rte_lcore_count() - MULTI_DIST_NUM;
+	static struct multi_dist_params mp[MULTI_DIST_NUM];
+	struct rte_mbuf *bufs[BIG_BATCH];
+	struct rte_mbuf *returns[BIG_BATCH];
+	unsigned int flow_worker[MULTI_DIST_FLOWS] = { 0 };
+	unsigned int i, k, flow, worker, lcore_id;
+	unsigned int num_returned = 0;
+	unsigned int failed = 0;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	printf("=== Multi-distributor test ===\n");
+	for (k = 0; k < MULTI_DIST_NUM; k++) {
+		if (multi_dist[k] == NULL) {
+			snprintf(name, sizeof(name), "Test_dist_multi_%u", k);
+			multi_dist[k] = rte_distributor_create(name,
+					rte_socket_id(), num_workers,
+					RTE_DIST_ALG_BURST);
+			if (multi_dist[k] == NULL) {
+				printf("Error creating multi distributor\n");
+				return -1;
+			}
+		}
+		if (rte_distributor_affinity_set(multi_dist[k],
+				RTE_DIST_AFFINITY_STATIC) != 0) {
+			printf("line %d: Error setting static affinity\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if (rte_mempool_get_bulk(p, (void *)bufs, BIG_BATCH) != 0) {
+		printf("line %d: Error getting mbufs from pool\n", __LINE__);
+		return -1;
+	}
+	for (i = 0; i < BIG_BATCH; i++) {
+		bufs[i]->hash.usr = (i % MULTI_DIST_FLOWS) << 1;
+		*seq_field(bufs[i]) = 0;
+	}
+
+	/* each distributor gets a share of the packets of all flows */
+	for (k = 0; k < MULTI_DIST_NUM; k++) {
+		mp[k].dist = multi_dist[k];
+		mp[k].num_workers = num_workers;
+		mp[k].num_bufs = BIG_BATCH / MULTI_DIST_NUM;
+		mp[k].bufs = &bufs[k * mp[k].num_bufs];
+		mp[k].returns = &returns[k * mp[k].num_bufs];
+		mp[k].num_returned = 0;
+	}
+
+	clear_packet_count();
+	/* the main lcore runs the first distributor, the first worker lcores
+	 * the other ones, and the remaining lcores are the workers.
+	 */
+	k = 1;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (k < MULTI_DIST_NUM)
+			rte_eal_remote_launch(run_multi_distributor, &mp[k++],
+					lcore_id);
+		else
+			rte_eal_remote_launch(handle_work_multi, multi_dist,
+					lcore_id);
+	}
+	run_multi_distributor(&mp[0]);
+	rte_eal_mp_wait_lcore();
+
+	for (i = 0; i < num_workers; i++)
+		printf("Worker %u handled %u packets\n", i,
+			__atomic_load_n(&worker_stats[i].handled_packets,
+					__ATOMIC_RELAXED));
+
+	for (k = 0; k < MULTI_DIST_NUM; k++) {
+		if (mp[k].num_returned != mp[k].num_bufs) {
+			printf("line %d: Missing packets, expected %u, got %u\n",
+					__LINE__, mp[k].num_bufs,
+					mp[k].num_returned);
+			failed = 1;
+		}
+		num_returned += mp[k].num_returned;
+	}
+
+	for (k = 0; k < MULTI_DIST_NUM; k++) {
+		for (i = 0; i < mp[k].num_returned; i++) {
+			flow = mp[k].returns[i]->hash.usr >> 1;
+			worker = *seq_field(mp[k].returns[i]);
+			if (worker == 0) {
+				printf("Packet of flow %u not handled\n",
+						flow);
+				failed = 1;
+			} else if (flow_worker[flow] == 0) {
+				flow_worker[flow] = worker;
+			} else if (flow_worker[flow] != worker) {
+				printf("Packet of flow %u processed by worker %u,"
+					" but should be processed by worker %u\n",
+					flow, worker - 1, flow_worker[flow] - 1);
+				failed = 1;
+			}
+		}
+	}
+
+	rte_mempool_put_bulk(p, (void *)bufs, BIG_BATCH);
+
+	quit = 0;
+	worker_idx = 0;
+	multi_ready = 0;
+	multi_done = 0;
+	multi_dist_done = 0;
+
+	if (failed)
+		return -1;
+
+	printf("Multi-distributor test passed\n\n");
+	return 0;
+}
+
+static
+int test_error_distributor_affinity(struct rte_distributor *ds,
+		struct rte_distributor *db)
+{
+	if (rte_distributor_affinity_set(ds, RTE_DIST_AFFINITY_STATIC) !=
+			-EINVAL) {
+		printf("ERROR: No error on affinity_set() with single API\n");
+		return -1;
+	}
+
+	if (rte_distributor_affinity_set(db,
+			(enum rte_distributor_affinity)-1) != -EINVAL) {
+		printf("ERROR: No error on affinity_set() with invalid affinity\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 /* Useful function which ensures that all worker functions terminate */
 static void
 quit_workers(struct worker_params *wp, struct rte_mempool *p)
@@ -824,7 +1078,8 @@ test_distributor(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
-	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dbs;
+	static struct rte_distributor *dist[3];
 	static struct rte_mempool *p;
 	int i;
 
@@ -858,6 +1113,25 @@ test_distributor(void)
 		rte_distributor_clear_returns(db);
 	}
 
+	if (dbs == NULL) {
+		dbs = rte_distributor_create("Test_dist_burst_static",
+				rte_socket_id(),
+				rte_lcore_count() - 1,
+				RTE_DIST_ALG_BURST);
+		if (dbs == NULL) {
+			printf("Error creating static burst distributor\n");
+			return -1;
+		}
+		if (rte_distributor_affinity_set(dbs,
+				RTE_DIST_AFFINITY_STATIC) != 0) {
+			printf("Error setting static affinity\n");
+			return -1;
+		}
+	} else {
+		rte_distributor_flush(dbs);
+		rte_distributor_clear_returns(dbs);
+	}
+
 	if (ds == NULL) {
 		ds = rte_distributor_create("Test_dist_single",
 				rte_socket_id(),
@@ -885,11 +1159,15 @@ test_distributor(void)
 
 	dist[0] = ds;
 	dist[1] = db;
+	dist[2] = dbs;
 
-	for (i = 0; i < 2; i++) {
+	for (i = 0; i < 3; i++) {
 
 		worker_params.dist = dist[i];
-		if (i)
+		if (i == 2)
+			strlcpy(worker_params.name, "burst-static",
+					sizeof(worker_params.name));
+		else if (i)
 			strlcpy(worker_params.name, "burst",
 					sizeof(worker_params.name));
 		else
@@ -937,12 +1215,24 @@ test_distributor(void)
 
 	}
 
+	if (rte_lcore_count() > MULTI_DIST_NUM) {
+		if (test_multi_distributor(p) < 0)
+			return -1;
+	} else {
+		printf("Too few cores to run multi-distributor test\n");
+	}
+
 	if (test_error_distributor_create_numworkers() == -1 ||
 			test_error_distributor_create_name() == -1) {
 		printf("rte_distributor_create parameter check tests failed");
 		return -1;
 	}
 
+	if (test_error_distributor_affinity(ds, db) == -1) {
+		printf("rte_distributor_affinity_set parameter check tests failed");
+		return -1;
+	}
+
 	return 0;
 
 err:
@@ -10,6 +10,7 @@
 #include <rte_ip.h>
 #include <rte_log.h>
 #include <rte_fib.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -21,6 +22,7 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_bulk_modify(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
@@ -376,6 +378,194 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+#define BULK_NB_ROUNDS	64
+#define BULK_NB_OPS	256
+#define BULK_NET	RTE_IPV4(10, 0, 0, 0)
+#define BULK_NET_SIZE	(1 << 16)
+#define BULK_NB_TBL8	64
+
+/*
+ * Check that the lookup in the FIB matches the lookup in the reference
+ * FIB for the whole test network
+ */
+static int
+check_bulk_lookup(struct rte_fib *fib, struct rte_fib *ref)
+{
+	static uint32_t ip_arr[BULK_NET_SIZE];
+	static uint64_t nh_arr[BULK_NET_SIZE];
+	static uint64_t ref_nh_arr[BULK_NET_SIZE];
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < BULK_NET_SIZE; i++)
+		ip_arr[i] = BULK_NET + i;
+
+	ret = rte_fib_lookup_bulk(fib, ip_arr, nh_arr, BULK_NET_SIZE);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+	ret = rte_fib_lookup_bulk(ref, ip_arr, ref_nh_arr, BULK_NET_SIZE);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+	for (i = 0; i < BULK_NET_SIZE; i++)
+		RTE_TEST_ASSERT(nh_arr[i] == ref_nh_arr[i],
+			"Failed to get proper nexthop\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Apply random batches of overlapping additions and deletions with
+ * rte_fib_bulk_modify() and compare the result with the same updates
+ * applied one by one
+ */
+static int
+check_bulk_modify(struct rte_fib *fib, struct rte_fib *ref)
+{
+	struct rte_fib_bulk_op ops[BULK_NB_OPS];
+	uint32_t i, j;
+	int ret, ref_ret;
+
+	for (i = 0; i < BULK_NB_ROUNDS; i++) {
+		for (j = 0; j < BULK_NB_OPS; j++) {
+			ops[j].ip = BULK_NET + rte_rand_max(BULK_NET_SIZE);
+			ops[j].depth = 16 + rte_rand_max(RTE_FIB_MAXDEPTH - 15);
+			ops[j].op = (rte_rand_max(3) == 0) ? RTE_FIB_DEL :
+				RTE_FIB_ADD;
+			ops[j].next_hop = rte_rand_max(8);
+			/* repeat some of the prefixes to flap them */
+			if ((j != 0) && (rte_rand_max(4) == 0)) {
+				ops[j].ip = ops[j - 1].ip;
+				ops[j].depth = ops[j - 1].depth;
+			}
+		}
+
+		ref_ret = 0;
+		for (j = 0; j < BULK_NB_OPS; j++) {
+			if (ops[j].op == RTE_FIB_ADD)
+				ret = rte_fib_add(ref, ops[j].ip, ops[j].depth,
+					ops[j].next_hop);
+			else
+				ret = rte_fib_delete(ref, ops[j].ip,
+					ops[j].depth);
+			if (ret != 0)
+				ref_ret = ret;
+		}
+
+		ret = rte_fib_bulk_modify(fib, ops, BULK_NB_OPS);
+		RTE_TEST_ASSERT(ret == ref_ret,
+			"Unexpected bulk modify result %d\n", ret);
+		ret = check_bulk_lookup(fib, ref);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Lookup and check fails\n");
+	}
+
+	/* an addition and a deletion of the same route cancel each other */
+	ops[0].ip = BULK_NET;
+	ops[0].depth = 30;
+	ops[0].op = RTE_FIB_ADD;
+	ops[0].next_hop = 9;
+	ops[1] = ops[0];
+	ops[1].op = RTE_FIB_DEL;
+	ret = rte_fib_delete(fib, ops[0].ip, ops[0].depth);
+	RTE_TEST_ASSERT((ret == 0) || (ret == -ENOENT),
+		"Failed to delete a route\n");
+	rte_fib_delete(ref, ops[0].ip, ops[0].depth);
+	ret = rte_fib_bulk_modify(fib, ops, 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to modify routes\n");
+	ret = check_bulk_lookup(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	/* invalid updates are reported without stopping the batch */
+	ops[0].depth = RTE_FIB_MAXDEPTH + 1;
+	ops[1].op = RTE_FIB_ADD;
+	ret = rte_fib_bulk_modify(fib, ops, 2);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Invalid update was not reported\n");
+	rte_fib_add(ref, ops[1].ip, ops[1].depth, ops[1].next_hop);
+	ret = check_bulk_lookup(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	return TEST_SUCCESS;
+}
+
+int32_t
+test_bulk_modify(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib *ref = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_bulk_op ops[2];
+	uint32_t ip_arr[2];
+	uint64_t nh_arr[2];
+	uint32_t i;
+	int ret;
+
+	ret = rte_fib_bulk_modify(NULL, NULL, 0);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 100;
+	config.type = RTE_FIB_DUMMY;
+
+	ref = rte_fib_create("bulk_ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_bulk_modify(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Bulk modify fails for DUMMY type\n");
+	rte_fib_free(fib);
+	rte_fib_free(ref);
+
+	config.type = RTE_FIB_DUMMY;
+	ref = rte_fib_create("bulk_ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_bulk_modify(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Bulk modify fails for DIR24_8_4B type\n");
+	rte_fib_free(fib);
+	rte_fib_free(ref);
+
+	/*
+	 * With all tbl8 groups in use an addition placed before a deletion
+	 * in the batch still succeeds
+	 */
+	config.dir24_8.num_tbl8 = BULK_NB_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	for (i = 0; i < BULK_NB_TBL8; i++) {
+		ret = rte_fib_add(fib, BULK_NET + (i << 8), 25, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib_add(fib, RTE_IPV4(9, 0, 0, 0), 25, 1);
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Unexpected add result %d\n", ret);
+
+	ops[0].ip = RTE_IPV4(9, 0, 0, 0);
+	ops[0].depth = 25;
+	ops[0].op = RTE_FIB_ADD;
+	ops[0].next_hop = 1;
+	ops[1].ip = BULK_NET;
+	ops[1].depth = 25;
+	ops[1].op = RTE_FIB_DEL;
+	ret = rte_fib_bulk_modify(fib, ops, 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to modify routes\n");
+
+	ip_arr[0] = RTE_IPV4(9, 0, 0, 1);
+	ip_arr[1] = BULK_NET + 1;
+	ret = rte_fib_lookup_bulk(fib, ip_arr, nh_arr, 2);
+	RTE_TEST_ASSERT((ret == 0) && (nh_arr[0] == 1) &&
+		(nh_arr[1] == config.default_nh),
+		"Failed to get proper nexthop\n");
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -386,6 +576,7 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_bulk_modify),
 	TEST_CASES_END()
 	}
 };
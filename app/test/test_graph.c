@@ -789,6 +789,246 @@ test_print_stats(void)
 	return 0;
 }
 
+static uint64_t dispatch_src_objs;
+static uint64_t dispatch_work_objs[RTE_MAX_LCORE];
+static uint64_t dispatch_sink_objs[RTE_MAX_LCORE];
+static uint64_t dispatch_objs[RTE_GRAPH_BURST_SIZE];
+static void *dispatch_objs_p[RTE_GRAPH_BURST_SIZE];
+static uint32_t dispatch_stop;
+static unsigned int dispatch_worker_lcore;
+
+static uint16_t
+test_dispatch_src(struct rte_graph *graph, struct rte_node *node, void **objs,
+		  uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	rte_node_enqueue(graph, node, 0, dispatch_objs_p, RTE_GRAPH_BURST_SIZE);
+	dispatch_src_objs += RTE_GRAPH_BURST_SIZE;
+	return RTE_GRAPH_BURST_SIZE;
+}
+
+static uint16_t
+test_dispatch_work(struct rte_graph *graph, struct rte_node *node, void **objs,
+		   uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	dispatch_work_objs[rte_lcore_id()] += nb_objs;
+	rte_node_next_stream_move(graph, node, 0);
+	return nb_objs;
+}
+
+static uint16_t
+test_dispatch_sink(struct rte_graph *graph, struct rte_node *node, void **objs,
+		   uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	dispatch_sink_objs[rte_lcore_id()] += nb_objs;
+	return nb_objs;
+}
+
+static struct rte_node_register test_dispatch_src_node = {
+	.name = "test_dispatch_src",
+	.process = test_dispatch_src,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_work"},
+};
+RTE_NODE_REGISTER(test_dispatch_src_node);
+
+static struct rte_node_register test_dispatch_work_node = {
+	.name = "test_dispatch_work",
+	.process = test_dispatch_work,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_sink"},
+};
+RTE_NODE_REGISTER(test_dispatch_work_node);
+
+static struct rte_node_register test_dispatch_sink_node = {
+	.name = "test_dispatch_sink",
+	.process = test_dispatch_sink,
+};
+RTE_NODE_REGISTER(test_dispatch_sink_node);
+
+static int
+dispatch_worker(void *arg)
+{
+	struct rte_graph *graph = arg;
+	int i;
+
+	while (!__atomic_load_n(&dispatch_stop, __ATOMIC_ACQUIRE))
+		rte_graph_walk(graph);
+
+	/* Drain the streams handed off before the stop */
+	for (i = 0; i < 4; i++)
+		rte_graph_walk(graph);
+
+	return 0;
+}
+
+/* The check result is stored in the int cookie, -1 until work is seen */
+static int
+dispatch_stats_cb(bool is_first, bool is_last, void *cookie,
+		  const struct rte_graph_cluster_node_stats *st)
+{
+	unsigned int main_lcore = rte_get_main_lcore();
+	int *result = cookie;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	if (st->id != rte_node_from_name("test_dispatch_work"))
+		return 0;
+
+	if (st->dispatch_objs != dispatch_work_objs[dispatch_worker_lcore] ||
+	    st->dispatch_fails != dispatch_work_objs[main_lcore] ||
+	    st->ring_count != 0) {
+		printf("Handoff stats mismatch, objs %" PRIu64 " fails %"
+		       PRIu64 " ring %u\n", st->dispatch_objs,
+		       st->dispatch_fails, st->ring_count);
+		*result = -1;
+		return -1;
+	}
+	*result = 0;
+	return 0;
+}
+
+/*
+ * Dispatch model test: the source node runs on the main lcore and hands
+ * its objects off to the work node bound to a worker lcore, through a
+ * small ring. The objects which do not fit in the ring are processed by
+ * the main lcore. The sink node has no affinity and runs where work ran.
+ */
+static int
+test_graph_dispatch(void)
+{
+	static const char *patterns[] = {
+		"test_dispatch_src", "test_dispatch_work", "test_dispatch_sink",
+	};
+	unsigned int main_lcore = rte_get_main_lcore();
+	struct rte_graph_cluster_stats_param s_param;
+	struct rte_graph_node_affinity affinities[2];
+	struct rte_graph *main_graph, *worker_graph;
+	struct rte_graph_cluster_stats *stats;
+	char name[RTE_GRAPH_NAMESIZE];
+	const char *pattern = "dispatch";
+	struct rte_graph_param gconf;
+	unsigned int lcores[2];
+	uint64_t local, remote;
+	int stats_result = -1;
+	rte_graph_t id;
+	int i, rc;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough lcores, skipping dispatch model test\n");
+		return TEST_SKIPPED;
+	}
+	dispatch_worker_lcore = rte_get_next_lcore(-1, 1, 0);
+
+	for (i = 0; i < RTE_GRAPH_BURST_SIZE; i++)
+		dispatch_objs_p[i] = &dispatch_objs[i];
+
+	lcores[0] = main_lcore;
+	lcores[1] = dispatch_worker_lcore;
+	affinities[0].node_pattern = "test_dispatch_src";
+	affinities[0].lcore_id = main_lcore;
+	affinities[1].node_pattern = "test_dispatch_work";
+	affinities[1].lcore_id = dispatch_worker_lcore;
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(patterns);
+	gconf.node_patterns = patterns;
+	gconf.model = RTE_GRAPH_MODEL_DISPATCH;
+	gconf.dispatch.nb_lcores = RTE_DIM(lcores);
+	gconf.dispatch.lcores = lcores;
+	gconf.dispatch.nb_affinities = RTE_DIM(affinities);
+	gconf.dispatch.affinities = affinities;
+	gconf.dispatch.ring_size = 4;
+
+	id = rte_graph_create("dispatch", &gconf);
+	TEST_ASSERT(id != RTE_GRAPH_ID_INVALID,
+		    "Dispatch graph creation failed, error = %d", rte_errno);
+
+	main_graph = rte_graph_dispatch_lookup("dispatch", main_lcore);
+	worker_graph = rte_graph_dispatch_lookup("dispatch",
+						 dispatch_worker_lcore);
+	snprintf(name, sizeof(name), "dispatch-%u", dispatch_worker_lcore);
+	if (main_graph != rte_graph_lookup("dispatch") ||
+	    worker_graph == NULL || worker_graph != rte_graph_lookup(name)) {
+		printf("Dispatch graph instance lookup failed\n");
+		goto fail;
+	}
+	if (rte_graph_destroy(rte_graph_from_name(name)) != -EINVAL) {
+		printf("Dispatch graph instance destroyed alone\n");
+		goto fail;
+	}
+
+	__atomic_store_n(&dispatch_stop, 0, __ATOMIC_RELAXED);
+	rte_eal_remote_launch(dispatch_worker, worker_graph,
+			      dispatch_worker_lcore);
+	for (i = 0; i < 1000; i++)
+		rte_graph_walk(main_graph);
+	__atomic_store_n(&dispatch_stop, 1, __ATOMIC_RELEASE);
+	rte_eal_wait_lcore(dispatch_worker_lcore);
+
+	remote = dispatch_work_objs[dispatch_worker_lcore];
+	local = dispatch_work_objs[main_lcore];
+	printf("Dispatch model: %" PRIu64 " objs handed off, %" PRIu64
+	       " processed locally\n", remote, local);
+	if (remote == 0 || remote + local != dispatch_src_objs ||
+	    dispatch_sink_objs[dispatch_worker_lcore] != remote ||
+	    dispatch_sink_objs[main_lcore] != local) {
+		printf("Dispatch model object count mismatch\n");
+		goto fail;
+	}
+
+	if (rte_graph_has_stats_feature()) {
+		memset(&s_param, 0, sizeof(s_param));
+		s_param.socket_id = SOCKET_ID_ANY;
+		s_param.graph_patterns = &pattern;
+		s_param.nb_graph_patterns = 1;
+		s_param.fn = dispatch_stats_cb;
+		s_param.cookie = &stats_result;
+		stats = rte_graph_cluster_stats_create(&s_param);
+		if (stats == NULL) {
+			printf("Unable to get dispatch graph stats\n");
+			goto fail;
+		}
+		rte_graph_cluster_stats_get(stats, 0);
+		rte_graph_cluster_stats_destroy(stats);
+		if (stats_result != 0) {
+			printf("Dispatch graph stats check failed\n");
+			goto fail;
+		}
+
+		s_param.fn = NULL;
+		s_param.f = stdout;
+		stats = rte_graph_cluster_stats_create(&s_param);
+		if (stats == NULL) {
+			printf("Unable to get dispatch graph stats\n");
+			goto fail;
+		}
+		rte_graph_cluster_stats_get(stats, 0);
+		rte_graph_cluster_stats_destroy(stats);
+	}
+
+	rc = rte_graph_destroy(id);
+	TEST_ASSERT(rc == 0, "Dispatch graph destroy failed");
+	TEST_ASSERT(rte_graph_lookup(name) == NULL,
+		    "Dispatch graph instance not destroyed");
+
+	return TEST_SUCCESS;
+fail:
+	rte_graph_destroy(id);
+	return TEST_FAILED;
+}
+
 static int
 graph_setup(void)
 {
@@ -840,6 +1080,7 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_dispatch),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
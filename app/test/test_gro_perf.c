@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_gro.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_tcp.h>
+
+#include "test.h"
+
+/*
+ * GRO performance test.
+ *
+ * Feed bursts of TCP/IPv4 packets, spread round-robin over a varying
+ * number of concurrent flows, into the GRO library and measure the
+ * cycles spent in the GRO calls only. Every flow gets a few in-order
+ * segments between two flushes, so the reassembly table holds all the
+ * flows while they are looked up.
+ */
+
+#define GRO_PERF_NB_MBUFS 8191
+#define GRO_PERF_MBUF_CACHE 256
+#define GRO_PERF_PAYLOAD_LEN 64
+#define GRO_PERF_BURST_SIZE 32
+#define GRO_PERF_PKTS_PER_FLOW 4
+#define GRO_PERF_MAX_FLOWS 1024
+#define GRO_PERF_NB_PKTS (1 << 20)
+
+#define GRO_PERF_HDR_LEN (sizeof(struct rte_ether_hdr) + \
+		sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_tcp_hdr))
+
+static const uint32_t flow_counts[] = {1, 4, 16, 64, 128, 256, 1024};
+
+static struct rte_mempool *pkt_pool;
+static uint32_t flow_seq[GRO_PERF_MAX_FLOWS];
+
+static struct rte_mbuf *
+gro_perf_build_pkt(uint32_t flow)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_tcp_hdr *tcp;
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			GRO_PERF_HDR_LEN + GRO_PERF_PAYLOAD_LEN);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(eth, 0, GRO_PERF_HDR_LEN);
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + sizeof(*tcp) +
+			GRO_PERF_PAYLOAD_LEN);
+	ip->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_TCP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, flow >> 8, flow & 0xff));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 1, 0, 1));
+
+	tcp = (struct rte_tcp_hdr *)(ip + 1);
+	tcp->src_port = rte_cpu_to_be_16(1024 + flow);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(flow_seq[flow]);
+	tcp->data_off = (sizeof(*tcp) / 4) << 4;
+	tcp->tcp_flags = RTE_TCP_ACK_FLAG;
+	flow_seq[flow] += GRO_PERF_PAYLOAD_LEN;
+
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_TCP;
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+
+	return m;
+}
+
+/* Build a burst of packets, going on round-robin from flow *next */
+static int
+gro_perf_build_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+		uint32_t nb_flows, uint32_t *next)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++) {
+		pkts[i] = gro_perf_build_pkt(*next);
+		if (pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(pkts, i);
+			return -1;
+		}
+		*next = (*next + 1) % nb_flows;
+	}
+
+	return 0;
+}
+
+static void
+gro_perf_report(const char *mode, uint32_t nb_flows, uint64_t nb_pkts,
+		uint64_t cycles)
+{
+	double cpp = (double)cycles / nb_pkts;
+
+	printf("%-6s %8u %14.2f %12.2f\n", mode, nb_flows, cpp,
+			(double)rte_get_tsc_hz() / cpp / 1e6);
+}
+
+/*
+ * Heavyweight mode: the flows stay in the reassembly table of a GRO
+ * context until they are flushed, once every flow got
+ * GRO_PERF_PKTS_PER_FLOW segments.
+ */
+static int
+gro_perf_heavy(uint32_t nb_flows)
+{
+	struct rte_mbuf *pkts[GRO_PERF_BURST_SIZE];
+	struct rte_mbuf *out[GRO_PERF_BURST_SIZE];
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV4,
+		.max_flow_num = nb_flows,
+		.max_item_per_flow = GRO_PERF_PKTS_PER_FLOW,
+		.socket_id = rte_socket_id(),
+	};
+	uint64_t start, cycles = 0, total = 0;
+	uint32_t round_pkts, round = 0, next = 0;
+	uint16_t nb, n;
+	void *ctx;
+
+	ctx = rte_gro_ctx_create(&param);
+	if (ctx == NULL) {
+		printf("Cannot create GRO context for %u flows\n", nb_flows);
+		return -1;
+	}
+
+	round_pkts = RTE_MAX(nb_flows * GRO_PERF_PKTS_PER_FLOW,
+			(uint32_t)GRO_PERF_BURST_SIZE);
+	while (total < GRO_PERF_NB_PKTS) {
+		if (gro_perf_build_burst(pkts, GRO_PERF_BURST_SIZE, nb_flows,
+					&next) < 0) {
+			printf("Cannot allocate packets\n");
+			rte_gro_ctx_destroy(ctx);
+			return -1;
+		}
+
+		start = rte_rdtsc_precise();
+		nb = rte_gro_reassemble(pkts, GRO_PERF_BURST_SIZE, ctx);
+		cycles += rte_rdtsc_precise() - start;
+		/* packets not handled by GRO are returned in place */
+		rte_pktmbuf_free_bulk(pkts, nb);
+
+		total += GRO_PERF_BURST_SIZE;
+		round += GRO_PERF_BURST_SIZE;
+		if (round < round_pkts)
+			continue;
+		round = 0;
+
+		do {
+			start = rte_rdtsc_precise();
+			n = rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV4,
+					out, RTE_DIM(out));
+			cycles += rte_rdtsc_precise() - start;
+			rte_pktmbuf_free_bulk(out, n);
+		} while (n == RTE_DIM(out));
+	}
+
+	do {
+		n = rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV4,
+				out, RTE_DIM(out));
+		rte_pktmbuf_free_bulk(out, n);
+	} while (n == RTE_DIM(out));
+	rte_gro_ctx_destroy(ctx);
+
+	gro_perf_report("heavy", nb_flows, total, cycles);
+
+	return 0;
+}
+
+/*
+ * Lightweight mode: all the flows share one burst, so only the flow
+ * counts up to RTE_GRO_MAX_BURST_ITEM_NUM are measured.
+ */
+static int
+gro_perf_burst(uint32_t nb_flows)
+{
+	struct rte_mbuf *pkts[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV4,
+		.max_flow_num = RTE_GRO_MAX_BURST_ITEM_NUM,
+		.max_item_per_flow = 1,
+	};
+	uint64_t start, cycles = 0, total = 0;
+	uint32_t next = 0;
+	uint16_t nb;
+
+	while (total < GRO_PERF_NB_PKTS) {
+		if (gro_perf_build_burst(pkts, RTE_DIM(pkts), nb_flows,
+					&next) < 0) {
+			printf("Cannot allocate packets\n");
+			return -1;
+		}
+
+		start = rte_rdtsc_precise();
+		nb = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &param);
+		cycles += rte_rdtsc_precise() - start;
+		rte_pktmbuf_free_bulk(pkts, nb);
+
+		total += RTE_DIM(pkts);
+	}
+
+	gro_perf_report("burst", nb_flows, total, cycles);
+
+	return 0;
+}
+
+static int
+test_gro_perf(void)
+{
+	unsigned int i;
+	int ret = 0;
+
+	pkt_pool = rte_pktmbuf_pool_create("gro_perf_pool", GRO_PERF_NB_MBUFS,
+			GRO_PERF_MBUF_CACHE, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return TEST_FAILED;
+	}
+
+	printf("\n%-6s %8s %14s %12s\n", "mode", "flows", "cycles/pkt",
+			"Mpps");
+	for (i = 0; i < RTE_DIM(flow_counts) && ret == 0; i++)
+		ret = gro_perf_heavy(flow_counts[i]);
+	for (i = 0; i < RTE_DIM(flow_counts) && ret == 0; i++) {
+		if (flow_counts[i] > RTE_GRO_MAX_BURST_ITEM_NUM)
+			break;
+		ret = gro_perf_burst(flow_counts[i]);
+	}
+
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+
+	return ret == 0 ? TEST_SUCCESS : TEST_FAILED;
+}
+
+REGISTER_TEST_COMMAND(gro_perf_autotest, test_gro_perf);
@@ -1387,6 +1387,17 @@ static int test_hash_creation_with_bad_parameters(void)
 		return -1;
 	}
 
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_5";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE |
+			    RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating resizable hash successfully with ext table\n");
+		return -1;
+	}
+
 	/* test with same name should fail */
 	memcpy(&params, &ut_params, sizeof(params));
 	params.name = "same_name";
@@ -1596,6 +1607,391 @@ static int test_hash_iteration(uint32_t ext_table)
 	return -1;
 }
 
+/*
+ * Bulk lookup functional test, for all the burst sizes up to
+ * RTE_HASH_LOOKUP_BULK_MAX so that every tail of the vector signature
+ * compare is used. Every other key is not in the table.
+ */
+static int
+test_hash_lookup_bulk_sizes(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_lookup_bulk_sizes",
+		.entries = 1024,
+		.key_len = sizeof(struct flow_key),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	struct flow_key bulk_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle;
+	uint64_t hit_mask;
+	unsigned int i, n;
+	int ret;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		memset(&bulk_keys[i], 0, sizeof(bulk_keys[i]));
+		bulk_keys[i].ip_src = RTE_IPV4(10, 1, 0, i);
+		bulk_keys[i].port_dst = i;
+		key_ptrs[i] = &bulk_keys[i];
+		if (i & 1)
+			continue;
+		ret = rte_hash_add_key_data(handle, &bulk_keys[i],
+					    (void *)(uintptr_t)(i + 1));
+		RETURN_IF_ERROR(ret < 0, "failed to add key %u", i);
+	}
+
+	for (n = 1; n <= RTE_HASH_LOOKUP_BULK_MAX; n++) {
+		memset(data, 0, sizeof(data));
+		ret = rte_hash_lookup_bulk_data(handle, key_ptrs, n,
+						&hit_mask, data);
+		RETURN_IF_ERROR(ret != (int)((n + 1) / 2),
+				"bulk lookup of %u keys found %d", n, ret);
+		for (i = 0; i < n; i++) {
+			RETURN_IF_ERROR(!!(hit_mask & (1ULL << i)) == (i & 1),
+					"wrong hit bit for key %u of %u", i, n);
+			RETURN_IF_ERROR(!(i & 1) &&
+					data[i] != (void *)(uintptr_t)(i + 1),
+					"wrong data for key %u of %u", i, n);
+		}
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+#define RESIZE_INIT_ENTRIES 64
+#define RESIZE_NUM_KEYS (RESIZE_INIT_ENTRIES * 16)
+#define RESIZE_BULK 32
+
+static struct flow_key resize_keys[RESIZE_NUM_KEYS];
+static int32_t resize_pos[RESIZE_NUM_KEYS];
+
+/*
+ * Resizable table functional test.
+ *  - Create a resizable table for RESIZE_INIT_ENTRIES entries
+ *  - Add RESIZE_NUM_KEYS keys, forcing several doublings
+ *  - Check key positions stay stable across growth (single and bulk lookup)
+ *  - Delete every other key while a migration is pending
+ *  - Finish the migration and check iteration sees the remaining keys
+ *  - Re-add the deleted keys
+ * Repeat in lock-free mode, where growth needs an attached RCU QSBR variable.
+ */
+static int
+test_hash_resizable(uint8_t lf)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_resizable",
+		.entries = RESIZE_INIT_ENTRIES,
+		.key_len = sizeof(struct flow_key),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv = NULL;
+	struct rte_hash *handle;
+	const void *key_ptrs[RESIZE_BULK];
+	int32_t positions[RESIZE_BULK];
+	const void *next_key;
+	void *next_data;
+	uint32_t iter = 0;
+	unsigned int i, j, n;
+	int32_t ret;
+	size_t sz;
+
+	printf("\n# Running resizable hash functional test%s\n",
+	       lf ? " in lock-free mode" : "");
+
+	if (lf)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+
+	for (i = 0; i < RESIZE_NUM_KEYS; i++) {
+		memset(&resize_keys[i], 0, sizeof(resize_keys[i]));
+		resize_keys[i].ip_src = RTE_IPV4(10, 0, i >> 8, i & 0xff);
+		resize_keys[i].ip_dst = RTE_IPV4(192, 168, 0, 1);
+		resize_keys[i].port_src = i;
+		resize_keys[i].port_dst = 80;
+		resize_keys[i].proto = IPPROTO_TCP;
+	}
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	if (lf) {
+		/* Without RCU the table cannot retire old buckets: no growth */
+		for (i = 0; i < RESIZE_NUM_KEYS; i++)
+			if (rte_hash_add_key(handle, &resize_keys[i]) < 0)
+				break;
+		RETURN_IF_ERROR(i > RESIZE_INIT_ENTRIES,
+				"lock-free table grew without RCU (%u keys)", i);
+		rte_hash_reset(handle);
+
+		sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+		qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+		RETURN_IF_ERROR(qsv == NULL, "RCU QSBR variable creation failed");
+		ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+		if (ret == 0) {
+			rcu_cfg.v = qsv;
+			rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+			ret = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+		}
+		if (ret != 0)
+			rte_free(qsv);
+		RETURN_IF_ERROR(ret != 0, "Attach RCU QSBR to hash table failed");
+	}
+
+	for (i = 0; i < RESIZE_NUM_KEYS; i++) {
+		resize_pos[i] = rte_hash_add_key(handle, &resize_keys[i]);
+		if (resize_pos[i] < 0)
+			break;
+	}
+	if (i != RESIZE_NUM_KEYS)
+		goto fail;
+	if (rte_hash_count(handle) != RESIZE_NUM_KEYS ||
+			rte_hash_max_key_id(handle) < RESIZE_NUM_KEYS) {
+		printf("Unexpected count %d / max key id %d\n",
+		       rte_hash_count(handle), rte_hash_max_key_id(handle));
+		goto fail;
+	}
+
+	/* Re-adding existing keys must return the same positions */
+	for (i = 0; i < RESIZE_NUM_KEYS; i++) {
+		ret = rte_hash_add_key(handle, &resize_keys[i]);
+		if (ret != resize_pos[i])
+			goto fail;
+	}
+
+	for (i = 0; i < RESIZE_NUM_KEYS; i += RESIZE_BULK) {
+		for (j = 0; j < RESIZE_BULK; j++)
+			key_ptrs[j] = &resize_keys[i + j];
+		ret = rte_hash_lookup_bulk(handle, key_ptrs, RESIZE_BULK,
+					   positions);
+		if (ret != 0)
+			goto fail;
+		for (j = 0; j < RESIZE_BULK; j++) {
+			if (positions[j] != resize_pos[i + j])
+				goto fail;
+		}
+	}
+
+	/* Delete every other key, some of them still in the old buckets */
+	for (i = 0; i < RESIZE_NUM_KEYS; i += 2) {
+		ret = rte_hash_del_key(handle, &resize_keys[i]);
+		if (ret != resize_pos[i])
+			goto fail;
+	}
+
+	ret = rte_hash_resize_step(handle, UINT32_MAX);
+	if (ret != 0)
+		goto fail;
+
+	for (i = 0; i < RESIZE_NUM_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &resize_keys[i]);
+		if ((i & 1) ? ret != resize_pos[i] : ret != -ENOENT)
+			goto fail;
+	}
+
+	n = 0;
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0)
+		n++;
+	if (n != RESIZE_NUM_KEYS / 2) {
+		printf("Iterated %u keys, expected %u\n", n,
+		       RESIZE_NUM_KEYS / 2);
+		goto fail;
+	}
+
+	/* Deleted keys can be added back once their slots are reclaimed */
+	for (i = 0; i < RESIZE_NUM_KEYS; i += 2) {
+		if (rte_hash_add_key(handle, &resize_keys[i]) < 0)
+			goto fail;
+	}
+	if (rte_hash_count(handle) != RESIZE_NUM_KEYS) {
+		printf("Unexpected count %d after re-adding\n",
+		       rte_hash_count(handle));
+		goto fail;
+	}
+
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+
+fail:
+	printf("Resizable hash test failed at key %u\n", i);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return -1;
+}
+
+#define AGING_ENTRIES 1024
+#define AGING_NUM_KEYS 256
+#define AGING_SCAN_BUCKETS 4
+
+static struct flow_key aging_keys[AGING_NUM_KEYS];
+static int32_t aging_pos[AGING_NUM_KEYS];
+
+/* Run a full incremental scan pass, return the number of expired keys */
+static int
+aging_scan_pass(const struct rte_hash *handle, uint64_t now,
+		uint64_t timeout, int32_t *expired)
+{
+	uint32_t next = 0;
+	int n = 0, ret;
+
+	do {
+		ret = rte_hash_age_scan(handle, now, timeout, &next,
+					AGING_SCAN_BUCKETS, &expired[n],
+					AGING_NUM_KEYS - n);
+		if (ret < 0)
+			return ret;
+		n += ret;
+	} while (next != 0);
+
+	return n;
+}
+
+/*
+ * Key aging functional test.
+ *  - Add AGING_NUM_KEYS keys, a first scan sets their timestamps
+ *  - Touch the even keys with a bulk lookup and key 1 with a single
+ *    lookup, then check a scan reports exactly the other odd keys
+ *  - Delete the expired keys and check the others are still found
+ *  - Check the aging APIs fail on a table created without aging
+ */
+static int
+test_hash_aging(uint32_t ext_table)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_aging",
+		.entries = AGING_ENTRIES,
+		.key_len = sizeof(struct flow_key),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING,
+	};
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t expired[AGING_NUM_KEYS];
+	uint8_t is_expired[AGING_NUM_KEYS];
+	struct rte_hash *handle;
+	uint32_t next = 0;
+	unsigned int i, j, n;
+	void *k;
+	int ret;
+
+	printf("\n# Running key aging test%s\n",
+	       ext_table ? " with extendable buckets" : "");
+
+	if (ext_table)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+
+	for (i = 0; i < AGING_NUM_KEYS; i++) {
+		memset(&aging_keys[i], 0, sizeof(aging_keys[i]));
+		aging_keys[i].ip_src = RTE_IPV4(10, 1, 0, i);
+		aging_keys[i].ip_dst = RTE_IPV4(192, 168, 0, 1);
+		aging_keys[i].port_src = i;
+		aging_keys[i].port_dst = 443;
+		aging_keys[i].proto = IPPROTO_UDP;
+	}
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < AGING_NUM_KEYS; i++) {
+		aging_pos[i] = rte_hash_add_key(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(aging_pos[i] < 0, "failed to add key %u", i);
+	}
+
+	/* New keys get their timestamp from the first scan */
+	ret = aging_scan_pass(handle, 100, 50, expired);
+	RETURN_IF_ERROR(ret != 0, "first scan expired %d keys", ret);
+
+	/* A single call visits a bounded number of buckets */
+	ret = rte_hash_age_scan(handle, 1000, 50, &next, 1, expired,
+				AGING_NUM_KEYS);
+	RETURN_IF_ERROR(ret < 0 || ret >= AGING_NUM_KEYS / 2 || next == 0,
+			"bounded scan returned %d, cursor %u", ret, next);
+	ret = rte_hash_age_scan(handle, 1000, 50, &next, AGING_ENTRIES,
+				expired, 1);
+	RETURN_IF_ERROR(ret != 1, "scan ignored max_positions (%d)", ret);
+
+	for (i = 0, n = 0; i < AGING_NUM_KEYS; i += 2) {
+		key_ptrs[n++] = &aging_keys[i];
+		if (n < RTE_HASH_LOOKUP_BULK_MAX && i + 2 < AGING_NUM_KEYS)
+			continue;
+		ret = rte_hash_lookup_bulk_touch(handle, key_ptrs, n,
+						 positions, 200);
+		RETURN_IF_ERROR(ret != (int)n, "bulk touch found %d of %u",
+				ret, n);
+		for (j = 0; j < n; j++)
+			RETURN_IF_ERROR(positions[j] !=
+					aging_pos[i - 2 * (n - 1 - j)],
+					"bulk touch returned wrong position");
+		n = 0;
+	}
+	ret = rte_hash_lookup_touch(handle, &aging_keys[1], 200);
+	RETURN_IF_ERROR(ret != aging_pos[1], "touch lookup failed (%d)", ret);
+
+	ret = aging_scan_pass(handle, 200, 50, expired);
+	RETURN_IF_ERROR(ret != AGING_NUM_KEYS / 2 - 1,
+			"scan expired %d keys, expected %d", ret,
+			AGING_NUM_KEYS / 2 - 1);
+
+	memset(is_expired, 0, sizeof(is_expired));
+	for (j = 0; j < (unsigned int)ret; j++) {
+		for (i = 0; i < AGING_NUM_KEYS; i++)
+			if (aging_pos[i] == expired[j])
+				break;
+		RETURN_IF_ERROR(i == AGING_NUM_KEYS || (i & 1) == 0 || i == 1 ||
+				is_expired[i],
+				"unexpected expired position %d", expired[j]);
+		is_expired[i] = 1;
+
+		RETURN_IF_ERROR(rte_hash_get_key_with_position(handle,
+				expired[j], &k) != 0,
+				"expired key %u not found by position", i);
+		RETURN_IF_ERROR(rte_hash_del_key(handle, k) != expired[j],
+				"failed to delete expired key %u", i);
+	}
+
+	/* Keys touched with a later timestamp than the scan do not expire */
+	rte_hash_touch(handle, aging_pos[0], 300);
+	ret = aging_scan_pass(handle, 260, 50, expired);
+	RETURN_IF_ERROR(ret != AGING_NUM_KEYS / 2, "scan expired %d keys",
+			ret);
+
+	for (i = 0; i < AGING_NUM_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(is_expired[i] ? ret != -ENOENT :
+				ret != aging_pos[i],
+				"wrong lookup result %d for key %u", ret, i);
+	}
+
+	rte_hash_free(handle);
+
+	params.extra_flag &= ~RTE_HASH_EXTRA_FLAGS_AGING;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	next = 0;
+	ret = rte_hash_age_scan(handle, 100, 50, &next, 1, expired,
+				AGING_NUM_KEYS);
+	RETURN_IF_ERROR(ret != -ENOTSUP, "scan without aging returned %d",
+			ret);
+	ret = rte_hash_lookup_touch(handle, &aging_keys[0], 100);
+	RETURN_IF_ERROR(ret != -ENOTSUP, "touch without aging returned %d",
+			ret);
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 static uint8_t key[16] = {0x00, 0x01, 0x02, 0x03,
 			0x04, 0x05, 0x06, 0x07,
 			0x08, 0x09, 0x0a, 0x0b,
@@ -2241,6 +2637,19 @@ test_hash(void)
 	if (test_hash_iteration(1) < 0)
 		return -1;
 
+	if (test_hash_lookup_bulk_sizes() < 0)
+		return -1;
+
+	if (test_hash_resizable(0) < 0)
+		return -1;
+	if (test_hash_resizable(1) < 0)
+		return -1;
+
+	if (test_hash_aging(0) < 0)
+		return -1;
+	if (test_hash_aging(1) < 0)
+		return -1;
+
 	run_hash_func_tests();
 
 	if (test_crc32_hash_alg_equiv() < 0)
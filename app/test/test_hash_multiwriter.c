@@ -254,6 +254,125 @@ test_hash_multiwriter(void)
 	return -1;
 }
 
+#define SCALING_NB_KEYS (1 << 20)
+
+static struct {
+	struct rte_hash *h;
+	uint32_t *keys;
+	uint32_t nb_keys;	/**< Keys inserted by each writer */
+} scaling_params;
+
+static int
+test_hash_multiwriter_scaling_worker(void *arg)
+{
+	uint32_t offset = (uint32_t)(uintptr_t)arg * scaling_params.nb_keys;
+	uint32_t i;
+
+	for (i = offset; i < offset + scaling_params.nb_keys; i++)
+		if (rte_hash_add_key(scaling_params.h,
+				     scaling_params.keys + i) < 0)
+			return -1;
+
+	return 0;
+}
+
+/* Insert SCALING_NB_KEYS keys with @nb_writers lcores, return inserts/s */
+static double
+test_hash_multiwriter_scaling_run(uint32_t *keys, unsigned int nb_writers,
+				  uint32_t extra_flag2)
+{
+	struct rte_hash_parameters hash_params = {
+		.name = "multiwriter_scaling",
+		.entries = SCALING_NB_KEYS * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+		.extra_flag2 = extra_flag2,
+	};
+	unsigned int lcore_id, n;
+	uint64_t begin, cycles;
+	int ret = 0;
+
+	scaling_params.h = rte_hash_create(&hash_params);
+	if (scaling_params.h == NULL) {
+		printf("hash creation failed\n");
+		return -1;
+	}
+	scaling_params.keys = keys;
+	scaling_params.nb_keys = SCALING_NB_KEYS / nb_writers;
+
+	begin = rte_rdtsc_precise();
+
+	n = 1;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (n == nb_writers)
+			break;
+		rte_eal_remote_launch(test_hash_multiwriter_scaling_worker,
+				      (void *)(uintptr_t)n++, lcore_id);
+	}
+	ret |= test_hash_multiwriter_scaling_worker(NULL);
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		ret |= rte_eal_wait_lcore(lcore_id);
+
+	cycles = rte_rdtsc_precise() - begin;
+
+	if (ret == 0 && rte_hash_count(scaling_params.h) !=
+			(int32_t)(scaling_params.nb_keys * nb_writers))
+		ret = -1;
+	rte_hash_free(scaling_params.h);
+	if (ret != 0) {
+		printf("insertion failed with %u writers\n", nb_writers);
+		return -1;
+	}
+
+	return (double)scaling_params.nb_keys * nb_writers *
+		rte_get_tsc_hz() / cycles;
+}
+
+/*
+ * Report the insertion rate depending on the number of writers, when the
+ * writers take the table lock and when they lock only the buckets they
+ * update.
+ */
+static int
+test_hash_multiwriter_scaling(void)
+{
+	unsigned int nb_writers;
+	double table_lock, bucket_lock;
+	uint32_t *keys;
+	uint32_t i;
+
+	keys = rte_malloc(NULL, sizeof(uint32_t) * SCALING_NB_KEYS, 0);
+	if (keys == NULL) {
+		printf("RTE_MALLOC failed\n");
+		return -1;
+	}
+	for (i = 0; i < SCALING_NB_KEYS; i++)
+		keys[i] = i;
+
+	printf("\n%-8s %24s %24s\n", "Writers", "Table lock (inserts/s)",
+	       "Bucket lock (inserts/s)");
+	for (nb_writers = 1; nb_writers <= rte_lcore_count();
+			nb_writers <<= 1) {
+		table_lock = test_hash_multiwriter_scaling_run(keys,
+				nb_writers, 0);
+		bucket_lock = test_hash_multiwriter_scaling_run(keys,
+				nb_writers,
+				RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK);
+		if (table_lock < 0 || bucket_lock < 0) {
+			rte_free(keys);
+			return -1;
+		}
+		printf("%-8u %'24.0f %'24.0f\n", nb_writers, table_lock,
+		       bucket_lock);
+	}
+
+	rte_free(keys);
+	return 0;
+}
+
 static int
 test_hash_multiwriter_main(void)
 {
@@ -284,6 +403,9 @@ test_hash_multiwriter_main(void)
 	if (test_hash_multiwriter() < 0)
 		return -1;
 
+	if (test_hash_multiwriter_scaling() < 0)
+		return -1;
+
 	return 0;
 }
 
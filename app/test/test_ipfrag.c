@@ -17,6 +17,12 @@
 #define NUM_MBUFS 128
 #define BURST 32
 
+/* bulk reassembly test */
+#define FRAG_SIZE 64
+#define NB_DGRAMS 3
+#define NB_FRAGS 3
+#define MAX_CYCLES 1000
+
 uint8_t expected_first_frag_ipv4_opts_copied[] = {
 	0x07, 0x0b, 0x04, 0x00,
 	0x00, 0x00, 0x00, 0x00,
@@ -488,6 +494,92 @@ test_ip_frag(void)
 	return result;
 }
 
+/* Build a fragment of size bytes at offset ofs, which is a multiple of 8. */
+static struct rte_mbuf *
+test_v4_fragment(uint16_t pkt_id, uint16_t ofs, size_t size, uint8_t mf)
+{
+	struct rte_mbuf *b;
+
+	b = rte_pktmbuf_alloc(pkt_pool);
+	if (b == NULL)
+		return NULL;
+
+	v4_allocate_packet_of(b, 0x41, size, 0, mf,
+		ofs / RTE_IPV4_HDR_OFFSET_UNITS, 0, IPPROTO_UDP, pkt_id,
+		false, false, false);
+	b->l2_len = 0;
+	b->l3_len = sizeof(struct rte_ipv4_hdr);
+
+	return b;
+}
+
+static int
+test_ip_reassembly_bulk(void)
+{
+	struct rte_ip_frag_death_row dr = { .cnt = 0 };
+	struct rte_mbuf *pkts[BURST], *plain[2];
+	struct rte_ip_frag_tbl *tbl;
+	uint16_t i, j, n, nb_out;
+
+	tbl = rte_ip_frag_table_create(16, 4, 64, MAX_CYCLES, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(tbl, "Cannot create fragment table");
+
+	/* interleave the fragments of the datagrams with two plain packets */
+	n = 0;
+	for (j = 0; j != NB_FRAGS; j++) {
+		for (i = 0; i != NB_DGRAMS; i++) {
+			pkts[n] = test_v4_fragment(i + 1, j * FRAG_SIZE,
+				FRAG_SIZE, j != NB_FRAGS - 1);
+			TEST_ASSERT_NOT_NULL(pkts[n], "Cannot allocate mbuf");
+			n++;
+		}
+		if (j < RTE_DIM(plain)) {
+			plain[j] = test_v4_fragment(0, 0, FRAG_SIZE, 0);
+			TEST_ASSERT_NOT_NULL(plain[j], "Cannot allocate mbuf");
+			pkts[n++] = plain[j];
+		}
+	}
+
+	nb_out = rte_ipv4_frag_reassemble_bulk(tbl, &dr, pkts, n, 0);
+	TEST_ASSERT_EQUAL(nb_out, NB_DGRAMS + RTE_DIM(plain),
+		"Unexpected number of packets: %u", nb_out);
+	TEST_ASSERT_EQUAL(dr.cnt, 0, "Unexpected death row size: %u", dr.cnt);
+
+	/* plain packets are passed through in order */
+	TEST_ASSERT(pkts[0] == plain[0] && pkts[1] == plain[1],
+		"Plain packets are not returned in order");
+	for (i = RTE_DIM(plain); i != nb_out; i++) {
+		TEST_ASSERT_EQUAL(pkts[i]->pkt_len,
+			sizeof(struct rte_ipv4_hdr) + NB_FRAGS * FRAG_SIZE,
+			"Unexpected reassembled packet length: %u",
+			pkts[i]->pkt_len);
+		TEST_ASSERT_EQUAL(pkts[i]->nb_segs, NB_FRAGS,
+			"Unexpected number of segments: %u", pkts[i]->nb_segs);
+	}
+	test_free_fragments(pkts, nb_out);
+
+	/* an incomplete datagram expires on a later burst */
+	pkts[0] = test_v4_fragment(NB_DGRAMS + 1, 0, FRAG_SIZE, 1);
+	TEST_ASSERT_NOT_NULL(pkts[0], "Cannot allocate mbuf");
+	nb_out = rte_ipv4_frag_reassemble_bulk(tbl, &dr, pkts, 1, 0);
+	TEST_ASSERT_EQUAL(nb_out, 0, "Unexpected number of packets: %u",
+		nb_out);
+
+	pkts[0] = test_v4_fragment(0, 0, FRAG_SIZE, 0);
+	TEST_ASSERT_NOT_NULL(pkts[0], "Cannot allocate mbuf");
+	nb_out = rte_ipv4_frag_reassemble_bulk(tbl, &dr, pkts, 1,
+		MAX_CYCLES + 1);
+	TEST_ASSERT_EQUAL(nb_out, 1, "Unexpected number of packets: %u",
+		nb_out);
+	TEST_ASSERT_EQUAL(dr.cnt, 1, "Expired fragment not on death row");
+	test_free_fragments(pkts, nb_out);
+
+	rte_ip_frag_free_death_row(&dr, 0);
+	rte_ip_frag_table_destroy(tbl);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite ipfrag_testsuite  = {
 	.suite_name = "IP Frag Unit Test Suite",
 	.setup = testsuite_setup,
@@ -495,6 +587,8 @@ static struct unit_test_suite ipfrag_testsuite  = {
 	.unit_test_cases = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			     test_ip_frag),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			     test_ip_reassembly_bulk),
 
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
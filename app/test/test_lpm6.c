@@ -10,6 +10,8 @@
 #include <string.h>
 
 #include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_vect.h>
 #include <rte_lpm6.h>
 
 #include "test_lpm6_data.h"
@@ -52,6 +54,9 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
+static int32_t test30(void);
+static int32_t test31(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -84,6 +89,9 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
+	test30,
+	test31,
 };
 
 #define MAX_DEPTH                                                    128
@@ -1771,6 +1779,285 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * rte_lpm6_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to LPM
+ *  - Add another RCU QSBR variable to LPM
+ *  - Check returns
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Invalid arguments */
+	status = rte_lpm6_rcu_qsbr_add(NULL, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+	status = rte_lpm6_rcu_qsbr_add(lpm, NULL);
+	TEST_LPM_ASSERT(status != 0);
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to LPM table */
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Create and attach another RCU QSBR to LPM table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv2 != NULL);
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_SYNC;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return PASS;
+}
+
+/*
+ * rte_lpm6_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create LPM which supports 1 tbl8 at max
+ *  - Add RCU QSBR variable to LPM
+ *  - Add a rule with depth=32 (> 24)
+ *  - Register a reader thread (not a real thread)
+ *  - Reader lookup existing rule
+ *  - Writer delete the rule
+ *  - Reader lookup the rule
+ *  - Writer re-add the rule (no available tbl8)
+ *  - Reader report quiescent state
+ *  - Writer re-add the rule
+ *  - Reader lookup the rule
+ *  - Writer delete the rule, reader goes offline
+ *  - Writer delete all the rules, check that the tbl8 pool is consistent
+ */
+int32_t
+test30(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	int32_t status;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t ip2[] = {0x20, 0x01, 0x0e, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t depth = 32;
+	uint32_t next_hop = 1, next_hop_return;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 1;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to LPM table */
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(next_hop_return == next_hop);
+
+	/* Writer update */
+	status = rte_lpm6_delete(lpm, ip, depth);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status != 0);
+
+	/* The only tbl8 is still held by the reader */
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == -ENOSPC);
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(next_hop_return == next_hop);
+
+	/* Leave the tbl8 in the defer queue */
+	status = rte_lpm6_delete(lpm, ip, depth);
+	TEST_LPM_ASSERT(status == 0);
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* The deferred tbl8 must not be returned to the pool twice */
+	rte_lpm6_delete_all(lpm);
+
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_add(lpm, ip2, depth, next_hop);
+	TEST_LPM_ASSERT(status == -ENOSPC);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(next_hop_return == next_hop);
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
+/*
+ * Check that every bulk lookup implementation supported by the CPU
+ * returns the same next hops as rte_lpm6_lookup().
+ *  - Select the implementation through the max SIMD bitwidth
+ *  - Add the large route table and a chain of rules down to depth 128
+ *  - Look up random addresses, with bulk sizes which are not
+ *    a multiple of the vector width
+ */
+#define BULK_NB_IPS 1000
+
+int32_t
+test31(void)
+{
+	const uint16_t simd_bitwidths[] = {
+		RTE_VECT_SIMD_512,
+		RTE_VECT_SIMD_256,
+		RTE_VECT_SIMD_128,
+		RTE_VECT_SIMD_DISABLED,
+	};
+	const uint32_t bulk_sizes[] = {1, 7, 15, 33, BULK_NB_IPS};
+	static uint8_t ip_batch[BULK_NB_IPS][RTE_LPM6_IPV6_ADDR_SIZE];
+	static int32_t next_hop_return[BULK_NB_IPS];
+	uint16_t orig_bitwidth = rte_vect_get_max_simd_bitwidth();
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE];
+	uint32_t next_hop;
+	uint32_t i, j, k;
+	uint8_t depth;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	generate_large_ips_table(0);
+	for (i = 0; i < BULK_NB_IPS; i++)
+		memcpy(ip_batch[i], large_ips_table[i * (NUM_IPS_ENTRIES /
+			BULK_NB_IPS)].ip, RTE_LPM6_IPV6_ADDR_SIZE);
+
+	/* addresses matching the deepest rules */
+	IPv6(ip, 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	for (i = 0; i < 16; i++) {
+		memcpy(ip_batch[i * 61], ip, RTE_LPM6_IPV6_ADDR_SIZE);
+		ip_batch[i * 61][15] = i;
+	}
+
+	for (i = 0; i < RTE_DIM(simd_bitwidths); i++) {
+		if (rte_vect_set_max_simd_bitwidth(simd_bitwidths[i]) != 0)
+			/* forced from the command line */
+			continue;
+
+		lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_LPM_ASSERT(lpm != NULL);
+
+		for (j = 0; j < NUM_ROUTE_ENTRIES; j++) {
+			status = rte_lpm6_add(lpm, large_route_table[j].ip,
+				large_route_table[j].depth,
+				large_route_table[j].next_hop);
+			TEST_LPM_ASSERT(status == 0);
+		}
+
+		for (depth = 32; depth <= MAX_DEPTH; depth += 8) {
+			status = rte_lpm6_add(lpm, ip, depth, 0x1FFFFF - depth);
+			TEST_LPM_ASSERT(status == 0);
+		}
+
+		for (j = 0; j < RTE_DIM(bulk_sizes); j++) {
+			memset(next_hop_return, 0, sizeof(next_hop_return));
+			status = rte_lpm6_lookup_bulk_func(lpm, ip_batch,
+				next_hop_return, bulk_sizes[j]);
+			TEST_LPM_ASSERT(status == 0);
+
+			for (k = 0; k < bulk_sizes[j]; k++) {
+				status = rte_lpm6_lookup(lpm, ip_batch[k],
+					&next_hop);
+				if (status == 0)
+					TEST_LPM_ASSERT(next_hop_return[k] ==
+						(int32_t)next_hop);
+				else
+					TEST_LPM_ASSERT(next_hop_return[k] ==
+						-1);
+			}
+			/* the entries after the bulk must be left untouched */
+			if (bulk_sizes[j] < BULK_NB_IPS)
+				TEST_LPM_ASSERT(
+					next_hop_return[bulk_sizes[j]] == 0);
+		}
+
+		rte_lpm6_free(lpm);
+	}
+
+	rte_vect_set_max_simd_bitwidth(orig_bitwidth);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -27,6 +27,10 @@
 #include <rte_random.h>
 #include <rte_string_fns.h>
 
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include "process.h"
+#endif
+
 #define N 10000
 
 static int
@@ -374,6 +378,122 @@ test_multi_alloc_statistics(void)
 	return 0;
 }
 
+#ifndef RTE_EXEC_ENV_WINDOWS
+/*
+ * Free and reallocate small blocks, which are recycled through the
+ * per-lcore malloc cache, and check that zeroed allocations are still zeroed.
+ * Runs in a process started with --malloc-cache by test_malloc_cache_spawn().
+ */
+int
+test_malloc_cache(void)
+{
+#define N_SMALL_ALLOCS 64
+#define REUSE_SIZE 200
+	uint64_t pre_hits, pre_misses, post_hits, post_misses;
+	void *ptrs[N_SMALL_ALLOCS];
+	int socket = rte_socket_id();
+	void *ptr, *zptr = NULL;
+	unsigned int i;
+	size_t j, size;
+	int ret = -1;
+
+	memset(ptrs, 0, sizeof(ptrs));
+
+	ret = rte_malloc_get_cache_stats(socket, &pre_hits, &pre_misses);
+	if (ret == -ENOTSUP) {
+		printf("%s: malloc cache not available, skipping\n", __func__);
+		return 0;
+	}
+	if (ret < 0) {
+		printf("%s: cannot get malloc cache statistics\n", __func__);
+		return -1;
+	}
+	ret = -1;
+
+	for (i = 0; i < N_SMALL_ALLOCS; i++) {
+		size = (i * 67) % 4096 + 1;
+		ptrs[i] = rte_malloc("reuse", size, 0);
+		if (ptrs[i] == NULL) {
+			printf("%s: cannot allocate %zu bytes\n", __func__, size);
+			goto end;
+		}
+		memset(ptrs[i], 0xa5, size);
+	}
+	for (i = 0; i < N_SMALL_ALLOCS; i++) {
+		rte_free(ptrs[i]);
+		ptrs[i] = NULL;
+	}
+
+	for (i = 0; i < N_SMALL_ALLOCS; i++) {
+		size = (i * 67) % 4096 + 1;
+		ptrs[i] = rte_zmalloc("reuse", size, 0);
+		if (ptrs[i] == NULL) {
+			printf("%s: cannot allocate %zu bytes\n", __func__, size);
+			goto end;
+		}
+		for (j = 0; j < size; j++) {
+			if (((char *)ptrs[i])[j] != 0) {
+				printf("%s: reused block is not zeroed\n",
+					__func__);
+				goto end;
+			}
+		}
+	}
+
+	rte_malloc_get_cache_stats(socket, &post_hits, &post_misses);
+	if (post_hits <= pre_hits || post_misses <= pre_misses) {
+		printf("%s: malloc cache was not used\n", __func__);
+		goto end;
+	}
+
+	/* the last freed block of a size class is the next one allocated */
+	ptr = rte_malloc("reuse", REUSE_SIZE, 0);
+	if (ptr == NULL) {
+		printf("%s: cannot allocate %d bytes\n", __func__, REUSE_SIZE);
+		goto end;
+	}
+	memset(ptr, 0xa5, REUSE_SIZE);
+	rte_free(ptr);
+
+	rte_malloc_get_cache_stats(socket, &pre_hits, &pre_misses);
+	zptr = rte_zmalloc("reuse", REUSE_SIZE, 0);
+	rte_malloc_get_cache_stats(socket, &post_hits, &post_misses);
+	if (zptr != ptr || post_hits != pre_hits + 1) {
+		printf("%s: freed block was not recycled by the malloc cache\n",
+			__func__);
+		goto end;
+	}
+	for (j = 0; j < REUSE_SIZE; j++) {
+		if (((char *)zptr)[j] != 0) {
+			printf("%s: recycled block is not zeroed\n", __func__);
+			goto end;
+		}
+	}
+
+	ret = 0;
+end:
+	rte_free(zptr);
+	for (i = 0; i < N_SMALL_ALLOCS; i++)
+		rte_free(ptrs[i]);
+	return ret;
+#undef REUSE_SIZE
+#undef N_SMALL_ALLOCS
+}
+
+/*
+ * Run test_malloc_cache() in a standalone process with the per-lcore
+ * malloc cache enabled.
+ */
+static int
+test_malloc_cache_spawn(void)
+{
+	const char * const argv[] = {prgname, "--no-huge", "-m", "64",
+				     "--no-shconf", "--malloc-cache"};
+
+	return process_dup(argv, RTE_DIM(argv), "test_malloc_cache");
+}
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
 #ifdef RTE_EXEC_ENV_WINDOWS
 static int
 test_realloc(void)
@@ -1087,6 +1207,16 @@ test_malloc(void)
 	else
 		printf("test_multi_alloc_statistics() passed\n");
 
+#ifndef RTE_EXEC_ENV_WINDOWS
+	ret = test_malloc_cache_spawn();
+	if (ret != 0) {
+		printf("test_malloc_cache() failed\n");
+		return -1;
+	}
+	else
+		printf("test_malloc_cache() passed\n");
+#endif
+
 	return 0;
 }
 
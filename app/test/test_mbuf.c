@@ -724,9 +724,13 @@ test_pktmbuf_pool(struct rte_mempool *pktmbuf_pool)
 static int
 test_pktmbuf_pool_bulk(void)
 {
+/* one more than the pools with pending mbufs in rte_pktmbuf_free_bulk() */
+#define NB_BULK_POOLS 5
 	struct rte_mempool *pool = NULL;
 	struct rte_mempool *pool2 = NULL;
-	unsigned int i;
+	struct rte_mempool *pools[NB_BULK_POOLS] = { NULL };
+	char name[RTE_MEMPOOL_NAMESIZE];
+	unsigned int i, j;
 	struct rte_mbuf *m;
 	struct rte_mbuf *mbufs[NB_MBUF];
 	int ret = 0;
@@ -874,6 +878,79 @@ test_pktmbuf_pool_bulk(void)
 		goto err;
 	}
 
+	printf("Test bulk free of interleaved and shared mbufs.\n");
+
+	/* Alternate mbufs from both pools, sharing two of every four. */
+	for (i = 0; i < NB_MBUF; i++) {
+		mbufs[i] = rte_pktmbuf_alloc((i & 1) ? pool2 : pool);
+		if (mbufs[i] == NULL) {
+			printf("rte_pktmbuf_alloc() failed (%u)\n", i);
+			goto err;
+		}
+		if ((i % 4) < 2)
+			rte_mbuf_refcnt_update(mbufs[i], 1);
+	}
+	/* Free them, the shared mbufs must stay out of the pools. */
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	if (!(rte_mempool_avail_count(pool) == NB_MBUF / 4 &&
+			rte_mempool_avail_count(pool2) == NB_MBUF / 4)) {
+		printf("mempools avail count incorrect: %u+%u != %u+%u\n",
+		       rte_mempool_avail_count(pool),
+		       rte_mempool_avail_count(pool2),
+		       NB_MBUF / 4, NB_MBUF / 4);
+		goto err;
+	}
+	/* Free the last reference of the shared mbufs. */
+	for (i = 0; i < NB_MBUF; i++) {
+		if ((i % 4) >= 2) {
+			mbufs[i] = NULL;
+		} else if (rte_mbuf_refcnt_read(mbufs[i]) != 1) {
+			printf("refcnt of shared mbuf incorrect\n");
+			goto err;
+		}
+	}
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	if (!(rte_mempool_full(pool) && rte_mempool_full(pool2))) {
+		printf("mempools not full\n");
+		goto err;
+	}
+
+	printf("Test bulk free of mbufs interleaved from %u pools.\n",
+	       NB_BULK_POOLS);
+
+	pools[0] = pool;
+	pools[1] = pool2;
+	for (i = 2; i < NB_BULK_POOLS; i++) {
+		snprintf(name, sizeof(name), "test_pktmbuf_bulk%u", i + 1);
+		pools[i] = rte_pktmbuf_pool_create(name, NB_MBUF, 0, 0,
+				MBUF_DATA_SIZE, SOCKET_ID_ANY);
+		if (pools[i] == NULL) {
+			printf("rte_pktmbuf_pool_create() failed. rte_errno %d\n",
+			       rte_errno);
+			goto err;
+		}
+	}
+	/* Runs of four mbufs from the first pool followed by one mbuf from
+	 * each other pool: the last pool finds no free pending array, and
+	 * the fullest one, of the first pool, has to be flushed.
+	 */
+	RTE_BUILD_BUG_ON(NB_MBUF % (NB_BULK_POOLS + 3) != 0);
+	for (i = 0; i < NB_MBUF; i++) {
+		j = i % (NB_BULK_POOLS + 3);
+		mbufs[i] = rte_pktmbuf_alloc(pools[j < 4 ? 0 : j - 3]);
+		if (mbufs[i] == NULL) {
+			printf("rte_pktmbuf_alloc() failed (%u)\n", i);
+			goto err;
+		}
+	}
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	for (i = 0; i < NB_BULK_POOLS; i++) {
+		if (!rte_mempool_full(pools[i])) {
+			printf("mempool %u not full\n", i);
+			goto err;
+		}
+	}
+
 	ret = 0;
 	goto done;
 
@@ -884,7 +961,10 @@ test_pktmbuf_pool_bulk(void)
 	printf("Free mbuf pools for bulk allocation.\n");
 	rte_mempool_free(pool);
 	rte_mempool_free(pool2);
+	for (i = 2; i < NB_BULK_POOLS; i++)
+		rte_mempool_free(pools[i]);
 	return ret;
+#undef NB_BULK_POOLS
 }
 
 /*
@@ -29,6 +29,10 @@
 #include <rte_mbuf_pool_ops.h>
 #include <rte_mbuf.h>
 
+#ifdef RTE_MEMPOOL_NUMA
+#include <rte_mempool_numa.h>
+#endif
+
 #include "test.h"
 
 /*
@@ -225,6 +229,325 @@ static int test_mempool_creation_with_invalid_flags(void)
 	return 0;
 }
 
+/*
+ * Check that an adaptive cache starts small, grows when the requests
+ * keep reaching the backend and shrinks when they never do. A lcore which
+ * only frees objects in bulks larger than the cache must grow it too.
+ */
+static int test_mempool_adaptive_cache(void)
+{
+#define ADAPTIVE_BULK 64
+	void *objs[ADAPTIVE_BULK];
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	unsigned int i, size;
+	int ret = -1;
+
+	/* an adaptive cache needs a maximum size */
+	mp = rte_mempool_create("test_adaptive_nocache", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 0, 0,
+		NULL, NULL,
+		NULL, NULL,
+		SOCKET_ID_ANY, RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp != NULL) {
+		rte_mempool_free(mp);
+		RET_ERR();
+	}
+
+	mp = rte_mempool_create("test_adaptive_cache", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		NULL, NULL,
+		my_obj_init, NULL,
+		SOCKET_ID_ANY, RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp == NULL)
+		RET_ERR();
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		GOTO_ERR(ret, out);
+	if (cache->size != RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE)
+		GOTO_ERR(ret, out);
+
+	/* bulks larger than the cache make half of the requests miss */
+	for (i = 0; i < 2 * RTE_MEMPOOL_CACHE_SAMPLE_PERIOD; i++) {
+		if (rte_mempool_get_bulk(mp, objs, ADAPTIVE_BULK) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, ADAPTIVE_BULK);
+	}
+
+	printf("adaptive cache: size=%u hit_ratio=%u%%\n",
+		cache->size, cache->hit_ratio);
+	if (cache->size <= RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE ||
+			cache->size > RTE_MEMPOOL_CACHE_MAX_SIZE)
+		GOTO_ERR(ret, out);
+	if (cache->hit_ratio > 100)
+		GOTO_ERR(ret, out);
+
+	/* single objects are nearly always served by the cache */
+	size = cache->size;
+	for (i = 0; i < 3 * RTE_MEMPOOL_CACHE_SAMPLE_PERIOD; i++) {
+		if (rte_mempool_get(mp, &objs[0]) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put(mp, objs[0]);
+	}
+
+	printf("adaptive cache: size=%u hit_ratio=%u%%\n",
+		cache->size, cache->hit_ratio);
+	if (cache->hit_ratio < RTE_MEMPOOL_CACHE_GROW_HIT_RATIO ||
+			cache->size >= size)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_cache_flush(cache, mp);
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE)
+		GOTO_ERR(ret, out);
+	rte_mempool_free(mp);
+
+	mp = rte_mempool_create("test_adaptive_put", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		NULL, NULL,
+		my_obj_init, NULL,
+		SOCKET_ID_ANY, RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp == NULL)
+		RET_ERR();
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		GOTO_ERR(ret, out);
+	if (cache->flushthresh >= ADAPTIVE_BULK)
+		GOTO_ERR(ret, out);
+
+	/* objects come from elsewhere, the cache only sees the puts */
+	for (i = 0; i < 2 * RTE_MEMPOOL_CACHE_SAMPLE_PERIOD; i++) {
+		if (rte_mempool_generic_get(mp, objs, ADAPTIVE_BULK, NULL) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, ADAPTIVE_BULK);
+	}
+
+	printf("adaptive cache: size=%u hit_ratio=%u%%\n",
+		cache->size, cache->hit_ratio);
+	if (cache->size <= RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_cache_flush(cache, mp);
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE)
+		GOTO_ERR(ret, out);
+
+	ret = 0;
+out:
+	rte_mempool_free(mp);
+	return ret;
+#undef ADAPTIVE_BULK
+}
+
+#ifdef RTE_MEMPOOL_NUMA
+#define NUMA_EXT_AREAS 2
+#define NUMA_EXT_SIZE 64
+#define NUMA_EXT_ELT_SIZE 64
+
+/*
+ * Populate a NUMA mempool with local memory and with two external memory
+ * areas, each having a socket of its own, so that objects of several home
+ * sockets are mixed whatever the number of sockets of the machine.
+ */
+static int test_mempool_numa_extmem(void)
+{
+	struct rte_mempool_numa_stats stats;
+	size_t pgsz = rte_mem_page_size();
+	void *ext_addr[NUMA_EXT_AREAS] = { NULL };
+	int ext_socket[NUMA_EXT_AREAS];
+	void *objs[NUMA_EXT_SIZE];
+	void *mixed[NUMA_EXT_SIZE];
+	struct rte_mempool *mp;
+	size_t min_chunk_size, align, ext_len;
+	unsigned int i, j, n, ext_n, local_n;
+	void *local_addr = NULL;
+	ssize_t mem_size;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("test_numa_extmem", NUMA_EXT_SIZE,
+		NUMA_EXT_ELT_SIZE, 0, 0, SOCKET_ID_ANY,
+		RTE_MEMPOOL_F_NO_IOVA_CONTIG);
+	if (mp == NULL)
+		RET_ERR();
+	if (rte_mempool_set_ops_byname(mp, "numa", NULL) < 0)
+		GOTO_ERR(ret, out);
+
+	/* each external area holds a quarter of the objects */
+	ext_n = NUMA_EXT_SIZE / 4;
+	local_n = NUMA_EXT_SIZE - NUMA_EXT_AREAS * ext_n;
+	mem_size = rte_mempool_ops_calc_mem_size(mp, ext_n, 0,
+		&min_chunk_size, &align);
+	if (mem_size < 0)
+		GOTO_ERR(ret, out);
+	ext_len = RTE_ALIGN_CEIL(mem_size, pgsz);
+
+	for (i = 0; i < NUMA_EXT_AREAS; i++) {
+		ext_addr[i] = rte_mem_map(NULL, ext_len,
+			RTE_PROT_READ | RTE_PROT_WRITE,
+			RTE_MAP_PRIVATE | RTE_MAP_ANONYMOUS, -1, 0);
+		if (ext_addr[i] == NULL)
+			GOTO_ERR(ret, out);
+		if (rte_extmem_register(ext_addr[i], ext_len, NULL, 0,
+				pgsz) < 0) {
+			rte_mem_unmap(ext_addr[i], ext_len);
+			ext_addr[i] = NULL;
+			GOTO_ERR(ret, out);
+		}
+		ext_socket[i] =
+			rte_mem_virt2memseg_list(ext_addr[i])->socket_id;
+
+		if (rte_mempool_populate_iova(mp, ext_addr[i], RTE_BAD_IOVA,
+				mem_size, NULL, NULL) != (int)ext_n)
+			GOTO_ERR(ret, out);
+	}
+
+	mem_size = rte_mempool_ops_calc_mem_size(mp, local_n, 0,
+		&min_chunk_size, &align);
+	if (mem_size < 0)
+		GOTO_ERR(ret, out);
+	local_addr = rte_malloc_socket("test_numa_extmem", mem_size, align,
+		rte_socket_id());
+	if (local_addr == NULL)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_populate_iova(mp, local_addr, RTE_BAD_IOVA, mem_size,
+			NULL, NULL) != (int)local_n)
+		GOTO_ERR(ret, out);
+
+	if (rte_mempool_numa_avail_count(mp, rte_socket_id()) != (int)local_n)
+		GOTO_ERR(ret, out);
+	for (i = 0; i < NUMA_EXT_AREAS; i++) {
+		if (rte_mempool_numa_avail_count(mp, ext_socket[i]) !=
+				(int)ext_n)
+			GOTO_ERR(ret, out);
+	}
+
+	/* the local objects come first, the external ones are borrowed */
+	if (rte_mempool_get_bulk(mp, objs, NUMA_EXT_SIZE) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_numa_stats_get(mp, &stats) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.local_get != local_n ||
+			stats.remote_get != NUMA_EXT_SIZE - local_n)
+		GOTO_ERR(ret, out);
+
+	/* free objects of all home sockets interleaved in one burst */
+	for (i = 0, n = 0; n < NUMA_EXT_SIZE; i++)
+		for (j = i; j < NUMA_EXT_SIZE; j += ext_n, n++)
+			mixed[n] = objs[j];
+	rte_mempool_put_bulk(mp, mixed, NUMA_EXT_SIZE);
+
+	if (rte_mempool_numa_stats_get(mp, &stats) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.local_put != stats.local_get ||
+			stats.remote_put != stats.remote_get)
+		GOTO_ERR(ret, out);
+
+	/* each object went back to the sub-pool of its home socket */
+	if (rte_mempool_numa_avail_count(mp, rte_socket_id()) != (int)local_n)
+		GOTO_ERR(ret, out);
+	for (i = 0; i < NUMA_EXT_AREAS; i++) {
+		if (rte_mempool_numa_avail_count(mp, ext_socket[i]) !=
+				(int)ext_n)
+			GOTO_ERR(ret, out);
+	}
+
+	ret = 0;
+out:
+	rte_mempool_free(mp);
+	rte_free(local_addr);
+	for (i = 0; i < NUMA_EXT_AREAS; i++) {
+		if (ext_addr[i] == NULL)
+			continue;
+		rte_extmem_unregister(ext_addr[i], ext_len);
+		rte_mem_unmap(ext_addr[i], ext_len);
+	}
+	return ret;
+}
+
+/*
+ * Check that the NUMA handler serves the local socket first, borrows
+ * from the remote ones only when it is empty and sends objects back home.
+ */
+static int test_mempool_numa(void)
+{
+	struct rte_mempool_numa_stats stats;
+	struct rte_mempool *mp;
+	unsigned int i, local_avail;
+	void **objs = NULL;
+	void *obj;
+	int count, total = 0;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("test_numa", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 0, 0,
+		SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+	if (rte_mempool_set_ops_byname(mp, "numa", NULL) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_numa_populate(mp) != (int)MEMPOOL_SIZE)
+		GOTO_ERR(ret, out);
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+	/* objects are spread over the sub-pools */
+	for (i = 0; i < rte_socket_count(); i++) {
+		count = rte_mempool_numa_avail_count(mp,
+				rte_socket_id_by_idx(i));
+		if (count < 0)
+			GOTO_ERR(ret, out);
+		total += count;
+	}
+	if (total != (int)MEMPOOL_SIZE)
+		GOTO_ERR(ret, out);
+
+	count = rte_mempool_numa_avail_count(mp, rte_socket_id());
+	if (count < 0)
+		GOTO_ERR(ret, out);
+	local_avail = count;
+
+	objs = rte_calloc("test_numa", MEMPOOL_SIZE, sizeof(void *), 0);
+	if (objs == NULL)
+		GOTO_ERR(ret, out);
+
+	/* drain the whole pool from this lcore */
+	if (rte_mempool_get_bulk(mp, objs, MEMPOOL_SIZE) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_get(mp, &obj) == 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put_bulk(mp, objs, MEMPOOL_SIZE);
+
+	if (rte_mempool_numa_stats_get(mp, &stats) < 0)
+		GOTO_ERR(ret, out);
+	printf("numa mempool: local_get=%"PRIu64" remote_get=%"PRIu64
+		" local_put=%"PRIu64" remote_put=%"PRIu64"\n",
+		stats.local_get, stats.remote_get,
+		stats.local_put, stats.remote_put);
+	if (stats.local_get != local_avail ||
+			stats.remote_get != MEMPOOL_SIZE - local_avail)
+		GOTO_ERR(ret, out);
+	if (stats.local_put != stats.local_get ||
+			stats.remote_put != stats.remote_get)
+		GOTO_ERR(ret, out);
+
+	/* borrowed objects went back to their home socket */
+	if (rte_mempool_numa_avail_count(mp, rte_socket_id()) !=
+			(int)local_avail)
+		GOTO_ERR(ret, out);
+
+	if (test_mempool_basic(mp, 0) < 0)
+		GOTO_ERR(ret, out);
+
+	if (test_mempool_numa_extmem() < 0)
+		GOTO_ERR(ret, out);
+
+	ret = 0;
+out:
+	rte_free(objs);
+	rte_mempool_free(mp);
+	return ret;
+}
+#endif
+
 static struct rte_mempool *mp_spsc;
 static rte_spinlock_t scsp_spinlock;
 static void *scsp_obj_table[MAX_KEEP];
@@ -1004,6 +1327,15 @@ test_mempool(void)
 	if (test_mempool_creation_with_invalid_flags() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_adaptive_cache() < 0)
+		GOTO_ERR(ret, err);
+
+#ifdef RTE_MEMPOOL_NUMA
+	/* test the NUMA handler */
+	if (test_mempool_numa() < 0)
+		GOTO_ERR(ret, err);
+#endif
+
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
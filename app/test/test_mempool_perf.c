@@ -51,6 +51,9 @@
  *      - One core with user-owned cache
  *      - Two cores with user-owned cache
  *      - Max. cores with user-owned cache
+ *      - One core with adaptive cache
+ *      - Two cores with adaptive cache
+ *      - Max. cores with adaptive cache
  *
  *    - Bulk size (*n_get_bulk*, *n_put_bulk*)
  *
@@ -280,7 +283,16 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 		rate += (stats[lcore_id].enq_count / TIME_S);
 
-	printf("rate_persec=%" PRIu64 "\n", rate);
+	printf("rate_persec=%" PRIu64, rate);
+	/* show where the main lcore cache converged */
+	if (!use_external_cache && (mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE)) {
+		struct rte_mempool_cache *cache =
+			rte_mempool_default_cache(mp, rte_get_main_lcore());
+
+		printf(" cache_size=%u hit_ratio=%u%%",
+		       cache->size, cache->hit_ratio);
+	}
+	printf("\n");
 
 	return 0;
 }
@@ -326,6 +338,7 @@ static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
+	struct rte_mempool *mp_adaptive = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
 	const char *default_pool_ops;
@@ -350,6 +363,17 @@ test_mempool_perf(void)
 	if (mp_cache == NULL)
 		goto err;
 
+	/* create a mempool (with adaptive cache) */
+	mp_adaptive = rte_mempool_create("perf_test_adaptive", MEMPOOL_SIZE,
+					 MEMPOOL_ELT_SIZE,
+					 RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+					 NULL, NULL,
+					 my_obj_init, NULL,
+					 SOCKET_ID_ANY,
+					 RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp_adaptive == NULL)
+		goto err;
+
 	default_pool_ops = rte_mbuf_best_mempool_ops();
 	/* Create a mempool based on Default handler */
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -413,6 +437,18 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_cache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* performance test with 1, 2 and max cores */
+	printf("start performance test (with adaptive cache)\n");
+
+	if (do_one_mempool_test(mp_adaptive, 1) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_adaptive, 2) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_adaptive, rte_lcore_count()) < 0)
+		goto err;
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (with user-owned cache)\n");
 	use_external_cache = 1;
@@ -432,6 +468,7 @@ test_mempool_perf(void)
 
 err:
 	rte_mempool_free(mp_cache);
+	rte_mempool_free(mp_adaptive);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
 	return ret;
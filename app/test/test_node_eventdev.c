@@ -0,0 +1,346 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include "test.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_node_eventdev(void)
+{
+	printf("node_eventdev not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_bus_vdev.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_node_eventdev_api.h>
+#include <rte_service.h>
+
+#define EVENTDEV_NAME "event_sw0"
+#define GRAPH_NAME "test_node_eventdev"
+#define SINK_NODE_NAME "test_eventdev_sink"
+#define NB_MBUFS 128
+#define NB_OBJS 64
+#define VECTOR_SIZE 8
+/* two vectors together overflow a graph stream */
+#define BIG_VECTOR_SIZE 40000
+#define NB_BIG_OBJS (2 * BIG_VECTOR_SIZE)
+#define MAX_ITERATIONS 1024
+
+static int evdev = -1;
+static bool evdev_created;
+static uint32_t service_id;
+static struct rte_mempool *mbuf_pool;
+static struct rte_mempool *vector_pool;
+static struct rte_mempool *big_vector_pool;
+static rte_graph_t graph_id = RTE_GRAPH_ID_INVALID;
+static struct rte_graph *test_graph;
+
+/* Objects received by the sink node */
+static void **sink_objs;
+static uint32_t sink_count;
+static uint32_t sink_calls;
+static bool sink_forward;
+
+static uint16_t
+test_eventdev_sink_process(struct rte_graph *graph, struct rte_node *node,
+			   void **objs, uint16_t nb_objs)
+{
+	if (sink_count + nb_objs <= NB_BIG_OBJS)
+		memcpy(&sink_objs[sink_count], objs, nb_objs * sizeof(void *));
+	sink_count += nb_objs;
+	sink_calls++;
+
+	/* Send the objects back to the event device through eventdev_tx */
+	if (sink_forward)
+		rte_node_enqueue(graph, node, 0, objs, nb_objs);
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_eventdev_sink_node = {
+	.name = SINK_NODE_NAME,
+	.process = test_eventdev_sink_process,
+};
+
+RTE_NODE_REGISTER(test_eventdev_sink_node);
+
+/* Run the event scheduler and the graph until n objects reach the sink */
+static int
+test_node_eventdev_run(uint32_t n)
+{
+	unsigned int i;
+
+	for (i = 0; i < MAX_ITERATIONS && sink_count < n; i++) {
+		rte_service_run_iter_on_app_lcore(service_id, 1);
+		rte_graph_walk(test_graph);
+	}
+
+	return sink_count == n ? 0 : -1;
+}
+
+static void
+test_node_eventdev_sink_reset(bool forward)
+{
+	sink_count = 0;
+	sink_calls = 0;
+	sink_forward = forward;
+}
+
+static int
+test_node_eventdev_rx_tx(void)
+{
+	struct rte_mbuf *mbufs[NB_OBJS];
+	struct rte_event ev[NB_OBJS];
+	uint16_t sent = 0;
+	unsigned int i;
+
+	TEST_ASSERT_SUCCESS(rte_pktmbuf_alloc_bulk(mbuf_pool, mbufs, NB_OBJS),
+			    "Cannot allocate mbufs");
+
+	memset(ev, 0, sizeof(ev));
+	for (i = 0; i < NB_OBJS; i++) {
+		/* A single atomic flow keeps the objects in order */
+		mbufs[i]->hash.rss = 0;
+		ev[i].op = RTE_EVENT_OP_NEW;
+		ev[i].queue_id = 0;
+		ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev[i].event_type = RTE_EVENT_TYPE_CPU;
+		ev[i].mbuf = mbufs[i];
+	}
+	for (i = 0; i < MAX_ITERATIONS && sent < NB_OBJS; i++)
+		sent += rte_event_enqueue_new_burst(evdev, 0, &ev[sent],
+						    NB_OBJS - sent);
+	TEST_ASSERT_EQUAL(sent, NB_OBJS, "Only %u events enqueued", sent);
+
+	/* Single events are moved to the sink, which sends them to Tx */
+	test_node_eventdev_sink_reset(true);
+	TEST_ASSERT_SUCCESS(test_node_eventdev_run(NB_OBJS),
+			    "Only %u objects received from single events",
+			    sink_count);
+	for (i = 0; i < NB_OBJS; i++)
+		TEST_ASSERT(sink_objs[i] == mbufs[i],
+			    "Object %u received out of order", i);
+
+	/* Tx packed them in event vectors, which Rx unpacks */
+	test_node_eventdev_sink_reset(false);
+	TEST_ASSERT_SUCCESS(test_node_eventdev_run(NB_OBJS),
+			    "Only %u objects received from event vectors",
+			    sink_count);
+	for (i = 0; i < NB_OBJS; i++)
+		TEST_ASSERT(sink_objs[i] == mbufs[i],
+			    "Object %u received out of order", i);
+	TEST_ASSERT(rte_mempool_full(vector_pool),
+		    "Event vectors not freed by Rx node");
+
+	rte_pktmbuf_free_bulk(mbufs, NB_OBJS);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_node_eventdev_rx_stream_limit(void)
+{
+	struct rte_event_vector *vecs[2];
+	struct rte_event ev[2];
+	unsigned int i, j;
+
+	TEST_ASSERT_SUCCESS(rte_mempool_get_bulk(big_vector_pool,
+						 (void **)vecs, 2),
+			    "Cannot allocate event vectors");
+
+	/* The vectors carry dummy objects, which are not sent to Tx */
+	memset(ev, 0, sizeof(ev));
+	for (i = 0; i < 2; i++) {
+		vecs[i]->nb_elem = BIG_VECTOR_SIZE;
+		vecs[i]->elem_offset = 0;
+		vecs[i]->attr_valid = 0;
+		for (j = 0; j < BIG_VECTOR_SIZE; j++)
+			vecs[i]->ptrs[j] =
+				(void *)(uintptr_t)(i * BIG_VECTOR_SIZE + j + 1);
+		ev[i].op = RTE_EVENT_OP_NEW;
+		ev[i].queue_id = 0;
+		ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev[i].event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+		ev[i].vec = vecs[i];
+	}
+	TEST_ASSERT_EQUAL(rte_event_enqueue_new_burst(evdev, 0, ev, 2), 2,
+			  "Cannot enqueue event vectors");
+
+	/* The second vector does not fit in the stream with the first one,
+	 * Rx has to keep it for its next call.
+	 */
+	test_node_eventdev_sink_reset(false);
+	TEST_ASSERT_SUCCESS(test_node_eventdev_run(NB_BIG_OBJS),
+			    "Only %u objects received", sink_count);
+	TEST_ASSERT_EQUAL(sink_calls, 2, "Objects received in %u bursts",
+			  sink_calls);
+	for (i = 0; i < NB_BIG_OBJS; i++)
+		TEST_ASSERT(sink_objs[i] == (void *)(uintptr_t)(i + 1),
+			    "Object %u received out of order", i);
+	TEST_ASSERT(rte_mempool_full(big_vector_pool),
+		    "Event vectors not freed by Rx node");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_node_eventdev_setup(void)
+{
+	struct rte_event_dev_config config = {
+		.nb_event_queues = 1,
+		.nb_event_ports = 1,
+		.nb_event_queue_flows = 1024,
+		.nb_events_limit = 4096,
+		.nb_event_port_dequeue_depth = 32,
+		.nb_event_port_enqueue_depth = 64,
+	};
+	struct rte_node_eventdev_config node_conf;
+	char rx_name[RTE_NODE_NAMESIZE];
+	char tx_name[RTE_NODE_NAMESIZE];
+	const char *patterns[4];
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = RTE_DIM(patterns),
+		.node_patterns = patterns,
+	};
+	const char *edge;
+
+	evdev = rte_event_dev_get_dev_id(EVENTDEV_NAME);
+	if (evdev < 0) {
+		if (rte_vdev_init(EVENTDEV_NAME, NULL) < 0) {
+			printf("Cannot create %s, skipping\n", EVENTDEV_NAME);
+			return TEST_SKIPPED;
+		}
+		evdev_created = true;
+		evdev = rte_event_dev_get_dev_id(EVENTDEV_NAME);
+		TEST_ASSERT(evdev >= 0, "Cannot find %s", EVENTDEV_NAME);
+	}
+
+	TEST_ASSERT_SUCCESS(rte_event_dev_configure(evdev, &config),
+			    "Cannot configure event device");
+	TEST_ASSERT_SUCCESS(rte_event_queue_setup(evdev, 0, NULL),
+			    "Cannot setup event queue");
+	TEST_ASSERT_SUCCESS(rte_event_port_setup(evdev, 0, NULL),
+			    "Cannot setup event port");
+	TEST_ASSERT_EQUAL(rte_event_port_link(evdev, 0, NULL, NULL, 0), 1,
+			  "Cannot link event port");
+	TEST_ASSERT_SUCCESS(rte_event_dev_service_id_get(evdev, &service_id),
+			    "Cannot get event device service");
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+	TEST_ASSERT_SUCCESS(rte_event_dev_start(evdev),
+			    "Cannot start event device");
+
+	mbuf_pool = rte_pktmbuf_pool_create("test_node_evdev_mbuf", NB_MBUFS,
+					    0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+					    SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(mbuf_pool, "Cannot create mbuf pool");
+	vector_pool = rte_event_vector_pool_create("test_node_evdev_vec",
+						   NB_OBJS, 0, VECTOR_SIZE,
+						   SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(vector_pool, "Cannot create event vector pool");
+	big_vector_pool = rte_event_vector_pool_create("test_node_evdev_bvec",
+						       2, 0, BIG_VECTOR_SIZE,
+						       SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(big_vector_pool,
+			     "Cannot create event vector pool");
+	sink_objs = rte_zmalloc(NULL, NB_BIG_OBJS * sizeof(void *), 0);
+	TEST_ASSERT_NOT_NULL(sink_objs, "Cannot allocate sink objects");
+
+	memset(&node_conf, 0, sizeof(node_conf));
+	node_conf.dev_id = evdev;
+	node_conf.port_id = 0;
+	node_conf.queue_id = 0;
+	node_conf.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	node_conf.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	node_conf.vector_pool = vector_pool;
+	TEST_ASSERT_SUCCESS(rte_node_eventdev_config(&node_conf, 1),
+			    "Cannot configure eventdev nodes");
+
+	/* eventdev_rx -> sink -> eventdev_tx -> pkt_drop */
+	snprintf(rx_name, sizeof(rx_name), "eventdev_rx-%d-0", evdev);
+	snprintf(tx_name, sizeof(tx_name), "eventdev_tx-%d-0", evdev);
+	edge = SINK_NODE_NAME;
+	TEST_ASSERT_EQUAL(rte_node_edge_update(rte_node_from_name(rx_name), 0,
+					       &edge, 1), 1,
+			  "Cannot update %s edge", rx_name);
+	edge = tx_name;
+	TEST_ASSERT_EQUAL(rte_node_edge_update(
+				rte_node_from_name(SINK_NODE_NAME),
+				RTE_EDGE_ID_INVALID, &edge, 1), 1,
+			  "Cannot update %s edge", SINK_NODE_NAME);
+
+	patterns[0] = rx_name;
+	patterns[1] = SINK_NODE_NAME;
+	patterns[2] = tx_name;
+	patterns[3] = "pkt_drop";
+	graph_id = rte_graph_create(GRAPH_NAME, &gconf);
+	TEST_ASSERT(graph_id != RTE_GRAPH_ID_INVALID,
+		    "Cannot create graph, error = %d", rte_errno);
+	test_graph = rte_graph_lookup(GRAPH_NAME);
+	TEST_ASSERT_NOT_NULL(test_graph, "Cannot lookup graph");
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_node_eventdev_teardown(void)
+{
+	if (graph_id != RTE_GRAPH_ID_INVALID)
+		rte_graph_destroy(graph_id);
+	graph_id = RTE_GRAPH_ID_INVALID;
+
+	if (evdev >= 0) {
+		rte_event_dev_stop(evdev);
+		rte_event_dev_close(evdev);
+		if (evdev_created)
+			rte_vdev_uninit(EVENTDEV_NAME);
+	}
+	evdev = -1;
+	evdev_created = false;
+
+	rte_free(sink_objs);
+	sink_objs = NULL;
+	rte_mempool_free(big_vector_pool);
+	big_vector_pool = NULL;
+	rte_mempool_free(vector_pool);
+	vector_pool = NULL;
+	rte_mempool_free(mbuf_pool);
+	mbuf_pool = NULL;
+}
+
+static struct unit_test_suite node_eventdev_testsuite = {
+	.suite_name = "Node eventdev Rx and Tx test suite",
+	.setup = test_node_eventdev_setup,
+	.teardown = test_node_eventdev_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_node_eventdev_rx_tx),
+		TEST_CASE(test_node_eventdev_rx_stream_limit),
+		TEST_CASES_END(), /**< NULL terminate unit test array */
+	},
+};
+
+static int
+test_node_eventdev(void)
+{
+	return unit_test_suite_runner(&node_eventdev_testsuite);
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_TEST_COMMAND(node_eventdev_autotest, test_node_eventdev);
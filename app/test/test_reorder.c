@@ -11,6 +11,7 @@
 #include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_mbuf.h>
+#include <rte_pause.h>
 #include <rte_reorder.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
@@ -485,6 +486,197 @@ test_reorder_set_seqn(void)
 	return ret;
 }
 
+static int
+test_reorder_insert_mp(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 4;
+	const unsigned int num_bufs = 8;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+	int ret = 0;
+
+	b = rte_reorder_create_mp("test_insert_mp", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+	TEST_ASSERT((rte_reorder_create("test_insert_mp", rte_socket_id(),
+			size) == NULL) && (rte_errno == EEXIST),
+			"No error on create() of a multi-producer buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = i;
+	}
+
+	/* insert 1, 0, 3: drain stops at the gap of 2 */
+	if (rte_reorder_insert(b, bufs[1]) != 0 ||
+			rte_reorder_insert(b, bufs[0]) != 0 ||
+			rte_reorder_insert(b, bufs[3]) != 0) {
+		printf("%s:%d: Error inserting packets in window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	robufs[0] = bufs[0];
+	robufs[1] = bufs[1];
+	robufs[3] = bufs[3];
+	bufs[0] = bufs[1] = bufs[3] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 2 || *rte_reorder_seqn(robufs[0]) != 0 ||
+			*rte_reorder_seqn(robufs[1]) != 1) {
+		printf("%s:%d: Unexpected drain of %u packets\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	rte_pktmbuf_free_bulk(robufs, cnt);
+
+	/* early packet: the window is not moved */
+	if (rte_reorder_insert(b, bufs[6]) != -1 || rte_errno != ENOSPC) {
+		printf("%s:%d: No error inserting early packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* skip the gap of 2 */
+	cnt = rte_reorder_drain_up_to_seqn(b, robufs, num_bufs, 4);
+	if (cnt != 1 || *rte_reorder_seqn(robufs[0]) != 3) {
+		printf("%s:%d: Unexpected drain of %u packets\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	rte_pktmbuf_free(robufs[0]);
+
+	/* late packet */
+	if (rte_reorder_insert(b, bufs[2]) != -1 || rte_errno != ERANGE) {
+		printf("%s:%d: No error inserting late packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* the window moved, so the early packet now fits */
+	if (rte_reorder_insert(b, bufs[6]) != 0) {
+		printf("%s:%d: Error inserting packet in moved window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	bufs[6] = NULL;
+
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++)
+		rte_pktmbuf_free(bufs[i]);
+
+	return ret;
+}
+
+#define MP_NUM_PKTS (1 << 18)
+#define MP_BUFFER_SIZE 1024
+
+static struct rte_reorder_buffer *mp_buffer;
+static unsigned int mp_nb_producers;
+static uint32_t mp_producers_done;
+static uint32_t mp_producer_failed;
+
+static int
+reorder_mp_producer(void *arg)
+{
+	const unsigned int id = (uintptr_t)arg;
+	struct rte_mbuf *m;
+	uint32_t seqn;
+	int ret = 0;
+
+	for (seqn = id; seqn < MP_NUM_PKTS; seqn += mp_nb_producers) {
+		do
+			m = rte_pktmbuf_alloc(test_params->p);
+		while (m == NULL);
+		*rte_reorder_seqn(m) = seqn;
+
+		while (rte_reorder_insert(mp_buffer, m) != 0) {
+			if (rte_errno != ENOSPC) {
+				__atomic_store_n(&mp_producer_failed, 1,
+						__ATOMIC_RELAXED);
+				rte_pktmbuf_free(m);
+				ret = -1;
+				goto exit;
+			}
+			rte_pause();
+		}
+	}
+
+exit:
+	__atomic_fetch_add(&mp_producers_done, 1, __ATOMIC_RELEASE);
+	return ret;
+}
+
+static int
+test_reorder_mp_concurrent(void)
+{
+	struct rte_mbuf *robufs[BURST];
+	unsigned int lcore_id, i, cnt;
+	uint32_t seqn, expected = 0;
+	int done, ret = 0;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for the multi-producer test\n");
+		return TEST_SKIPPED;
+	}
+
+	mp_buffer = rte_reorder_create_mp("test_mp", rte_socket_id(),
+			MP_BUFFER_SIZE);
+	TEST_ASSERT_NOT_NULL(mp_buffer, "Failed to create reorder buffer");
+	mp_nb_producers = rte_lcore_count() - 1;
+	mp_producers_done = 0;
+	mp_producer_failed = 0;
+
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(reorder_mp_producer,
+				(void *)(uintptr_t)i++, lcore_id);
+
+	/* drain until all the producers are done and the buffer is empty */
+	do {
+		done = __atomic_load_n(&mp_producers_done, __ATOMIC_ACQUIRE) ==
+				mp_nb_producers;
+		/* skip the packets of a failed producer, so others don't block */
+		if (__atomic_load_n(&mp_producer_failed, __ATOMIC_RELAXED))
+			cnt = rte_reorder_drain_up_to_seqn(mp_buffer, robufs,
+					RTE_DIM(robufs), MP_NUM_PKTS);
+		else
+			cnt = rte_reorder_drain(mp_buffer, robufs,
+					RTE_DIM(robufs));
+		for (i = 0; i < cnt; i++) {
+			seqn = *rte_reorder_seqn(robufs[i]);
+			if (seqn != expected)
+				ret = -1;
+			expected = seqn + 1;
+		}
+		rte_pktmbuf_free_bulk(robufs, cnt);
+	} while (cnt != 0 || !done);
+
+	rte_eal_mp_wait_lcore();
+	rte_reorder_free(mp_buffer);
+	mp_buffer = NULL;
+
+	if (mp_producer_failed) {
+		printf("%s: Error inserting packet\n", __func__);
+		return -1;
+	}
+	if (ret != 0 || expected != MP_NUM_PKTS) {
+		printf("%s: Packets drained out of order\n", __func__);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_setup(void)
 {
@@ -537,6 +729,8 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_drain),
 		TEST_CASE(test_reorder_drain_up_to_seqn),
 		TEST_CASE(test_reorder_set_seqn),
+		TEST_CASE(test_reorder_insert_mp),
+		TEST_CASE(test_reorder_mp_concurrent),
 		TEST_CASES_END()
 	}
 };
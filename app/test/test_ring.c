@@ -1190,6 +1190,127 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+/*
+ * Test the staging of objects in MP chunk mode.
+ */
+static int
+test_ring_mp_chunk(void)
+{
+	struct rte_ring *r = NULL;
+	void **src = NULL, **cur_src = NULL, **dst = NULL, **cur_dst = NULL;
+	unsigned int i, j, chunk, count;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(esize); i++) {
+		test_ring_print_test_string("Test MP chunk ring",
+				TEST_RING_IGNORE_API_TYPE,
+				esize[i]);
+
+		r = test_ring_create("test_ring_mp_chunk", esize[i], RING_SIZE,
+				SOCKET_ID_ANY, RING_F_MP_CHUNK_ENQ);
+		if (r == NULL) {
+			printf("%s: failed to create ring\n", __func__);
+			goto fail_test;
+		}
+		chunk = r->chunk_prod.chunk_size;
+		TEST_RING_VERIFY(chunk == RTE_RING_CHUNK_SIZE, r,
+				goto fail_test);
+
+		src = test_ring_calloc(RING_SIZE, esize[i]);
+		if (src == NULL) {
+			printf("%s: failed to alloc src memory\n", __func__);
+			goto fail_test;
+		}
+		test_ring_mem_init(src, RING_SIZE, esize[i]);
+		cur_src = src;
+
+		dst = test_ring_calloc(RING_SIZE, esize[i]);
+		if (dst == NULL) {
+			printf("%s: failed to alloc dst memory\n", __func__);
+			goto fail_test;
+		}
+		cur_dst = dst;
+
+		/* objects are staged until the chunk is full */
+		for (j = 0; j < chunk - 1; j++) {
+			ret = test_ring_enqueue(r, cur_src, esize[i], 1,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_SINGLE);
+			TEST_RING_VERIFY(ret == 0, r, goto fail_test);
+			cur_src = test_ring_inc_ptr(cur_src, esize[i], 1);
+		}
+		TEST_RING_VERIFY(rte_ring_count(r) == 0, r, goto fail_test);
+
+		ret = test_ring_enqueue(r, cur_src, esize[i], 1,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_SINGLE);
+		TEST_RING_VERIFY(ret == 0, r, goto fail_test);
+		cur_src = test_ring_inc_ptr(cur_src, esize[i], 1);
+		TEST_RING_VERIFY(rte_ring_count(r) == chunk, r, goto fail_test);
+		count = chunk;
+
+		/* flush publishes a partial chunk */
+		ret = test_ring_enqueue(r, cur_src, esize[i], 3,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		TEST_RING_VERIFY(ret == 3, r, goto fail_test);
+		cur_src = test_ring_inc_ptr(cur_src, esize[i], 3);
+		TEST_RING_VERIFY(rte_ring_count(r) == count, r, goto fail_test);
+
+		TEST_RING_VERIFY(test_ring_chunk_flush(r, esize[i]) == 0, r,
+				goto fail_test);
+		count += 3;
+		TEST_RING_VERIFY(rte_ring_count(r) == count, r, goto fail_test);
+		TEST_RING_VERIFY(test_ring_chunk_flush(r, esize[i]) == 0, r,
+				goto fail_test);
+
+		/* a bulk bigger than the chunk goes after the staged ones */
+		ret = test_ring_enqueue(r, cur_src, esize[i], 5,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+		TEST_RING_VERIFY(ret == 5, r, goto fail_test);
+		cur_src = test_ring_inc_ptr(cur_src, esize[i], 5);
+
+		ret = test_ring_enqueue(r, cur_src, esize[i], MAX_BULK * 2,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		TEST_RING_VERIFY(ret == MAX_BULK * 2, r, goto fail_test);
+		cur_src = test_ring_inc_ptr(cur_src, esize[i], MAX_BULK * 2);
+		count += 5 + MAX_BULK * 2;
+		TEST_RING_VERIFY(rte_ring_count(r) == count, r, goto fail_test);
+
+		/* check that the objects are dequeued in order */
+		ret = test_ring_dequeue(r, cur_dst, esize[i], count,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+		TEST_RING_VERIFY(ret == (int)count, r, goto fail_test);
+		cur_dst = test_ring_inc_ptr(cur_dst, esize[i], count);
+		TEST_RING_VERIFY(rte_ring_empty(r) == 1, r, goto fail_test);
+
+		TEST_RING_VERIFY(test_ring_mem_cmp(src, dst,
+					RTE_PTR_DIFF(cur_dst, dst)) == 0,
+					r, goto fail_test);
+
+		/* staged objects are dropped by a reset */
+		ret = test_ring_enqueue(r, cur_src, esize[i], 1,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_SINGLE);
+		TEST_RING_VERIFY(ret == 0, r, goto fail_test);
+		rte_ring_reset(r);
+		TEST_RING_VERIFY(test_ring_chunk_flush(r, esize[i]) == 0, r,
+				goto fail_test);
+		TEST_RING_VERIFY(rte_ring_empty(r) == 1, r, goto fail_test);
+
+		rte_ring_free(r);
+		rte_free(src);
+		rte_free(dst);
+		r = NULL;
+		src = NULL;
+		dst = NULL;
+	}
+
+	return 0;
+
+fail_test:
+	rte_ring_free(r);
+	rte_free(src);
+	rte_free(dst);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1207,6 +1328,9 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_mp_chunk() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
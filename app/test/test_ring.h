@@ -240,3 +240,14 @@ test_ring_calloc(unsigned int rsize, int esize)
 
 	return p;
 }
+
+/* Flush the objects staged by the calling lcore in MP chunk mode */
+static inline unsigned int
+test_ring_chunk_flush(struct rte_ring *r, int esize)
+{
+	/* Legacy queue APIs? */
+	if (esize == -1)
+		return rte_ring_chunk_flush(r);
+	else
+		return rte_ring_chunk_flush_elem(r, esize);
+}
@@ -420,6 +420,192 @@ run_on_all_cores(struct rte_ring *r, const int esize)
 	return 0;
 }
 
+/* producer sync modes compared with many producers and one consumer */
+static const struct {
+	const char *name;
+	unsigned int flags;
+} mp_sc_modes[] = {
+	{ "MP", 0 },
+	{ "MP_RTS", RING_F_MP_RTS_ENQ },
+	{ "MP_HTS", RING_F_MP_HTS_ENQ },
+	{ "MP_CHUNK", RING_F_MP_CHUNK_ENQ },
+};
+
+/* small enqueues, where the producer head contention matters most */
+static const volatile unsigned int mp_sc_bulk_sizes[] = { 1, 8 };
+
+static uint32_t producers_done;
+
+static int
+mp_sc_producer_fn_helper(struct thread_params *p, const int esize)
+{
+	uint64_t time_diff = 0;
+	uint64_t begin = 0;
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t lcount = 0;
+	const unsigned int lcore = rte_lcore_id();
+	struct thread_params *params = p;
+	void *burst = NULL;
+
+	burst = test_ring_calloc(MAX_BURST, esize);
+	if (burst == NULL) {
+		__atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+		return -1;
+	}
+
+	rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+
+	begin = rte_get_timer_cycles();
+	while (time_diff < hz * TIME_MS / 1000) {
+		lcount += test_ring_enqueue(params->r, burst, esize,
+				params->size,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		time_diff = rte_get_timer_cycles() - begin;
+	}
+
+	/* publish what is still staged in MP chunk mode */
+	while (test_ring_chunk_flush(params->r, esize) != 0)
+		rte_pause();
+
+	queue_count[lcore] = lcount;
+	__atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+
+	rte_free(burst);
+
+	return 0;
+}
+
+static int
+mp_sc_producer_fn(void *p)
+{
+	struct thread_params *params = p;
+
+	return mp_sc_producer_fn_helper(params, -1);
+}
+
+static int
+mp_sc_producer_fn_16B(void *p)
+{
+	struct thread_params *params = p;
+
+	return mp_sc_producer_fn_helper(params, 16);
+}
+
+/*
+ * Run nb_prod producers on worker cores, and the consumer on the main core
+ * until all producers are done and the ring is empty.
+ */
+static int
+run_mp_sc(struct rte_ring *r, const int esize, unsigned int nb_prod,
+	unsigned int size, const char *name)
+{
+	struct thread_params param;
+	lcore_function_t *lcore_f;
+	uint64_t enqueued = 0, dequeued = 0;
+	uint64_t begin, end;
+	unsigned int c, n, launched = 0;
+	uint32_t done;
+	void *burst;
+	int ret = 0;
+
+	if (esize == -1)
+		lcore_f = mp_sc_producer_fn;
+	else
+		lcore_f = mp_sc_producer_fn_16B;
+
+	burst = test_ring_calloc(MAX_BURST, esize);
+	if (burst == NULL)
+		return -1;
+
+	memset(&param, 0, sizeof(struct thread_params));
+	param.r = r;
+	param.size = size;
+	memset(queue_count, 0, sizeof(queue_count));
+
+	/* clear synchro and start producers */
+	__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&producers_done, 0, __ATOMIC_RELAXED);
+	RTE_LCORE_FOREACH_WORKER(c) {
+		if (launched == nb_prod)
+			break;
+		if (rte_eal_remote_launch(lcore_f, &param, c) < 0)
+			break;
+		launched++;
+	}
+
+	begin = rte_get_timer_cycles();
+	__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+
+	do {
+		/* producers are done before the last empty dequeue */
+		done = __atomic_load_n(&producers_done, __ATOMIC_ACQUIRE);
+		n = test_ring_dequeue(r, burst, esize, MAX_BURST,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+		dequeued += n;
+	} while (n != 0 || done != launched);
+	end = rte_get_timer_cycles();
+
+	if (launched != nb_prod)
+		ret = -1;
+
+	RTE_LCORE_FOREACH_WORKER(c) {
+		if (rte_eal_wait_lcore(c) < 0)
+			ret = -1;
+		enqueued += queue_count[c];
+	}
+
+	if (enqueued != dequeued) {
+		printf("%s: enqueued %"PRIu64" objects, dequeued %"PRIu64"\n",
+				name, enqueued, dequeued);
+		ret = -1;
+	}
+
+	if (ret == 0 && dequeued != 0)
+		printf("%s: %u producers, bulk (size: %u): %.2F cycles per object\n",
+				name, nb_prod, size,
+				(double)(end - begin) / dequeued);
+
+	rte_free(burst);
+
+	return ret;
+}
+
+static int
+test_mp_sc_enqueue(const int esize)
+{
+	struct rte_ring *r;
+	unsigned int i, j, nb_prod;
+	const unsigned int nb_workers = rte_lcore_count() - 1;
+
+	if (nb_workers == 0) {
+		printf("Skipping, at least 2 lcores are needed\n");
+		return 0;
+	}
+
+	for (i = 0; i < RTE_DIM(mp_sc_modes); i++) {
+		r = test_ring_create(RING_NAME "_MP_SC", esize, RING_SIZE,
+				rte_socket_id(),
+				mp_sc_modes[i].flags | RING_F_SC_DEQ);
+		if (r == NULL)
+			return -1;
+
+		for (j = 0; j < RTE_DIM(mp_sc_bulk_sizes); j++) {
+			for (nb_prod = 1; nb_prod <= nb_workers; nb_prod <<= 1) {
+				if (run_mp_sc(r, esize, nb_prod,
+						mp_sc_bulk_sizes[j],
+						mp_sc_modes[i].name) < 0) {
+					rte_ring_free(r);
+					return -1;
+				}
+			}
+		}
+
+		rte_ring_free(r);
+	}
+
+	return 0;
+}
+
 /*
  * Test function that determines how long an enqueue + dequeue of a single item
  * takes on a single lcore. Result is for comparison with the bulk enq+deq.
@@ -556,6 +742,10 @@ test_ring_perf_esize(const int esize)
 	if (run_on_all_cores(r, esize) < 0)
 		goto test_fail;
 
+	printf("\n### Testing many producers and one consumer ###\n");
+	if (test_mp_sc_enqueue(esize) < 0)
+		goto test_fail;
+
 	rte_ring_free(r);
 
 	return 0;
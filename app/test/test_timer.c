@@ -83,6 +83,31 @@
  *      - At initialization, timer3 is loaded by the main core, on
  *        another core in "periodical" mode (time = 1 second).
  *      - It is stopped at t=25s by timer2.
+ *
+ * #. Timer wheel test.
+ *
+ *    This test checks the timer wheel backend on the main core.
+ *
+ *    - Timers are loaded with random delays, covering all levels of the
+ *      wheel, and some of them further than the range of the wheel.
+ *    - Some of the timers are then stopped or reloaded.
+ *    - rte_timer_alt_manage() is called until all timers expired, and we
+ *      check that each timer that was not stopped ran exactly once, and
+ *      not before its expiry time.
+ *    - Then all timers are loaded again in a wheel with the default
+ *      resolution, and once they all expired, we check that a single call
+ *      to rte_timer_alt_manage() runs them all.
+ *
+ * #. Timer burst test.
+ *
+ *    This test checks rte_timer_alt_manage_burst() with both backends.
+ *
+ *    - One-shot timers and a periodic timer are loaded, and once they all
+ *      expired, the expired timers are retrieved by bursts. We check that
+ *      each one-shot timer is returned exactly once and stopped, and that
+ *      the periodic timer is re-armed.
+ *    - Then a short burst leaves expired timers behind, and we check that
+ *      rte_timer_stop_all() stops them.
  */
 
 #include <stdio.h>
@@ -90,6 +115,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <inttypes.h>
 #include <sys/queue.h>
 #include <math.h>
@@ -595,3 +621,334 @@ test_timer(void)
 }
 
 REGISTER_TEST_COMMAND(timer_autotest, test_timer);
+
+#define WHEEL_NB_TIMER 4096
+/* range of the wheel with a resolution of 1 cycle */
+#define WHEEL_RANGE (UINT64_C(1) << 32)
+
+struct wheel_timer {
+	struct rte_timer tim;
+	uint64_t expire; /* earliest time to run */
+	unsigned int count;
+	bool stopped;
+};
+
+static struct wheel_timer *wheel_timers;
+static unsigned int wheel_expired;
+static unsigned int wheel_periodic;
+
+static void
+timer_wheel_cb(struct rte_timer *tim)
+{
+	struct wheel_timer *wt = container_of(tim, struct wheel_timer, tim);
+	uint64_t cur_time = rte_get_timer_cycles();
+
+	if (tim->period != 0) {
+		wheel_periodic++;
+		return;
+	}
+
+	if (cur_time < tim->expire || tim->expire < wt->expire) {
+		printf("Timer %td run at %" PRIu64 ", expiring at %" PRIu64
+			"\n", wt - wheel_timers, cur_time, wt->expire);
+		test_failed = 1;
+	}
+
+	wt->count++;
+	wheel_expired++;
+}
+
+static uint64_t
+timer_wheel_ticks(unsigned int i, uint64_t hz)
+{
+	/* some timers further than the range of the wheel */
+	if (i % 64 == 0)
+		return WHEEL_RANGE + rte_rand_max(hz / 8);
+	return rte_rand_max(hz / 4);
+}
+
+static int
+test_timer_wheel(void)
+{
+	struct rte_timer_data_conf conf = {
+		.backend = RTE_TIMER_BACKEND_WHEEL,
+		.wheel_resolution = 1,
+	};
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t ticks, cur_time, max_expire;
+	unsigned int i, nb_running;
+	struct rte_timer periodic;
+	uint32_t id;
+	int ret;
+
+	/* invalid parameters */
+	ret = rte_timer_data_alloc_ext(&id, NULL);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "NULL configuration accepted");
+	conf.backend = RTE_TIMER_BACKEND_WHEEL + 1;
+	ret = rte_timer_data_alloc_ext(&id, &conf);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "invalid backend accepted");
+
+	/* skiplist, the same as rte_timer_data_alloc() */
+	conf.backend = RTE_TIMER_BACKEND_SKIPLIST;
+	ret = rte_timer_data_alloc_ext(&id, &conf);
+	TEST_ASSERT_SUCCESS(ret, "cannot allocate timer data");
+	rte_timer_data_dealloc(id);
+
+	conf.backend = RTE_TIMER_BACKEND_WHEEL;
+	ret = rte_timer_data_alloc_ext(&id, &conf);
+	TEST_ASSERT_SUCCESS(ret, "cannot allocate timer wheel");
+
+	wheel_timers = rte_zmalloc(NULL,
+			sizeof(*wheel_timers) * WHEEL_NB_TIMER, 0);
+	if (wheel_timers == NULL) {
+		rte_timer_data_dealloc(id);
+		printf("Cannot allocate timers\n");
+		return TEST_FAILED;
+	}
+
+	test_failed = 0;
+	wheel_expired = 0;
+	wheel_periodic = 0;
+	max_expire = 0;
+
+	rte_timer_init(&periodic);
+	rte_timer_alt_reset(id, &periodic, hz / 65536, PERIODICAL, lcore_id,
+			NULL, NULL);
+
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		rte_timer_init(&wheel_timers[i].tim);
+		ticks = timer_wheel_ticks(i, hz);
+		wheel_timers[i].expire = rte_get_timer_cycles() + ticks;
+		rte_timer_alt_reset(id, &wheel_timers[i].tim, ticks, SINGLE,
+				lcore_id, NULL, NULL);
+	}
+
+	/* stop or reload some pending timers */
+	nb_running = 0;
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		if (i % 5 == 1) {
+			rte_timer_alt_stop(id, &wheel_timers[i].tim);
+			wheel_timers[i].stopped = true;
+			continue;
+		}
+		if (i % 7 == 2) {
+			ticks = timer_wheel_ticks(rte_rand(), hz);
+			wheel_timers[i].expire = rte_get_timer_cycles() + ticks;
+			rte_timer_alt_reset(id, &wheel_timers[i].tim, ticks,
+					SINGLE, lcore_id, NULL, NULL);
+		}
+		max_expire = RTE_MAX(max_expire, wheel_timers[i].expire);
+		nb_running++;
+	}
+
+	cur_time = rte_get_timer_cycles();
+	while (wheel_expired < nb_running && cur_time < max_expire + hz) {
+		rte_timer_alt_manage(id, NULL, 0, timer_wheel_cb);
+		rte_delay_us(10);
+		cur_time = rte_get_timer_cycles();
+	}
+
+	rte_timer_alt_stop(id, &periodic);
+
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		if (wheel_timers[i].count != !wheel_timers[i].stopped) {
+			printf("Timer %u ran %u times\n", i,
+				wheel_timers[i].count);
+			test_failed = 1;
+		}
+	}
+
+	if (wheel_periodic == 0) {
+		printf("Periodic timer did not run\n");
+		test_failed = 1;
+	}
+
+	rte_timer_data_dealloc(id);
+
+	/* all expired timers must run at once, even after a while */
+	conf.wheel_resolution = 0;
+	ret = rte_timer_data_alloc_ext(&id, &conf);
+	if (ret != 0) {
+		rte_free(wheel_timers);
+		printf("Cannot allocate timer wheel\n");
+		return TEST_FAILED;
+	}
+
+	wheel_expired = 0;
+	max_expire = 0;
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		/* close timers, in the first three levels of the wheel */
+		ticks = rte_rand_max(hz / 10);
+		wheel_timers[i].expire = rte_get_timer_cycles() + ticks;
+		rte_timer_alt_reset(id, &wheel_timers[i].tim, ticks, SINGLE,
+				lcore_id, NULL, NULL);
+		max_expire = RTE_MAX(max_expire, wheel_timers[i].expire);
+	}
+
+	/* expiry is rounded up to the resolution */
+	while (rte_get_timer_cycles() <= max_expire + hz / MS_PER_S)
+		rte_pause();
+
+	rte_timer_alt_manage(id, NULL, 0, timer_wheel_cb);
+	if (wheel_expired != WHEEL_NB_TIMER) {
+		printf("%u timers out of %u expired\n", wheel_expired,
+			WHEEL_NB_TIMER);
+		test_failed = 1;
+	}
+
+	rte_free(wheel_timers);
+	wheel_timers = NULL;
+	rte_timer_data_dealloc(id);
+
+	return test_failed ? TEST_FAILED : TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(timer_wheel_autotest, test_timer_wheel);
+
+#define BURST_NB_TIMER 1024
+#define BURST_SIZE 32
+#define BURST_NB_LEFTOVER 64
+
+static unsigned int burst_stopped;
+
+static void
+timer_burst_stop_cb(struct rte_timer *tim __rte_unused,
+		void *arg __rte_unused)
+{
+	burst_stopped++;
+}
+
+static int
+timer_burst_backend(const struct rte_timer_data_conf *conf,
+		struct wheel_timer *timers)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	struct rte_timer *burst[BURST_SIZE];
+	struct rte_timer periodic;
+	unsigned int i, nb_expired, nb_periodic;
+	uint64_t ticks, max_expire;
+	struct wheel_timer *wt;
+	uint32_t id;
+	int ret, n;
+
+	ret = rte_timer_data_alloc_ext(&id, conf);
+	TEST_ASSERT_SUCCESS(ret, "cannot allocate timer data");
+
+	ret = rte_timer_alt_manage_burst(id, NULL, BURST_SIZE);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "NULL array accepted");
+
+	memset(timers, 0, sizeof(*timers) * BURST_NB_TIMER);
+	max_expire = 0;
+
+	/* periodic timer without callback, the caller processes it */
+	rte_timer_init(&periodic);
+	rte_timer_alt_reset(id, &periodic, hz / 1000, PERIODICAL, lcore_id,
+			NULL, NULL);
+
+	for (i = 0; i < BURST_NB_TIMER; i++) {
+		rte_timer_init(&timers[i].tim);
+		ticks = rte_rand_max(hz / 100);
+		timers[i].expire = rte_get_timer_cycles() + ticks;
+		rte_timer_alt_reset(id, &timers[i].tim, ticks, SINGLE,
+				lcore_id, NULL, NULL);
+		max_expire = RTE_MAX(max_expire, timers[i].expire);
+	}
+
+	/* expiry is rounded up to the wheel resolution */
+	while (rte_get_timer_cycles() <= max_expire + hz / MS_PER_S)
+		rte_pause();
+
+	nb_expired = 0;
+	nb_periodic = 0;
+	do {
+		n = rte_timer_alt_manage_burst(id, burst, BURST_SIZE);
+		TEST_ASSERT(n >= 0 && n <= BURST_SIZE,
+			"invalid number of expired timers %d", n);
+		for (i = 0; i < (unsigned int)n; i++) {
+			if (burst[i] == &periodic) {
+				TEST_ASSERT_EQUAL(rte_timer_pending(burst[i]), 1,
+					"periodic timer not re-armed");
+				nb_periodic++;
+				continue;
+			}
+			wt = container_of(burst[i], struct wheel_timer, tim);
+			TEST_ASSERT((burst[i]->status.state == RTE_TIMER_STOP),
+				"one-shot timer %td not stopped",
+				wt - timers);
+			if (burst[i]->expire < wt->expire) {
+				printf("Timer %td returned before %" PRIu64
+					"\n", wt - timers, wt->expire);
+				test_failed = 1;
+			}
+			wt->count++;
+			nb_expired++;
+		}
+	} while (n != 0 && nb_expired < BURST_NB_TIMER);
+
+	TEST_ASSERT_EQUAL(nb_expired, BURST_NB_TIMER,
+		"%u timers out of %u returned", nb_expired, BURST_NB_TIMER);
+	TEST_ASSERT(nb_periodic != 0, "periodic timer not returned");
+	for (i = 0; i < BURST_NB_TIMER; i++)
+		TEST_ASSERT_EQUAL(timers[i].count, 1,
+			"timer %u returned %u times", i, timers[i].count);
+
+	/* expired timers left by a short burst are stopped with the rest */
+	rte_timer_alt_stop(id, &periodic);
+	for (i = 0; i < BURST_NB_LEFTOVER; i++)
+		rte_timer_alt_reset(id, &timers[i].tim, 0, SINGLE, lcore_id,
+				NULL, NULL);
+	max_expire = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() <= max_expire + hz / MS_PER_S)
+		rte_pause();
+
+	n = rte_timer_alt_manage_burst(id, burst, 1);
+	TEST_ASSERT_EQUAL(n, 1, "%d timers returned", n);
+	burst_stopped = 0;
+	ret = rte_timer_stop_all(id, &lcore_id, 1, timer_burst_stop_cb, NULL);
+	TEST_ASSERT_SUCCESS(ret, "cannot stop timers");
+	TEST_ASSERT_EQUAL(burst_stopped, BURST_NB_LEFTOVER - 1,
+		"%u timers stopped", burst_stopped);
+	for (i = 0; i < BURST_NB_LEFTOVER; i++)
+		TEST_ASSERT((timers[i].tim.status.state == RTE_TIMER_STOP),
+			"timer %u not stopped", i);
+	TEST_ASSERT_EQUAL(rte_timer_alt_manage_burst(id, burst, BURST_SIZE),
+		0, "stopped timers returned");
+
+	rte_timer_data_dealloc(id);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_timer_burst(void)
+{
+	struct rte_timer_data_conf conf = {
+		.backend = RTE_TIMER_BACKEND_SKIPLIST,
+	};
+	struct wheel_timer *timers;
+	int ret;
+
+	timers = rte_zmalloc(NULL, sizeof(*timers) * BURST_NB_TIMER, 0);
+	if (timers == NULL) {
+		printf("Cannot allocate timers\n");
+		return TEST_FAILED;
+	}
+
+	test_failed = 0;
+
+	ret = timer_burst_backend(&conf, timers);
+	if (ret == TEST_SUCCESS) {
+		conf.backend = RTE_TIMER_BACKEND_WHEEL;
+		ret = timer_burst_backend(&conf, timers);
+	}
+
+	rte_free(timers);
+
+	if (ret != TEST_SUCCESS || test_failed)
+		return TEST_FAILED;
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(timer_burst_autotest, test_timer_burst);
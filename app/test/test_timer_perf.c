@@ -16,6 +16,8 @@
 #include <rte_pause.h>
 
 #define MAX_ITERATIONS 1000000
+#define BACKEND_MIN_TIMERS 1000000
+#define BACKEND_MAX_TIMERS 10000000
 
 int outstanding_count = 0;
 
@@ -33,6 +35,119 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+static void
+backend_timer_cb(struct rte_timer *t __rte_unused)
+{
+	outstanding_count--;
+}
+
+static void
+print_backend_time(const char *op, unsigned int n, uint64_t start_tsc,
+		   uint64_t end_tsc)
+{
+	printf("  %-8s %"PRIu64" cycles per timer\n", op,
+		(end_tsc - start_tsc + n / 2) / n);
+}
+
+/* Start, restart, stop and run n timers with a timer backend */
+static int
+test_timer_perf_backend(const struct rte_timer_data_conf *conf,
+			struct rte_timer *tms, unsigned int n)
+{
+	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t start_tsc, end_tsc, delay_start;
+	uint32_t id;
+	unsigned int i;
+	int ret;
+
+	ret = rte_timer_data_alloc_ext(&id, conf);
+	if (ret != 0) {
+		printf("Cannot allocate timer data: %d\n", ret);
+		return -1;
+	}
+
+	printf("%s with %u timers:\n",
+		conf->backend == RTE_TIMER_BACKEND_WHEEL ?
+		"Timer wheel" : "Skiplist", n);
+
+	for (i = 0; i < n; i++)
+		rte_timer_init(&tms[i]);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(id, &tms[i], rte_rand_max(ticks), SINGLE,
+				lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	print_backend_time("start", n, start_tsc, end_tsc);
+
+	/* as done to refresh the idle timeout of a flow */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(id, &tms[i], rte_rand_max(ticks), SINGLE,
+				lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	print_backend_time("restart", n, start_tsc, end_tsc);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i += 2)
+		rte_timer_alt_stop(id, &tms[i]);
+	end_tsc = rte_rdtsc();
+	print_backend_time("stop", n / 2, start_tsc, end_tsc);
+
+	outstanding_count = n / 2;
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	rte_timer_alt_manage(id, NULL, 0, backend_timer_cb);
+	end_tsc = rte_rdtsc();
+	print_backend_time("expire", n / 2, start_tsc, end_tsc);
+
+	rte_timer_data_dealloc(id);
+
+	if (outstanding_count != 0) {
+		printf("Error: outstanding callback count = %d\n",
+			outstanding_count);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Compare the timer backends with a large number of timers */
+static int
+test_timer_perf_backends(void)
+{
+	const struct rte_timer_data_conf confs[] = {
+		{ .backend = RTE_TIMER_BACKEND_SKIPLIST, },
+		{ .backend = RTE_TIMER_BACKEND_WHEEL, },
+	};
+	struct rte_timer *tms;
+	unsigned int i, n;
+
+	for (n = BACKEND_MIN_TIMERS; n <= BACKEND_MAX_TIMERS; n *= 10) {
+		tms = rte_malloc(NULL, sizeof(*tms) * n, 0);
+		if (tms == NULL) {
+			printf("Not enough memory for %u timers\n", n);
+			break;
+		}
+
+		for (i = 0; i < RTE_DIM(confs); i++) {
+			if (test_timer_perf_backend(&confs[i], tms, n) < 0) {
+				rte_free(tms);
+				return -1;
+			}
+		}
+		printf("\n");
+
+		rte_free(tms);
+	}
+
+	return 0;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -127,8 +242,11 @@ test_timer_perf(void)
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
+	rte_timer_stop_sync(&tms[0]);
 	rte_free(tms);
-	return 0;
+
+	printf("\n");
+	return test_timer_perf_backends();
 }
 
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
@@ -0,0 +1,549 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_memzone.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+#include "rte_mempool_numa.h"
+
+/*
+ * The NUMA-aware mempool driver keeps one ring per socket. The home socket
+ * of an object is the socket of the memory chunk it was populated from, and
+ * objects always go back to the ring of their home socket, whichever lcore
+ * frees them. Objects are taken from the ring of the calling lcore socket
+ * and only borrowed from the other sockets when it runs empty.
+ *
+ * Memory registered as external memory has a socket of its own, which is
+ * given its own ring when the first chunk of it is populated. No lcore
+ * runs on such a socket, so its objects are only ever borrowed.
+ */
+
+/* maximum number of distinct memory chunks tracked per mempool */
+#define NUMA_MAX_CHUNKS 64
+/* number of objects sorted by home socket at once on enqueue */
+#define NUMA_ENQUEUE_BATCH 64
+/* invalid node index */
+#define NUMA_NODE_NONE UINT8_MAX
+/* ring name, made of the mempool address so that it always fits */
+#define NUMA_RING_NAME_FMT "MPN_%" PRIxPTR ".%u"
+
+struct numa_chunk {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int node;
+};
+
+struct numa_stats {
+	uint64_t local_get;
+	uint64_t remote_get;
+	uint64_t local_put;
+	uint64_t remote_put;
+} __rte_cache_aligned;
+
+struct numa_pool {
+	/* EAL sockets first, then the external memory sockets */
+	unsigned int nb_nodes;
+	unsigned int nb_sockets;
+	/* node of objects and lcores whose socket is unknown */
+	unsigned int default_node;
+	int rg_flags;
+	uint8_t node_of_socket[RTE_MAX_NUMA_NODES];
+	int socket_of_node[RTE_MAX_NUMA_NODES];
+	struct rte_ring *rings[RTE_MAX_NUMA_NODES];
+	uint32_t nb_chunks;
+	struct numa_chunk chunks[NUMA_MAX_CHUNKS];
+	/* one more slot for unregistered non-EAL threads */
+	struct numa_stats stats[RTE_MAX_LCORE + 1];
+};
+
+#define NUMA_STATS_ADD(np, name, n) do {                                        \
+		unsigned int __lcore_id = rte_lcore_id();                       \
+		if (likely(__lcore_id < RTE_MAX_LCORE))                         \
+			(np)->stats[__lcore_id].name += (n);                    \
+		else                                                            \
+			__atomic_fetch_add(&((np)->stats[RTE_MAX_LCORE].name),  \
+					   (n), __ATOMIC_RELAXED);              \
+	} while (0)
+
+static bool
+numa_mempool_check(const struct rte_mempool *mp)
+{
+	return strcmp(rte_mempool_get_ops(mp->ops_index)->name,
+			RTE_MEMPOOL_NUMA_OPS_NAME) == 0;
+}
+
+static inline unsigned int
+numa_lcore_node(const struct numa_pool *np)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (socket_id >= RTE_MAX_NUMA_NODES)
+		return np->default_node;
+
+	return np->node_of_socket[socket_id];
+}
+
+static inline unsigned int
+numa_obj_node(const struct numa_pool *np, const void *obj, unsigned int *hint)
+{
+	const struct numa_chunk *chunk = &np->chunks[*hint];
+	uintptr_t addr = (uintptr_t)obj;
+	uint32_t i, nb_chunks;
+
+	/* objects of a burst usually come from the same chunk */
+	if (addr - chunk->start < chunk->end - chunk->start)
+		return chunk->node;
+
+	nb_chunks = __atomic_load_n(&np->nb_chunks, __ATOMIC_ACQUIRE);
+	for (i = 0; i < nb_chunks; i++) {
+		chunk = &np->chunks[i];
+		if (addr - chunk->start < chunk->end - chunk->start) {
+			*hint = i;
+			return chunk->node;
+		}
+	}
+
+	return np->default_node;
+}
+
+static inline int
+numa_put(struct numa_pool *np, unsigned int node, unsigned int local,
+	 void * const *obj_table, unsigned int n)
+{
+	/* rings are sized to hold all objects, this cannot fail */
+	if (rte_ring_enqueue_bulk(np->rings[node], obj_table, n, NULL) == 0)
+		return -ENOBUFS;
+
+	if (node == local)
+		NUMA_STATS_ADD(np, local_put, n);
+	else
+		NUMA_STATS_ADD(np, remote_put, n);
+
+	return 0;
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	     unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int local = numa_lcore_node(np);
+	uint8_t nodes[NUMA_ENQUEUE_BATCH];
+	void *batch[NUMA_ENQUEUE_BATCH];
+	unsigned int i, j, len, nb, node, next;
+	unsigned int hint = 0;
+	bool mixed;
+
+	for (i = 0; i < n; i += len) {
+		void * const *objs = &obj_table[i];
+
+		len = RTE_MIN(n - i, (unsigned int)NUMA_ENQUEUE_BATCH);
+		mixed = false;
+		for (j = 0; j < len; j++) {
+			nodes[j] = numa_obj_node(np, objs[j], &hint);
+			mixed |= nodes[j] != nodes[0];
+		}
+
+		if (likely(!mixed)) {
+			if (numa_put(np, nodes[0], local, objs, len) < 0)
+				return -ENOBUFS;
+			continue;
+		}
+
+		/* send each home socket all its objects at once */
+		for (node = nodes[0]; node != NUMA_NODE_NONE; node = next) {
+			next = NUMA_NODE_NONE;
+			for (j = 0, nb = 0; j < len; j++) {
+				if (nodes[j] == node) {
+					batch[nb++] = objs[j];
+					nodes[j] = NUMA_NODE_NONE;
+				} else if (next == NUMA_NODE_NONE) {
+					next = nodes[j];
+				}
+			}
+			if (numa_put(np, node, local, batch, nb) < 0)
+				return -ENOBUFS;
+		}
+	}
+
+	return 0;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int local = numa_lcore_node(np);
+	unsigned int got[RTE_MAX_NUMA_NODES];
+	unsigned int i, j, nb, nb_nodes;
+
+	nb = rte_ring_dequeue_burst(np->rings[local], obj_table, n, NULL);
+	if (likely(nb == n)) {
+		NUMA_STATS_ADD(np, local_get, n);
+		return 0;
+	}
+
+	/* local socket ran out of objects, borrow from the other ones */
+	nb_nodes = __atomic_load_n(&np->nb_nodes, __ATOMIC_ACQUIRE);
+	got[0] = nb;
+	for (i = 1; i < nb_nodes && nb < n; i++) {
+		got[i] = rte_ring_dequeue_burst(
+			np->rings[(local + i) % nb_nodes],
+			&obj_table[nb], n - nb, NULL);
+		nb += got[i];
+	}
+
+	if (nb < n) {
+		/* not enough objects in the whole pool, give them back */
+		for (j = 0, nb = 0; j < i; nb += got[j], j++)
+			rte_ring_enqueue_bulk(
+				np->rings[(local + j) % nb_nodes],
+				&obj_table[nb], got[j], NULL);
+		return -ENOBUFS;
+	}
+
+	NUMA_STATS_ADD(np, local_get, got[0]);
+	NUMA_STATS_ADD(np, remote_get, n - got[0]);
+
+	return 0;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int i, nb_nodes, count = 0;
+
+	nb_nodes = __atomic_load_n(&np->nb_nodes, __ATOMIC_ACQUIRE);
+	for (i = 0; i < nb_nodes; i++)
+		count += rte_ring_count(np->rings[i]);
+
+	return count;
+}
+
+static struct rte_ring *
+numa_ring_create(const struct rte_mempool *mp, const struct numa_pool *np,
+		 unsigned int node, int socket_id)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+	int ret;
+
+	ret = snprintf(rg_name, sizeof(rg_name), NUMA_RING_NAME_FMT,
+		       (uintptr_t)mp, node);
+	if (ret < 0 || ret >= (int)sizeof(rg_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	/* any socket may end up holding all the objects */
+	r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+			    socket_id, np->rg_flags);
+	/* the socket may have no memory at all */
+	if (r == NULL && rte_errno == ENOMEM)
+		r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+				    mp->socket_id, np->rg_flags);
+
+	return r;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	struct numa_pool *np;
+	unsigned int i;
+	int rc;
+
+	RTE_BUILD_BUG_ON(RTE_MAX_NUMA_NODES >= NUMA_NODE_NONE);
+	/* "MPN_" + 64-bit address + "." + node index */
+	RTE_BUILD_BUG_ON(4 + 16 + 1 + 3 >= RTE_RING_NAMESIZE);
+
+	np = rte_zmalloc_socket("numa_pool", sizeof(*np),
+				RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (np == NULL) {
+		rc = -ENOMEM;
+		goto no_mem_for_data;
+	}
+
+	np->nb_sockets = rte_socket_count();
+	np->nb_nodes = np->nb_sockets;
+	for (i = 0; i < np->nb_nodes; i++) {
+		np->socket_of_node[i] = rte_socket_id_by_idx(i);
+		if (np->socket_of_node[i] == mp->socket_id)
+			np->default_node = i;
+	}
+	memset(np->node_of_socket, np->default_node,
+	       sizeof(np->node_of_socket));
+	for (i = 0; i < np->nb_nodes; i++)
+		np->node_of_socket[np->socket_of_node[i]] = i;
+
+	if (mp->flags & RTE_MEMPOOL_F_SP_PUT)
+		np->rg_flags |= RING_F_SP_ENQ;
+	if (mp->flags & RTE_MEMPOOL_F_SC_GET)
+		np->rg_flags |= RING_F_SC_DEQ;
+
+	for (i = 0; i < np->nb_nodes; i++) {
+		np->rings[i] = numa_ring_create(mp, np, i,
+						np->socket_of_node[i]);
+		if (np->rings[i] == NULL) {
+			rc = -rte_errno;
+			goto cannot_create_ring;
+		}
+	}
+
+	mp->pool_data = np;
+
+	return 0;
+
+cannot_create_ring:
+	while (i-- > 0)
+		rte_ring_free(np->rings[i]);
+	rte_free(np);
+no_mem_for_data:
+	rte_errno = -rc;
+	return rc;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int i;
+
+	if (np == NULL)
+		return;
+
+	for (i = 0; i < np->nb_nodes; i++)
+		rte_ring_free(np->rings[i]);
+
+	rte_free(np);
+}
+
+/* get the node of an external memory socket, adding it on first use */
+static int
+numa_ext_node(const struct rte_mempool *mp, struct numa_pool *np,
+	      int socket_id)
+{
+	unsigned int node;
+
+	for (node = np->nb_sockets; node < np->nb_nodes; node++)
+		if (np->socket_of_node[node] == socket_id)
+			return node;
+
+	if (node == RTE_MAX_NUMA_NODES) {
+		RTE_LOG(WARNING, MEMPOOL,
+			"%s: too many sockets, external socket %d accounted to socket %d\n",
+			mp->name, socket_id,
+			np->socket_of_node[np->default_node]);
+		return np->default_node;
+	}
+
+	np->rings[node] = numa_ring_create(mp, np, node, mp->socket_id);
+	if (np->rings[node] == NULL)
+		return -rte_errno;
+	np->socket_of_node[node] = socket_id;
+	/* the ring is only reached by the datapath once it is counted */
+	__atomic_store_n(&np->nb_nodes, node + 1, __ATOMIC_RELEASE);
+
+	return node;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+	      void *vaddr, rte_iova_t iova, size_t len,
+	      rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_pool *np = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	unsigned int node = np->default_node;
+	struct numa_chunk *chunk;
+	uint32_t nb_chunks;
+	int ret;
+
+	/* anonymous memory belongs to the default socket */
+	msl = rte_mem_virt2memseg_list(vaddr);
+	if (msl != NULL && msl->external) {
+		ret = numa_ext_node(mp, np, msl->socket_id);
+		if (ret < 0)
+			return ret;
+		node = ret;
+	} else if (msl != NULL && msl->socket_id >= 0 &&
+			msl->socket_id < RTE_MAX_NUMA_NODES) {
+		node = np->node_of_socket[msl->socket_id];
+	}
+
+	/*
+	 * Objects only become visible through the rings once the chunk
+	 * they belong to is recorded, adjacent chunks of the same socket,
+	 * e.g. pages of a memzone, are merged.
+	 */
+	nb_chunks = np->nb_chunks;
+	chunk = &np->chunks[nb_chunks > 0 ? nb_chunks - 1 : 0];
+	if (nb_chunks > 0 && chunk->node == node &&
+			chunk->end == (uintptr_t)vaddr) {
+		__atomic_store_n(&chunk->end, (uintptr_t)vaddr + len,
+				 __ATOMIC_RELEASE);
+	} else if (nb_chunks < NUMA_MAX_CHUNKS) {
+		chunk = &np->chunks[nb_chunks];
+		chunk->start = (uintptr_t)vaddr;
+		chunk->end = (uintptr_t)vaddr + len;
+		chunk->node = node;
+		__atomic_store_n(&np->nb_chunks, nb_chunks + 1,
+				 __ATOMIC_RELEASE);
+	} else {
+		RTE_LOG(WARNING, MEMPOOL,
+			"%s: too many memory chunks, objects at %p accounted to socket %d\n",
+			mp->name, vaddr,
+			np->socket_of_node[np->default_node]);
+	}
+
+	return rte_mempool_op_populate_helper(mp, 0, max_objs, vaddr, iova,
+					      len, obj_cb, obj_cb_arg);
+}
+
+static struct rte_mempool_ops ops_numa = {
+	.name = RTE_MEMPOOL_NUMA_OPS_NAME,
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_numa);
+
+/* free a memchunk allocated with rte_memzone_reserve() */
+static void
+numa_memchunk_mz_free(__rte_unused struct rte_mempool_memhdr *memhdr,
+		      void *opaque)
+{
+	const struct rte_memzone *mz = opaque;
+
+	rte_memzone_free(mz);
+}
+
+int
+rte_mempool_numa_populate(struct rte_mempool *mp)
+{
+	unsigned int mz_flags = RTE_MEMZONE_1GB | RTE_MEMZONE_SIZE_HINT_ONLY;
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	size_t min_chunk_size, align;
+	unsigned int i, nb_sockets, n;
+	ssize_t mem_size;
+	rte_iova_t iova;
+	int ret;
+
+	if (!numa_mempool_check(mp))
+		return -EINVAL;
+
+	/* mempool must not be populated */
+	if (mp->nb_mem_chunks != 0)
+		return -EEXIST;
+
+	/* the share of each socket is reserved as a single memzone */
+	if (!(mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG))
+		mz_flags |= RTE_MEMZONE_IOVA_CONTIG;
+
+	nb_sockets = rte_socket_count();
+	for (i = 0; i < nb_sockets; i++) {
+		/* the last socket takes the remainder */
+		if (i == nb_sockets - 1)
+			n = mp->size - mp->populated_size;
+		else
+			n = mp->size / nb_sockets;
+		if (n == 0)
+			continue;
+
+		mem_size = rte_mempool_ops_calc_mem_size(mp, n, 0,
+				&min_chunk_size, &align);
+		if (mem_size < 0)
+			return mem_size;
+
+		ret = snprintf(mz_name, sizeof(mz_name),
+			RTE_MEMPOOL_MZ_FORMAT "_%u", mp->name, i);
+		if (ret < 0 || ret >= (int)sizeof(mz_name))
+			return -ENAMETOOLONG;
+
+		mz = rte_memzone_reserve_aligned(mz_name, mem_size,
+				rte_socket_id_by_idx(i), mz_flags, align);
+		if (mz == NULL)
+			return -rte_errno;
+
+		if (mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG)
+			iova = RTE_BAD_IOVA;
+		else
+			iova = mz->iova;
+
+		ret = rte_mempool_populate_iova(mp, mz->addr, iova, mz->len,
+				numa_memchunk_mz_free, (void *)(uintptr_t)mz);
+		if (ret == 0) /* should not happen */
+			ret = -ENOBUFS;
+		if (ret < 0) {
+			rte_memzone_free(mz);
+			return ret;
+		}
+	}
+
+	return mp->populated_size;
+}
+
+int
+rte_mempool_numa_avail_count(const struct rte_mempool *mp, int socket_id)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int i, nb_nodes;
+
+	if (!numa_mempool_check(mp) || socket_id < 0)
+		return -EINVAL;
+
+	/* not populated yet */
+	if (np == NULL)
+		return 0;
+
+	nb_nodes = __atomic_load_n(&np->nb_nodes, __ATOMIC_ACQUIRE);
+	for (i = 0; i < nb_nodes; i++)
+		if (np->socket_of_node[i] == socket_id)
+			return rte_ring_count(np->rings[i]);
+
+	return -EINVAL;
+}
+
+int
+rte_mempool_numa_stats_get(const struct rte_mempool *mp,
+			   struct rte_mempool_numa_stats *stats)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int lcore_id;
+
+	if (!numa_mempool_check(mp) || stats == NULL)
+		return -EINVAL;
+
+	memset(stats, 0, sizeof(*stats));
+
+	/* not populated yet */
+	if (np == NULL)
+		return 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE + 1; lcore_id++) {
+		stats->local_get += np->stats[lcore_id].local_get;
+		stats->remote_get += np->stats[lcore_id].remote_get;
+		stats->local_put += np->stats[lcore_id].local_put;
+		stats->remote_put += np->stats[lcore_id].remote_put;
+	}
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef RTE_MEMPOOL_NUMA_H
+#define RTE_MEMPOOL_NUMA_H
+
+/**
+ * @file
+ *
+ * NUMA-aware mempool driver specific functions.
+ *
+ * A mempool using the "numa" ops keeps one sub-pool per NUMA socket.
+ * Objects are always returned to the sub-pool of the socket their memory
+ * lives on, and are taken from the sub-pool of the calling lcore socket,
+ * falling back to the other sockets only when the local one is empty.
+ * Memory registered as external memory makes a sub-pool of its own,
+ * identified by the socket identifier EAL gave to that memory.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+/** Name of the NUMA-aware mempool ops. */
+#define RTE_MEMPOOL_NUMA_OPS_NAME "numa"
+
+/**
+ * Cross-socket statistics of a NUMA-aware mempool.
+ */
+struct rte_mempool_numa_stats {
+	/** Objects taken from the sub-pool of the caller socket. */
+	uint64_t local_get;
+	/** Objects borrowed from the sub-pool of another socket. */
+	uint64_t remote_get;
+	/** Objects put back from a lcore of their home socket. */
+	uint64_t local_put;
+	/** Objects sent back to their home socket from another socket. */
+	uint64_t remote_put;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Populate a NUMA-aware mempool with memory spread over all sockets.
+ *
+ * The objects are evenly split between the sockets detected by EAL,
+ * each share being allocated from a memzone reserved on its socket.
+ * A mempool populated by any other means is also supported, in which
+ * case each object belongs to the socket its memory was allocated on,
+ * or to the socket of the external memory it lives in.
+ *
+ * @param mp
+ *   A pointer to an empty mempool using the "numa" ops.
+ * @return
+ *   The number of objects added on success (the whole mempool).
+ *   On error, a negative errno is returned and the mempool, which
+ *   may be partially populated, has to be freed.
+ */
+__rte_experimental
+int
+rte_mempool_numa_populate(struct rte_mempool *mp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of objects available in the sub-pool of a socket.
+ *
+ * Objects held in the per-lcore caches are not accounted.
+ *
+ * @param mp
+ *   A pointer to a mempool using the "numa" ops.
+ * @param socket_id
+ *   The socket identifier, which may be the one of an external memory
+ *   area the mempool was populated from.
+ * @return
+ *   The number of available objects, or a negative errno on error.
+ */
+__rte_experimental
+int
+rte_mempool_numa_avail_count(const struct rte_mempool *mp, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the cross-socket statistics of a NUMA-aware mempool.
+ *
+ * Counters only account for objects moved between the sub-pools and
+ * the per-lcore caches, or the application when there is no cache.
+ *
+ * @param mp
+ *   A pointer to a mempool using the "numa" ops.
+ * @param stats
+ *   A pointer to a structure filled with the statistics.
+ * @return
+ *   0 on success, -EINVAL if the mempool does not use the "numa" ops.
+ */
+__rte_experimental
+int
+rte_mempool_numa_stats_get(const struct rte_mempool *mp,
+		struct rte_mempool_numa_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTE_MEMPOOL_NUMA_H */
@@ -8,12 +8,14 @@
 
 #include <rte_eal.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_mempool.h>
+#include <rte_pause.h>
 #include <rte_ring.h>
 #include <rte_reorder.h>
 
@@ -35,11 +37,14 @@ enum {
 	OPT_DISABLE_REORDER_NUM = 256,
 #define OPT_INSIGHT_WORKER  "insight-worker"
 	OPT_INSIGHT_WORKER_NUM,
+#define OPT_MP_REORDER      "mp-reorder"
+	OPT_MP_REORDER_NUM,
 };
 
 unsigned int portmask;
 unsigned int disable_reorder;
 unsigned int insight_worker;
+unsigned int mp_reorder;
 volatile uint8_t quit_signal;
 
 static struct rte_mempool *mbuf_pool;
@@ -49,6 +54,8 @@ static struct rte_eth_conf port_conf_default;
 struct worker_thread_args {
 	struct rte_ring *ring_in;
 	struct rte_ring *ring_out;
+	/* multi-producer reorder buffer replacing ring_out, if not NULL */
+	struct rte_reorder_buffer *buffer;
 };
 
 struct send_thread_args {
@@ -78,6 +85,10 @@ volatile struct app_stats {
 		uint64_t ro_tx_pkts;
 		uint64_t ro_tx_failed_pkts;
 	} tx __rte_cache_aligned;
+
+	/* TSC at the start and the end of the packet processing */
+	uint64_t start_tsc;
+	uint64_t stop_tsc;
 } app_stats;
 
 /* per worker lcore stats */
@@ -138,7 +149,10 @@ static void
 print_usage(const char *prgname)
 {
 	printf("%s [EAL options] -- -p PORTMASK\n"
-			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n",
+			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n"
+			"  --disable-reorder: transmit the packets without reordering\n"
+			"  --insight-worker: print the statistics of each worker\n"
+			"  --mp-reorder: workers insert the packets into the reorder buffer\n",
 			prgname);
 }
 
@@ -167,6 +181,7 @@ parse_args(int argc, char **argv)
 	static struct option lgopts[] = {
 		{OPT_DISABLE_REORDER, 0, NULL, OPT_DISABLE_REORDER_NUM},
 		{OPT_INSIGHT_WORKER,  0, NULL, OPT_INSIGHT_WORKER_NUM },
+		{OPT_MP_REORDER,      0, NULL, OPT_MP_REORDER_NUM     },
 		{NULL,                0, 0,    0                      }
 	};
 
@@ -196,6 +211,11 @@ parse_args(int argc, char **argv)
 			insight_worker = 1;
 			break;
 
+		case OPT_MP_REORDER_NUM:
+			printf("multi-producer reorder enabled\n");
+			mp_reorder = 1;
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -401,6 +421,10 @@ print_stats(void)
 						app_stats.tx.early_pkts_txtd_woro);
 	printf(" - Pkts tx failed w/o reorder:		%"PRIu64"\n",
 						app_stats.tx.early_pkts_tx_failed_woro);
+	if (app_stats.stop_tsc > app_stats.start_tsc)
+		printf(" - Ro Pkts tx rate (Mpps):		%.2f\n",
+			(double)app_stats.tx.ro_tx_pkts * rte_get_tsc_hz() /
+			(app_stats.stop_tsc - app_stats.start_tsc) / 1e6);
 
 	RTE_ETH_FOREACH_DEV(i) {
 		rte_eth_stats_get(i, &eth_stats);
@@ -466,6 +490,11 @@ rx_thread(struct rte_ring *ring_out)
 					app_stats.rx.enqueue_failed_pkts +=
 									(nb_rx_pkts-ret);
 					pktmbuf_free_bulk(&pkts[ret], nb_rx_pkts - ret);
+					/*
+					 * reuse the sequence numbers of dropped
+					 * packets, so they leave no gap
+					 */
+					seqn -= nb_rx_pkts - ret;
 				}
 			}
 		}
@@ -511,6 +540,27 @@ worker_thread(void *args_ptr)
 		for (i = 0; i < burst_size;)
 			burst_buffer[i++]->port ^= xor_val;
 
+		if (args->buffer != NULL) {
+			/* insert the mbufs into the reorder buffer */
+			ret = 0;
+			for (i = 0; i < burst_size; i++) {
+				while (rte_reorder_insert(args->buffer,
+						burst_buffer[i]) != 0) {
+					/* wait for the send thread to drain */
+					if (rte_errno == ENOSPC && !quit_signal) {
+						rte_pause();
+						continue;
+					}
+					rte_pktmbuf_free(burst_buffer[i]);
+					ret++;
+					break;
+				}
+			}
+			wkr_stats[core_id].enq_pkts += burst_size - ret;
+			wkr_stats[core_id].enq_failed_pkts += ret;
+			continue;
+		}
+
 		/* enqueue the modified mbufs to workers_to_tx ring */
 		ret = rte_ring_enqueue_burst(ring_out, (void *)burst_buffer,
 				burst_size, NULL);
@@ -524,20 +574,50 @@ worker_thread(void *args_ptr)
 	return 0;
 }
 
+/**
+ * Drain MAX_PKTS_BURST of reordered mbufs from the reorder buffer and
+ * transmit them.
+ */
+static void
+drain_tx(struct rte_reorder_buffer *buffer,
+		struct rte_eth_dev_tx_buffer *tx_buffer[])
+{
+	unsigned int i, dret;
+	unsigned sent;
+	struct rte_mbuf *rombufs[MAX_PKTS_BURST];
+	struct rte_eth_dev_tx_buffer *outbuf;
+	uint8_t outp;
+
+	dret = rte_reorder_drain(buffer, rombufs, MAX_PKTS_BURST);
+	for (i = 0; i < dret; i++) {
+
+		outp = rombufs[i]->port;
+		/* skip ports that are not enabled */
+		if ((portmask & (1 << outp)) == 0) {
+			rte_pktmbuf_free(rombufs[i]);
+			continue;
+		}
+
+		outbuf = tx_buffer[outp];
+		sent = rte_eth_tx_buffer(outp, 0, outbuf, rombufs[i]);
+		if (sent)
+			app_stats.tx.ro_tx_pkts += sent;
+	}
+}
+
 /**
  * Dequeue mbufs from the workers_to_tx ring and reorder them before
- * transmitting.
+ * transmitting. With a multi-producer reorder buffer, the workers
+ * insert the mbufs themselves, so only drain and transmit them.
  */
 static int
 send_thread(struct send_thread_args *args)
 {
 	int ret;
-	unsigned int i, dret;
+	unsigned int i;
 	uint16_t nb_dq_mbufs;
 	uint8_t outp;
-	unsigned sent;
 	struct rte_mbuf *mbufs[MAX_PKTS_BURST];
-	struct rte_mbuf *rombufs[MAX_PKTS_BURST] = {NULL};
 	static struct rte_eth_dev_tx_buffer *tx_buffer[RTE_MAX_ETHPORTS];
 
 	RTE_LOG(INFO, REORDERAPP, "%s() started on lcore %u\n", __func__, rte_lcore_id());
@@ -546,6 +626,11 @@ send_thread(struct send_thread_args *args)
 
 	while (!quit_signal) {
 
+		if (args->ring_in == NULL) {
+			drain_tx(args->buffer, tx_buffer);
+			continue;
+		}
+
 		/* deque the mbufs from workers_to_tx ring */
 		nb_dq_mbufs = rte_ring_dequeue_burst(args->ring_in,
 				(void *)mbufs, MAX_PKTS_BURST, NULL);
@@ -582,28 +667,7 @@ send_thread(struct send_thread_args *args)
 			}
 		}
 
-		/*
-		 * drain MAX_PKTS_BURST of reordered
-		 * mbufs for transmit
-		 */
-		dret = rte_reorder_drain(args->buffer, rombufs, MAX_PKTS_BURST);
-		for (i = 0; i < dret; i++) {
-
-			struct rte_eth_dev_tx_buffer *outbuf;
-			uint8_t outp1;
-
-			outp1 = rombufs[i]->port;
-			/* skip ports that are not enabled */
-			if ((portmask & (1 << outp1)) == 0) {
-				rte_pktmbuf_free(rombufs[i]);
-				continue;
-			}
-
-			outbuf = tx_buffer[outp1];
-			sent = rte_eth_tx_buffer(outp1, 0, outbuf, rombufs[i]);
-			if (sent)
-				app_stats.tx.ro_tx_pkts += sent;
-		}
+		drain_tx(args->buffer, tx_buffer);
 	}
 
 	free_tx_buffers(tx_buffer);
@@ -666,7 +730,7 @@ main(int argc, char **argv)
 	unsigned int lcore_id, last_lcore_id, main_lcore_id;
 	uint16_t port_id;
 	uint16_t nb_ports_available;
-	struct worker_thread_args worker_args = {NULL, NULL};
+	struct worker_thread_args worker_args = {NULL, NULL, NULL};
 	struct send_thread_args send_args = {NULL, NULL};
 	struct rte_ring *rx_to_workers;
 	struct rte_ring *workers_to_tx;
@@ -743,8 +807,12 @@ main(int argc, char **argv)
 		rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 
 	if (!disable_reorder) {
-		send_args.buffer = rte_reorder_create("PKT_RO", rte_socket_id(),
-				REORDER_BUFFER_SIZE);
+		if (mp_reorder)
+			send_args.buffer = rte_reorder_create_mp("PKT_RO",
+					rte_socket_id(), REORDER_BUFFER_SIZE);
+		else
+			send_args.buffer = rte_reorder_create("PKT_RO",
+					rte_socket_id(), REORDER_BUFFER_SIZE);
 		if (send_args.buffer == NULL)
 			rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 	}
@@ -754,6 +822,8 @@ main(int argc, char **argv)
 
 	worker_args.ring_in  = rx_to_workers;
 	worker_args.ring_out = workers_to_tx;
+	if (!disable_reorder && mp_reorder)
+		worker_args.buffer = send_args.buffer;
 
 	/* Start worker_thread() on all the available worker cores but the last 1 */
 	for (lcore_id = 0; lcore_id <= get_previous_lcore_id(last_lcore_id); lcore_id++)
@@ -766,14 +836,18 @@ main(int argc, char **argv)
 		rte_eal_remote_launch((lcore_function_t *)tx_thread, workers_to_tx,
 				last_lcore_id);
 	} else {
-		send_args.ring_in = workers_to_tx;
+		/* the workers insert into a multi-producer reorder buffer */
+		if (!mp_reorder)
+			send_args.ring_in = workers_to_tx;
 		/* Start send_thread() on the last worker core */
 		rte_eal_remote_launch((lcore_function_t *)send_thread,
 				(void *)&send_args, last_lcore_id);
 	}
 
 	/* Start rx_thread() on the main core */
+	app_stats.start_tsc = rte_rdtsc();
 	rx_thread(rx_to_workers);
+	app_stats.stop_tsc = rte_rdtsc();
 
 	RTE_LCORE_FOREACH_WORKER(lcore_id) {
 		if (rte_eal_wait_lcore(lcore_id) < 0)
@@ -163,6 +163,15 @@ struct rte_acl_bld_trie {
 	struct rte_acl_node *trie;
 };
 
+/* Statistics of the last build. */
+struct acl_build_stats {
+	uint64_t            time_us;     /* duration of the build. */
+	size_t              mem_sz;      /* temporary memory used. */
+	uint32_t            num_nodes;   /* nodes created. */
+	uint32_t            num_threads; /* threads the tries were built on. */
+	uint32_t            node_max;    /* node limit for trie split. */
+};
+
 struct rte_acl_ctx {
 	char                name[RTE_ACL_NAMESIZE];
 	/** Name of the ACL context. */
@@ -174,6 +183,7 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	struct acl_incr    *incr; /* incremental update state, if enabled. */
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
@@ -185,6 +195,7 @@ struct rte_acl_ctx {
 	void               *mem;
 	size_t              mem_sz;
 	struct rte_acl_config config; /* copy of build config. */
+	struct acl_build_stats bld_stats;
 };
 
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
@@ -194,6 +205,43 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+void acl_build_reset(struct rte_acl_ctx *ctx);
+
+#define ACL_RULE_BITMAP_WORD	(sizeof(uint64_t) * CHAR_BIT)
+
+/* Size in bytes of a bitmap with one bit per rule. */
+#define ACL_RULE_BITMAP_SZ(n)	\
+	(RTE_ALIGN_CEIL(n, ACL_RULE_BITMAP_WORD) / CHAR_BIT)
+
+#define ACL_RULE_BITMAP_BIT(n)	\
+	(UINT64_C(1) << ((n) % ACL_RULE_BITMAP_WORD))
+
+#define ACL_RULE_BITMAP_TEST(bm, n)	\
+	(((bm)[(n) / ACL_RULE_BITMAP_WORD] & ACL_RULE_BITMAP_BIT(n)) != 0)
+
+#define ACL_RULE_BITMAP_SET(bm, n)	\
+	((bm)[(n) / ACL_RULE_BITMAP_WORD] |= ACL_RULE_BITMAP_BIT(n))
+
+int acl_find_rules(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num, uint64_t *mark);
+
+/*
+ * Incremental update mode, see acl_incr.c.
+ */
+int acl_incr_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+int acl_incr_del_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+int acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify);
+
+void acl_incr_free(struct rte_acl_ctx *ctx);
+
+void acl_incr_dump(const struct rte_acl_ctx *ctx);
+
 /*
  * Different implementations of ACL classify.
  */
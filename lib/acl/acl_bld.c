@@ -2,7 +2,12 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <pthread.h>
+
 #include <rte_acl.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include "tb_mem.h"
 #include "acl.h"
 
@@ -88,6 +93,35 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/*
+	 * Parallel build: the tries split from the rule set are rebuilt
+	 * by the worker threads, each with its own build context
+	 * and memory pool.
+	 */
+	struct acl_build_context  *main;
+	struct acl_build_worker   *workers;
+	uint32_t                  num_workers;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+	uint32_t                  num_jobs;
+	uint32_t                  next_job;
+	uint32_t                  stop;
+	int32_t                   worker_rc;
+};
+
+/* Worker of a parallel build. */
+struct acl_build_worker {
+	struct acl_build_context  bcx;
+	pthread_t                 tid;
+	uint32_t                  lcore_id; /* LCORE_ID_ANY for a thread. */
+	uint32_t                  running;
+};
+
+/* Values of acl_build_context.stop */
+enum {
+	ACL_BUILD_RUN = 0,
+	ACL_BUILD_DRAIN, /* no more jobs will be queued. */
+	ACL_BUILD_ABORT, /* build failed, leave the remaining jobs. */
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -772,7 +806,7 @@ acl_merge_trie(struct acl_build_context *context,
  *  - free allocated RT memory.
  *  - reset all RT related fields to zero.
  */
-static void
+void
 acl_build_reset(struct rte_acl_ctx *ctx)
 {
 	rte_free(ctx->mem);
@@ -1341,15 +1375,46 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+/*
+ * Rebuild the n-th trie from its reduced rule set with the given build
+ * context, and store it into the main build context.
+ */
+static int
+acl_rebuild_trie(struct acl_build_context *context, uint32_t n)
+{
+	struct acl_build_context *bcx;
+	struct rte_acl_build_rule *last;
+
+	bcx = (context->main != NULL) ? context->main : context;
+
+	last = build_one_trie(context, bcx->rule_sets, n, INT32_MAX);
+	if (context->bld_tries[n].trie == NULL || last != NULL) {
+		RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
+		return -ENOMEM;
+	}
+
+	if (context != bcx) {
+		memcpy(bcx->data_indexes[n], context->data_indexes[n],
+			sizeof(bcx->data_indexes[n]));
+		bcx->tries[n] = context->tries[n];
+		bcx->tries[n].data_index = bcx->data_indexes[n];
+		bcx->bld_tries[n] = context->bld_tries[n];
+	}
+
+	return 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
+	int32_t rc;
 	uint32_t n, num_tries;
 	struct rte_acl_config *config;
 	struct rte_acl_build_rule *last;
-	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+	struct rte_acl_build_rule **rule_sets;
 
+	rule_sets = context->rule_sets;
 	config = head->config;
 	rule_sets[0] = head;
 
@@ -1403,19 +1468,225 @@ acl_build_tries(struct acl_build_context *context,
 		/*
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
+		 * With workers, let one of them do it while the remaining
+		 * rules are split.
 		 */
-		last = build_one_trie(context, rule_sets, n, INT32_MAX);
-		if (context->bld_tries[n].trie == NULL || last != NULL) {
-			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
-			return -ENOMEM;
+		if (context->num_workers != 0) {
+			__atomic_store_n(&context->num_jobs, num_tries,
+				__ATOMIC_RELEASE);
+			continue;
 		}
 
+		rc = acl_rebuild_trie(context, n);
+		if (rc != 0)
+			return rc;
 	}
 
 	context->num_tries = num_tries;
 	return 0;
 }
 
+/*
+ * Get the index of the next trie to rebuild,
+ * UINT32_MAX when there are no more.
+ */
+static uint32_t
+acl_build_next_job(struct acl_build_context *bcx)
+{
+	uint32_t n, stop;
+
+	for (;;) {
+		stop = __atomic_load_n(&bcx->stop, __ATOMIC_ACQUIRE);
+		if (stop == ACL_BUILD_ABORT)
+			return UINT32_MAX;
+
+		n = __atomic_load_n(&bcx->next_job, __ATOMIC_RELAXED);
+		if (n < __atomic_load_n(&bcx->num_jobs, __ATOMIC_ACQUIRE)) {
+			if (__atomic_compare_exchange_n(&bcx->next_job, &n,
+					n + 1, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED))
+				return n;
+		} else if (stop == ACL_BUILD_DRAIN)
+			return UINT32_MAX;
+		else
+			rte_pause();
+	}
+}
+
+static void
+acl_build_abort(struct acl_build_context *bcx, int32_t rc)
+{
+	int32_t exp = 0;
+
+	__atomic_compare_exchange_n(&bcx->worker_rc, &exp, rc, 0,
+		__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	__atomic_store_n(&bcx->stop, ACL_BUILD_ABORT, __ATOMIC_RELEASE);
+}
+
+static void
+acl_build_worker_run(struct acl_build_context *context)
+{
+	int32_t rc;
+	uint32_t n;
+
+	/* worker runs out of memory. */
+	rc = sigsetjmp(context->pool.fail, 0);
+
+	while (rc == 0 && (n = acl_build_next_job(context->main)) !=
+			UINT32_MAX)
+		rc = acl_rebuild_trie(context, n);
+
+	if (rc != 0) {
+		RTE_LOG(ERR, ACL,
+			"ACL context: %s, %s() failed with error code: %d\n",
+			context->acx->name, __func__, rc);
+		acl_build_abort(context->main, rc);
+	}
+}
+
+static void *
+acl_build_thread(void *arg)
+{
+	acl_build_worker_run(arg);
+	return NULL;
+}
+
+static int
+acl_build_lcore(void *arg)
+{
+	acl_build_worker_run(arg);
+	return 0;
+}
+
+static void
+acl_build_init(struct acl_build_context *bcx, const struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, uint32_t node_max)
+{
+	memset(bcx, 0, sizeof(*bcx));
+	bcx->acx = ctx;
+	bcx->pool.alignment = ACL_POOL_ALIGN;
+	bcx->pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	bcx->cfg = *cfg;
+	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
+		typeof(bcx->category_mask));
+	bcx->node_max = node_max;
+}
+
+/*
+ * Launch the workers of a parallel build, each with its own build context.
+ * They wait for the tries to rebuild until told to stop.
+ */
+static void
+acl_build_start_workers(struct acl_build_context *bcx,
+	const struct rte_acl_build_param *prm)
+{
+	int32_t rc;
+	uint32_t i, n;
+	struct acl_build_worker *wrk;
+	char name[RTE_MAX_THREAD_NAME_LEN];
+
+	/* there is at most one trie to rebuild per split. */
+	n = RTE_MIN(prm->num_lcores + prm->num_threads,
+		RTE_ACL_MAX_TRIES - 1U);
+	if (n == 0)
+		return;
+
+	bcx->workers = tb_alloc(&bcx->pool, n * sizeof(bcx->workers[0]));
+
+	for (i = 0; i != n; i++) {
+		wrk = bcx->workers + bcx->num_workers;
+		acl_build_init(&wrk->bcx, bcx->acx, &bcx->cfg, bcx->node_max);
+		wrk->bcx.main = bcx;
+
+		if (i < prm->num_lcores) {
+			wrk->lcore_id = prm->lcores[i];
+			rc = rte_eal_remote_launch(acl_build_lcore, &wrk->bcx,
+				wrk->lcore_id);
+		} else {
+			wrk->lcore_id = LCORE_ID_ANY;
+			snprintf(name, sizeof(name), "acl-bld-%u", i);
+			rc = rte_ctrl_thread_create(&wrk->tid, name, NULL,
+				acl_build_thread, &wrk->bcx);
+		}
+
+		if (rc != 0) {
+			RTE_LOG(WARNING, ACL,
+				"ACL context: %s, failed to start build "
+				"worker %u, error code: %d\n",
+				bcx->acx->name, i, rc);
+			continue;
+		}
+
+		wrk->running = 1;
+		bcx->num_workers++;
+	}
+}
+
+/*
+ * Let the workers complete the queued tries, with the help of the
+ * calling thread, unless the build failed, and wait for them.
+ */
+static int
+acl_build_stop_workers(struct acl_build_context *bcx, int32_t rc)
+{
+	uint32_t i, n;
+	struct acl_build_worker *wrk;
+
+	if (bcx->num_workers == 0)
+		return rc;
+
+	if (rc == 0) {
+		__atomic_store_n(&bcx->stop, ACL_BUILD_DRAIN,
+			__ATOMIC_RELEASE);
+		while (rc == 0 && (n = acl_build_next_job(bcx)) != UINT32_MAX)
+			rc = acl_rebuild_trie(bcx, n);
+	}
+
+	if (rc != 0)
+		acl_build_abort(bcx, rc);
+
+	for (i = 0; i != bcx->num_workers; i++) {
+		wrk = bcx->workers + i;
+		if (wrk->running == 0)
+			continue;
+		if (wrk->lcore_id == LCORE_ID_ANY)
+			pthread_join(wrk->tid, NULL);
+		else
+			rte_eal_wait_lcore(wrk->lcore_id);
+		wrk->running = 0;
+		bcx->num_nodes += wrk->bcx.num_nodes;
+	}
+
+	return __atomic_load_n(&bcx->worker_rc, __ATOMIC_RELAXED);
+}
+
+/*
+ * Total amount of temporary memory used by the build.
+ */
+static size_t
+acl_build_mem_size(const struct acl_build_context *bcx)
+{
+	uint32_t i;
+	size_t sz;
+
+	sz = bcx->pool.alloc;
+	for (i = 0; i != bcx->num_workers; i++)
+		sz += bcx->workers[i].bcx.pool.alloc;
+	return sz;
+}
+
+static void
+acl_build_free_pools(struct acl_build_context *bcx)
+{
+	uint32_t i;
+
+	/* workers build contexts are allocated from the main pool. */
+	for (i = 0; i != bcx->num_workers; i++)
+		tb_free_pool(&bcx->workers[i].bcx.pool);
+	bcx->num_workers = 0;
+	tb_free_pool(&bcx->pool);
+}
+
 static void
 acl_build_log(const struct acl_build_context *ctx)
 {
@@ -1424,11 +1695,13 @@ acl_build_log(const struct acl_build_context *ctx)
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
 		"nodes created: %u\n"
-		"memory consumed: %zu\n",
+		"memory consumed: %zu\n"
+		"worker threads: %u\n",
 		ctx->acx->name,
 		ctx->node_max,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		acl_build_mem_size(ctx),
+		ctx->num_workers);
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1505,19 +1778,13 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	const struct rte_acl_build_param *prm)
 {
 	int32_t rc;
 
 	/* setup build context. */
-	memset(bcx, 0, sizeof(*bcx));
-	bcx->acx = ctx;
-	bcx->pool.alignment = ACL_POOL_ALIGN;
-	bcx->pool.min_alloc = ACL_POOL_ALLOC_MIN;
-	bcx->cfg = *cfg;
-	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
-		typeof(bcx->category_mask));
-	bcx->node_max = node_max;
+	acl_build_init(bcx, ctx, cfg, node_max);
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
@@ -1526,7 +1793,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
-		return rc;
+		return acl_build_stop_workers(bcx, rc);
 	}
 
 	/* Create a build rules copy. */
@@ -1538,8 +1805,12 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	if (bcx->build_rules == NULL) {
 		rc = -EINVAL;
 	} else {
+		if (prm != NULL)
+			acl_build_start_workers(bcx, prm);
+
 		/* build internal trie representation. */
 		rc = acl_build_tries(bcx, bcx->build_rules);
+		rc = acl_build_stop_workers(bcx, rc);
 	}
 	return rc;
 }
@@ -1618,11 +1889,40 @@ get_first_load_size(const struct rte_acl_config *cfg)
 	return (ofs < max_ofs) ? sizeof(uint32_t) : sizeof(uint8_t);
 }
 
-int
-rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+/*
+ * Check that the workers of a parallel build are valid.
+ */
+static int
+acl_check_bld_workers(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_build_param *prm)
+{
+	uint32_t i, lcore_id;
+
+	if (prm->num_lcores != 0 && prm->lcores == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != prm->num_lcores; i++) {
+		lcore_id = prm->lcores[i];
+		if (lcore_id >= RTE_MAX_LCORE ||
+				!rte_lcore_is_enabled(lcore_id) ||
+				lcore_id == rte_lcore_id()) {
+			RTE_LOG(ERR, ACL,
+				"ACL context: %s, invalid build worker lcore: %u\n",
+				ctx->name, lcore_id);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int
+acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm)
 {
 	int32_t rc;
 	uint32_t n;
+	uint64_t start;
 	size_t max_size;
 	struct acl_build_context bcx;
 
@@ -1630,6 +1930,10 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	if (rc != 0)
 		return rc;
 
+	/* full build discards incremental updates state. */
+	if (ctx->incr != NULL)
+		acl_incr_free(ctx);
+
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1640,10 +1944,12 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		max_size = cfg->max_size;
 	}
 
+	start = rte_get_timer_cycles();
+
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, prm);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1660,14 +1966,47 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 
 				/* copy in build config. */
 				ctx->config = *cfg;
+
+				ctx->bld_stats.time_us =
+					(rte_get_timer_cycles() - start) *
+					US_PER_S / rte_get_timer_hz();
+				ctx->bld_stats.mem_sz =
+					acl_build_mem_size(&bcx);
+				ctx->bld_stats.num_nodes = bcx.num_nodes;
+				ctx->bld_stats.num_threads =
+					bcx.num_workers + 1;
+				ctx->bld_stats.node_max = n;
 			}
 		}
 
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
-		tb_free_pool(&bcx.pool);
+		acl_build_free_pools(&bcx);
 	}
 
 	return rc;
 }
+
+int
+rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return acl_build(ctx, cfg, NULL);
+}
+
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm)
+{
+	int32_t rc;
+
+	if (ctx == NULL || prm == NULL)
+		return -EINVAL;
+
+	rc = acl_check_bld_workers(ctx, prm);
+	if (rc != 0)
+		return rc;
+
+	return acl_build(ctx, cfg, prm);
+}
@@ -0,0 +1,738 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_acl.h>
+#include <rte_spinlock.h>
+
+#include "acl.h"
+
+/*
+ * Incremental update mode.
+ *
+ * The rules are looked up in two tries built from copies of the rules
+ * of the context, where the userdata is replaced by the index + 1 of the
+ * rule in the trie, so that the priority of a match is known:
+ *  - the main trie, built from all the rules at rte_acl_incr_build() and
+ *    at each rte_acl_incr_compact();
+ *  - the delta trie, rebuilt at each update, which holds the rules added
+ *    since the main trie was built.
+ * A deleted rule which is in the main trie is kept in the context as a
+ * tombstone until the next compaction, and its main trie match is ignored.
+ * The live rules of the main trie which overlap a tombstone with no higher
+ * priority could be hidden by it, so they are copied into the delta trie.
+ * The result for each category is the match with the highest priority of
+ * the two tries.
+ */
+
+/* Number of inputs classified at once against the delta trie. */
+#define ACL_INCR_BURST	64
+
+/* State of a rule of the context. */
+struct acl_incr_slot {
+	uint32_t main_id;  /* index + 1 in the main trie, 0 if not in it. */
+	uint32_t snap_id;  /* index + 1 in the main trie under compaction. */
+	uint32_t deleted;  /* tombstone of a rule in a main trie. */
+};
+
+/* Result of a trie match. */
+struct acl_incr_res {
+	uint32_t userdata;
+	int32_t priority;
+};
+
+struct acl_incr_trie {
+	struct rte_acl_ctx *ctx;
+	struct acl_incr_res *res; /* indexed by match - 1. */
+};
+
+/* Tries looked up by the classify, replaced as a whole at each update. */
+struct acl_incr_view {
+	struct acl_incr_trie main;
+	struct acl_incr_trie delta; /* ctx is NULL if there is no rule. */
+	uint64_t *main_del; /* deleted main trie rules, NULL if none. */
+};
+
+struct acl_incr {
+	struct acl_incr_view *view;
+	struct acl_incr_trie main;
+	struct acl_incr_slot *slot; /* one per rule of the context. */
+	struct rte_acl_config cfg;
+	struct rte_rcu_qsbr *v;
+	rte_spinlock_t lock; /* serializes the updates. */
+	uint32_t compacting;
+	uint32_t num_delta;
+	uint32_t num_added;
+	uint32_t num_deleted;
+};
+
+static inline const struct rte_acl_rule *
+acl_incr_rule(const struct rte_acl_ctx *ctx, uint32_t idx)
+{
+	return (const struct rte_acl_rule *)
+		((uintptr_t)ctx->rules + idx * ctx->rule_sz);
+}
+
+static void
+acl_incr_trie_free(struct acl_incr_trie *trie)
+{
+	if (trie->ctx != NULL) {
+		rte_free(trie->ctx->rules);
+		rte_free(trie->ctx->mem);
+		rte_free(trie->ctx);
+	}
+	rte_free(trie->res);
+	trie->ctx = NULL;
+	trie->res = NULL;
+}
+
+/*
+ * Copy the given rules of the context into a new trie context,
+ * to be built with acl_incr_trie_build().
+ */
+static int
+acl_incr_trie_init(const struct rte_acl_ctx *ctx, const uint32_t *idx,
+	uint32_t num, struct acl_incr_trie *trie)
+{
+	struct rte_acl_ctx *tctx;
+	struct rte_acl_rule *rule;
+	const struct rte_acl_rule *src;
+	uint32_t i;
+
+	tctx = rte_zmalloc_socket(ctx->name, sizeof(*tctx),
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	trie->ctx = tctx;
+	trie->res = rte_malloc_socket(NULL,
+		RTE_MAX(num, 1U) * sizeof(trie->res[0]), 0, ctx->socket_id);
+	if (tctx == NULL || trie->res == NULL) {
+		acl_incr_trie_free(trie);
+		return -ENOMEM;
+	}
+
+	tctx->rules = rte_malloc_socket(NULL, RTE_MAX(num, 1U) * ctx->rule_sz,
+		0, ctx->socket_id);
+	if (tctx->rules == NULL) {
+		acl_incr_trie_free(trie);
+		return -ENOMEM;
+	}
+
+	strlcpy(tctx->name, ctx->name, sizeof(tctx->name));
+	tctx->socket_id = ctx->socket_id;
+	tctx->alg = ctx->alg;
+	tctx->max_rules = num;
+	tctx->rule_sz = ctx->rule_sz;
+	tctx->num_rules = num;
+
+	for (i = 0; i != num; i++) {
+		src = acl_incr_rule(ctx, idx[i]);
+		rule = (struct rte_acl_rule *)
+			((uintptr_t)tctx->rules + i * ctx->rule_sz);
+		memcpy(rule, src, ctx->rule_sz);
+		rule->data.userdata = i + 1;
+		trie->res[i].userdata = src->data.userdata;
+		trie->res[i].priority = src->data.priority;
+	}
+
+	return 0;
+}
+
+static int
+acl_incr_trie_build(struct acl_incr_trie *trie,
+	const struct rte_acl_config *cfg)
+{
+	int32_t rc;
+
+	rc = rte_acl_build(trie->ctx, cfg);
+
+	/* the rules are not needed by the run-time structures. */
+	rte_free(trie->ctx->rules);
+	trie->ctx->rules = NULL;
+	trie->ctx->max_rules = 0;
+
+	return rc;
+}
+
+static void
+acl_incr_view_free(struct acl_incr_view *view, int free_main)
+{
+	if (free_main)
+		acl_incr_trie_free(&view->main);
+	acl_incr_trie_free(&view->delta);
+	rte_free(view->main_del);
+	rte_free(view);
+}
+
+/*
+ * Make the new view visible to the classify, and free the old one
+ * once it is not used anymore.
+ */
+static void
+acl_incr_publish(struct acl_incr *incr, struct acl_incr_view *view)
+{
+	struct acl_incr_view *old;
+
+	old = incr->view;
+	__atomic_store_n(&incr->view, view, __ATOMIC_RELEASE);
+
+	if (old == NULL)
+		return;
+
+	if (incr->v != NULL)
+		rte_rcu_qsbr_synchronize(incr->v, RTE_QSBR_THRID_INVALID);
+
+	acl_incr_view_free(old, old->main.ctx != view->main.ctx);
+}
+
+static inline uint64_t
+acl_incr_field_value(const union rte_acl_field_types *val, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return val->u8;
+	case sizeof(uint16_t):
+		return val->u16;
+	case sizeof(uint32_t):
+		return val->u32;
+	default:
+		return val->u64;
+	}
+}
+
+/*
+ * Check whether some input could match both rules.
+ */
+static int
+acl_incr_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	const struct rte_acl_field *f1, *f2;
+	uint64_t m, m1, m2, v1, v2;
+	uint32_t i, size;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		size = cfg->defs[i].size;
+		f1 = r1->field + cfg->defs[i].field_index;
+		f2 = r2->field + cfg->defs[i].field_index;
+		v1 = acl_incr_field_value(&f1->value, size);
+		v2 = acl_incr_field_value(&f2->value, size);
+		m1 = acl_incr_field_value(&f1->mask_range, size);
+		m2 = acl_incr_field_value(&f2->mask_range, size);
+
+		switch (cfg->defs[i].type) {
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (v1 > m2 || v2 > m1)
+				return 0;
+			continue;
+		case RTE_ACL_FIELD_TYPE_BITMASK:
+			m = m1 & m2;
+			break;
+		default:
+			m = RTE_ACL_MASKLEN_TO_BITMASK(RTE_MIN(m1, m2), size);
+			break;
+		}
+
+		if (((v1 ^ v2) & m) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Check whether a live rule of the main trie could be hidden
+ * by one of the tombstones.
+ */
+static int
+acl_incr_rule_hidden(const struct rte_acl_ctx *ctx, uint32_t idx,
+	const uint32_t *tomb, uint32_t num_tomb)
+{
+	const struct rte_acl_rule *rule, *del;
+	uint32_t i;
+
+	rule = acl_incr_rule(ctx, idx);
+
+	for (i = 0; i != num_tomb; i++) {
+		del = acl_incr_rule(ctx, tomb[i]);
+		if (rule->data.priority <= del->data.priority &&
+				(rule->data.category_mask &
+				del->data.category_mask) != 0 &&
+				acl_incr_rule_overlap(&ctx->incr->cfg,
+				rule, del))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Rebuild the delta trie from the current state of the rules
+ * and publish it, along with the current main trie.
+ * Called with the lock held.
+ */
+static int
+acl_incr_update(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr *incr;
+	struct acl_incr_view *view;
+	struct acl_incr_slot *slot;
+	uint32_t i, n, num_added, num_delta, num_tomb, *idx, *tomb;
+	int32_t rc;
+
+	incr = ctx->incr;
+	slot = incr->slot;
+	n = ctx->num_rules;
+
+	idx = rte_malloc(NULL, 2 * RTE_MAX(n, 1U) * sizeof(idx[0]), 0);
+	view = rte_zmalloc_socket(ctx->name, sizeof(*view),
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (idx == NULL || view == NULL) {
+		rte_free(idx);
+		rte_free(view);
+		return -ENOMEM;
+	}
+	tomb = idx + n;
+
+	view->main = incr->main;
+
+	num_tomb = 0;
+	for (i = 0; i != n; i++) {
+		if (slot[i].deleted != 0 && slot[i].main_id != 0)
+			tomb[num_tomb++] = i;
+	}
+
+	if (num_tomb != 0) {
+		view->main_del = rte_zmalloc_socket(NULL,
+			ACL_RULE_BITMAP_SZ(incr->main.ctx->num_rules), 0,
+			ctx->socket_id);
+		if (view->main_del == NULL) {
+			rc = -ENOMEM;
+			goto err;
+		}
+		for (i = 0; i != num_tomb; i++)
+			ACL_RULE_BITMAP_SET(view->main_del,
+				slot[tomb[i]].main_id - 1);
+	}
+
+	num_added = 0;
+	num_delta = 0;
+	for (i = 0; i != n; i++) {
+		if (slot[i].deleted != 0)
+			continue;
+		if (slot[i].main_id == 0) {
+			idx[num_delta++] = i;
+			num_added++;
+		} else if (num_tomb != 0 &&
+				acl_incr_rule_hidden(ctx, i, tomb, num_tomb))
+			idx[num_delta++] = i;
+	}
+
+	if (num_delta != 0) {
+		rc = acl_incr_trie_init(ctx, idx, num_delta, &view->delta);
+		if (rc == 0)
+			rc = acl_incr_trie_build(&view->delta, &incr->cfg);
+		if (rc != 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): failed to build delta trie "
+				"of %u rules, error code: %d\n",
+				__func__, ctx->name, num_delta, rc);
+			goto err;
+		}
+	}
+
+	rte_free(idx);
+
+	incr->num_delta = num_delta;
+	incr->num_added = num_added;
+	incr->num_deleted = num_tomb;
+	acl_incr_publish(incr, view);
+	return 0;
+
+err:
+	rte_free(idx);
+	acl_incr_view_free(view, 0);
+	return rc;
+}
+
+/*
+ * Remove the deleted rules which are in none of the main tries.
+ * Called with the lock held.
+ */
+static void
+acl_incr_pack(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr_slot *slot;
+	uint8_t *pos;
+	uint32_t i, n;
+
+	slot = ctx->incr->slot;
+	pos = ctx->rules;
+
+	for (i = 0, n = 0; i != ctx->num_rules; i++) {
+		if (slot[i].deleted != 0 && slot[i].main_id == 0 &&
+				slot[i].snap_id == 0)
+			continue;
+		if (i != n) {
+			memcpy(pos + n * ctx->rule_sz, pos + i * ctx->rule_sz,
+				ctx->rule_sz);
+			slot[n] = slot[i];
+		}
+		n++;
+	}
+
+	ctx->num_rules = n;
+}
+
+int
+acl_incr_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	struct acl_incr *incr;
+	uint32_t n;
+	int32_t rc;
+
+	incr = ctx->incr;
+
+	rte_spinlock_lock(&incr->lock);
+
+	n = ctx->num_rules;
+	if (num + n > ctx->max_rules) {
+		rte_spinlock_unlock(&incr->lock);
+		return -ENOMEM;
+	}
+
+	memcpy((uint8_t *)ctx->rules + n * ctx->rule_sz, rules,
+		num * ctx->rule_sz);
+	memset(incr->slot + n, 0, num * sizeof(incr->slot[0]));
+	ctx->num_rules += num;
+
+	rc = acl_incr_update(ctx);
+	if (rc != 0)
+		ctx->num_rules = n;
+
+	rte_spinlock_unlock(&incr->lock);
+	return rc;
+}
+
+int
+acl_incr_del_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	struct acl_incr *incr;
+	uint64_t *mark;
+	uint32_t i;
+	int32_t rc;
+
+	incr = ctx->incr;
+
+	rte_spinlock_lock(&incr->lock);
+
+	mark = rte_zmalloc(NULL, ACL_RULE_BITMAP_SZ(ctx->num_rules + 1), 0);
+	if (mark == NULL) {
+		rte_spinlock_unlock(&incr->lock);
+		return -ENOMEM;
+	}
+
+	/* tombstones can't be deleted again. */
+	for (i = 0; i != ctx->num_rules; i++) {
+		if (incr->slot[i].deleted != 0)
+			ACL_RULE_BITMAP_SET(mark, i);
+	}
+
+	rc = acl_find_rules(ctx, rules, num, mark);
+	if (rc == 0) {
+		for (i = 0; i != ctx->num_rules; i++) {
+			if (ACL_RULE_BITMAP_TEST(mark, i) &&
+					incr->slot[i].deleted == 0)
+				incr->slot[i].deleted = 2;
+		}
+
+		rc = acl_incr_update(ctx);
+
+		/* commit or roll back the deletion. */
+		for (i = 0; i != ctx->num_rules; i++) {
+			if (incr->slot[i].deleted == 2)
+				incr->slot[i].deleted = (rc == 0);
+		}
+
+		if (rc == 0)
+			acl_incr_pack(ctx);
+	}
+
+	rte_free(mark);
+	rte_spinlock_unlock(&incr->lock);
+	return rc;
+}
+
+int
+acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify)
+{
+	const struct acl_incr_view *view;
+	const struct acl_incr_res *res;
+	uint32_t dres[ACL_INCR_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t i, k, m, n, r, *mres;
+	int32_t rc;
+
+	view = __atomic_load_n(&ctx->incr->view, __ATOMIC_ACQUIRE);
+
+	rc = classify(view->main.ctx, data, results, num, categories);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_INCR_BURST);
+		m = n * categories;
+		mres = results + i * categories;
+
+		if (view->delta.ctx != NULL) {
+			rc = classify(view->delta.ctx, data + i, dres, n,
+				categories);
+			if (rc != 0)
+				return rc;
+		}
+
+		for (k = 0; k != m; k++) {
+			res = NULL;
+			r = mres[k];
+			if (r != 0 && (view->main_del == NULL ||
+					!ACL_RULE_BITMAP_TEST(view->main_del,
+					r - 1)))
+				res = view->main.res + r - 1;
+
+			r = (view->delta.ctx != NULL) ? dres[k] : 0;
+			if (r != 0 && (res == NULL ||
+					view->delta.res[r - 1].priority >
+					res->priority))
+				res = view->delta.res + r - 1;
+
+			mres[k] = (res != NULL) ? res->userdata : 0;
+		}
+	}
+
+	return 0;
+}
+
+int
+rte_acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_incr_config *icfg)
+{
+	struct acl_incr *incr;
+	uint32_t i, *idx;
+	int32_t rc;
+
+	if (ctx == NULL || cfg == NULL || 0 == ctx->rule_sz)
+		return -EINVAL;
+
+	/* start over from the live rules. */
+	acl_incr_free(ctx);
+
+	incr = rte_zmalloc_socket(ctx->name, sizeof(*incr),
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (incr == NULL)
+		return -ENOMEM;
+
+	incr->slot = rte_zmalloc_socket(NULL,
+		RTE_MAX(ctx->max_rules, 1U) * sizeof(incr->slot[0]), 0,
+		ctx->socket_id);
+	idx = rte_malloc(NULL, RTE_MAX(ctx->num_rules, 1U) * sizeof(idx[0]), 0);
+	if (incr->slot == NULL || idx == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	incr->cfg = *cfg;
+	incr->v = (icfg != NULL) ? icfg->v : NULL;
+	rte_spinlock_init(&incr->lock);
+
+	for (i = 0; i != ctx->num_rules; i++) {
+		idx[i] = i;
+		incr->slot[i].main_id = i + 1;
+	}
+
+	rc = acl_incr_trie_init(ctx, idx, ctx->num_rules, &incr->main);
+	rte_free(idx);
+	idx = NULL;
+	if (rc != 0)
+		goto err;
+
+	rc = acl_incr_trie_build(&incr->main, cfg);
+	if (rc != 0)
+		goto err;
+
+	ctx->incr = incr;
+	rc = acl_incr_update(ctx);
+	if (rc != 0) {
+		ctx->incr = NULL;
+		goto err;
+	}
+
+	/* the context itself is not looked up anymore. */
+	acl_build_reset(ctx);
+	ctx->num_categories = cfg->num_categories;
+	ctx->config = *cfg;
+
+	return 0;
+
+err:
+	rte_free(idx);
+	acl_incr_trie_free(&incr->main);
+	rte_free(incr->slot);
+	rte_free(incr);
+	return rc;
+}
+
+int
+rte_acl_incr_compact(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr *incr;
+	struct acl_incr_trie main, old;
+	uint32_t i, n, *idx;
+	int32_t rc;
+
+	if (ctx == NULL || ctx->incr == NULL)
+		return -EINVAL;
+
+	incr = ctx->incr;
+
+	rte_spinlock_lock(&incr->lock);
+
+	if (incr->compacting != 0) {
+		rte_spinlock_unlock(&incr->lock);
+		return -EBUSY;
+	}
+
+	/* take a snapshot of the live rules. */
+	idx = rte_malloc(NULL, RTE_MAX(ctx->num_rules, 1U) * sizeof(idx[0]), 0);
+	if (idx == NULL) {
+		rte_spinlock_unlock(&incr->lock);
+		return -ENOMEM;
+	}
+
+	for (i = 0, n = 0; i != ctx->num_rules; i++) {
+		if (incr->slot[i].deleted == 0) {
+			idx[n] = i;
+			incr->slot[i].snap_id = ++n;
+		}
+	}
+
+	rc = acl_incr_trie_init(ctx, idx, n, &main);
+	rte_free(idx);
+	if (rc != 0) {
+		for (i = 0; i != ctx->num_rules; i++)
+			incr->slot[i].snap_id = 0;
+		rte_spinlock_unlock(&incr->lock);
+		return rc;
+	}
+
+	incr->compacting = 1;
+	rte_spinlock_unlock(&incr->lock);
+
+	/* build the new main trie while the updates go on. */
+	rc = acl_incr_trie_build(&main, &incr->cfg);
+
+	rte_spinlock_lock(&incr->lock);
+	incr->compacting = 0;
+
+	idx = NULL;
+	if (rc == 0) {
+		idx = rte_malloc(NULL,
+			RTE_MAX(ctx->num_rules, 1U) * sizeof(idx[0]), 0);
+		if (idx == NULL)
+			rc = -ENOMEM;
+	}
+
+	if (rc == 0) {
+		/* switch the rules to the new main trie. */
+		for (i = 0; i != ctx->num_rules; i++) {
+			idx[i] = incr->slot[i].main_id;
+			incr->slot[i].main_id = incr->slot[i].snap_id;
+		}
+		old = incr->main;
+		incr->main = main;
+
+		rc = acl_incr_update(ctx);
+		if (rc != 0) {
+			for (i = 0; i != ctx->num_rules; i++)
+				incr->slot[i].main_id = idx[i];
+			incr->main = old;
+		}
+	}
+
+	for (i = 0; i != ctx->num_rules; i++)
+		incr->slot[i].snap_id = 0;
+
+	if (rc == 0)
+		acl_incr_pack(ctx);
+	else
+		acl_incr_trie_free(&main);
+
+	rte_free(idx);
+	rte_spinlock_unlock(&incr->lock);
+	return rc;
+}
+
+int
+rte_acl_incr_stats_get(struct rte_acl_ctx *ctx,
+	struct rte_acl_incr_stats *stats)
+{
+	struct acl_incr *incr;
+
+	if (ctx == NULL || ctx->incr == NULL || stats == NULL)
+		return -EINVAL;
+
+	incr = ctx->incr;
+
+	rte_spinlock_lock(&incr->lock);
+	stats->main_rules = incr->main.ctx->num_rules;
+	stats->delta_rules = incr->num_delta;
+	stats->added_rules = incr->num_added;
+	stats->deleted_rules = incr->num_deleted;
+	rte_spinlock_unlock(&incr->lock);
+
+	return 0;
+}
+
+/*
+ * Leave the incremental update mode, dropping the tombstones
+ * from the rules of the context.
+ */
+void
+acl_incr_free(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr *incr;
+	uint32_t i;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	for (i = 0; i != ctx->num_rules; i++) {
+		incr->slot[i].main_id = 0;
+		incr->slot[i].snap_id = 0;
+	}
+	acl_incr_pack(ctx);
+
+	if (incr->v != NULL)
+		rte_rcu_qsbr_synchronize(incr->v, RTE_QSBR_THRID_INVALID);
+
+	acl_incr_view_free(incr->view, 1);
+	rte_free(incr->slot);
+	rte_free(incr);
+	ctx->incr = NULL;
+}
+
+void
+acl_incr_dump(const struct rte_acl_ctx *ctx)
+{
+	const struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	printf("  incremental mode: main_rules=%"PRIu32
+		", delta_rules=%"PRIu32", added_rules=%"PRIu32
+		", deleted_rules=%"PRIu32"\n",
+		incr->main.ctx->num_rules, incr->num_delta,
+		incr->num_added, incr->num_deleted);
+}
@@ -295,6 +295,10 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	if (ctx->incr != NULL)
+		return acl_incr_classify(ctx, data, results, num, categories,
+			classify_fns[alg]);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -357,6 +361,7 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_incr_free(ctx);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -480,9 +485,78 @@ rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 		}
 	}
 
+	if (ctx->incr != NULL)
+		return acl_incr_add_rules(ctx, rules, num);
+
 	return acl_add_rules(ctx, rules, num);
 }
 
+/*
+ * For each of the given rules, find the first rule of the context with
+ * the same content which is not marked yet, and mark it.
+ */
+int
+acl_find_rules(const struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num, uint64_t *mark)
+{
+	const uint8_t *pos;
+	uint32_t i, j;
+
+	for (i = 0; i != num; i++) {
+		pos = (const uint8_t *)rules + i * ctx->rule_sz;
+		for (j = 0; j != ctx->num_rules; j++) {
+			if (!ACL_RULE_BITMAP_TEST(mark, j) &&
+					memcmp((const uint8_t *)ctx->rules +
+					j * ctx->rule_sz, pos,
+					ctx->rule_sz) == 0)
+				break;
+		}
+		if (j == ctx->num_rules)
+			return -ENOENT;
+		ACL_RULE_BITMAP_SET(mark, j);
+	}
+
+	return 0;
+}
+
+int
+rte_acl_del_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	uint8_t *pos;
+	uint64_t *mark;
+	uint32_t i, n;
+	int32_t rc;
+
+	if (ctx == NULL || rules == NULL || 0 == ctx->rule_sz)
+		return -EINVAL;
+
+	if (ctx->incr != NULL)
+		return acl_incr_del_rules(ctx, rules, num);
+
+	mark = rte_zmalloc(NULL, ACL_RULE_BITMAP_SZ(ctx->num_rules + 1), 0);
+	if (mark == NULL)
+		return -ENOMEM;
+
+	rc = acl_find_rules(ctx, rules, num, mark);
+	if (rc == 0) {
+		/* remove marked rules, keeping the others in order. */
+		pos = ctx->rules;
+		for (i = 0, n = 0; i != ctx->num_rules; i++) {
+			if (ACL_RULE_BITMAP_TEST(mark, i))
+				continue;
+			if (i != n)
+				memcpy(pos + n * ctx->rule_sz,
+					pos + i * ctx->rule_sz, ctx->rule_sz);
+			n++;
+		}
+		ctx->num_rules = n;
+	}
+
+	rte_free(mark);
+	return rc;
+}
+
 /*
  * Reset all rules.
  * Note that RT structures are not affected.
@@ -490,8 +564,10 @@ rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 void
 rte_acl_reset_rules(struct rte_acl_ctx *ctx)
 {
-	if (ctx != NULL)
+	if (ctx != NULL) {
+		acl_incr_free(ctx);
 		ctx->num_rules = 0;
+	}
 }
 
 /*
@@ -523,6 +599,12 @@ rte_acl_dump(const struct rte_acl_ctx *ctx)
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
 	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
 	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
+	printf("  build_time_us=%"PRIu64"\n", ctx->bld_stats.time_us);
+	printf("  build_mem_sz=%zu\n", ctx->bld_stats.mem_sz);
+	printf("  build_nodes=%"PRIu32"\n", ctx->bld_stats.num_nodes);
+	printf("  build_threads=%"PRIu32"\n", ctx->bld_stats.num_threads);
+	printf("  build_node_max=%"PRIu32"\n", ctx->bld_stats.node_max);
+	acl_incr_dump(ctx);
 }
 
 /*
@@ -12,6 +12,8 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -172,7 +174,9 @@ rte_acl_free(struct rte_acl_ctx *ctx);
 
 /**
  * Add rules to an existing ACL context.
- * This function is not multi-thread safe.
+ * In incremental mode, see rte_acl_incr_build(), the rules
+ * take effect at once.
+ * This function is not multi-thread safe, unless in incremental mode.
  *
  * @param ctx
  *   ACL context to add patterns to.
@@ -193,10 +197,40 @@ int
 rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 	uint32_t num);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an existing ACL context.
+ * Each rule is matched against the rules of the context by its
+ * binary content, i.e. it has to be exactly the same as the one added.
+ * Either all the rules are deleted, or none of them.
+ * The rules are taken out of the run-time structures by the next
+ * rte_acl_build(), or at once in incremental mode, see rte_acl_incr_build().
+ * This function is not multi-thread safe, unless in incremental mode.
+ *
+ * @param ctx
+ *   ACL context to delete rules from.
+ * @param rules
+ *   Array of rules to delete from the ACL context.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOENT if one of the rules is not in the ACL context.
+ *   - -ENOMEM if memory allocation failed.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_del_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num);
+
 /**
  * Delete all rules from the ACL context.
  * This function is not multi-thread safe.
- * Note that internal run-time structures are not affected.
+ * Note that internal run-time structures are not affected,
+ * except in incremental mode, which is left.
  *
  * @param ctx
  *   ACL context to delete rules from.
@@ -221,6 +255,46 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/** Threads to run a parallel build on. */
+struct rte_acl_build_param {
+	const unsigned int *lcores;
+	/**< Worker lcores, in WAIT state, to launch the build on. */
+	uint32_t num_lcores;  /**< Number of worker lcores. */
+	uint32_t num_threads; /**< Number of control threads to create. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Analyze set of rules and build required internal run-time structures,
+ * as rte_acl_build() does, spreading the work over several threads.
+ * The rule set is split into tries on the calling thread, while each
+ * trie split from it is built on one of the workers, so that extra
+ * workers beyond the number of tries are left idle.
+ * The workers are the given lcores, launched with rte_eal_remote_launch()
+ * (so this function must then be called from the main lcore),
+ * and control threads created for the build.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param prm
+ *   Pointer to struct rte_acl_build_param - defines the build workers.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -232,6 +306,103 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 void
 rte_acl_reset(struct rte_acl_ctx *ctx);
 
+/** Incremental update configuration structure. */
+struct rte_acl_incr_config {
+	/**
+	 * RCU QSBR variable of the classifying threads.
+	 * If not NULL, the run-time structures replaced by an update
+	 * are freed once these threads went through a quiescent state,
+	 * so that updates can run concurrently with rte_acl_classify().
+	 * If NULL, they are freed at once and the caller has to make sure
+	 * that no classification is in progress during the updates.
+	 */
+	struct rte_rcu_qsbr *v;
+};
+
+/** Incremental update statistics. */
+struct rte_acl_incr_stats {
+	uint32_t main_rules;    /**< Rules in the main trie. */
+	uint32_t delta_rules;   /**< Rules in the delta trie. */
+	uint32_t added_rules;   /**< Rules added since last compaction. */
+	uint32_t deleted_rules; /**< Rules deleted since last compaction. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Build the ACL context in incremental update mode.
+ * The rules of the context are built into a main trie, as done by
+ * rte_acl_build(). From then on, rte_acl_add_rules() and rte_acl_del_rules()
+ * take effect at once: the updated rules are built into a small delta trie,
+ * which rte_acl_classify() looks up along with the main trie.
+ * The delta trie grows with the updates, rte_acl_incr_compact() merges it
+ * back into the main trie.
+ * A call to rte_acl_build(), rte_acl_reset() or rte_acl_reset_rules()
+ * leaves the incremental update mode.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param icfg
+ *   Pointer to struct rte_acl_incr_config - defines update parameters,
+ *   NULL for the defaults.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_incr_config *icfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Merge the delta trie of an ACL context in incremental update mode into
+ * a new main trie.
+ * The new main trie is built from a snapshot of the rules, while rule
+ * updates can still go on from other threads; they are carried over
+ * to the delta trie of the new main trie.
+ *
+ * @param ctx
+ *   ACL context to compact.
+ * @return
+ *   - -EBUSY if a compaction is already in progress.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_compact(struct rte_acl_ctx *ctx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the incremental update statistics of an ACL context,
+ * e.g. to decide when to call rte_acl_incr_compact().
+ *
+ * @param ctx
+ *   ACL context in incremental update mode.
+ * @param stats
+ *   Statistics to fill.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_stats_get(struct rte_acl_ctx *ctx,
+	struct rte_acl_incr_stats *stats);
+
 /**
  *  Available implementations of ACL classify.
  */
@@ -341,7 +512,8 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
 /**
- * Dump an ACL context structure to the console.
+ * Dump an ACL context structure to the console,
+ * along with the statistics of its last build.
  *
  * @param ctx
  *   ACL context to dump.
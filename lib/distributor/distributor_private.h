@@ -62,6 +62,9 @@ union rte_distributor_buffer_single {
  */
 #define RTE_DIST_BURST_SIZE 8
 
+/* Multiplier of the tag hash used with static flow affinity */
+#define RTE_DIST_TAG_HASH_MULT 2654435761u
+
 struct rte_distributor_backlog {
 	unsigned int start;
 	unsigned int count;
@@ -101,6 +104,8 @@ struct rte_distributor_single {
 enum rte_distributor_match_function {
 	RTE_DIST_MATCH_SCALAR = 0,
 	RTE_DIST_MATCH_VECTOR,
+	RTE_DIST_MATCH_AVX2,
+	RTE_DIST_MATCH_AVX512,
 	RTE_DIST_NUM_MATCH_FNS
 };
 
@@ -150,6 +155,8 @@ struct rte_distributor {
 
 	enum rte_distributor_match_function dist_match_fn;
 
+	unsigned int affinity;                /**< Flow to worker affinity */
+
 	struct rte_distributor_single *d_single;
 
 	uint8_t active[RTE_DISTRIB_MAX_WORKERS];
@@ -166,4 +173,14 @@ find_match_vec(struct rte_distributor *d,
 			uint16_t *data_ptr,
 			uint16_t *output_ptr);
 
+void
+find_match_vec_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
+void
+find_match_vec_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
 #endif /* _DIST_PRIV_H_ */
@@ -7,6 +7,7 @@
 #include <sys/queue.h>
 #include <string.h>
 #include <rte_mbuf.h>
+#include <rte_cpuflags.h>
 #include <rte_cycles.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
@@ -278,6 +279,55 @@ find_match_scalar(struct rte_distributor *d,
 	 */
 }
 
+/*
+ * With static affinity the worker of a flow is selected by a hash of its
+ * tag, instead of by matching the tags inflight on the workers, so that all
+ * the distributors sharing a set of workers send a flow to the same worker.
+ * If that worker has stopped requesting packets, the flow goes to the next
+ * active worker.
+ */
+static void
+find_match_static(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	unsigned int j, w;
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		/* Scale the multiplicative hash of the tag to the workers */
+		w = ((uint64_t)(uint32_t)(data_ptr[j] * RTE_DIST_TAG_HASH_MULT) *
+				d->num_workers) >> 32;
+		while (unlikely(!d->active[w]))
+			w = (w + 1) % d->num_workers;
+		output_ptr[j] = w + 1;
+	}
+}
+
+/* match the flow_ids with the function selected at creation */
+static inline void
+find_match(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	switch (d->dist_match_fn) {
+	case RTE_DIST_MATCH_VECTOR:
+		find_match_vec(d, data_ptr, output_ptr);
+		break;
+#ifdef CC_DISTRIBUTOR_AVX2_SUPPORT
+	case RTE_DIST_MATCH_AVX2:
+		find_match_vec_avx2(d, data_ptr, output_ptr);
+		break;
+#endif
+#ifdef CC_DISTRIBUTOR_AVX512_SUPPORT
+	case RTE_DIST_MATCH_AVX512:
+		find_match_vec_avx512(d, data_ptr, output_ptr);
+		break;
+#endif
+	default:
+		find_match_scalar(d, data_ptr, output_ptr);
+	}
+}
+
 /*
  * When worker called rte_distributor_return_pkt()
  * and passed RTE_DISTRIB_RETURN_BUF handshake through retptr64,
@@ -409,6 +459,16 @@ release(struct rte_distributor *d, unsigned int wkr)
 		handle_returns(d, wkr);
 		if (unlikely(!d->active[wkr]))
 			return 0;
+		/*
+		 * With static affinity the worker may be serving another
+		 * distributor, itself waiting for a worker which waits for
+		 * this distributor to take its returns. Take the returns of
+		 * all the workers, so that none of them waits for us.
+		 */
+		if (d->affinity == RTE_DIST_AFFINITY_STATIC)
+			for (i = 0; i < d->num_workers; i++)
+				if (i != wkr)
+					handle_returns(d, i);
 		rte_pause();
 	}
 
@@ -502,15 +562,11 @@ rte_distributor_process(struct rte_distributor *d,
 				return next_idx;
 
 			if (unlikely(matching_required)) {
-				switch (d->dist_match_fn) {
-				case RTE_DIST_MATCH_VECTOR:
-					find_match_vec(d, &flows[0],
+				if (d->affinity == RTE_DIST_AFFINITY_STATIC)
+					find_match_static(d, &flows[0],
 						&matches[0]);
-					break;
-				default:
-					find_match_scalar(d, &flows[0],
-						&matches[0]);
-				}
+				else
+					find_match(d, &flows[0], &matches[0]);
 				matching_required = 0;
 			}
 		/*
@@ -592,7 +648,12 @@ rte_distributor_process(struct rte_distributor *d,
 						matches[w] = wkr+1;
 			}
 		}
-		wkr = (wkr + 1) % d->num_workers;
+		/*
+		 * The round-robin worker is shared by all the instances,
+		 * leave it to the ones using it.
+		 */
+		if (d->affinity != RTE_DIST_AFFINITY_STATIC)
+			wkr = (wkr + 1) % d->num_workers;
 	}
 
 	/* Flush out all non-full cache-lines to workers. */
@@ -764,7 +825,19 @@ rte_distributor_create(const char *name,
 #if defined(RTE_ARCH_X86)
 	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
 		d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
+#ifdef CC_DISTRIBUTOR_AVX2_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX2;
+#endif
+#ifdef CC_DISTRIBUTOR_AVX512_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX512;
+#endif
 #endif
+	d->affinity = RTE_DIST_AFFINITY_DYNAMIC;
 
 	/*
 	 * Set up the backlog tags so they're pointing at the second cache
@@ -786,3 +859,23 @@ rte_distributor_create(const char *name,
 
 	return d;
 }
+
+int
+rte_distributor_affinity_set(struct rte_distributor *d,
+		enum rte_distributor_affinity affinity)
+{
+	if (d == NULL || d->alg_type != RTE_DIST_ALG_BURST)
+		return -EINVAL;
+
+	if (affinity != RTE_DIST_AFFINITY_DYNAMIC &&
+			affinity != RTE_DIST_AFFINITY_STATIC)
+		return -EINVAL;
+
+	/* The inflight packets were distributed with the former affinity */
+	if (total_outstanding(d) > 0)
+		return -EBUSY;
+
+	d->affinity = affinity;
+
+	return 0;
+}
@@ -13,6 +13,8 @@
  * one-at-a-time to workers, with dynamic load balancing.
  */
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,6 +26,21 @@ enum rte_distributor_alg_type {
 	RTE_DIST_NUM_ALG_TYPES
 };
 
+/* Flow to worker affinity of a burst distributor */
+enum rte_distributor_affinity {
+	/**
+	 * A flow is pinned to the worker processing its packets, while it has
+	 * packets inflight or queued for that worker. Otherwise its packets go
+	 * to any worker (default).
+	 */
+	RTE_DIST_AFFINITY_DYNAMIC = 0,
+	/**
+	 * A flow is always sent to the worker selected by a hash of its tag,
+	 * or to the next active worker if that one does not request packets.
+	 */
+	RTE_DIST_AFFINITY_STATIC,
+};
+
 struct rte_distributor;
 struct rte_mbuf;
 
@@ -52,6 +69,39 @@ rte_distributor_create(const char *name, unsigned int socket_id,
 		unsigned int num_workers,
 		unsigned int alg_type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the flow to worker affinity of a burst distributor.
+ *
+ * With the static affinity, the worker of a packet depends only on its tag
+ * and on the number of workers, so several distributor instances, each one
+ * running on its own distributor lcore, can share the same worker lcores:
+ * every worker uses the same worker id with all the distributors, and polls
+ * all of them with rte_distributor_request_pkt() and
+ * rte_distributor_poll_pkt(). As long as the distributors are created with
+ * the same number of workers, they send the packets of a flow to the same
+ * worker, which processes them in the order each distributor received them.
+ *
+ * This must be called while the distributor has no packets inflight,
+ * typically before the first call to rte_distributor_process().
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param affinity
+ *   The flow to worker affinity, RTE_DIST_AFFINITY_DYNAMIC by default.
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the distributor does not use the burst API,
+ *     or if the affinity is invalid
+ *   - -EBUSY if the distributor has packets inflight
+ */
+__rte_experimental
+int
+rte_distributor_affinity_set(struct rte_distributor *d,
+		enum rte_distributor_affinity affinity);
+
 /*  *** APIS to be called on the distributor lcore ***  */
 /*
  * The following APIs are the public APIs which are designed for use on a
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "distributor_private.h"
+
+/*
+ * Compare the incoming flow ids with the 16 tags of a worker, rotated
+ * by n tags within each 128-bit lane.
+ */
+#define MATCH_ROTATED(acc, fids, tags, n) \
+	((acc) = _mm256_or_si256((acc), _mm256_cmpeq_epi16((fids), \
+		_mm256_alignr_epi8((tags), (tags), 2 * (n)))))
+
+void
+find_match_vec_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m256i incoming_fids;
+	__m256i tags;
+	__m256i match;
+	__m128i mask;
+	__m128i output;
+	uint16_t i;
+
+	/*
+	 * Function overview:
+	 * 1. Load the incoming flow ids in both 128-bit lanes of a ymm reg
+	 * 2. Loop through all worker ID's
+	 *  2a. Load the inflights and the backlog of the worker, which are
+	 *      contiguous, into a ymm reg
+	 *  2b. Compare the incoming flow ids with the 8 rotations of
+	 *      both lanes, so each incoming flow id meets all 16 tags
+	 *  2c. Fold the two lanes and set the worker ID in the output
+	 *      where there's a match
+	 * 3. Write the output xmm (matching worker ids).
+	 */
+
+	output = _mm_setzero_si128();
+	incoming_fids = _mm256_broadcastsi128_si256(
+			_mm_load_si128((__m128i *)data_ptr));
+
+	for (i = 0; i < d->num_workers; i++) {
+		tags = _mm256_load_si256((__m256i *)d->in_flight_tags[i]);
+
+		match = _mm256_cmpeq_epi16(incoming_fids, tags);
+		MATCH_ROTATED(match, incoming_fids, tags, 1);
+		MATCH_ROTATED(match, incoming_fids, tags, 2);
+		MATCH_ROTATED(match, incoming_fids, tags, 3);
+		MATCH_ROTATED(match, incoming_fids, tags, 4);
+		MATCH_ROTATED(match, incoming_fids, tags, 5);
+		MATCH_ROTATED(match, incoming_fids, tags, 6);
+		MATCH_ROTATED(match, incoming_fids, tags, 7);
+
+		/*
+		 * The low lane holds the matches against the inflights,
+		 * the high lane the matches against the backlog.
+		 */
+		mask = _mm_or_si128(_mm256_castsi256_si128(match),
+				_mm256_extracti128_si256(match, 1));
+
+		/* As in the scalar version, the last matching worker wins */
+		output = _mm_blendv_epi8(output, _mm_set1_epi16(i + 1), mask);
+	}
+
+	/*
+	 * At this stage, the output 128-bit contains 8 16-bit values, with
+	 * each non-zero value containing the worker ID on which the
+	 * corresponding flow is pinned to.
+	 */
+	_mm_store_si128((__m128i *)output_ptr, output);
+}
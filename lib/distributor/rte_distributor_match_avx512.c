@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "distributor_private.h"
+
+/* Rotate the 8 16-bit values of each 128-bit lane by n values */
+#define ROTATE_LANES(v, n) _mm512_alignr_epi8((v), (v), 2 * (n))
+
+/*
+ * Set the worker ID of the tags matching the incoming flow ids rotated by
+ * n, in the output for the rotation n.
+ */
+#define MATCH_ROTATED(out, fids, tags, wkr, valid, n) \
+	((out)[n] = _mm512_mask_mov_epi16((out)[n], \
+		_mm512_mask_cmpeq_epi16_mask((valid), (fids)[n], (tags)), (wkr)))
+
+void
+find_match_vec_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m512i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m512i output[RTE_DIST_BURST_SIZE];
+	__m512i tags;
+	__m512i wkr;
+	__m256i out256;
+	__m128i out128;
+	__mmask32 valid;
+	unsigned int i;
+
+	/*
+	 * Function overview:
+	 * 1. Load the incoming flow ids in the four 128-bit lanes of a zmm
+	 *    reg, with the 8 rotations of the lanes in 8 zmm regs
+	 * 2. Loop through the worker ID's, two at a time
+	 *  2a. Load the inflights and the backlog of both workers, which are
+	 *      contiguous, into a zmm reg
+	 *  2b. Compare them with each rotation of the incoming flow ids, so
+	 *      each incoming flow id meets all 32 tags, and set the worker
+	 *      ID of the matching tags in the output of the rotation
+	 * 3. Rotate back the outputs and keep the highest worker ID of each
+	 *    incoming flow id, i.e. the last matching worker as in the
+	 *    scalar version
+	 * 4. Write the output xmm (matching worker ids).
+	 */
+
+	incoming_fids[0] = _mm512_broadcast_i32x4(
+			_mm_load_si128((__m128i *)data_ptr));
+	incoming_fids[1] = ROTATE_LANES(incoming_fids[0], 1);
+	incoming_fids[2] = ROTATE_LANES(incoming_fids[0], 2);
+	incoming_fids[3] = ROTATE_LANES(incoming_fids[0], 3);
+	incoming_fids[4] = ROTATE_LANES(incoming_fids[0], 4);
+	incoming_fids[5] = ROTATE_LANES(incoming_fids[0], 5);
+	incoming_fids[6] = ROTATE_LANES(incoming_fids[0], 6);
+	incoming_fids[7] = ROTATE_LANES(incoming_fids[0], 7);
+
+	for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
+		output[i] = _mm512_setzero_si512();
+
+	/* worker ID of the first worker in the low 256-bit, then the next */
+	wkr = _mm512_inserti64x4(_mm512_set1_epi16(1), _mm256_set1_epi16(2), 1);
+	valid = UINT32_MAX;
+
+	/*
+	 * The tags array has a row per possible worker, and num_workers is
+	 * lower than RTE_DISTRIB_MAX_WORKERS, so the row following the last
+	 * worker can be read. Its matches are ignored.
+	 */
+	for (i = 0; i < d->num_workers; i += 2) {
+		tags = _mm512_load_si512((void *)d->in_flight_tags[i]);
+		if (i + 1 == d->num_workers)
+			valid = UINT16_MAX;
+
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 0);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 1);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 2);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 3);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 4);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 5);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 6);
+		MATCH_ROTATED(output, incoming_fids, tags, wkr, valid, 7);
+
+		wkr = _mm512_add_epi16(wkr, _mm512_set1_epi16(2));
+	}
+
+	/*
+	 * The value n of a lane in the output of rotation r is the match of
+	 * the incoming flow id n + r: rotate it back by 8 - r.
+	 */
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[1], 7));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[2], 6));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[3], 5));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[4], 4));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[5], 3));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[6], 2));
+	output[0] = _mm512_max_epu16(output[0], ROTATE_LANES(output[7], 1));
+
+	/* Fold the inflights and backlog lanes of both workers */
+	out256 = _mm256_max_epu16(_mm512_castsi512_si256(output[0]),
+			_mm512_extracti64x4_epi64(output[0], 1));
+	out128 = _mm_max_epu16(_mm256_castsi256_si128(out256),
+			_mm256_extracti128_si256(out256, 1));
+
+	/*
+	 * At this stage, the output 128-bit contains 8 16-bit values, with
+	 * each non-zero value containing the worker ID on which the
+	 * corresponding flow is pinned to.
+	 */
+	_mm_store_si128((__m128i *)output_ptr, out128);
+}
@@ -25,6 +25,7 @@
 #include "eal_internal_cfg.h"
 #include "eal_memcfg.h"
 #include "eal_options.h"
+#include "malloc_cache.h"
 #include "malloc_heap.h"
 
 /*
@@ -1126,6 +1127,7 @@ handle_eal_heap_info_request(const char *cmd __rte_unused, const char *params,
 {
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
 	struct rte_malloc_socket_stats sock_stats;
+	uint64_t cache_hit_count, cache_miss_count;
 	struct malloc_heap *heap;
 	unsigned int heap_id;
 
@@ -1137,6 +1139,7 @@ handle_eal_heap_info_request(const char *cmd __rte_unused, const char *params,
 	/* Get the heap stats of user provided heap id */
 	heap = &mcfg->malloc_heaps[heap_id];
 	malloc_heap_get_stats(heap, &sock_stats);
+	malloc_cache_get_stats(heap_id, &cache_hit_count, &cache_miss_count);
 
 	rte_tel_data_start_dict(d);
 	rte_tel_data_add_dict_uint(d, "Heap_id", heap_id);
@@ -1151,6 +1154,8 @@ handle_eal_heap_info_request(const char *cmd __rte_unused, const char *params,
 				   sock_stats.greatest_free_size);
 	rte_tel_data_add_dict_uint(d, "Alloc_count", sock_stats.alloc_count);
 	rte_tel_data_add_dict_uint(d, "Free_count", sock_stats.free_count);
+	rte_tel_data_add_dict_uint(d, "Cache_hit_count", cache_hit_count);
+	rte_tel_data_add_dict_uint(d, "Cache_miss_count", cache_miss_count);
 
 	return 0;
 }
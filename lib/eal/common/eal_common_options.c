@@ -104,6 +104,7 @@ eal_long_options[] = {
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
 	{OPT_HUGE_WORKER_STACK, 2, NULL, OPT_HUGE_WORKER_STACK_NUM     },
+	{OPT_MALLOC_CACHE,      0, NULL, OPT_MALLOC_CACHE_NUM     },
 
 	{0,                     0, NULL, 0                        }
 };
@@ -327,6 +328,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 		internal_cfg->hugepage_info[i].lock_descriptor = -1;
 	}
 	internal_cfg->base_virtaddr = 0;
+	internal_cfg->malloc_cache = 0;
 
 #ifdef LOG_DAEMON
 	internal_cfg->syslog_facility = LOG_DAEMON;
@@ -1914,6 +1916,9 @@ eal_parse_common_option(int opt, const char *optarg,
 	case OPT_NO_TELEMETRY_NUM:
 		conf->no_telemetry = 1;
 		break;
+	case OPT_MALLOC_CACHE_NUM:
+		conf->malloc_cache = 1;
+		break;
 	case OPT_FORCE_MAX_SIMD_BITWIDTH_NUM:
 		if (eal_parse_simd_bitwidth(optarg) < 0) {
 			RTE_LOG(ERR, EAL, "invalid parameter for --"
@@ -2232,6 +2237,7 @@ eal_common_usage(void)
 	       "  --"OPT_TELEMETRY"   Enable telemetry support (on by default)\n"
 	       "  --"OPT_NO_TELEMETRY"   Disable telemetry support\n"
 	       "  --"OPT_FORCE_MAX_SIMD_BITWIDTH" Force the max SIMD bitwidth\n"
+	       "  --"OPT_MALLOC_CACHE"      Enable per-lcore cache for small rte_malloc allocations\n"
 	       "\nEAL options for DEBUG use only:\n"
 	       "  --"OPT_HUGE_UNLINK"[=existing|always|never]\n"
 	       "                      When to unlink files in hugetlbfs\n"
@@ -0,0 +1,250 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_memory.h>
+
+#include "eal_internal_cfg.h"
+#include "eal_memcfg.h"
+#include "eal_private.h"
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+#include "malloc_cache.h"
+
+/*
+ * Small allocations are served from per-lcore magazines, one per native heap
+ * and power-of-two size class. Cached elements stay busy from the point of
+ * view of the heap, so a magazine can be refilled from, or flushed to, the
+ * heap in batches under a single acquisition of the heap lock.
+ */
+
+/* smallest size class, one cache line on most architectures */
+#define MALLOC_CACHE_MIN_SHIFT 6
+#define MALLOC_CACHE_MIN_SIZE (1U << MALLOC_CACHE_MIN_SHIFT)
+/* 64, 128, 256, 512, 1K, 2K and 4K byte classes */
+#define MALLOC_CACHE_NUM_CLASSES 7
+/* number of elements held by a magazine */
+#define MALLOC_CACHE_SIZE 32
+/* number of elements moved at once between a magazine and its heap */
+#define MALLOC_CACHE_BULK (MALLOC_CACHE_SIZE / 2)
+
+struct malloc_cache_class {
+	unsigned int len;
+	void *objs[MALLOC_CACHE_SIZE];
+};
+
+struct malloc_cache {
+	struct malloc_cache_class
+		classes[RTE_MAX_NUMA_NODES][MALLOC_CACHE_NUM_CLASSES];
+	uint64_t hit_count[RTE_MAX_NUMA_NODES];
+	uint64_t miss_count[RTE_MAX_NUMA_NODES];
+};
+
+static bool malloc_cache_enabled;
+
+/* process-local, allocated on first use by each lcore */
+static struct malloc_cache *malloc_caches[RTE_MAX_LCORE];
+
+static struct malloc_cache *
+malloc_cache_get(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_cache *cache;
+
+	/* unregistered non-EAL threads go straight to the heap */
+	if (lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	cache = malloc_caches[lcore_id];
+	if (cache == NULL) {
+		cache = calloc(1, sizeof(*cache));
+		malloc_caches[lcore_id] = cache;
+	}
+
+	return cache;
+}
+
+static void
+malloc_cache_flush(unsigned int heap_id, struct malloc_cache_class *c,
+		unsigned int n)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_elem *elems[MALLOC_CACHE_SIZE];
+	unsigned int i;
+
+	c->len -= n;
+	for (i = 0; i < n; i++) {
+		elems[i] = malloc_elem_from_data(c->objs[c->len + i]);
+		elems[i]->state = ELEM_BUSY;
+	}
+
+	if (malloc_heap_free_bulk(&mcfg->malloc_heaps[heap_id], elems, n) < 0)
+		RTE_LOG(ERR, EAL, "Error: Invalid memory in malloc cache\n");
+}
+
+void
+malloc_cache_init(void)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	if (!internal_conf->malloc_cache)
+		return;
+
+#if defined(RTE_MALLOC_DEBUG) || defined(RTE_MALLOC_ASAN)
+	RTE_LOG(NOTICE, EAL,
+		"Malloc cache is not available with malloc debugging, ignoring\n");
+#else
+	malloc_cache_enabled = true;
+#endif
+}
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket_arg)
+{
+	struct malloc_cache_class *c;
+	struct malloc_cache *cache;
+	struct malloc_elem *elem;
+	unsigned int idx, i;
+	int socket, heap_id;
+	void *ptr;
+
+	if (!malloc_cache_enabled || size > MALLOC_CACHE_MAX_SIZE ||
+			align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	socket = socket_arg == SOCKET_ID_ANY ? (int)rte_socket_id() : socket_arg;
+	if (socket == SOCKET_ID_ANY)
+		return NULL;
+
+	/* only native heaps are cached */
+	heap_id = malloc_socket_to_heap_id(socket);
+	if (heap_id < 0 || (unsigned int)heap_id >= rte_socket_count())
+		return NULL;
+
+	cache = malloc_cache_get();
+	if (cache == NULL)
+		return NULL;
+
+	idx = size <= MALLOC_CACHE_MIN_SIZE ? 0 :
+		rte_log2_u32(size) - MALLOC_CACHE_MIN_SHIFT;
+	c = &cache->classes[heap_id][idx];
+
+	if (c->len == 0) {
+		cache->miss_count[heap_id]++;
+		c->len = malloc_heap_alloc_bulk(heap_id,
+				MALLOC_CACHE_MIN_SIZE << idx, c->objs,
+				MALLOC_CACHE_BULK);
+		/* heap needs to grow, leave it to malloc_heap_alloc() */
+		if (c->len == 0)
+			return NULL;
+		for (i = 0; i < c->len; i++)
+			malloc_elem_from_data(c->objs[i])->state = ELEM_CACHED;
+	} else {
+		cache->hit_count[heap_id]++;
+	}
+
+	ptr = c->objs[--c->len];
+	elem = malloc_elem_from_data(ptr);
+	elem->state = ELEM_BUSY;
+
+	return ptr;
+}
+
+int
+malloc_cache_free(struct malloc_elem *elem, void *addr)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_cache_class *c;
+	struct malloc_cache *cache;
+	unsigned int heap_id, idx;
+	size_t size;
+
+	if (!malloc_cache_enabled)
+		return -1;
+
+	/* let the heap report invalid pointers */
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
+		return -1;
+
+	heap_id = elem->heap - mcfg->malloc_heaps;
+	if (heap_id >= rte_socket_count())
+		return -1;
+
+	/*
+	 * The element may be somewhat larger than requested, put it in the
+	 * biggest class it can serve.
+	 */
+	size = elem->size - elem->pad - MALLOC_ELEM_OVERHEAD;
+	if (size < MALLOC_CACHE_MIN_SIZE || size >= 2 * MALLOC_CACHE_MAX_SIZE)
+		return -1;
+
+	cache = malloc_cache_get();
+	if (cache == NULL)
+		return -1;
+
+	idx = RTE_MIN(rte_fls_u32(size) - 1 - MALLOC_CACHE_MIN_SHIFT,
+			MALLOC_CACHE_NUM_CLASSES - 1U);
+	c = &cache->classes[heap_id][idx];
+
+	if (c->len == MALLOC_CACHE_SIZE)
+		malloc_cache_flush(heap_id, c, MALLOC_CACHE_BULK);
+
+	/* contents are no longer known to be zeroed */
+	elem->dirty = 1;
+	elem->state = ELEM_CACHED;
+	c->objs[c->len++] = addr;
+
+	return 0;
+}
+
+int
+malloc_cache_get_stats(unsigned int heap_id, uint64_t *hit_count,
+		uint64_t *miss_count)
+{
+	unsigned int lcore_id;
+
+	*hit_count = 0;
+	*miss_count = 0;
+
+	if (!malloc_cache_enabled)
+		return -ENOTSUP;
+
+	/* external heaps are never cached */
+	if (heap_id >= RTE_MAX_NUMA_NODES)
+		return 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct malloc_cache *cache = malloc_caches[lcore_id];
+
+		if (cache == NULL)
+			continue;
+		*hit_count += cache->hit_count[heap_id];
+		*miss_count += cache->miss_count[heap_id];
+	}
+
+	return 0;
+}
+
+void
+malloc_cache_cleanup(void)
+{
+	unsigned int lcore_id;
+
+	/* heap memory is already detached, just drop the magazines */
+	malloc_cache_enabled = false;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		free(malloc_caches[lcore_id]);
+		malloc_caches[lcore_id] = NULL;
+	}
+}
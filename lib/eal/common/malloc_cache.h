@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef MALLOC_CACHE_H
+#define MALLOC_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* forward declarations */
+struct malloc_elem;
+
+/* largest allocation size served from the per-lcore cache */
+#define MALLOC_CACHE_MAX_SIZE 4096
+
+void
+malloc_cache_init(void);
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket_arg);
+
+int
+malloc_cache_free(struct malloc_elem *elem, void *addr);
+
+int
+malloc_cache_get_stats(unsigned int heap_id, uint64_t *hit_count,
+		uint64_t *miss_count);
+
+void
+malloc_cache_cleanup(void);
+
+#endif /* MALLOC_CACHE_H */
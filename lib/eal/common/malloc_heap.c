@@ -23,6 +23,7 @@
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 #include "malloc_mp.h"
@@ -764,6 +765,33 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+/*
+ * Allocate up to n elements of the same size from an already populated heap,
+ * taking the heap lock only once. The heap is not expanded, so the caller
+ * has to fall back to malloc_heap_alloc() when nothing could be allocated.
+ */
+unsigned int
+malloc_heap_alloc_bulk(unsigned int heap_id, size_t size, void **objs,
+		unsigned int n)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_heap *heap = &mcfg->malloc_heaps[heap_id];
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, RTE_CACHE_LINE_SIZE,
+				0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+
+	rte_spinlock_unlock(&(heap->lock));
+
+	return i;
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -852,8 +880,12 @@ malloc_heap_free_pages(void *aligned_start, size_t aligned_len)
 	return 0;
 }
 
-int
-malloc_heap_free(struct malloc_elem *elem)
+/*
+ * Return a busy element to its heap, and give back to the system any pages
+ * which became entirely free. Must be called with the heap lock held.
+ */
+static int
+heap_free(struct malloc_elem *elem)
 {
 	struct malloc_heap *heap;
 	void *start, *aligned_start, *end, *aligned_end;
@@ -865,18 +897,11 @@ malloc_heap_free(struct malloc_elem *elem)
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
-	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
-		return -1;
-
-	asan_clear_redzone(elem);
-
 	/* elem may be merged with previous element, so keep heap address */
 	heap = elem->heap;
 	msl = elem->msl;
 	page_sz = (size_t)msl->page_sz;
 
-	rte_spinlock_lock(&(heap->lock));
-
 	void *asan_ptr = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN + elem->pad);
 	size_t asan_data_len = elem->size - MALLOC_ELEM_OVERHEAD - elem->pad;
 
@@ -892,18 +917,18 @@ malloc_heap_free(struct malloc_elem *elem)
 	 * externally allocated segment.
 	 */
 	if (internal_conf->legacy_mem || (msl->external > 0))
-		goto free_unlock;
+		goto free_done;
 
 	/* check if we can free any memory back to the system */
 	if (elem->size < page_sz)
-		goto free_unlock;
+		goto free_done;
 
 	/* if user requested to match allocations, the sizes must match - if not,
 	 * we will defer freeing these hugepages until the entire original allocation
 	 * can be freed
 	 */
 	if (internal_conf->match_allocations && elem->size != elem->orig_size)
-		goto free_unlock;
+		goto free_done;
 
 	/* probably, but let's make sure, as we may not be using up full page */
 	start = elem;
@@ -916,7 +941,7 @@ malloc_heap_free(struct malloc_elem *elem)
 
 	/* can't free anything */
 	if (aligned_len < page_sz)
-		goto free_unlock;
+		goto free_done;
 
 	/* we can free something. however, some of these pages may be marked as
 	 * unfreeable, so also check that as well
@@ -938,7 +963,7 @@ malloc_heap_free(struct malloc_elem *elem)
 
 	/* check if we can still free some pages */
 	if (n_segs == 0)
-		goto free_unlock;
+		goto free_done;
 
 	/* We're not done yet. We also have to check if by freeing space we will
 	 * be leaving free elements that are too small to store new elements.
@@ -953,7 +978,7 @@ malloc_heap_free(struct malloc_elem *elem)
 		 * move the start forward by one page.
 		 */
 		if (n_segs == 1)
-			goto free_unlock;
+			goto free_done;
 
 		/* move start */
 		aligned_start = RTE_PTR_ADD(aligned_start, page_sz);
@@ -966,7 +991,7 @@ malloc_heap_free(struct malloc_elem *elem)
 		 * move the end backwards by one page.
 		 */
 		if (n_segs == 1)
-			goto free_unlock;
+			goto free_done;
 
 		/* move end */
 		aligned_end = RTE_PTR_SUB(aligned_end, page_sz);
@@ -1035,7 +1060,7 @@ malloc_heap_free(struct malloc_elem *elem)
 		msl->socket_id, aligned_len >> 20ULL);
 
 	rte_mcfg_mem_write_unlock();
-free_unlock:
+free_done:
 	asan_set_freezone(asan_ptr, asan_data_len);
 
 	/* if we unmapped some memory, we need to do additional work for ASan */
@@ -1069,6 +1094,59 @@ malloc_heap_free(struct malloc_elem *elem)
 			asan_set_zone(aligned_trailer, MALLOC_ELEM_TRAILER_LEN, 0x00);
 	}
 
+	return ret;
+}
+
+int
+malloc_heap_free(struct malloc_elem *elem)
+{
+	struct malloc_heap *heap;
+	int ret;
+
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
+		return -1;
+
+	asan_clear_redzone(elem);
+
+	heap = elem->heap;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	ret = heap_free(elem);
+
+	rte_spinlock_unlock(&(heap->lock));
+	return ret;
+}
+
+/*
+ * Free a batch of busy elements belonging to the same heap, taking the heap
+ * lock only once. Invalid elements are skipped.
+ */
+int
+malloc_heap_free_bulk(struct malloc_heap *heap, struct malloc_elem **elems,
+		unsigned int n)
+{
+	unsigned int i;
+	int ret = 0;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		struct malloc_elem *elem = elems[i];
+
+		if (!malloc_elem_cookies_ok(elem) ||
+				elem->state != ELEM_BUSY ||
+				elem->heap != heap) {
+			ret = -1;
+			continue;
+		}
+
+		asan_clear_redzone(elem);
+
+		if (heap_free(elem) < 0)
+			ret = -1;
+	}
+
 	rte_spinlock_unlock(&(heap->lock));
 	return ret;
 }
@@ -1402,6 +1480,8 @@ rte_eal_malloc_heap_init(void)
 	if (internal_conf->match_allocations)
 		RTE_LOG(DEBUG, EAL, "Hugepages will be freed exactly as allocated.\n");
 
+	malloc_cache_init();
+
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		/* assign min socket ID to external heaps */
 		mcfg->next_socket_id = EXTERNAL_HEAP_MIN_SOCKET_ID;
@@ -1443,5 +1523,6 @@ rte_eal_malloc_heap_init(void)
 void
 rte_eal_malloc_heap_cleanup(void)
 {
+	malloc_cache_cleanup();
 	unregister_mp_requests();
 }
@@ -298,6 +298,29 @@ int
 rte_malloc_get_socket_stats(int socket,
 		struct rte_malloc_socket_stats *socket_stats);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the per-lcore malloc cache statistics for the specified heap,
+ * summed over all the lcores of the calling process.
+ *
+ * @param socket
+ *   An unsigned integer specifying the socket to get cache statistics for
+ * @param hit_count
+ *   Returns the number of allocations served from the per-lcore caches
+ * @param miss_count
+ *   Returns the number of cacheable allocations which had to go to the heap
+ * @return
+ *   0 on success
+ *   -EINVAL if the socket is invalid or a parameter is NULL
+ *   -ENOTSUP if the malloc cache is not enabled in this process
+ */
+__rte_experimental
+int
+rte_malloc_get_cache_stats(int socket, uint64_t *hit_count,
+		uint64_t *miss_count);
+
 /**
  * Add memory chunk to a heap with specified name.
  *
@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <rte_debug.h>
 #include <rte_malloc.h>
@@ -151,9 +152,12 @@ tbl8_get_idx(struct dir24_8_tbl *dp)
 	uint32_t i;
 	int bit_idx;
 
-	for (i = 0; (i < (dp->number_tbl8s >> BITMAP_SLAB_BIT_SIZE_LOG2)) &&
+	/* slabs below the hint are known to be full */
+	for (i = dp->tbl8_slab_hint;
+			(i < (dp->number_tbl8s >> BITMAP_SLAB_BIT_SIZE_LOG2)) &&
 			(dp->tbl8_idxes[i] == UINT64_MAX); i++)
 		;
+	dp->tbl8_slab_hint = i;
 	if (i < (dp->number_tbl8s >> BITMAP_SLAB_BIT_SIZE_LOG2)) {
 		bit_idx = __builtin_ctzll(~dp->tbl8_idxes[i]);
 		dp->tbl8_idxes[i] |= (1ULL << bit_idx);
@@ -167,6 +171,8 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 {
 	dp->tbl8_idxes[idx >> BITMAP_SLAB_BIT_SIZE_LOG2] &=
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
+	if ((uint32_t)(idx >> BITMAP_SLAB_BIT_SIZE_LOG2) < dp->tbl8_slab_hint)
+		dp->tbl8_slab_hint = idx >> BITMAP_SLAB_BIT_SIZE_LOG2;
 }
 
 static int
@@ -492,6 +498,377 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	return -EINVAL;
 }
 
+/* Flags of a route in a batch passed to dir24_8_bulk_modify() */
+#define DIR24_8_BULK_OLD	0x1	/* route exists before the batch */
+#define DIR24_8_BULK_NEW	0x2	/* route exists after the batch */
+#define DIR24_8_BULK_SKIP	0x4	/* RIB update failed, route unchanged */
+#define DIR24_8_BULK_DONE	0x8	/* range of the route is rewritten */
+#define DIR24_8_BULK_PAR	0x10	/* deleted route has a parent */
+#define DIR24_8_BULK_RETRY	0x20	/* rewrite failed for lack of tbl8 */
+
+struct dir24_8_bulk_ent {
+	uint64_t	nh;	/* next hop after the batch */
+	uint64_t	old_nh;	/* next hop before the batch */
+	uint64_t	par_nh;	/* next hop of the parent of a deleted route */
+	struct rte_rib_node	*node;	/* RIB node while the route exists */
+	uint32_t	ip;
+	uint32_t	idx;	/* position in the batch, keeps the ops order */
+	uint32_t	par_ip;
+	uint8_t		depth;
+	uint8_t		par_depth;
+	uint8_t		flags;	/* op while sorting, DIR24_8_BULK_* after */
+};
+
+static int
+bulk_prefix_cmp(const void *a, const void *b)
+{
+	const struct dir24_8_bulk_ent *e1 = a;
+	const struct dir24_8_bulk_ent *e2 = b;
+
+	if (e1->ip != e2->ip)
+		return (e1->ip < e2->ip) ? -1 : 1;
+	if (e1->depth != e2->depth)
+		return (e1->depth < e2->depth) ? -1 : 1;
+	return 0;
+}
+
+static int
+bulk_ent_cmp(const void *a, const void *b)
+{
+	const struct dir24_8_bulk_ent *e1 = a;
+	const struct dir24_8_bulk_ent *e2 = b;
+	int ret;
+
+	ret = bulk_prefix_cmp(a, b);
+	if (ret != 0)
+		return ret;
+	return (e1->idx < e2->idx) ? -1 : (e1->idx > e2->idx);
+}
+
+static int
+bulk_rib_insert(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct dir24_8_bulk_ent *e, uint64_t next_hop)
+{
+	struct rte_rib_node *tmp = NULL;
+
+	if (e->depth > 24) {
+		tmp = rte_rib_get_nxt(rib, e->ip, 24, NULL,
+			RTE_RIB_GET_NXT_COVER);
+		if ((tmp == NULL) &&
+				(dp->rsvd_tbl8s >= dp->number_tbl8s))
+			return -ENOSPC;
+	}
+	e->node = rte_rib_insert(rib, e->ip, e->depth);
+	if (e->node == NULL)
+		return -rte_errno;
+	rte_rib_set_nh(e->node, next_hop);
+	if ((e->depth > 24) && (tmp == NULL))
+		dp->rsvd_tbl8s++;
+	return 0;
+}
+
+static void
+bulk_rib_remove(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct dir24_8_bulk_ent *e)
+{
+	rte_rib_remove(rib, e->ip, e->depth);
+	e->node = NULL;
+	if ((e->depth > 24) && (rte_rib_get_nxt(rib, e->ip, 24, NULL,
+			RTE_RIB_GET_NXT_COVER) == NULL))
+		dp->rsvd_tbl8s--;
+}
+
+/* Returns true if the route is changed by the batch and gets rewritten */
+static int
+bulk_is_rewritten(const struct dir24_8_bulk_ent *ents, unsigned int nb_ents,
+	uint32_t ip, uint8_t depth)
+{
+	const struct dir24_8_bulk_ent *e;
+	struct dir24_8_bulk_ent key;
+
+	key.ip = ip;
+	key.depth = depth;
+	e = bsearch(&key, ents, nb_ents, sizeof(*ents), bulk_prefix_cmp);
+	return (e != NULL) && ((e->flags & (DIR24_8_BULK_NEW |
+		DIR24_8_BULK_SKIP)) == DIR24_8_BULK_NEW);
+}
+
+static inline int
+bulk_is_covered(const struct dir24_8_bulk_ent *e,
+	const struct dir24_8_bulk_ent *par)
+{
+	return (par->depth < e->depth) &&
+		((e->ip & rte_rib_depth_to_mask(par->depth)) == par->ip);
+}
+
+/*
+ * Restore the next hop of the closest covering route over the range of
+ * a deleted route. The parent recorded on removal is the closest route
+ * left in the RIB at that time, the stack holds the changed routes
+ * covering e. The range is left alone if it is rewritten anyway, either
+ * by a changed covering route or by a bigger deleted route.
+ */
+static int
+bulk_restore_cover(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	const struct dir24_8_bulk_ent *ents, unsigned int nb_ents,
+	struct dir24_8_bulk_ent *e, struct dir24_8_bulk_ent **stack,
+	unsigned int nb_stack)
+{
+	const struct dir24_8_bulk_ent *par;
+	uint64_t par_nh = dp->def_nh;
+
+	if (e->flags & DIR24_8_BULK_PAR) {
+		if (bulk_is_rewritten(ents, nb_ents, e->par_ip,
+				e->par_depth))
+			return 0;
+		par_nh = e->par_nh;
+	}
+	while (nb_stack > 0) {
+		par = stack[--nb_stack];
+		if ((e->flags & DIR24_8_BULK_PAR) &&
+				(par->depth <= e->par_depth))
+			break;
+		if ((par->flags & DIR24_8_BULK_DONE) ||
+				((par->flags & (DIR24_8_BULK_NEW |
+				DIR24_8_BULK_SKIP)) == DIR24_8_BULK_NEW))
+			return 0;
+	}
+
+	if (par_nh == e->old_nh)
+		return 0;
+	e->flags |= DIR24_8_BULK_DONE;
+	return modify_fib(dp, rib, e->ip, e->depth, par_nh);
+}
+
+/*
+ * Returns true if the parent of a new route has the same next hop and
+ * is not changed by the batch, so the range already holds the next hop.
+ */
+static int
+bulk_same_as_parent(struct dir24_8_tbl *dp,
+	const struct dir24_8_bulk_ent *ents, unsigned int nb_ents,
+	const struct dir24_8_bulk_ent *e)
+{
+	struct rte_rib_node *node;
+	uint64_t par_nh;
+	uint32_t par_ip;
+	uint8_t par_depth;
+
+	node = rte_rib_lookup_parent(e->node);
+	if (node == NULL)
+		return dp->def_nh == e->nh;
+	rte_rib_get_ip(node, &par_ip);
+	rte_rib_get_depth(node, &par_depth);
+	if (bulk_is_rewritten(ents, nb_ents, par_ip, par_depth))
+		return 0;
+	rte_rib_get_nh(node, &par_nh);
+	return par_nh == e->nh;
+}
+
+/*
+ * Apply the state of a route after the batch to the RIB.
+ * Deleted routes record their closest parent left in the RIB,
+ * deleted parents are already gone as prefixes are sorted.
+ */
+static int
+bulk_rib_update(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct dir24_8_bulk_ent *e)
+{
+	struct rte_rib_node *node;
+	int ret;
+
+	switch (e->flags) {
+	case DIR24_8_BULK_OLD:
+		node = rte_rib_lookup_parent(e->node);
+		if (node != NULL) {
+			rte_rib_get_ip(node, &e->par_ip);
+			rte_rib_get_depth(node, &e->par_depth);
+			rte_rib_get_nh(node, &e->par_nh);
+			e->flags |= DIR24_8_BULK_PAR;
+		}
+		bulk_rib_remove(dp, rib, e);
+		return 0;
+	case DIR24_8_BULK_OLD | DIR24_8_BULK_NEW:
+		rte_rib_set_nh(e->node, e->nh);
+		return 0;
+	default:
+		ret = bulk_rib_insert(dp, rib, e, e->nh);
+		if (ret != 0)
+			e->flags |= DIR24_8_BULK_SKIP;
+		return ret;
+	}
+}
+
+/* Undo the RIB update of a route which range failed to be rewritten */
+static void
+bulk_rib_rollback(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct dir24_8_bulk_ent *e)
+{
+	e->flags &= ~DIR24_8_BULK_DONE;
+	if ((e->flags & DIR24_8_BULK_NEW) == 0)
+		bulk_rib_insert(dp, rib, e, e->old_nh);
+	else if (e->flags & DIR24_8_BULK_OLD)
+		rte_rib_set_nh(e->node, e->old_nh);
+	else {
+		bulk_rib_remove(dp, rib, e);
+		e->flags |= DIR24_8_BULK_SKIP;
+	}
+}
+
+int
+dir24_8_bulk_modify(struct rte_fib *fib, const struct rte_fib_bulk_op *ops,
+	unsigned int n)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct dir24_8_bulk_ent *ents, *e;
+	struct dir24_8_bulk_ent *stack[RTE_FIB_MAXDEPTH + 1];
+	struct dir24_8_bulk_ent cur;
+	unsigned int i, j, nb_ops, nb_ents, nb_del, nb_retry, nb_stack;
+	int ret = 0;
+	int err;
+
+	if (fib == NULL)
+		return -EINVAL;
+	if (n == 0)
+		return 0;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	ents = rte_malloc(NULL, n * sizeof(*ents), 0);
+	if (ents == NULL)
+		return -ENOMEM;
+
+	for (i = 0, nb_ops = 0; i < n; i++) {
+		if ((ops[i].depth > RTE_FIB_MAXDEPTH) ||
+				((ops[i].op != RTE_FIB_ADD) &&
+				(ops[i].op != RTE_FIB_DEL)) ||
+				((ops[i].op == RTE_FIB_ADD) &&
+				(ops[i].next_hop > get_max_nh(dp->nh_sz)))) {
+			ret = -EINVAL;
+			continue;
+		}
+		e = &ents[nb_ops++];
+		e->ip = ops[i].ip & rte_rib_depth_to_mask(ops[i].depth);
+		e->depth = ops[i].depth;
+		e->idx = i;
+		e->nh = ops[i].next_hop;
+		e->flags = ops[i].op;
+	}
+
+	/*
+	 * Sort by prefix keeping the batch order for the same prefix,
+	 * reduce every prefix to its state after the batch and update
+	 * the RIB. Prefixes that end up the way they were are dropped.
+	 */
+	qsort(ents, nb_ops, sizeof(*ents), bulk_ent_cmp);
+	nb_ents = 0;
+	nb_del = 0;
+	nb_retry = 0;
+	for (i = 0; i < nb_ops; i = j) {
+		cur.ip = ents[i].ip;
+		cur.depth = ents[i].depth;
+		cur.idx = ents[i].idx;
+		cur.old_nh = 0;
+		cur.flags = 0;
+		cur.node = rte_rib_lookup_exact(rib, cur.ip, cur.depth);
+		if (cur.node != NULL) {
+			rte_rib_get_nh(cur.node, &cur.old_nh);
+			cur.flags = DIR24_8_BULK_OLD | DIR24_8_BULK_NEW;
+		}
+		cur.nh = cur.old_nh;
+		for (j = i; (j < nb_ops) &&
+				(bulk_prefix_cmp(&ents[j], &cur) == 0); j++) {
+			if (ents[j].flags == RTE_FIB_ADD) {
+				cur.flags |= DIR24_8_BULK_NEW;
+				cur.nh = ents[j].nh;
+			} else if (cur.flags & DIR24_8_BULK_NEW) {
+				cur.flags &= ~DIR24_8_BULK_NEW;
+				cur.nh = cur.old_nh;
+			} else
+				ret = -ENOENT;
+		}
+		if ((cur.flags == 0) || ((cur.nh == cur.old_nh) &&
+				(cur.flags == (DIR24_8_BULK_OLD |
+				DIR24_8_BULK_NEW))))
+			continue;
+		if (cur.flags == DIR24_8_BULK_OLD)
+			nb_del++;
+		e = &ents[nb_ents++];
+		*e = cur;
+		err = bulk_rib_update(dp, rib, e);
+		if (err == -ENOSPC) {
+			/* retry once later deletions release tbl8 groups */
+			e->flags |= DIR24_8_BULK_RETRY;
+			nb_retry++;
+		} else if (err != 0)
+			ret = err;
+	}
+	for (i = 0; (i < nb_ents) && (nb_retry != 0); i++) {
+		e = &ents[i];
+		if ((e->flags & DIR24_8_BULK_RETRY) == 0)
+			continue;
+		nb_retry--;
+		e->flags &= ~DIR24_8_BULK_RETRY;
+		err = bulk_rib_insert(dp, rib, e, e->nh);
+		if (err == 0)
+			e->flags &= ~DIR24_8_BULK_SKIP;
+		else
+			ret = err;
+	}
+
+	/*
+	 * Rewrite the dataplane once per changed range. The stack holds
+	 * the changed routes covering the current one.
+	 */
+	nb_stack = 0;
+	for (i = 0; i < nb_ents; i++) {
+		e = &ents[i];
+		while ((nb_stack > 0) &&
+				!bulk_is_covered(e, stack[nb_stack - 1]))
+			nb_stack--;
+		stack[nb_stack++] = e;
+		if (e->flags & DIR24_8_BULK_SKIP)
+			continue;
+		if ((e->flags & DIR24_8_BULK_NEW) == 0)
+			err = bulk_restore_cover(dp, rib, ents, nb_ents, e,
+				stack, nb_stack - 1);
+		else if ((nb_del == 0) && (e->flags == DIR24_8_BULK_NEW) &&
+				bulk_same_as_parent(dp, ents, nb_ents, e))
+			continue;
+		else {
+			e->flags |= DIR24_8_BULK_DONE;
+			err = modify_fib(dp, rib, e->ip, e->depth, e->nh);
+		}
+		if (err == -ENOSPC) {
+			e->flags |= DIR24_8_BULK_RETRY;
+			nb_retry++;
+		} else if (err != 0) {
+			bulk_rib_rollback(dp, rib, e);
+			ret = err;
+		}
+	}
+	for (i = 0; (i < nb_ents) && (nb_retry != 0); i++) {
+		e = &ents[i];
+		if ((e->flags & DIR24_8_BULK_RETRY) == 0)
+			continue;
+		nb_retry--;
+		err = modify_fib(dp, rib, e->ip, e->depth,
+			(e->flags & DIR24_8_BULK_NEW) ? e->nh :
+			((e->flags & DIR24_8_BULK_PAR) ? e->par_nh :
+			dp->def_nh));
+		if (err != 0) {
+			bulk_rib_rollback(dp, rib, e);
+			ret = err;
+		}
+	}
+
+	rte_free(ents);
+	return ret;
+}
+
 void *
 dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 {
@@ -31,6 +31,7 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	uint32_t	tbl8_slab_hint;	/**< first bitmap slab with free idxes*/
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -248,4 +249,8 @@ int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+int
+dir24_8_bulk_modify(struct rte_fib *fib, const struct rte_fib_bulk_op *ops,
+	unsigned int n);
+
 #endif /* _DIR24_8_H_ */
@@ -134,6 +134,29 @@ rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 	return fib->modify(fib, ip, depth, 0, RTE_FIB_DEL);
 }
 
+int
+rte_fib_bulk_modify(struct rte_fib *fib, const struct rte_fib_bulk_op *ops,
+	unsigned int n)
+{
+	unsigned int i;
+	int ret, err = 0;
+
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			((ops == NULL) && (n != 0)))
+		return -EINVAL;
+
+	if (fib->type == RTE_FIB_DIR24_8)
+		return dir24_8_bulk_modify(fib, ops, n);
+
+	for (i = 0; i < n; i++) {
+		ret = fib->modify(fib, ops[i].ip, ops[i].depth,
+			ops[i].next_hop, ops[i].op);
+		if ((ret != 0) && (err == 0))
+			err = ret;
+	}
+	return err;
+}
+
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	uint64_t *next_hops, int n)
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,14 @@ enum rte_fib_op {
 	RTE_FIB_DEL,
 };
 
+/** Route update passed to rte_fib_bulk_modify() */
+struct rte_fib_bulk_op {
+	uint32_t	ip;	/**< IPv4 prefix address */
+	uint8_t		depth;	/**< Prefix length */
+	uint8_t		op;	/**< RTE_FIB_ADD or RTE_FIB_DEL */
+	uint64_t	next_hop; /**< Next hop, ignored for RTE_FIB_DEL */
+};
+
 /** Size of nexthop (1 << nh_sz) bits for DIR24_8 based FIB */
 enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_1B,
@@ -160,6 +169,40 @@ rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth, uint64_t next_hop);
 int
 rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Apply a batch of route additions and deletions to the FIB.
+ *
+ * Every prefix ends up in the state it would have after calling
+ * rte_fib_add() and rte_fib_delete() for every element of ops in order,
+ * but the batch is sorted and reduced first: several updates of the same
+ * prefix are collapsed into the last one, updates cancelling each other
+ * are dropped, and each changed range of the dataplane is rewritten only
+ * once. With the DIR24_8 type, the intermediate states are never built
+ * and the additions lacking tbl8 groups are retried after the deletions
+ * of the batch, so a batch can succeed where the same sequence of
+ * rte_fib_add() and rte_fib_delete() calls would fail with -ENOSPC.
+ * Updates that fail do not prevent the rest of the batch from being
+ * applied.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ops
+ *   Array of route updates
+ * @param n
+ *   Number of elements in ops array
+ * @return
+ *   0 if every update was applied,
+ *   -ENOMEM if the batch could not be processed,
+ *   otherwise the negative value returned for one of the failed updates
+ */
+__rte_experimental
+int
+rte_fib_bulk_modify(struct rte_fib *fib, const struct rte_fib_bulk_op *ops,
+	unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
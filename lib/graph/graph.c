@@ -267,23 +267,40 @@ rte_graph_lookup(const char *name)
 	return graph_mem_fixup_secondary(rc);
 }
 
-rte_graph_t
-rte_graph_create(const char *name, struct rte_graph_param *prm)
+struct rte_graph *
+rte_graph_dispatch_lookup(const char *name, unsigned int lcore_id)
+{
+	char instance_name[RTE_GRAPH_NAMESIZE];
+	struct rte_graph *graph;
+
+	graph = rte_graph_lookup(name);
+	if (graph == NULL || graph->model != RTE_GRAPH_MODEL_DISPATCH)
+		return NULL;
+
+	if (graph->lcore_id == lcore_id)
+		return graph;
+
+	if (snprintf(instance_name, sizeof(instance_name), "%s-%u", name,
+		     lcore_id) >= (int)sizeof(instance_name))
+		return NULL;
+
+	graph = rte_graph_lookup(instance_name);
+	if (graph == NULL || graph->model != RTE_GRAPH_MODEL_DISPATCH ||
+	    graph->lcore_id != lcore_id)
+		return NULL;
+
+	return graph;
+}
+
+static struct graph *
+graph_create(const char *name, struct rte_graph_param *prm,
+	     unsigned int lcore_id, struct graph *parent)
 {
 	rte_node_t src_node_count;
 	struct graph *graph;
 	const char *pattern;
 	uint16_t i;
 
-	graph_spinlock_lock();
-
-	/* Check arguments sanity */
-	if (prm == NULL)
-		SET_ERR_JMP(EINVAL, fail, "Param should not be NULL");
-
-	if (name == NULL)
-		SET_ERR_JMP(EINVAL, fail, "Graph name should not be NULL");
-
 	/* Check for existence of duplicate graph */
 	STAILQ_FOREACH(graph, &graph_list, next)
 		if (strncmp(name, graph->name, RTE_GRAPH_NAMESIZE) == 0)
@@ -343,6 +360,9 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph->num_pkt_to_capture = prm->num_pkt_to_capture;
 	if (prm->pcap_filename)
 		rte_strscpy(graph->pcap_filename, prm->pcap_filename, RTE_GRAPH_PCAP_FILE_SZ);
+	graph->model = prm->model;
+	graph->lcore_id = lcore_id;
+	graph->parent = parent;
 
 	/* Allocate the Graph fast path memory and populate the data */
 	if (graph_fp_mem_create(graph))
@@ -356,8 +376,7 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_id++;
 	STAILQ_INSERT_TAIL(&graph_list, graph, next);
 
-	graph_spinlock_unlock();
-	return graph->id;
+	return graph;
 
 graph_mem_destroy:
 	graph_fp_mem_destroy(graph);
@@ -365,6 +384,133 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_cleanup(graph);
 free:
 	free(graph);
+fail:
+	return NULL;
+}
+
+static int
+graph_instance_destroy(struct graph *graph)
+{
+	int rc;
+
+	/* Call fini() of the all the nodes in the graph */
+	graph_node_fini(graph);
+	if (graph->model == RTE_GRAPH_MODEL_DISPATCH)
+		graph_dispatch_fini(graph);
+	/* Destroy graph fast path memory */
+	rc = graph_fp_mem_destroy(graph);
+	if (rc)
+		SET_ERR_JMP(rc, done, "Graph %s destroy failed", graph->name);
+
+	graph_cleanup(graph);
+	STAILQ_REMOVE(&graph_list, graph, graph, next);
+	free(graph);
+	graph_id--;
+done:
+	return rc;
+}
+
+static int
+graph_destroy(struct graph *graph)
+{
+	struct graph *instance, *tmp;
+	int rc;
+
+	/* Destroy the other instances of a dispatch model graph first */
+	instance = STAILQ_FIRST(&graph_list);
+	while (instance != NULL) {
+		tmp = STAILQ_NEXT(instance, next);
+		if (instance->parent == graph) {
+			rc = graph_instance_destroy(instance);
+			if (rc)
+				return rc;
+		}
+		instance = tmp;
+	}
+
+	return graph_instance_destroy(graph);
+}
+
+static int
+graph_dispatch_lcores_check(const struct rte_graph_param *prm)
+{
+	uint16_t i, j;
+
+	if (prm->dispatch.nb_lcores == 0 || prm->dispatch.lcores == NULL)
+		SET_ERR_JMP(EINVAL, fail, "No lcore to walk the graph");
+
+	for (i = 0; i < prm->dispatch.nb_lcores; i++) {
+		if (prm->dispatch.lcores[i] >= RTE_MAX_LCORE)
+			SET_ERR_JMP(EINVAL, fail, "Invalid lcore %u",
+				    prm->dispatch.lcores[i]);
+		for (j = 0; j < i; j++)
+			if (prm->dispatch.lcores[j] == prm->dispatch.lcores[i])
+				SET_ERR_JMP(EINVAL, fail, "Duplicate lcore %u",
+					    prm->dispatch.lcores[i]);
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+rte_graph_t
+rte_graph_create(const char *name, struct rte_graph_param *prm)
+{
+	char instance_name[RTE_GRAPH_NAMESIZE];
+	struct graph *graph = NULL;
+	unsigned int lcore_id;
+	uint16_t i;
+	int err;
+
+	graph_spinlock_lock();
+
+	/* Check arguments sanity */
+	if (prm == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Param should not be NULL");
+
+	if (name == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Graph name should not be NULL");
+
+	if (prm->model == RTE_GRAPH_MODEL_RTC) {
+		graph = graph_create(name, prm, RTE_MAX_LCORE, NULL);
+		if (graph == NULL)
+			goto fail;
+		goto done;
+	}
+
+	if (prm->model != RTE_GRAPH_MODEL_DISPATCH)
+		SET_ERR_JMP(EINVAL, fail, "Invalid graph model %d",
+			    prm->model);
+
+	if (graph_dispatch_lcores_check(prm))
+		goto fail;
+
+	/* One instance of the graph for each lcore */
+	graph = graph_create(name, prm, prm->dispatch.lcores[0], NULL);
+	if (graph == NULL)
+		goto fail;
+
+	for (i = 1; i < prm->dispatch.nb_lcores; i++) {
+		lcore_id = prm->dispatch.lcores[i];
+		if (snprintf(instance_name, sizeof(instance_name), "%s-%u",
+			     name, lcore_id) >= (int)sizeof(instance_name))
+			SET_ERR_JMP(E2BIG, destroy, "Too big name=%s", name);
+		if (graph_create(instance_name, prm, lcore_id, graph) == NULL)
+			goto destroy;
+	}
+
+	if (graph_dispatch_setup(graph, prm))
+		goto destroy;
+
+done:
+	graph_spinlock_unlock();
+	return graph->id;
+
+destroy:
+	err = rte_errno;
+	graph_destroy(graph);
+	rte_errno = err;
 fail:
 	graph_spinlock_unlock();
 	return RTE_GRAPH_ID_INVALID;
@@ -373,32 +519,22 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 int
 rte_graph_destroy(rte_graph_t id)
 {
-	struct graph *graph, *tmp;
+	struct graph *graph;
 	int rc = -ENOENT;
 
 	graph_spinlock_lock();
 
-	graph = STAILQ_FIRST(&graph_list);
-	while (graph != NULL) {
-		tmp = STAILQ_NEXT(graph, next);
+	STAILQ_FOREACH(graph, &graph_list, next) {
 		if (graph->id == id) {
-			/* Call fini() of the all the nodes in the graph */
-			graph_node_fini(graph);
-			/* Destroy graph fast path memory */
-			rc = graph_fp_mem_destroy(graph);
-			if (rc)
-				SET_ERR_JMP(rc, done, "Graph %s destroy failed",
-					    graph->name);
-
-			graph_cleanup(graph);
-			STAILQ_REMOVE(&graph_list, graph, graph, next);
-			free(graph);
-			graph_id--;
-			goto done;
+			/* Instances of a dispatch model graph go with it */
+			if (graph->parent != NULL)
+				rc = -EINVAL;
+			else
+				rc = graph_destroy(graph);
+			break;
 		}
-		graph = tmp;
 	}
-done:
+
 	graph_spinlock_unlock();
 	return rc;
 }
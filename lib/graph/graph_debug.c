@@ -20,6 +20,8 @@ graph_dump(FILE *f, struct graph *g)
 	fprintf(f, "  mem_sz=%zu\n", g->mem_sz);
 	fprintf(f, "  node_count=%" PRIu32 "\n", g->node_count);
 	fprintf(f, "  src_node_count=%" PRIu32 "\n", g->src_node_count);
+	if (g->model == RTE_GRAPH_MODEL_DISPATCH)
+		fprintf(f, "  dispatch lcore=%u\n", g->lcore_id);
 
 	STAILQ_FOREACH(graph_node, &g->node_list, next)
 		fprintf(f, "     node[%d] <%s>\n", i++, graph_node->node->name);
@@ -75,6 +77,14 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       idx=%d\n", n->idx);
 		fprintf(f, "       total_objs=%" PRId64 "\n", n->total_objs);
 		fprintf(f, "       total_calls=%" PRId64 "\n", n->total_calls);
+		if (g->model == RTE_GRAPH_MODEL_DISPATCH) {
+			fprintf(f, "       lcore_id=%u\n", n->lcore_id);
+			fprintf(f, "       dispatch_ring=%p\n", n->dispatch_ring);
+			fprintf(f, "       dispatch_objs=%" PRIu64 "\n",
+				n->dispatch_objs);
+			fprintf(f, "       dispatch_fails=%" PRIu64 "\n",
+				n->dispatch_fails);
+		}
 		for (i = 0; i < n->nb_edges; i++)
 			fprintf(f, "          edge[%d] <%s>\n", i,
 				n->nodes[i]->name);
@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <fnmatch.h>
+#include <stdbool.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_ring.h>
+#include <rte_ring_elem.h>
+
+#include "graph_private.h"
+
+/* Maximum number of streams moved from a handoff ring per graph walk */
+#define GRAPH_DISPATCH_PULL_MAX 8
+
+static struct graph *
+graph_instance_get(struct graph *graph, unsigned int lcore_id)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *instance;
+
+	if (graph->lcore_id == lcore_id)
+		return graph;
+
+	STAILQ_FOREACH(instance, graph_head, next)
+		if (instance->parent == graph && instance->lcore_id == lcore_id)
+			return instance;
+
+	return NULL;
+}
+
+static int
+graph_dispatch_node_list_add(struct rte_graph *graph, struct rte_node *node)
+{
+	rte_graph_off_t *nodes;
+
+	nodes = rte_realloc_socket(graph->dispatch_nodes,
+				   (graph->nb_dispatch_nodes + 1) *
+				   sizeof(*nodes), 0, graph->socket);
+	if (nodes == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to realloc dispatch nodes");
+
+	nodes[graph->nb_dispatch_nodes++] = node->off;
+	graph->dispatch_nodes = nodes;
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+static int
+graph_dispatch_node_bind(struct graph *graph, struct graph *home,
+			 struct node *node, uint32_t ring_size)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	char name[RTE_RING_NAMESIZE];
+	struct rte_ring *ring = NULL;
+	struct graph *instance;
+	struct rte_node *n;
+
+	n = graph_node_id_to_ptr(home->graph, node->id);
+	if (n == NULL)
+		SET_ERR_JMP(ENOENT, fail, "Node %s not found in graph %s",
+			    node->name, home->name);
+
+	/* The first affinity matching a node applies */
+	if (n->lcore_id != RTE_MAX_LCORE)
+		return 0;
+
+	/* Source nodes are only polled by their lcore, nothing to hand off */
+	if (!(node->flags & RTE_NODE_SOURCE_F)) {
+		snprintf(name, sizeof(name), "graph_%u_%u", home->id,
+			 node->id);
+		ring = rte_ring_create_elem(name,
+				sizeof(struct graph_dispatch_stream), ring_size,
+				home->socket, RING_F_MP_HTS_ENQ |
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (ring == NULL)
+			SET_ERR_JMP(rte_errno, fail,
+				    "Failed to create ring for node %s",
+				    node->name);
+
+		if (graph_dispatch_node_list_add(home->graph, n)) {
+			rte_ring_free(ring);
+			goto fail;
+		}
+	}
+
+	/* Bind the node in all the instances */
+	STAILQ_FOREACH(instance, graph_head, next) {
+		if (instance != graph && instance->parent != graph)
+			continue;
+		n = graph_node_id_to_ptr(instance->graph, node->id);
+		n->lcore_id = home->lcore_id;
+		n->dispatch_ring = ring;
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+int
+graph_dispatch_setup(struct graph *graph, const struct rte_graph_param *prm)
+{
+	const struct rte_graph_node_affinity *affinity;
+	struct graph_node *graph_node;
+	struct graph *home;
+	uint32_t ring_size;
+	bool found;
+	uint16_t i;
+
+	ring_size = prm->dispatch.ring_size;
+	if (ring_size == 0)
+		ring_size = RTE_GRAPH_DISPATCH_RING_SIZE;
+
+	if (prm->dispatch.nb_affinities && prm->dispatch.affinities == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Invalid node affinities");
+
+	for (i = 0; i < prm->dispatch.nb_affinities; i++) {
+		affinity = &prm->dispatch.affinities[i];
+		home = graph_instance_get(graph, affinity->lcore_id);
+		if (home == NULL)
+			SET_ERR_JMP(EINVAL, fail, "Lcore %u does not walk %s",
+				    affinity->lcore_id, graph->name);
+
+		found = false;
+		STAILQ_FOREACH(graph_node, &graph->node_list, next) {
+			if (fnmatch(affinity->node_pattern,
+				    graph_node->node->name, 0) != 0)
+				continue;
+			if (graph_dispatch_node_bind(graph, home,
+						     graph_node->node,
+						     ring_size))
+				goto fail;
+			found = true;
+		}
+		if (found == false)
+			SET_ERR_JMP(EFAULT, fail, "Pattern %s node not found",
+				    affinity->node_pattern);
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+void
+graph_dispatch_fini(struct graph *graph)
+{
+	struct rte_graph *g = graph->graph;
+	rte_graph_off_t off;
+	struct rte_node *n;
+	rte_node_t count;
+
+	/* Rings are owned by the instance of the lcore of their node */
+	rte_graph_foreach_node(count, off, g, n)
+		if (n->dispatch_ring != NULL && n->lcore_id == g->lcore_id)
+			rte_ring_free(n->dispatch_ring);
+
+	rte_free(g->dispatch_nodes);
+	g->dispatch_nodes = NULL;
+	g->nb_dispatch_nodes = 0;
+}
+
+bool __rte_noinline
+__rte_graph_dispatch_push(struct rte_node *node)
+{
+	const size_t esize = sizeof(struct graph_dispatch_stream);
+	struct rte_ring *ring = node->dispatch_ring;
+	struct graph_dispatch_stream *stream;
+	struct rte_ring_zc_data zcd;
+	uint16_t left = node->idx;
+	void **objs = node->objs;
+	uint16_t n;
+
+	while (left) {
+		n = RTE_MIN(left, RTE_GRAPH_BURST_SIZE);
+		if (rte_ring_enqueue_zc_bulk_elem_start(ring, esize, 1, &zcd,
+							NULL) == 0)
+			break;
+
+		stream = zcd.n1 ? zcd.ptr1 : zcd.ptr2;
+		stream->nb_objs = n;
+		memcpy(stream->objs, objs, n * sizeof(void *));
+		rte_ring_enqueue_zc_elem_finish(ring, 1);
+
+		objs += n;
+		left -= n;
+	}
+
+	if (rte_graph_has_stats_feature()) {
+		node->dispatch_objs += node->idx - left;
+		node->dispatch_fails += left;
+	}
+
+	if (likely(left == 0)) {
+		node->idx = 0;
+		return true;
+	}
+
+	/* Keep the objects left for the local lcore */
+	memmove(node->objs, objs, left * sizeof(void *));
+	node->idx = left;
+	return false;
+}
+
+void __rte_noinline
+__rte_graph_dispatch_pull(struct rte_graph *graph)
+{
+	const size_t esize = sizeof(struct graph_dispatch_stream);
+	struct graph_dispatch_stream *stream;
+	struct rte_ring_zc_data zcd;
+	struct rte_node *node;
+	unsigned int i, n;
+	uint16_t idx;
+	rte_node_t k;
+
+	for (k = 0; k < graph->nb_dispatch_nodes; k++) {
+		node = RTE_PTR_ADD(graph, graph->dispatch_nodes[k]);
+		n = rte_ring_dequeue_zc_burst_elem_start(node->dispatch_ring,
+				esize, GRAPH_DISPATCH_PULL_MAX, &zcd, NULL);
+		for (i = 0; i < n; i++) {
+			if (i < zcd.n1)
+				stream = RTE_PTR_ADD(zcd.ptr1, i * esize);
+			else
+				stream = RTE_PTR_ADD(zcd.ptr2,
+						     (i - zcd.n1) * esize);
+
+			idx = node->idx;
+			__rte_node_enqueue_prologue(graph, node, idx,
+						    stream->nb_objs);
+			memcpy(&node->objs[idx], stream->objs,
+			       stream->nb_objs * sizeof(void *));
+			node->idx = idx + stream->nb_objs;
+		}
+		if (n)
+			rte_ring_dequeue_zc_elem_finish(node->dispatch_ring, n);
+	}
+}
@@ -105,10 +105,28 @@ struct graph {
 	/**< Number of packets to be captured per core. */
 	char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];
 	/**< pcap file name/path. */
+	enum rte_graph_model model;
+	/**< Graph walk model. */
+	unsigned int lcore_id;
+	/**< Lcore walking this instance in dispatch model. */
+	struct graph *parent;
+	/**< Graph created by rte_graph_create() if this is another instance
+	 * of a dispatch model graph, NULL otherwise.
+	 */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
 };
 
+/**
+ * @internal
+ *
+ * Element of the handoff ring of a node in dispatch model.
+ */
+struct graph_dispatch_stream {
+	uint32_t nb_objs; /**< Number of objects in the stream. */
+	void *objs[RTE_GRAPH_BURST_SIZE]; /**< Objects of the stream. */
+};
+
 /* Node functions */
 STAILQ_HEAD(node_head, node);
 
@@ -291,6 +309,36 @@ int graph_fp_mem_create(struct graph *graph);
  */
 int graph_fp_mem_destroy(struct graph *graph);
 
+/* Dispatch model functions */
+/**
+ * @internal
+ *
+ * Bind the nodes of a dispatch model graph to their lcores and create
+ * the handoff rings. All the instances of the graph must be created.
+ *
+ * @param graph
+ *   Pointer to the internal graph object created by rte_graph_create().
+ * @param prm
+ *   Graph parameter.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Failure, rte_errno is set.
+ */
+int graph_dispatch_setup(struct graph *graph,
+			 const struct rte_graph_param *prm);
+
+/**
+ * @internal
+ *
+ * Free the handoff rings of the nodes bound to the lcore of an instance
+ * of a dispatch model graph.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_dispatch_fini(struct graph *graph);
+
 /* Lookup functions */
 /**
  * @internal
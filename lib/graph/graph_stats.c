@@ -9,6 +9,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_ring.h>
 
 #include "graph_private.h"
 
@@ -40,14 +41,27 @@ struct rte_graph_cluster_stats {
 	struct cluster_node clusters[];
 } __rte_cache_aligned;
 
-#define boarder()                                                              \
-	fprintf(f, "+-------------------------------+---------------+--------" \
-		   "-------+---------------+---------------+---------------+-" \
-		   "----------+\n")
+#define BOARDER                                                                \
+	"+-------------------------------+---------------+---------------+"   \
+	"---------------+---------------+---------------+-----------+"
+#define BOARDER_DISPATCH "---------------+---------------+-----------+"
+
+#define boarder() fprintf(f, BOARDER "\n")
+#define boarder_dispatch() fprintf(f, BOARDER BOARDER_DISPATCH "\n")
 
 static inline void
-print_banner(FILE *f)
+print_banner(FILE *f, bool dispatch)
 {
+	if (dispatch) {
+		boarder_dispatch();
+		fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-13s%-15s%-16s%-12s\n",
+			"|Node", "|calls", "|objs", "|realloc_count",
+			"|objs/call", "|objs/sec(10E6)", "|cycles/call|",
+			"handoff_objs", "|handoff_fails", "|ring_count|");
+		boarder_dispatch();
+		return;
+	}
+
 	boarder();
 	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-16s\n", "|Node", "|calls",
 		"|objs", "|realloc_count", "|objs/call", "|objs/sec(10E6)",
@@ -56,7 +70,8 @@ print_banner(FILE *f)
 }
 
 static inline void
-print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
+print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat,
+	   bool dispatch)
 {
 	double objs_per_call, objs_per_sec, cycles_per_call, ts_per_hz;
 	const uint64_t prev_calls = stat->prev_calls;
@@ -78,27 +93,52 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 
 	fprintf(f,
 		"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
-		"|%-15.3f|%-15.6f|%-11.4f|\n",
+		"|%-15.3f|%-15.6f|%-11.4f|",
 		stat->name, calls, objs, stat->realloc_count, objs_per_call,
 		objs_per_sec, cycles_per_call);
+	if (dispatch)
+		fprintf(f, "%-15" PRIu64 "|%-15" PRIu64 "|%-11" PRIu32 "|\n",
+			stat->dispatch_objs, stat->dispatch_fails,
+			stat->ring_count);
+	else
+		fprintf(f, "\n");
 }
 
-static int
-graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
-		       const struct rte_graph_cluster_node_stats *stat)
+static inline int
+graph_cluster_stats_print(bool is_first, bool is_last, FILE *f,
+			  const struct rte_graph_cluster_node_stats *stat,
+			  bool dispatch)
 {
-	FILE *f = cookie;
-
 	if (unlikely(is_first))
-		print_banner(f);
-	if (stat->objs)
-		print_node(f, stat);
-	if (unlikely(is_last))
-		boarder();
+		print_banner(f, dispatch);
+	if (stat->objs || stat->dispatch_objs)
+		print_node(f, stat, dispatch);
+	if (unlikely(is_last)) {
+		if (dispatch)
+			boarder_dispatch();
+		else
+			boarder();
+	}
 
 	return 0;
+}
+
+static int
+graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
+		       const struct rte_graph_cluster_node_stats *stat)
+{
+	return graph_cluster_stats_print(is_first, is_last, cookie, stat,
+					 false);
 };
 
+static int
+graph_cluster_stats_dispatch_cb(bool is_first, bool is_last, void *cookie,
+				const struct rte_graph_cluster_node_stats *stat)
+{
+	return graph_cluster_stats_print(is_first, is_last, cookie, stat,
+					 true);
+}
+
 static struct rte_graph_cluster_stats *
 stats_mem_init(struct cluster *cluster,
 	       const struct rte_graph_cluster_stats_param *prm)
@@ -108,11 +148,18 @@ stats_mem_init(struct cluster *cluster,
 	rte_graph_cluster_stats_cb_t fn;
 	int socket_id = prm->socket_id;
 	uint32_t cluster_node_size;
+	bool dispatch = false;
+	rte_graph_t i;
+
+	for (i = 0; i < cluster->nb_graphs; i++)
+		if (cluster->graphs[i]->model == RTE_GRAPH_MODEL_DISPATCH)
+			dispatch = true;
 
-	/* Fix up callback */
+	/* Fix up callback, with the handoff stats of dispatch model graphs */
 	fn = prm->fn;
 	if (fn == NULL)
-		fn = graph_cluster_stats_cb;
+		fn = dispatch ? graph_cluster_stats_dispatch_cb :
+				graph_cluster_stats_cb;
 
 	cluster_node_size = sizeof(struct cluster_node);
 	/* For a given cluster, max nodes will be the max number of graphs */
@@ -252,6 +299,15 @@ expand_pattern_to_cluster(struct cluster *cluster, const char *pattern)
 			found = true;
 		}
 	}
+
+	/* Add the other instances of the matching dispatch model graphs */
+	STAILQ_FOREACH(graph, graph_head, next) {
+		if (graph->parent == NULL ||
+		    fnmatch(pattern, graph->parent->name, 0) != 0)
+			continue;
+		if (cluster_add(cluster, graph))
+			goto fail;
+	}
 	if (found == false)
 		SET_ERR_JMP(EFAULT, fail, "Pattern %s graph not found",
 			    pattern);
@@ -332,7 +388,10 @@ static inline void
 cluster_node_arregate_stats(struct cluster_node *cluster)
 {
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
+	uint64_t dispatch_objs = 0, dispatch_fails = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
+	const struct rte_graph *graph;
+	uint32_t ring_count = 0;
 	struct rte_node *node;
 	rte_node_t count;
 
@@ -343,6 +402,14 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		dispatch_objs += node->dispatch_objs;
+		dispatch_fails += node->dispatch_fails;
+
+		/* The ring is shared by the instances, count it once */
+		graph = RTE_PTR_SUB(node, node->off);
+		if (node->dispatch_ring != NULL &&
+		    node->lcore_id == graph->lcore_id)
+			ring_count += rte_ring_count(node->dispatch_ring);
 	}
 
 	stat->calls = calls;
@@ -350,6 +417,9 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	stat->cycles = cycles;
 	stat->ts = rte_get_timer_cycles();
 	stat->realloc_count = realloc_count;
+	stat->dispatch_objs = dispatch_objs;
+	stat->dispatch_fails = dispatch_fails;
+	stat->ring_count = ring_count;
 }
 
 static inline void
@@ -404,6 +474,9 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		node->dispatch_objs = 0;
+		node->dispatch_fails = 0;
+		node->ring_count = 0;
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
@@ -155,6 +155,33 @@ typedef void (*rte_node_fini_t)(const struct rte_graph *graph,
 typedef int (*rte_graph_cluster_stats_cb_t)(bool is_first, bool is_last,
 	     void *cookie, const struct rte_graph_cluster_node_stats *stats);
 
+/**
+ * Graph walk models.
+ *
+ * @see rte_graph_walk()
+ */
+enum rte_graph_model {
+	/** All the nodes run on the lcore walking the graph. */
+	RTE_GRAPH_MODEL_RTC = 0,
+	/** Nodes bound to an lcore run on it, the graph has one instance
+	 * per lcore and streams are handed off between the instances.
+	 */
+	RTE_GRAPH_MODEL_DISPATCH,
+};
+
+/** Default number of streams in the handoff ring of a node. */
+#define RTE_GRAPH_DISPATCH_RING_SIZE 64
+
+/**
+ * Lcore affinity of nodes in the dispatch model.
+ *
+ * @see rte_graph_param
+ */
+struct rte_graph_node_affinity {
+	const char *node_pattern; /**< Node names based on shell pattern. */
+	unsigned int lcore_id;    /**< Lcore walking the matching nodes. */
+};
+
 /**
  * Structure to hold configuration parameters for creating the graph.
  *
@@ -169,6 +196,27 @@ struct rte_graph_param {
 	bool pcap_enable; /**< Pcap enable. */
 	uint64_t num_pkt_to_capture; /**< Number of packets to capture. */
 	char *pcap_filename; /**< Filename in which packets to be captured.*/
+
+	enum rte_graph_model model; /**< Graph walk model. */
+	/** Configuration of the dispatch model. */
+	struct {
+		uint16_t nb_lcores; /**< Number of lcores walking the graph. */
+		const unsigned int *lcores;
+		/**< Lcores walking the graph, each one walks its own instance.
+		 * The instance of the first lcore is the graph named by
+		 * rte_graph_create(), see rte_graph_dispatch_lookup().
+		 */
+		uint16_t nb_affinities; /**< Number of node affinities. */
+		const struct rte_graph_node_affinity *affinities;
+		/**< Lcores of the nodes. The first affinity matching a node
+		 * applies. Nodes without affinity run on the lcore which
+		 * enqueued objects to them.
+		 */
+		uint32_t ring_size;
+		/**< Number of streams in the handoff ring of a bound node,
+		 * RTE_GRAPH_DISPATCH_RING_SIZE if 0.
+		 */
+	} dispatch;
 };
 
 /**
@@ -211,6 +259,11 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	uint64_t dispatch_objs; /**< Objs handed off to the lcore of the node. */
+	uint64_t dispatch_fails;
+	/**< Objs processed by the sending lcore as the handoff ring was full. */
+	uint32_t ring_count;	/**< Streams waiting in the handoff ring. */
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
@@ -221,6 +274,10 @@ struct rte_graph_cluster_node_stats {
  *
  * Create memory reel, detect loops and find isolated nodes.
  *
+ * In the dispatch model, one instance of the graph is created for each
+ * lcore of rte_graph_param::dispatch, with a handoff ring for each node
+ * bound to an lcore.
+ *
  * @param name
  *   Unique name for this graph.
  * @param prm
@@ -302,6 +359,27 @@ int rte_graph_export(const char *name, FILE *f);
 __rte_experimental
 struct rte_graph *rte_graph_lookup(const char *name);
 
+/**
+ * Get the instance of a dispatch model graph walked by an lcore.
+ *
+ * The instance of the first lcore given at graph creation is the graph
+ * itself, the instances of the other lcores are named
+ * "<name>-<lcore_id>".
+ *
+ * @param name
+ *   Name of the graph given to rte_graph_create().
+ * @param lcore_id
+ *   Lcore walking the instance.
+ *
+ * @return
+ *   Graph pointer on success, NULL otherwise.
+ *
+ * @see rte_graph_walk()
+ */
+__rte_experimental
+struct rte_graph *rte_graph_dispatch_lookup(const char *name,
+					    unsigned int lcore_id);
+
 /**
  * Get maximum number of graph available.
  *
@@ -29,6 +29,8 @@
 extern "C" {
 #endif
 
+struct rte_ring;
+
 /**
  * @internal
  *
@@ -42,6 +44,7 @@ struct rte_graph {
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	rte_graph_t id;	/**< Graph identifier. */
+	uint8_t model;	/**< Graph walk model, see enum rte_graph_model. */
 	int socket;	/**< Socket ID where memory is allocated. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
 	bool pcap_enable;	        /**< Pcap trace enabled. */
@@ -50,6 +53,12 @@ struct rte_graph {
 	/** Number of packets to capture per core. */
 	uint64_t nb_pkt_to_capture;
 	char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];  /**< Pcap filename. */
+	/** Lcore walking the graph in dispatch model. */
+	unsigned int lcore_id;
+	/** Number of nodes of this lcore with a handoff ring. */
+	rte_node_t nb_dispatch_nodes;
+	/** Offsets of the nodes of this lcore with a handoff ring. */
+	rte_graph_off_t *dispatch_nodes;
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
 
@@ -73,6 +82,14 @@ struct rte_node {
 	/** Original process function when pcap is enabled. */
 	rte_node_process_t original_process;
 
+	/* Dispatch model, see rte_graph_param::dispatch */
+	/** Lcore the node runs on in dispatch model, RTE_MAX_LCORE if any. */
+	unsigned int lcore_id;
+	/** Ring of the streams handed off to the node by other lcores. */
+	struct rte_ring *dispatch_ring;
+	uint64_t dispatch_objs;	/**< Objs handed off to the node lcore. */
+	uint64_t dispatch_fails; /**< Objs not handed off, ring full. */
+
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
 	uint8_t ctx[RTE_NODE_CTX_SZ] __rte_cache_aligned; /**< Node Context. */
@@ -128,14 +145,119 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Hand off the stream of a node to the lcore the node is bound to, in
+ * dispatch model. The objects which do not fit in the handoff ring are
+ * left in the stream.
+ *
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   True if the whole stream was handed off.
+ */
+__rte_experimental
+bool __rte_graph_dispatch_push(struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Move the streams handed off by other lcores to the nodes of the graph,
+ * in dispatch model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+__rte_experimental
+void __rte_graph_dispatch_pull(struct rte_graph *graph);
+
+/**
+ * @internal
+ *
+ * Invoke the process function of a node on its stream and collect the stats.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_process(struct rte_graph *graph, struct rte_node *node)
+{
+	uint64_t start;
+	uint16_t rc;
+	void **objs;
+
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	objs = node->objs;
+	rte_prefetch0(objs);
+
+	if (rte_graph_has_stats_feature()) {
+		start = rte_rdtsc();
+		rc = node->process(graph, node, objs, node->idx);
+		node->total_cycles += rte_rdtsc() - start;
+		node->total_calls++;
+		node->total_objs += rc;
+	} else {
+		node->process(graph, node, objs, node->idx);
+	}
+	node->idx = 0;
+}
+
+/**
+ * @internal
+ *
+ * Graph walk in dispatch model. Same as the run-to-completion walk,
+ * except that the streams of the nodes bound to another lcore are handed
+ * off to it, and that the streams handed off by other lcores are walked
+ * first.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+static inline void
+__rte_graph_walk_dispatch(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const unsigned int lcore_id = graph->lcore_id;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+
+	if (graph->nb_dispatch_nodes)
+		__rte_graph_dispatch_pull(graph);
+
+	while (likely(head != graph->tail)) {
+		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+		if (node->lcore_id != lcore_id &&
+		    node->lcore_id != RTE_MAX_LCORE) {
+			/* Source nodes are only polled by their lcore, the
+			 * others are processed here if the ring is full.
+			 */
+			if (node->dispatch_ring == NULL ||
+			    __rte_graph_dispatch_push(node))
+				goto next;
+		}
+		__rte_node_process(graph, node);
+next:
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+	graph->tail = 0;
+}
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
  *
+ * In dispatch model, the graph must be the instance of the calling lcore.
+ *
  * @param graph
  *   Graph pointer returned from rte_graph_lookup function.
  *
  * @see rte_graph_lookup()
+ * @see rte_graph_dispatch_lookup()
  */
 __rte_experimental
 static inline void
@@ -145,9 +267,11 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
 	struct rte_node *node;
-	uint64_t start;
-	uint16_t rc;
-	void **objs;
+
+	if (unlikely(graph->model == RTE_GRAPH_MODEL_DISPATCH)) {
+		__rte_graph_walk_dispatch(graph);
+		return;
+	}
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -166,20 +290,7 @@ rte_graph_walk(struct rte_graph *graph)
 	 */
 	while (likely(head != graph->tail)) {
 		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
-		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
-		objs = node->objs;
-		rte_prefetch0(objs);
-
-		if (rte_graph_has_stats_feature()) {
-			start = rte_rdtsc();
-			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
-			node->total_calls++;
-			node->total_objs += rc;
-		} else {
-			node->process(graph, node, objs, node->idx);
-		}
-		node->idx = 0;
+		__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _GRO_FLOW_HASH_H_
+#define _GRO_FLOW_HASH_H_
+
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_hash_crc.h>
+#include <rte_vect.h>
+
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+
+/*
+ * Flow index of a reassembly table. It is an open addressed hash
+ * table with linear probing, which maps a flow key to the index of
+ * the flow in the flow array of the table. It has at least twice as
+ * many buckets as the flow array has flows, so a probe always ends on
+ * an empty bucket.
+ */
+struct gro_flow_bucket {
+	/* Hash value of the flow key */
+	uint32_t sig;
+	/*
+	 * The index of the flow in the flow array.
+	 * INVALID_ARRAY_INDEX indicates an empty bucket.
+	 */
+	uint32_t flow_idx;
+};
+
+/*
+ * Get the number of buckets of the flow index for a flow array
+ * of max_flow_num flows.
+ */
+static inline uint32_t
+gro_flow_hash_size(uint32_t max_flow_num)
+{
+	return rte_align32pow2(max_flow_num * 2);
+}
+
+/*
+ * Empty all buckets of the flow index.
+ */
+static inline void
+gro_flow_hash_reset(struct gro_flow_bucket *buckets, uint32_t nb_buckets)
+{
+	/* Set all bits of both sig and flow_idx */
+	memset(buckets, 0xff, sizeof(*buckets) * nb_buckets);
+}
+
+static inline uint32_t
+gro_flow_key_hash(const void *key, uint32_t key_len)
+{
+	return rte_hash_crc(key, key_len, 0);
+}
+
+/*
+ * Check if two flow keys are equal. The flow keys don't have any
+ * padding, so they are compared as byte arrays, 16 bytes at a time.
+ * The last 16 bytes overlap the previous ones when key_len isn't a
+ * multiple of 16. key_len must be at least 16.
+ */
+static __rte_always_inline int
+gro_flow_key_eq(const void *k1, const void *k2, const size_t key_len)
+{
+	const uint8_t *p1 = k1;
+	const uint8_t *p2 = k2;
+	size_t i;
+#if defined(RTE_ARCH_X86)
+	__m128i x = _mm_setzero_si128();
+
+	for (i = 0; i + 16 < key_len; i += 16)
+		x = _mm_or_si128(x, _mm_xor_si128(
+				_mm_loadu_si128((const __m128i *)(p1 + i)),
+				_mm_loadu_si128((const __m128i *)(p2 + i))));
+	x = _mm_or_si128(x, _mm_xor_si128(
+			_mm_loadu_si128((const __m128i *)(p1 + key_len - 16)),
+			_mm_loadu_si128((const __m128i *)(p2 + key_len - 16))));
+
+	return _mm_testz_si128(x, x);
+#elif defined(RTE_ARCH_ARM64)
+	uint8x16_t x = vdupq_n_u8(0);
+
+	for (i = 0; i + 16 < key_len; i += 16)
+		x = vorrq_u8(x, veorq_u8(vld1q_u8(p1 + i), vld1q_u8(p2 + i)));
+	x = vorrq_u8(x, veorq_u8(vld1q_u8(p1 + key_len - 16),
+			vld1q_u8(p2 + key_len - 16)));
+
+	return vmaxvq_u8(x) == 0;
+#else
+	RTE_SET_USED(i);
+	return memcmp(p1, p2, key_len) == 0;
+#endif
+}
+
+/*
+ * Look up a flow key in the flow index. The key of each flow is the
+ * first member of the flow structure, whose size is flow_sz.
+ *
+ * @return
+ *  The index of the matched flow, or INVALID_ARRAY_INDEX.
+ */
+static __rte_always_inline uint32_t
+gro_flow_hash_lookup(const struct gro_flow_bucket *buckets, uint32_t mask,
+		uint32_t sig, const void *flows, const size_t flow_sz,
+		const void *key, const size_t key_len)
+{
+	uint32_t i, flow_idx;
+
+	for (i = sig & mask; ; i = (i + 1) & mask) {
+		flow_idx = buckets[i].flow_idx;
+		if (flow_idx == INVALID_ARRAY_INDEX)
+			return INVALID_ARRAY_INDEX;
+		if (buckets[i].sig == sig && gro_flow_key_eq(
+				(const uint8_t *)flows + flow_idx * flow_sz,
+				key, key_len))
+			return flow_idx;
+	}
+}
+
+/*
+ * Add a flow, which isn't in the flow index yet, to the flow index.
+ */
+static inline void
+gro_flow_hash_add(struct gro_flow_bucket *buckets, uint32_t mask,
+		uint32_t sig, uint32_t flow_idx)
+{
+	uint32_t i;
+
+	for (i = sig & mask; buckets[i].flow_idx != INVALID_ARRAY_INDEX;
+			i = (i + 1) & mask)
+		;
+	buckets[i].sig = sig;
+	buckets[i].flow_idx = flow_idx;
+}
+
+/*
+ * Remove a flow from the flow index. The following buckets of the
+ * probe sequence are shifted back, so no tombstone is left.
+ */
+static inline void
+gro_flow_hash_del(struct gro_flow_bucket *buckets, uint32_t mask,
+		uint32_t sig, uint32_t flow_idx)
+{
+	uint32_t i, j, home;
+
+	for (i = sig & mask; buckets[i].flow_idx != flow_idx;
+			i = (i + 1) & mask)
+		;
+
+	for (j = (i + 1) & mask; buckets[j].flow_idx != INVALID_ARRAY_INDEX;
+			j = (j + 1) & mask) {
+		home = buckets[j].sig & mask;
+		/* Move the bucket if its home isn't in (i, j] */
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			buckets[i] = buckets[j];
+			i = j;
+		}
+	}
+	buckets[i].flow_idx = INVALID_ARRAY_INDEX;
+}
+
+#endif
@@ -30,7 +30,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 	if (tbl == NULL)
 		return NULL;
 
-	size = sizeof(struct gro_tcp4_item) * entries_num;
+	size = sizeof(struct gro_tcp_item) * entries_num;
 	tbl->items = rte_zmalloc_socket(__func__,
 			size,
 			RTE_CACHE_LINE_SIZE,
@@ -56,6 +56,21 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	size = sizeof(struct gro_flow_bucket) *
+		gro_flow_hash_size(entries_num);
+	tbl->buckets = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->buckets == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->bucket_mask = gro_flow_hash_size(entries_num) - 1;
+	gro_flow_hash_reset(tbl->buckets, tbl->bucket_mask + 1);
+
 	return tbl;
 }
 
@@ -67,6 +82,7 @@ gro_tcp4_tbl_destroy(void *tbl)
 	if (tcp_tbl) {
 		rte_free(tcp_tbl->items);
 		rte_free(tcp_tbl->flows);
+		rte_free(tcp_tbl->buckets);
 	}
 	rte_free(tcp_tbl);
 }
@@ -148,6 +164,7 @@ delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
+		uint32_t sig,
 		uint32_t item_idx)
 {
 	struct tcp4_flow_key *dst;
@@ -169,6 +186,7 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 
 	tbl->flows[flow_idx].start_index = item_idx;
 	tbl->flow_num++;
+	gro_flow_hash_add(tbl->buckets, tbl->bucket_mask, sig, flow_idx);
 
 	return flow_idx;
 }
@@ -177,7 +195,7 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
  * update the packet length for the flushed packet.
  */
 static inline void
-update_header(struct gro_tcp4_item *item)
+update_header(struct gro_tcp_item *item)
 {
 	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_mbuf *pkt = item->firstseg;
@@ -203,9 +221,8 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	int cmp;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -257,30 +274,21 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.recv_ack = tcp_hdr->recv_ack;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	sig = gro_flow_key_hash(&key, sizeof(key));
+	i = gro_flow_hash_lookup(tbl->buckets, tbl->bucket_mask, sig,
+			tbl->flows, sizeof(struct gro_tcp4_flow), &key, sizeof(key));
 
 	/*
 	 * Fail to find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (i == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, ip_id,
 				is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, sig, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -303,7 +311,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
 				is_atomic);
 		if (cmp) {
-			if (merge_two_tcp4_packets(&(tbl->items[cur_idx]),
+			if (merge_two_tcp_packets(&(tbl->items[cur_idx]),
 						pkt, cmp, sent_seq, ip_id, 0))
 				return 1;
 			/*
@@ -355,8 +363,13 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(tbl->buckets,
+						tbl->bucket_mask,
+						gro_flow_key_hash(&tbl->flows[i].key,
+							sizeof(tbl->flows[i].key)), i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -57,6 +57,21 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	size = sizeof(struct gro_flow_bucket) *
+		gro_flow_hash_size(entries_num);
+	tbl->buckets = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->buckets == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->bucket_mask = gro_flow_hash_size(entries_num) - 1;
+	gro_flow_hash_reset(tbl->buckets, tbl->bucket_mask + 1);
+
 	return tbl;
 }
 
@@ -68,6 +83,7 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->buckets);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -152,6 +168,7 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 		struct vxlan_tcp4_flow_key *src,
+		uint32_t sig,
 		uint32_t item_idx)
 {
 	struct vxlan_tcp4_flow_key *dst;
@@ -184,27 +201,11 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 
 	tbl->flows[flow_idx].start_index = item_idx;
 	tbl->flow_num++;
+	gro_flow_hash_add(tbl->buckets, tbl->bucket_mask, sig, flow_idx);
 
 	return flow_idx;
 }
 
-static inline int
-is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
-		struct vxlan_tcp4_flow_key k2)
-{
-	return (rte_is_same_ether_addr(&k1.outer_eth_saddr,
-					&k2.outer_eth_saddr) &&
-			rte_is_same_ether_addr(&k1.outer_eth_daddr,
-				&k2.outer_eth_daddr) &&
-			(k1.outer_ip_src_addr == k2.outer_ip_src_addr) &&
-			(k1.outer_ip_dst_addr == k2.outer_ip_dst_addr) &&
-			(k1.outer_src_port == k2.outer_src_port) &&
-			(k1.outer_dst_port == k2.outer_dst_port) &&
-			(k1.vxlan_hdr.vx_flags == k2.vxlan_hdr.vx_flags) &&
-			(k1.vxlan_hdr.vx_vni == k2.vxlan_hdr.vx_vni) &&
-			is_same_tcp4_flow(k1.inner_key, k2.inner_key));
-}
-
 static inline int
 check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 		struct rte_tcp_hdr *tcp_hdr,
@@ -248,7 +249,7 @@ merge_two_vxlan_tcp4_packets(struct gro_vxlan_tcp4_item *item,
 		uint16_t outer_ip_id,
 		uint16_t ip_id)
 {
-	if (merge_two_tcp4_packets(&item->inner_item, pkt, cmp, sent_seq,
+	if (merge_two_tcp_packets(&item->inner_item, pkt, cmp, sent_seq,
 				ip_id, pkt->outer_l2_len +
 				pkt->outer_l3_len)) {
 		/* Update the outer IPv4 ID to the large value. */
@@ -301,10 +302,9 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct vxlan_tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	int cmp;
 	uint16_t hdr_len;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -375,30 +375,21 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.outer_dst_port = udp_hdr->dst_port;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	sig = gro_flow_key_hash(&key, sizeof(key));
+	i = gro_flow_hash_lookup(tbl->buckets, tbl->bucket_mask, sig,
+			tbl->flows, sizeof(struct gro_vxlan_tcp4_flow), &key, sizeof(key));
 
 	/*
 	 * Can't find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (i == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, outer_ip_id,
 				ip_id, outer_is_atomic, is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, sig, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -475,8 +466,13 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(tbl->buckets,
+						tbl->bucket_mask,
+						gro_flow_key_hash(&tbl->flows[i].key,
+							sizeof(tbl->flows[i].key)), i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
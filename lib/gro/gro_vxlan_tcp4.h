@@ -36,7 +36,7 @@ struct gro_vxlan_tcp4_flow {
 };
 
 struct gro_vxlan_tcp4_item {
-	struct gro_tcp4_item inner_item;
+	struct gro_tcp_item inner_item;
 	/* IPv4 ID in the outer IPv4 header */
 	uint16_t outer_ip_id;
 	/* Indicate if outer IPv4 ID can be ignored */
@@ -60,6 +60,10 @@ struct gro_vxlan_tcp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/* flow index */
+	struct gro_flow_bucket *buckets;
+	/* the number of buckets of the flow index minus one */
+	uint32_t bucket_mask;
 };
 
 /**
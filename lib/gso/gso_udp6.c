@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <errno.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+/* Identification of the next fragmented packet */
+static uint32_t ipv6_frag_id;
+
+static inline void
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t l2_hdrlen = pkt->l2_len;
+	uint16_t hdr_offset = l2_hdrlen + pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, frag_offset = 0, is_mf, i;
+	uint32_t id;
+
+	/* All the fragments of a packet share the same identification */
+	id = __atomic_fetch_add(&ipv6_frag_id, 1, __ATOMIC_RELAXED);
+
+	for (i = 0; i < nb_segs; i++) {
+		/*
+		 * The direct MBUF of an output segment ends with the IPv6
+		 * header, so the fragment header is appended to it.
+		 */
+		frag_hdr = rte_pktmbuf_mtod_offset(segs[i],
+			struct rte_ipv6_fragment_ext *, hdr_offset);
+		segs[i]->data_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->pkt_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+
+		ipv6_hdr = rte_pktmbuf_mtod_offset(segs[i],
+			struct rte_ipv6_hdr *, l2_hdrlen);
+		is_mf = i < tail_idx ? RTE_IPV6_EHDR_MF_MASK : 0;
+		frag_hdr->next_header = ipv6_hdr->proto;
+		frag_hdr->reserved = 0;
+		frag_hdr->frag_data = rte_cpu_to_be_16(
+				RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf));
+		frag_hdr->id = rte_cpu_to_be_32(id);
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+		update_ipv6_header(segs[i], l2_hdrlen);
+
+		frag_offset += segs[i]->pkt_len - hdr_offset -
+			RTE_IPV6_FRAG_HDR_SIZE;
+	}
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret;
+
+	/* Don't process the packet with IPv6 extension headers */
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			pkt->l2_len);
+	if (unlikely(ipv6_hdr->proto != IPPROTO_UDP ||
+			pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* The direct MBUFs must have room for the fragment header */
+	if (unlikely(rte_pktmbuf_data_room_size(direct_pool) <
+			RTE_PKTMBUF_HEADROOM + hdr_offset +
+			RTE_IPV6_FRAG_HDR_SIZE))
+		return -EINVAL;
+
+	/* pyld_unit_size must be a multiple of 8 because frag_off
+	 * uses 8 bytes as unit.
+	 */
+	if (unlikely(gso_size < hdr_offset + RTE_IPV6_FRAG_HDR_SIZE +
+			RTE_IPV6_EHDR_FO_ALIGN))
+		return -EINVAL;
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~7U;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_ipv6_udp_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
@@ -19,12 +19,16 @@
 #include <rte_string_fns.h>
 #include <rte_cpuflags.h>
 #include <rte_rwlock.h>
+#include <rte_spinlock.h>
 #include <rte_ring_elem.h>
 #include <rte_vect.h>
 #include <rte_tailq.h>
 
 #include "rte_hash.h"
 #include "rte_cuckoo_hash.h"
+#if defined(RTE_ARCH_X86)
+#include "rte_cuckoo_hash_x86.h"
+#endif
 
 /* Mask of all flags supported by this version */
 #define RTE_HASH_EXTRA_FLAGS_MASK (RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT | \
@@ -32,7 +36,12 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE | \
+				   RTE_HASH_EXTRA_FLAGS_AGING)
+
+#define RTE_HASH_EXTRA_FLAGS2_MASK \
+	RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -128,6 +137,55 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/*
+ * Resizable tables grow their key store by adding segments, so that the
+ * keys never move and key indexes stay valid across resizes.
+ */
+static inline struct rte_hash_key *
+get_key_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	if (likely(!h->resize_support))
+		return (struct rte_hash_key *)((char *)h->key_store +
+				key_idx * h->key_entry_size);
+
+	return (struct rte_hash_key *)((char *)
+			h->key_segs[key_idx >> h->key_seg_shift] +
+			(key_idx & h->key_seg_mask) * h->key_entry_size);
+}
+
+/* Last access timestamp of a key entry, only with aging enabled */
+static inline uint64_t *
+get_key_age(const struct rte_hash *h, struct rte_hash_key *k)
+{
+	return (uint64_t *)((char *)k + h->age_offset);
+}
+
+/*
+ * Allocate the ring of free key slots of a resizable table. It is not
+ * registered as a named ring, as it is replaced by a larger one each
+ * time the table grows.
+ */
+static struct rte_ring *
+alloc_slot_ring(const char *name, uint32_t count, int socket_id)
+{
+	struct rte_ring *r;
+	ssize_t ring_size;
+
+	ring_size = rte_ring_get_memsize_elem(sizeof(uint32_t), count);
+	if (ring_size < 0)
+		return NULL;
+
+	r = rte_zmalloc_socket(NULL, ring_size, RTE_CACHE_LINE_SIZE, socket_id);
+	if (r == NULL)
+		return NULL;
+
+	if (rte_ring_init(r, name, count, 0) != 0) {
+		rte_free(r);
+		return NULL;
+	}
+	return r;
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -152,6 +210,9 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resize_support = 0;
+	unsigned int writer_bucket_lock = 0;
+	uint32_t age_offset = 0;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -172,7 +233,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
-	if (params->extra_flag & ~RTE_HASH_EXTRA_FLAGS_MASK) {
+	if ((params->extra_flag & ~RTE_HASH_EXTRA_FLAGS_MASK) ||
+			(params->extra_flag2 & ~RTE_HASH_EXTRA_FLAGS2_MASK)) {
 		rte_errno = EINVAL;
 		RTE_LOG(ERR, HASH, "rte_hash_create: unsupported extra flags\n");
 		return NULL;
@@ -187,6 +249,28 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+				   RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table cannot "
+			"use ext table or multi writer add\n");
+		return NULL;
+	}
+
+	if ((params->extra_flag2 &
+			RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK) &&
+	    (!(params->extra_flag & RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD) ||
+	     (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY |
+				    RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+				    RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: bucket lock requires "
+			"multi writer add, without rw concurrency, ext table "
+			"or transactional memory\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -216,8 +300,22 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)
+		resize_support = 1;
+
+	/* Multiple writers lock only the buckets they update */
+	if (params->extra_flag2 &
+			RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK)
+		writer_bucket_lock = 1;
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
-	if (use_local_cache)
+	if (resize_support)
+		/*
+		 * The key store grows by segments of a power of 2 slots,
+		 * the first segment includes the dummy entry.
+		 */
+		num_key_slots = rte_align32pow2(params->entries + 1);
+	else if (use_local_cache)
 		/*
 		 * Increase number of slots by total number of indices
 		 * that can be stored in the lcore caches
@@ -230,8 +328,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 
 	snprintf(ring_name, sizeof(ring_name), "HT_%s", params->name);
 	/* Create ring (Dummy slot index is not enqueued) */
-	r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
-			rte_align32pow2(num_key_slots), params->socket_id, 0);
+	if (resize_support)
+		r = alloc_slot_ring(ring_name, num_key_slots,
+				params->socket_id);
+	else
+		r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
+				rte_align32pow2(num_key_slots),
+				params->socket_id, 0);
 	if (r == NULL) {
 		RTE_LOG(ERR, HASH, "memory allocation failed\n");
 		goto err;
@@ -325,7 +428,15 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		}
 	}
 
-	const uint32_t key_entry_size =
+	/* The last access timestamp follows the key, on the cache line
+	 * already read by the key compare of a lookup.
+	 */
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING)
+		age_offset = RTE_ALIGN(sizeof(struct rte_hash_key) +
+				params->key_len, sizeof(uint64_t));
+
+	const uint32_t key_entry_size = age_offset ?
+		RTE_ALIGN(age_offset + sizeof(uint64_t), KEY_ALIGNMENT) :
 		RTE_ALIGN(sizeof(struct rte_hash_key) + params->key_len,
 			  KEY_ALIGNMENT);
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
@@ -407,6 +518,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->entries = params->entries;
 	h->key_len = params->key_len;
 	h->key_entry_size = key_entry_size;
+	h->age_offset = age_offset;
 	h->hash_func_init_val = params->hash_func_init_val;
 
 	h->num_buckets = num_buckets;
@@ -427,10 +539,37 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->readwrite_concur_support = readwrite_concur_support;
 	h->ext_table_support = ext_table_support;
 	h->writer_takes_lock = writer_takes_lock;
+	h->writer_bucket_lock = writer_bucket_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resize_support = resize_support;
+	h->socket_id = params->socket_id;
+
+	if (resize_support) {
+		/* All the slots of the first segment are usable */
+		h->entries = num_key_slots - 1;
+		h->key_seg_shift = rte_bsf32(num_key_slots);
+		h->key_seg_mask = num_key_slots - 1;
+		h->key_segs[0] = k;
+		h->num_key_segs = 1;
+		h->max_key_segs = RTE_MIN((uint32_t)RTE_HASH_RESIZE_MAX_GROWTH,
+				RTE_HASH_ENTRIES_MAX / num_key_slots);
+	}
 
 #if defined(RTE_ARCH_X86)
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
+#ifdef CC_HASH_AVX2_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX2;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -466,7 +605,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 err_unlock:
 	rte_mcfg_tailq_write_unlock();
 err:
-	rte_ring_free(r);
+	if (resize_support)
+		rte_free(r);
+	else
+		rte_ring_free(r);
 	rte_ring_free(r_ext);
 	rte_free(te);
 	rte_free(local_free_slots);
@@ -484,6 +626,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	uint32_t i;
 
 	if (h == NULL)
 		return;
@@ -509,12 +652,22 @@ rte_hash_free(struct rte_hash *h)
 
 	if (h->dq)
 		rte_rcu_qsbr_dq_delete(h->dq);
+	if (h->retired_dq)
+		rte_rcu_qsbr_dq_delete(h->retired_dq);
 
 	if (h->use_local_cache)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
 		rte_free(h->readwrite_lock);
-	rte_ring_free(h->free_slots);
+	if (h->resize_support) {
+		/* Segments are allocated in blocks doubling the key store */
+		for (i = 1; i < h->num_key_segs; i <<= 1)
+			rte_free(h->key_segs[i]);
+		rte_free(h->old_buckets);
+		rte_free(h->retired_buckets);
+		rte_free(h->free_slots);
+	} else
+		rte_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
 	rte_free(h->buckets);
@@ -627,8 +780,26 @@ rte_hash_reset(struct rte_hash *h)
 			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
 	}
 
+	if (h->retired_dq) {
+		if (rte_rcu_qsbr_dq_delete(h->retired_dq) != 0)
+			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
+		else
+			h->retired_dq = NULL;
+	}
+
+	if (h->resize_support) {
+		/* Drop any resize in progress, the table keeps its size */
+		rte_free(h->old_buckets);
+		h->old_buckets = NULL;
+		rte_free(h->retired_buckets);
+		h->retired_buckets = NULL;
+		for (i = 0; i < h->num_key_segs; i++)
+			memset(h->key_segs[i], 0,
+				(uint64_t)h->key_entry_size *
+				(h->key_seg_mask + 1));
+	} else
+		memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
-	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
 
 	/* reset the free ring */
@@ -692,12 +863,11 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	struct rte_hash_bucket *bkt, uint16_t sig)
 {
 	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = get_key_slot(h, bkt->key_idx[i]);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				/* The store to application data at *data
 				 * should not leak after the store to pdata
@@ -1006,7 +1176,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
-	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct rte_hash_key *new_k;
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
@@ -1063,7 +1233,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			return -ENOSPC;
 	}
 
-	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
+	new_k = get_key_slot(h, slot_id);
 	/* The store to application data (by the application) at *data should
 	 * not leak after the store of pdata in the key store. i.e. pdata is
 	 * the guard variable. Release the application data to the readers.
@@ -1073,6 +1243,9 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		__ATOMIC_RELEASE);
 	/* Copy key */
 	memcpy(new_k->key, key, h->key_len);
+	/* The next age scan sets the initial timestamp */
+	if (h->age_offset)
+		__atomic_store_n(get_key_age(h, new_k), 0, __ATOMIC_RELAXED);
 
 	/* Find an empty slot and insert */
 	ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key, data,
@@ -1192,148 +1365,778 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 }
 
-int32_t
-rte_hash_add_key_with_hash(const struct rte_hash *h,
-			const void *key, hash_sig_t sig)
+/* Insert an entry in the first empty slot of @bkt, return -1 if it is full */
+static inline int
+bucket_insert_empty(struct rte_hash_bucket *bkt, uint16_t sig,
+		uint32_t key_idx)
 {
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, sig, 0);
+	unsigned int i;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->key_idx[i] == EMPTY_SLOT) {
+			bkt->sig_current[i] = sig;
+			/* Store to signature should not leak after
+			 * the store to key_idx.
+			 */
+			__atomic_store_n(&bkt->key_idx[i], key_idx,
+					 __ATOMIC_RELEASE);
+			return 0;
+		}
+	}
+	return -1;
 }
 
-int32_t
-rte_hash_add_key(const struct rte_hash *h, const void *key)
+/* Lock the primary and secondary buckets of a key. The locks are taken
+ * in address order so that writers cannot deadlock.
+ */
+static inline void
+__hash_bkt_lock_pair(struct rte_hash_bucket *b1, struct rte_hash_bucket *b2)
 {
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), 0);
+	if (b1 > b2)
+		RTE_SWAP(b1, b2);
+	rte_spinlock_lock(&b1->lock);
+	if (b2 != b1)
+		rte_spinlock_lock(&b2->lock);
 }
 
-int
-rte_hash_add_key_with_hash_data(const struct rte_hash *h,
-			const void *key, hash_sig_t sig, void *data)
+static inline void
+__hash_bkt_unlock_pair(struct rte_hash_bucket *b1,
+		struct rte_hash_bucket *b2)
 {
-	int ret;
+	rte_spinlock_unlock(&b1->lock);
+	if (b2 != b1)
+		rte_spinlock_unlock(&b2->lock);
+}
 
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
-	if (ret >= 0)
-		return 0;
-	else
-		return ret;
+/* Bucket locked version of rte_hash_cuckoo_insert_mw(). Only tries to
+ * insert in @ins_bkt, which is @prim_bkt or @sec_bkt, while holding the
+ * locks of both buckets of the key.
+ * return 1 if matching existing key, return 0 if succeeds, return -1 for no
+ * empty entry.
+ */
+static inline int32_t
+rte_hash_cuckoo_insert_bl(const struct rte_hash *h,
+		struct rte_hash_bucket *ins_bkt,
+		struct rte_hash_bucket *prim_bkt,
+		struct rte_hash_bucket *sec_bkt,
+		const void *key, void *data,
+		uint16_t sig, uint32_t new_idx,
+		int32_t *ret_val)
+{
+	int32_t ret;
+
+	__hash_bkt_lock_pair(prim_bkt, sec_bkt);
+	/* Check if key was inserted after last check but before this
+	 * protected region in case of inserting duplicated keys.
+	 */
+	ret = search_and_update(h, data, key, prim_bkt, sig);
+	if (ret == -1)
+		ret = search_and_update(h, data, key, sec_bkt, sig);
+	if (ret != -1) {
+		__hash_bkt_unlock_pair(prim_bkt, sec_bkt);
+		*ret_val = ret;
+		return 1;
+	}
+
+	ret = bucket_insert_empty(ins_bkt, sig, new_idx);
+	__hash_bkt_unlock_pair(prim_bkt, sec_bkt);
+
+	return ret;
 }
 
-int
-rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
+/* Move entry @src_slot of @src_bkt (index @src_idx) to the empty entry
+ * @dst_slot of its alternative bucket @dst_bkt (index @dst_idx).
+ * The other writers may have changed the buckets since the cuckoo search,
+ * so the move is checked again under the bucket locks.
+ * return 0 if succeeds, return -1 if the cuckoo path was invalidated.
+ */
+static inline int
+rte_hash_cuckoo_move_bl(const struct rte_hash *h,
+		struct rte_hash_bucket *src_bkt, uint32_t src_idx,
+		uint32_t src_slot,
+		struct rte_hash_bucket *dst_bkt, uint32_t dst_idx,
+		uint32_t dst_slot)
 {
-	int ret;
+	int ret = -1;
 
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	__hash_bkt_lock_pair(src_bkt, dst_bkt);
 
-	ret = __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), data);
-	if (ret >= 0)
-		return 0;
-	else
-		return ret;
+	if (dst_bkt->key_idx[dst_slot] != EMPTY_SLOT ||
+			src_bkt->key_idx[src_slot] == EMPTY_SLOT ||
+			get_alt_bucket_index(h, src_idx,
+				src_bkt->sig_current[src_slot]) != dst_idx)
+		goto out;
+
+	dst_bkt->sig_current[dst_slot] = src_bkt->sig_current[src_slot];
+	/* Release the entry, it is now present in both buckets */
+	__atomic_store_n(&dst_bkt->key_idx[dst_slot],
+			 src_bkt->key_idx[src_slot],
+			 __ATOMIC_RELEASE);
+
+	if (h->readwrite_concur_lf_support) {
+		/* Inform the readers before the entry leaves the source
+		 * bucket. Other writers may update tbl_chng_cnt at the
+		 * same time.
+		 */
+		__atomic_fetch_add(h->tbl_chng_cnt, 1, __ATOMIC_RELEASE);
+		/* The store to key_idx should not move above
+		 * the store to tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+
+	src_bkt->sig_current[src_slot] = NULL_SIGNATURE;
+	__atomic_store_n(&src_bkt->key_idx[src_slot],
+			 EMPTY_SLOT,
+			 __ATOMIC_RELEASE);
+	ret = 0;
+
+out:
+	__hash_bkt_unlock_pair(src_bkt, dst_bkt);
+	return ret;
 }
 
-/* Search one bucket to find the match key - uses rw lock */
-static inline int32_t
-search_one_bucket_l(const struct rte_hash *h, const void *key,
-		uint16_t sig, void **data,
-		const struct rte_hash_bucket *bkt)
+/* Shift the entries along the cuckoo path ending at @leaf and @leaf_slot,
+ * one move at a time, then insert the new entry at the path head.
+ * return 1 if matched key found, return -1 if cuckoo path invalided and fail,
+ * return 0 if succeeds.
+ */
+static inline int
+rte_hash_cuckoo_move_insert_bl(const struct rte_hash *h,
+			struct rte_hash_bucket *prim_bkt,
+			struct rte_hash_bucket *sec_bkt,
+			const void *key, void *data,
+			struct queue_node *leaf, uint32_t leaf_slot,
+			uint16_t sig, uint32_t new_idx,
+			int32_t *ret_val)
 {
-	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct queue_node *prev_node, *curr_node = leaf;
+	uint32_t curr_slot = leaf_slot;
 
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == sig &&
-				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+	while (likely(curr_node->prev != NULL)) {
+		prev_node = curr_node->prev;
+		if (rte_hash_cuckoo_move_bl(h, prev_node->bkt,
+				prev_node->cur_bkt_idx, curr_node->prev_slot,
+				curr_node->bkt, curr_node->cur_bkt_idx,
+				curr_slot) != 0)
+			return -1;
 
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				if (data != NULL)
-					*data = k->pdata;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
-		}
+		curr_slot = curr_node->prev_slot;
+		curr_node = prev_node;
 	}
-	return -1;
+
+	return rte_hash_cuckoo_insert_bl(h, curr_node->bkt, prim_bkt, sec_bkt,
+			key, data, sig, new_idx, ret_val);
 }
 
-/* Search one bucket to find the match key */
-static inline int32_t
-search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
-			void **data, const struct rte_hash_bucket *bkt)
+/*
+ * Make space for new key in @bkt, using bfs Cuckoo Search. The buckets
+ * are locked two at a time while moving the entries.
+ */
+static inline int
+rte_hash_cuckoo_make_space_bl(const struct rte_hash *h,
+			struct rte_hash_bucket *bkt, uint32_t bucket_idx,
+			struct rte_hash_bucket *prim_bkt,
+			struct rte_hash_bucket *sec_bkt,
+			const void *key, void *data, uint16_t sig,
+			uint32_t new_idx, int32_t *ret_val)
 {
-	int i;
-	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	unsigned int i;
+	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
+	struct queue_node *tail, *head;
+	struct rte_hash_bucket *curr_bkt;
+	uint32_t cur_idx, alt_idx;
 
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		/* Signature comparison is done before the acquire-load
-		 * of the key index to achieve better performance.
-		 * This can result in the reader loading old signature
-		 * (which matches), while the key_idx is updated to a
-		 * value that belongs to a new key. However, the full
-		 * key comparison will ensure that the lookup fails.
-		 */
-		if (bkt->sig_current[i] == sig) {
-			key_idx = __atomic_load_n(&bkt->key_idx[i],
-					  __ATOMIC_ACQUIRE);
-			if (key_idx != EMPTY_SLOT) {
-				k = (struct rte_hash_key *) ((char *)keys +
-						key_idx * h->key_entry_size);
+	tail = queue;
+	head = queue + 1;
+	tail->bkt = bkt;
+	tail->prev = NULL;
+	tail->prev_slot = -1;
+	tail->cur_bkt_idx = bucket_idx;
 
-				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-					if (data != NULL) {
-						*data = __atomic_load_n(
-							&k->pdata,
-							__ATOMIC_ACQUIRE);
-					}
-					/*
-					 * Return index where key is stored,
-					 * subtracting the first dummy index
-					 */
-					return key_idx - 1;
-				}
+	/* Cuckoo bfs Search */
+	while (likely(tail != head && head <
+					queue + RTE_HASH_BFS_QUEUE_MAX_LEN -
+					RTE_HASH_BUCKET_ENTRIES)) {
+		curr_bkt = tail->bkt;
+		cur_idx = tail->cur_bkt_idx;
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (curr_bkt->key_idx[i] == EMPTY_SLOT) {
+				int32_t ret = rte_hash_cuckoo_move_insert_bl(h,
+						prim_bkt, sec_bkt, key, data,
+						tail, i, sig,
+						new_idx, ret_val);
+				if (likely(ret != -1))
+					return ret;
 			}
+
+			/* Enqueue new node and keep prev node info */
+			alt_idx = get_alt_bucket_index(h, cur_idx,
+						curr_bkt->sig_current[i]);
+			head->bkt = &h->buckets[alt_idx];
+			head->cur_bkt_idx = alt_idx;
+			head->prev = tail;
+			head->prev_slot = i;
+			head++;
 		}
+		tail++;
 	}
-	return -1;
+
+	return -ENOSPC;
 }
 
+/* Add a key when the writers lock only the buckets they update.
+ * The table has no extendable buckets in this mode.
+ */
 static inline int32_t
-__rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
-				hash_sig_t sig, void **data)
+__rte_hash_add_key_with_hash_bl(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
 {
+	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	struct lcore_cache *cached_free_slots;
+	struct rte_hash_key *new_k;
+	uint32_t slot_id;
+	int32_t ret_val;
 	int ret;
-	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+	rte_prefetch0(prim_bkt);
+	rte_prefetch0(sec_bkt);
 
-	bkt = &h->buckets[prim_bucket_idx];
-
-	__hash_rw_reader_lock(h);
-
-	/* Check if key is in primary location */
-	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
-	if (ret != -1) {
-		__hash_rw_reader_unlock(h);
+	/* Check if key is already inserted in primary or secondary location */
+	__hash_bkt_lock_pair(prim_bkt, sec_bkt);
+	ret = search_and_update(h, data, key, prim_bkt, short_sig);
+	if (ret == -1)
+		ret = search_and_update(h, data, key, sec_bkt, short_sig);
+	__hash_bkt_unlock_pair(prim_bkt, sec_bkt);
+	if (ret != -1)
 		return ret;
-	}
-	/* Calculate secondary hash */
-	bkt = &h->buckets[sec_bucket_idx];
 
-	/* Check if key is in secondary location */
-	FOR_EACH_BUCKET(cur_bkt, bkt) {
+	/* Did not find a match, so get a new slot for storing the new key */
+	cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT) {
+		/* The defer queue is multi-thread safe */
+		if (h->dq && rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->max_reclaim_size,
+				NULL, NULL, NULL) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
+		if (slot_id == EMPTY_SLOT)
+			return -ENOSPC;
+	}
+
+	new_k = get_key_slot(h, slot_id);
+	/* The store to application data (by the application) at *data should
+	 * not leak after the store of pdata in the key store. i.e. pdata is
+	 * the guard variable. Release the application data to the readers.
+	 */
+	__atomic_store_n(&new_k->pdata,
+		data,
+		__ATOMIC_RELEASE);
+	/* Copy key */
+	memcpy(new_k->key, key, h->key_len);
+	/* The next age scan sets the initial timestamp */
+	if (h->age_offset)
+		__atomic_store_n(get_key_age(h, new_k), 0, __ATOMIC_RELAXED);
+
+	/* Find an empty slot and insert */
+	ret = rte_hash_cuckoo_insert_bl(h, prim_bkt, prim_bkt, sec_bkt,
+					key, data, short_sig, slot_id,
+					&ret_val);
+	/* Primary bucket full, need to make space for new entry */
+	if (ret == -1)
+		ret = rte_hash_cuckoo_make_space_bl(h, prim_bkt,
+				prim_bucket_idx, prim_bkt, sec_bkt, key, data,
+				short_sig, slot_id, &ret_val);
+	/* Also search secondary bucket to get better occupancy */
+	if (ret == -ENOSPC)
+		ret = rte_hash_cuckoo_make_space_bl(h, sec_bkt,
+				sec_bucket_idx, prim_bkt, sec_bkt, key, data,
+				short_sig, slot_id, &ret_val);
+
+	if (ret == 0)
+		return slot_id - 1;
+
+	enqueue_slot_back(h, cached_free_slots, slot_id);
+	if (ret == 1)
+		return ret_val;
+
+	return -ENOSPC;
+}
+
+static struct rte_rcu_qsbr_dq *
+__hash_rcu_dq_create(struct rte_hash *h, const struct rte_hash_rcu_config *cfg,
+			uint32_t size);
+
+/* Release the bucket array and the defer queue retired by the last resize
+ * once the readers which may still reference them have gone through
+ * a quiescent state. Never waits for the readers.
+ */
+static inline void
+__rte_hash_resize_reclaim(struct rte_hash *h)
+{
+	if (h->retired_buckets != NULL &&
+			rte_rcu_qsbr_check(h->hash_rcu_cfg->v,
+				h->retired_token, false) == 1) {
+		rte_free(h->retired_buckets);
+		h->retired_buckets = NULL;
+	}
+
+	/* Fails while some of its entries are not reclaimable yet */
+	if (h->retired_dq != NULL &&
+			rte_rcu_qsbr_dq_delete(h->retired_dq) == 0)
+		h->retired_dq = NULL;
+}
+
+/* Called once all the buckets of old_buckets are migrated.
+ * Writer is expected to hold the lock while calling this function.
+ */
+static inline void
+__rte_hash_resize_finish(struct rte_hash *h)
+{
+	struct rte_hash_bucket *old_buckets = h->old_buckets;
+
+	__atomic_store_n(&h->old_buckets, NULL, __ATOMIC_RELEASE);
+
+	if (h->readwrite_concur_lf_support) {
+		/* Lock free readers might still be searching the old bucket
+		 * array, free it after the next grace period.
+		 */
+		__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+		h->retired_buckets = old_buckets;
+		h->retired_token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+	} else
+		rte_free(old_buckets);
+}
+
+/*
+ * Move the entries of up to @n_buckets buckets of old_buckets to the current
+ * bucket array. Entries are first made visible in their new bucket and then
+ * removed from the old one, so the readers always find them in one of them.
+ * Return the number of buckets left to migrate or -ENOSPC.
+ */
+static int
+__rte_hash_resize_migrate(struct rte_hash *h, uint32_t n_buckets)
+{
+	struct rte_hash_bucket *old_bkt, *prim_bkt, *sec_bkt;
+	struct rte_hash_key *k;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t key_idx, i;
+	uint16_t short_sig;
+	hash_sig_t sig;
+	int32_t ret_val;
+	int ret;
+
+	__hash_rw_writer_lock(h);
+
+	while (h->old_buckets != NULL && n_buckets-- > 0) {
+		old_bkt = &h->old_buckets[h->migrate_cursor];
+
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			key_idx = old_bkt->key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+
+			k = get_key_slot(h, key_idx);
+			sig = rte_hash_hash(h, k->key);
+			short_sig = old_bkt->sig_current[i];
+			prim_bucket_idx = get_prim_bucket_index(h, sig);
+			sec_bucket_idx = get_alt_bucket_index(h,
+					prim_bucket_idx, short_sig);
+			prim_bkt = &h->buckets[prim_bucket_idx];
+			sec_bkt = &h->buckets[sec_bucket_idx];
+
+			/* The doubled table is at most half full, the entry
+			 * nearly always fits in its primary or secondary bucket.
+			 */
+			if (bucket_insert_empty(prim_bkt, short_sig,
+						key_idx) != 0 &&
+			    bucket_insert_empty(sec_bkt, short_sig,
+						key_idx) != 0) {
+				/* Push entries of the new table around */
+				__hash_rw_writer_unlock(h);
+				ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt,
+						sec_bkt, (const void *)k->key,
+						k->pdata, short_sig,
+						prim_bucket_idx, key_idx,
+						&ret_val);
+				if (ret < 0)
+					ret = rte_hash_cuckoo_make_space_mw(h,
+						sec_bkt, prim_bkt,
+						(const void *)k->key, k->pdata,
+						short_sig, sec_bucket_idx,
+						key_idx, &ret_val);
+				__hash_rw_writer_lock(h);
+				if (ret < 0) {
+					__hash_rw_writer_unlock(h);
+					RTE_LOG(ERR, HASH, "%s: no space to "
+						"migrate entry\n", __func__);
+					return -ENOSPC;
+				}
+			}
+
+			if (h->readwrite_concur_lf_support) {
+				/* Inform the readers that the entry moved.
+				 * Since there is one writer, load acquires on
+				 * tbl_chng_cnt are not required.
+				 */
+				__atomic_store_n(h->tbl_chng_cnt,
+						 *h->tbl_chng_cnt + 1,
+						 __ATOMIC_RELEASE);
+				/* The store to sig_current should not
+				 * move above the store to tbl_chng_cnt.
+				 */
+				__atomic_thread_fence(__ATOMIC_RELEASE);
+			}
+			old_bkt->sig_current[i] = NULL_SIGNATURE;
+			__atomic_store_n(&old_bkt->key_idx[i], EMPTY_SLOT,
+					 __ATOMIC_RELEASE);
+		}
+
+		__atomic_store_n(&h->migrate_cursor, h->migrate_cursor + 1,
+				 __ATOMIC_RELEASE);
+		if (h->migrate_cursor == h->old_num_buckets)
+			__rte_hash_resize_finish(h);
+	}
+
+	ret = h->old_buckets != NULL ?
+		(int)(h->old_num_buckets - h->migrate_cursor) : 0;
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+/*
+ * Double the bucket array and the key store of a resizable table.
+ * The buckets of the previous array are migrated afterwards by
+ * __rte_hash_resize_migrate().
+ * Writer is expected to hold the lock while calling this function.
+ */
+static int
+__rte_hash_resize_grow(struct rte_hash *h)
+{
+	const uint32_t seg_slots = h->key_seg_mask + 1;
+	const uint32_t num_segs = h->num_key_segs;
+	struct rte_hash_bucket *buckets = NULL;
+	struct rte_rcu_qsbr_dq *dq = NULL;
+	struct rte_ring *r = NULL;
+	uint32_t slots[LCORE_CACHE_SIZE];
+	uint32_t i, n_slots, slot_id;
+	void *k = NULL;
+
+	if (num_segs * 2 > h->max_key_segs)
+		return -ENOSPC;
+
+	if (h->readwrite_concur_lf_support && h->hash_rcu_cfg == NULL) {
+		RTE_LOG(DEBUG, HASH, "%s: lock free resizable hash "
+			"requires RCU QSBR\n", __func__);
+		return -ENOSPC;
+	}
+
+	/* Only one bucket array and one defer queue can be waiting for the
+	 * readers. The writer may be a reader itself, so do not wait for
+	 * them: the next insertion failing for lack of space retries.
+	 */
+	__rte_hash_resize_reclaim(h);
+	if (h->retired_buckets != NULL || h->retired_dq != NULL) {
+		RTE_LOG(DEBUG, HASH, "%s: previous resize not reclaimed "
+			"yet\n", __func__);
+		return -ENOSPC;
+	}
+
+	/* The defer queue has to hold the deleted keys of the larger table */
+	if (h->dq != NULL) {
+		dq = __hash_rcu_dq_create(h, h->hash_rcu_cfg,
+				2 * h->hash_rcu_cfg->dq_size);
+		if (dq == NULL) {
+			RTE_LOG(ERR, HASH, "%s: defer queue creation failed\n",
+				__func__);
+			return -ENOMEM;
+		}
+	}
+
+	k = rte_zmalloc_socket(NULL,
+			(uint64_t)h->key_entry_size * seg_slots * num_segs,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	buckets = rte_zmalloc_socket(NULL,
+			2 * h->num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	r = alloc_slot_ring(h->free_slots->name, 2 * seg_slots * num_segs,
+			h->socket_id);
+	if (k == NULL || buckets == NULL || r == NULL) {
+		RTE_LOG(ERR, HASH, "%s: memory allocation failed\n", __func__);
+		rte_free(k);
+		rte_free(buckets);
+		rte_free(r);
+		rte_rcu_qsbr_dq_delete(dq);
+		return -ENOMEM;
+	}
+
+	/* Entries of the previous defer queue are reclaimed from it */
+	if (dq != NULL) {
+		h->retired_dq = h->dq;
+		h->dq = dq;
+		h->dq_gen++;
+		h->hash_rcu_cfg->dq_size *= 2;
+	}
+
+	/* The new segments must be visible before their slots get used */
+	for (i = 0; i < num_segs; i++)
+		h->key_segs[num_segs + i] = RTE_PTR_ADD(k,
+				(uint64_t)h->key_entry_size * seg_slots * i);
+	h->num_key_segs = 2 * num_segs;
+
+	/* Move the free slots to the larger ring and add the new ones */
+	do {
+		n_slots = rte_ring_sc_dequeue_burst_elem(h->free_slots, slots,
+				sizeof(uint32_t), RTE_DIM(slots), NULL);
+		rte_ring_sp_enqueue_bulk_elem(r, slots, sizeof(uint32_t),
+				n_slots, NULL);
+	} while (n_slots != 0);
+
+	for (slot_id = seg_slots * num_segs;
+			slot_id < seg_slots * num_segs * 2; slot_id++)
+		rte_ring_sp_enqueue_elem(r, &slot_id, sizeof(uint32_t));
+
+	rte_free(h->free_slots);
+	h->free_slots = r;
+	h->entries += seg_slots * num_segs;
+
+	/* Readers load the bucket bitmask before the bucket array, so they
+	 * never index an array with the bitmask of a larger one.
+	 */
+	h->old_bucket_bitmask = h->bucket_bitmask;
+	h->old_num_buckets = h->num_buckets;
+	h->migrate_cursor = 0;
+	__atomic_store_n(&h->old_buckets, h->buckets, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	h->num_buckets *= 2;
+	__atomic_store_n(&h->bucket_bitmask, h->num_buckets - 1,
+			 __ATOMIC_RELEASE);
+
+	if (h->readwrite_concur_lf_support)
+		__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/* Migrate a few buckets on each writer call while a resize is ongoing */
+static inline void
+__rte_hash_resize_work(struct rte_hash *h)
+{
+	__rte_hash_resize_reclaim(h);
+	if (h->old_buckets != NULL)
+		__rte_hash_resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_STEP);
+}
+
+static int32_t
+__rte_hash_add_key_with_hash_rs(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	struct rte_hash *rh = (struct rte_hash *)(uintptr_t)h;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+
+	__rte_hash_resize_work(rh);
+
+	/* Check if key is still in a bucket not migrated yet */
+	if (h->old_buckets != NULL) {
+		short_sig = get_short_sig(sig);
+		prim_bucket_idx = sig & h->old_bucket_bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					h->old_bucket_bitmask;
+
+		__hash_rw_writer_lock(h);
+		ret = search_and_update(h, data, key,
+				&h->old_buckets[prim_bucket_idx], short_sig);
+		if (ret == -1)
+			ret = search_and_update(h, data, key,
+				&h->old_buckets[sec_bucket_idx], short_sig);
+		__hash_rw_writer_unlock(h);
+		if (ret != -1)
+			return ret;
+	}
+
+	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
+	while (ret == -ENOSPC) {
+		if (h->old_buckets != NULL) {
+			/* Table filled up before the last resize completed */
+			if (__rte_hash_resize_migrate(rh, UINT32_MAX) != 0)
+				return -ENOSPC;
+		} else {
+			__hash_rw_writer_lock(h);
+			ret = __rte_hash_resize_grow(rh);
+			__hash_rw_writer_unlock(h);
+			if (ret != 0)
+				return -ENOSPC;
+		}
+		ret = __rte_hash_add_key_with_hash(h, key, sig, data);
+	}
+
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_add_key(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	if (unlikely(h->resize_support))
+		return __rte_hash_add_key_with_hash_rs(h, key, sig, data);
+	else if (h->writer_bucket_lock)
+		return __rte_hash_add_key_with_hash_bl(h, key, sig, data);
+	else
+		return __rte_hash_add_key_with_hash(h, key, sig, data);
+}
+
+int32_t
+rte_hash_add_key_with_hash(const struct rte_hash *h,
+			const void *key, hash_sig_t sig)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_add_key(h, key, sig, 0);
+}
+
+int32_t
+rte_hash_add_key(const struct rte_hash *h, const void *key)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_add_key(h, key, rte_hash_hash(h, key), 0);
+}
+
+int
+rte_hash_add_key_with_hash_data(const struct rte_hash *h,
+			const void *key, hash_sig_t sig, void *data)
+{
+	int ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	ret = __rte_hash_add_key(h, key, sig, data);
+	if (ret >= 0)
+		return 0;
+	else
+		return ret;
+}
+
+int
+rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
+{
+	int ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+
+	ret = __rte_hash_add_key(h, key, rte_hash_hash(h, key), data);
+	if (ret >= 0)
+		return 0;
+	else
+		return ret;
+}
+
+/* Search one bucket to find the match key - uses rw lock */
+static inline int32_t
+search_one_bucket_l(const struct rte_hash *h, const void *key,
+		uint16_t sig, void **data,
+		const struct rte_hash_bucket *bkt)
+{
+	int i;
+	struct rte_hash_key *k;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->sig_current[i] == sig &&
+				bkt->key_idx[i] != EMPTY_SLOT) {
+			k = get_key_slot(h, bkt->key_idx[i]);
+
+			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+				if (data != NULL)
+					*data = k->pdata;
+				/*
+				 * Return index where key is stored,
+				 * subtracting the first dummy index
+				 */
+				return bkt->key_idx[i] - 1;
+			}
+		}
+	}
+	return -1;
+}
+
+/* Search one bucket to find the match key */
+static inline int32_t
+search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
+			void **data, const struct rte_hash_bucket *bkt)
+{
+	int i;
+	uint32_t key_idx;
+	struct rte_hash_key *k;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		/* Signature comparison is done before the acquire-load
+		 * of the key index to achieve better performance.
+		 * This can result in the reader loading old signature
+		 * (which matches), while the key_idx is updated to a
+		 * value that belongs to a new key. However, the full
+		 * key comparison will ensure that the lookup fails.
+		 */
+		if (bkt->sig_current[i] == sig) {
+			key_idx = __atomic_load_n(&bkt->key_idx[i],
+					  __ATOMIC_ACQUIRE);
+			if (key_idx != EMPTY_SLOT) {
+				k = get_key_slot(h, key_idx);
+
+				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+					if (data != NULL) {
+						*data = __atomic_load_n(
+							&k->pdata,
+							__ATOMIC_ACQUIRE);
+					}
+					/*
+					 * Return index where key is stored,
+					 * subtracting the first dummy index
+					 */
+					return key_idx - 1;
+				}
+			}
+		}
+	}
+	return -1;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
+				hash_sig_t sig, void **data)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *bkt, *cur_bkt;
+	int ret;
+	uint16_t short_sig;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	bkt = &h->buckets[prim_bucket_idx];
+
+	__hash_rw_reader_lock(h);
+
+	/* Check if key is in primary location */
+	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
+	if (ret != -1) {
+		__hash_rw_reader_unlock(h);
+		return ret;
+	}
+	/* Calculate secondary hash */
+	bkt = &h->buckets[sec_bucket_idx];
+
+	/* Check if key is in secondary location */
+	FOR_EACH_BUCKET(cur_bkt, bkt) {
 		ret = search_one_bucket_l(h, key, short_sig,
 					data, cur_bkt);
 		if (ret != -1) {
@@ -1348,18 +2151,79 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 }
 
 static inline int32_t
-__rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
+__rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *bkt, *cur_bkt;
+	uint32_t cnt_b, cnt_a;
+	int ret;
+	uint16_t short_sig;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	do {
+		/* Load the table change counter before the lookup
+		 * starts. Acquire semantics will make sure that
+		 * loads in search_one_bucket are not hoisted.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+				__ATOMIC_ACQUIRE);
+
+		/* Check if key is in primary location */
+		bkt = &h->buckets[prim_bucket_idx];
+		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
+		if (ret != -1)
+			return ret;
+		/* Calculate secondary hash */
+		bkt = &h->buckets[sec_bucket_idx];
+
+		/* Check if key is in secondary location */
+		FOR_EACH_BUCKET(cur_bkt, bkt) {
+			ret = search_one_bucket_lf(h, key, short_sig,
+						data, cur_bkt);
+			if (ret != -1)
+				return ret;
+		}
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		/* Re-read the table change counter to check if the
+		 * table has changed during search. If yes, re-do
+		 * the search.
+		 * This load should not get hoisted. The load
+		 * acquires on cnt_b, key index in primary bucket
+		 * and key index in secondary bucket will make sure
+		 * that it does not get hoisted.
+		 */
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	return -ENOENT;
+}
+
+/* Lookup in a resizable table, searching also the buckets of the previous
+ * bucket array which are not migrated yet.
+ */
+static inline int32_t
+__rte_hash_lookup_with_hash_rs(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
+	const struct rte_hash_bucket *buckets, *old_buckets;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	uint32_t bitmask, cursor;
 	uint32_t cnt_b, cnt_a;
-	int ret;
+	int32_t ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	__hash_rw_reader_lock(h);
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1369,20 +2233,47 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 				__ATOMIC_ACQUIRE);
 
-		/* Check if key is in primary location */
-		bkt = &h->buckets[prim_bucket_idx];
-		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
+		/* The bucket array is replaced before its bitmask grows,
+		 * load them in the opposite order.
+		 */
+		bitmask = __atomic_load_n(&h->bucket_bitmask,
+				__ATOMIC_ACQUIRE);
+		buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		prim_bucket_idx = sig & bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) & bitmask;
+
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+					&buckets[prim_bucket_idx]);
 		if (ret != -1)
-			return ret;
-		/* Calculate secondary hash */
-		bkt = &h->buckets[sec_bucket_idx];
+			goto out;
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+					&buckets[sec_bucket_idx]);
+		if (ret != -1)
+			goto out;
 
-		/* Check if key is in secondary location */
-		FOR_EACH_BUCKET(cur_bkt, bkt) {
-			ret = search_one_bucket_lf(h, key, short_sig,
-						data, cur_bkt);
-			if (ret != -1)
-				return ret;
+		old_buckets = __atomic_load_n(&h->old_buckets,
+				__ATOMIC_ACQUIRE);
+		if (old_buckets != NULL) {
+			/* Buckets below the cursor are already migrated */
+			cursor = __atomic_load_n(&h->migrate_cursor,
+					__ATOMIC_ACQUIRE);
+			bitmask = h->old_bucket_bitmask;
+			prim_bucket_idx = sig & bitmask;
+			sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+						bitmask;
+
+			if (prim_bucket_idx >= cursor) {
+				ret = search_one_bucket_lf(h, key, short_sig,
+					data, &old_buckets[prim_bucket_idx]);
+				if (ret != -1)
+					goto out;
+			}
+			if (sec_bucket_idx >= cursor) {
+				ret = search_one_bucket_lf(h, key, short_sig,
+					data, &old_buckets[sec_bucket_idx]);
+				if (ret != -1)
+					goto out;
+			}
 		}
 
 		/* The loads of sig_current in search_one_bucket
@@ -1392,23 +2283,24 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		/* Re-read the table change counter to check if the
 		 * table has changed during search. If yes, re-do
 		 * the search.
-		 * This load should not get hoisted. The load
-		 * acquires on cnt_b, key index in primary bucket
-		 * and key index in secondary bucket will make sure
-		 * that it does not get hoisted.
 		 */
 		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 	} while (cnt_b != cnt_a);
 
-	return -ENOENT;
+	ret = -ENOENT;
+out:
+	__hash_rw_reader_unlock(h);
+	return ret;
 }
 
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resize_support))
+		return __rte_hash_lookup_with_hash_rs(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1475,16 +2367,13 @@ __hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
 {
 	void *key_data = NULL;
 	int ret;
-	struct rte_hash_key *keys, *k;
+	struct rte_hash_key *k;
 	struct rte_hash *h = (struct rte_hash *)p;
 	struct __rte_hash_rcu_dq_entry rcu_dq_entry =
 			*((struct __rte_hash_rcu_dq_entry *)e);
 
 	RTE_SET_USED(n);
-	keys = h->key_store;
-
-	k = (struct rte_hash_key *) ((char *)keys +
-				rcu_dq_entry.key_idx * h->key_entry_size);
+	k = get_key_slot(h, rcu_dq_entry.key_idx);
 	key_data = k->pdata;
 	if (h->hash_rcu_cfg->free_key_data_func)
 		h->hash_rcu_cfg->free_key_data_func(h->hash_rcu_cfg->key_data_ptr,
@@ -1504,11 +2393,33 @@ __hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
 	}
 }
 
-int
-rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
+/* Create a defer queue of @size entries for the keys deleted from @h */
+static struct rte_rcu_qsbr_dq *
+__hash_rcu_dq_create(struct rte_hash *h, const struct rte_hash_rcu_config *cfg,
+			uint32_t size)
 {
 	struct rte_rcu_qsbr_dq_parameters params = {0};
 	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	/* The queue replaced by a resize is alive until drained:
+	 * alternate between two names.
+	 */
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "HASH_RCU%s_%s",
+			(h->dq_gen & 1) ? "1" : "", h->name);
+	params.name = rcu_dq_name;
+	params.size = size;
+	params.trigger_reclaim_limit = cfg->trigger_reclaim_limit;
+	params.max_reclaim_size = cfg->max_reclaim_size;
+	params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+	params.free_fn = __hash_rcu_qsbr_free_resource;
+	params.p = h;
+	params.v = cfg->v;
+	return rte_rcu_qsbr_dq_create(&params);
+}
+
+int
+rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
+{
 	struct rte_hash_rcu_config *hash_rcu_cfg = NULL;
 
 	if (h == NULL || cfg == NULL || cfg->v == NULL) {
@@ -1531,43 +2442,34 @@ rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
 		return 1;
 	}
 
+	hash_rcu_cfg->v = cfg->v;
+	hash_rcu_cfg->mode = cfg->mode;
+	hash_rcu_cfg->trigger_reclaim_limit = cfg->trigger_reclaim_limit;
+	hash_rcu_cfg->max_reclaim_size = RTE_HASH_RCU_DQ_RECLAIM_MAX;
+	hash_rcu_cfg->free_key_data_func = cfg->free_key_data_func;
+	hash_rcu_cfg->key_data_ptr = cfg->key_data_ptr;
+
 	if (cfg->mode == RTE_HASH_QSBR_MODE_SYNC) {
 		/* No other things to do. */
 	} else if (cfg->mode == RTE_HASH_QSBR_MODE_DQ) {
 		/* Init QSBR defer queue. */
-		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
-					"HASH_RCU_%s", h->name);
-		params.name = rcu_dq_name;
-		params.size = cfg->dq_size;
-		if (params.size == 0)
-			params.size = total_entries;
-		params.trigger_reclaim_limit = cfg->trigger_reclaim_limit;
-		if (params.max_reclaim_size == 0)
-			params.max_reclaim_size = RTE_HASH_RCU_DQ_RECLAIM_MAX;
-		params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
-		params.free_fn = __hash_rcu_qsbr_free_resource;
-		params.p = h;
-		params.v = cfg->v;
-		h->dq = rte_rcu_qsbr_dq_create(&params);
+		hash_rcu_cfg->dq_size = cfg->dq_size;
+		if (hash_rcu_cfg->dq_size == 0)
+			hash_rcu_cfg->dq_size = total_entries;
+		h->dq = __hash_rcu_dq_create(h, hash_rcu_cfg,
+				hash_rcu_cfg->dq_size);
 		if (h->dq == NULL) {
 			rte_free(hash_rcu_cfg);
 			RTE_LOG(ERR, HASH, "HASH defer queue creation failed\n");
 			return 1;
 		}
+		h->dq_gen++;
 	} else {
 		rte_free(hash_rcu_cfg);
 		rte_errno = EINVAL;
 		return 1;
 	}
 
-	hash_rcu_cfg->v = cfg->v;
-	hash_rcu_cfg->mode = cfg->mode;
-	hash_rcu_cfg->dq_size = params.size;
-	hash_rcu_cfg->trigger_reclaim_limit = params.trigger_reclaim_limit;
-	hash_rcu_cfg->max_reclaim_size = params.max_reclaim_size;
-	hash_rcu_cfg->free_key_data_func = cfg->free_key_data_func;
-	hash_rcu_cfg->key_data_ptr = cfg->key_data_ptr;
-
 	h->hash_rcu_cfg = hash_rcu_cfg;
 
 	return 0;
@@ -1636,7 +2538,7 @@ static inline int32_t
 search_and_remove(const struct rte_hash *h, const void *key,
 			struct rte_hash_bucket *bkt, uint16_t sig, int *pos)
 {
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 	unsigned int i;
 	uint32_t key_idx;
 
@@ -1645,8 +2547,7 @@ search_and_remove(const struct rte_hash *h, const void *key,
 		key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 		if (bkt->sig_current[i] == sig && key_idx != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					key_idx * h->key_entry_size);
+			k = get_key_slot(h, key_idx);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
 				/* Free the key store index if
@@ -1671,6 +2572,65 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Free the key index @position (and the ext bucket @ext_bkt_idx)
+ * through the internal RCU QSBR.
+ */
+static inline void
+__hash_rcu_qsbr_free_key(const struct rte_hash *h, int32_t position,
+			uint32_t ext_bkt_idx)
+{
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	/* Key index where key is stored, adding the first dummy index */
+	rcu_dq_entry.key_idx = position + 1;
+	rcu_dq_entry.ext_bkt_idx = ext_bkt_idx;
+	if (h->dq == NULL) {
+		/* Wait for quiescent state change if using
+		 * RTE_HASH_QSBR_MODE_SYNC
+		 */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+		__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+					      &rcu_dq_entry, 1);
+	} else if (h->dq)
+		/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
+		if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
+			RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+}
+
+/* Delete a key when the writers lock only the buckets they update */
+static inline int32_t
+__rte_hash_del_key_with_hash_bl(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig;
+	int32_t ret;
+	int pos;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+
+	__hash_bkt_lock_pair(prim_bkt, sec_bkt);
+	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
+	if (ret == -1)
+		ret = search_and_remove(h, key, sec_bkt, short_sig, &pos);
+	__hash_bkt_unlock_pair(prim_bkt, sec_bkt);
+
+	if (ret == -1)
+		return -ENOENT;
+
+	/* Using internal RCU QSBR, no bucket lock is needed */
+	if (h->hash_rcu_cfg)
+		__hash_rcu_qsbr_free_key(h, ret, EMPTY_SLOT);
+
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
@@ -1682,7 +2642,11 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret, i;
 	uint16_t short_sig;
 	uint32_t index = EMPTY_SLOT;
-	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	if (unlikely(h->resize_support))
+		__rte_hash_resize_work((struct rte_hash *)(uintptr_t)h);
+	else if (h->writer_bucket_lock)
+		return __rte_hash_del_key_with_hash_bl(h, key, sig);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1712,6 +2676,22 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Look for key in buckets not migrated yet by a resize */
+	if (h->old_buckets != NULL) {
+		prim_bucket_idx = sig & h->old_bucket_bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					h->old_bucket_bitmask;
+		ret = search_and_remove(h, key,
+				&h->old_buckets[prim_bucket_idx], short_sig,
+				&pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+					&h->old_buckets[sec_bucket_idx],
+					short_sig, &pos);
+		if (ret != -1)
+			goto return_key;
+	}
+
 	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
@@ -1755,23 +2735,8 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 
 return_key:
 	/* Using internal RCU QSBR */
-	if (h->hash_rcu_cfg) {
-		/* Key index where key is stored, adding the first dummy index */
-		rcu_dq_entry.key_idx = ret + 1;
-		rcu_dq_entry.ext_bkt_idx = index;
-		if (h->dq == NULL) {
-			/* Wait for quiescent state change if using
-			 * RTE_HASH_QSBR_MODE_SYNC
-			 */
-			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
-						 RTE_QSBR_THRID_INVALID);
-			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
-						      &rcu_dq_entry, 1);
-		} else if (h->dq)
-			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
-	}
+	if (h->hash_rcu_cfg)
+		__hash_rcu_qsbr_free_key(h, ret, index);
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
@@ -1797,9 +2762,7 @@ rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	struct rte_hash_key *k, *keys = h->key_store;
-	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
-				     h->key_entry_size);
+	struct rte_hash_key *k = get_key_slot(h, position + 1);
 	*key = k->key;
 
 	if (position !=
@@ -1895,6 +2858,46 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/*
+ * Compare the signatures of a burst of keys. The AVX2/AVX512 versions
+ * compare the buckets of several keys with one instruction.
+ */
+static inline void
+compare_signatures_bulk(const struct rte_hash *h, uint32_t *prim_hitmask,
+			uint32_t *sec_hitmask,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			const uint16_t *sig, int32_t num_keys)
+{
+	int32_t i;
+
+	/* Vector versions load the signatures from the bucket address */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_hash_bucket, sig_current) != 0);
+
+	switch (h->sig_cmp_fn) {
+#ifdef CC_HASH_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+		rte_hash_compare_sigs_avx512(primary_bkt, secondary_bkt, sig,
+			num_keys, prim_hitmask, sec_hitmask);
+		break;
+#endif
+#ifdef CC_HASH_AVX2_SUPPORT
+	case RTE_HASH_COMPARE_AVX2:
+		rte_hash_compare_sigs_avx2(primary_bkt, secondary_bkt, sig,
+			num_keys, prim_hitmask, sec_hitmask);
+		break;
+#endif
+	default:
+		for (i = 0; i < num_keys; i++) {
+			prim_hitmask[i] = 0;
+			sec_hitmask[i] = 0;
+			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
+				primary_bkt[i], secondary_bkt[i],
+				sig[i], h->sig_cmp_fn);
+		}
+	}
+}
+
 static inline void
 __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
@@ -1905,18 +2908,16 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	uint64_t hits = 0;
 	int32_t i;
 	int32_t ret;
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
 	struct rte_hash_bucket *cur_bkt, *next_bkt;
 
 	__hash_rw_reader_lock(h);
 
 	/* Compare signatures and prefetch key slot of first hit */
+	compare_signatures_bulk(h, prim_hitmask, sec_hitmask,
+		primary_bkt, secondary_bkt, sig, num_keys);
 	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
-
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
 					__builtin_ctzl(prim_hitmask[i])
@@ -1924,9 +2925,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 			continue;
 		}
@@ -1938,9 +2937,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 		}
 	}
@@ -1955,9 +2952,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -1983,9 +2978,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -2052,8 +3045,8 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 	uint64_t hits = 0;
 	int32_t i;
 	int32_t ret;
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
 	struct rte_hash_bucket *cur_bkt, *next_bkt;
 	uint32_t cnt_b, cnt_a;
 
@@ -2069,11 +3062,9 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					__ATOMIC_ACQUIRE);
 
 		/* Compare signatures and prefetch key slot of first hit */
+		compare_signatures_bulk(h, prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, sig, num_keys);
 		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
-
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
 						__builtin_ctzl(prim_hitmask[i])
@@ -2081,9 +3072,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					primary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 				continue;
 			}
@@ -2095,9 +3084,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					secondary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 			}
 		}
@@ -2113,9 +3100,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&primary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2145,9 +3130,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&secondary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2307,12 +3290,102 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		positions, hit_mask, data);
 }
 
+/* Bulk lookup in a resizable table. @prim_hash is NULL if the hash values
+ * of the keys are not precomputed.
+ */
+static inline void
+__rte_hash_lookup_bulk_rs(const struct rte_hash *h, const void **keys,
+			hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	int32_t i;
+	uint64_t hits = 0;
+	uint32_t bitmask;
+	uint32_t prim_index, sec_index;
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *buckets;
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++)
+		hash[i] = prim_hash != NULL ? prim_hash[i] :
+					rte_hash_hash(h, keys[i]);
+
+	/* With reader locks a resize can complete between the bucket
+	 * prefetch and the search, look up the keys one by one.
+	 */
+	if (h->readwrite_concur_support) {
+		for (i = 0; i < num_keys; i++) {
+			positions[i] = __rte_hash_lookup_with_hash_rs(h,
+					keys[i], hash[i],
+					data != NULL ? &data[i] : NULL);
+			if (positions[i] >= 0)
+				hits |= 1ULL << i;
+		}
+		goto out;
+	}
+
+	/* Use the same bucket array for all the keys, see
+	 * __rte_hash_lookup_with_hash_rs() for the load order.
+	 */
+	bitmask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+	buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < num_keys; i++) {
+		rte_prefetch0(keys[i]);
+
+		sig[i] = get_short_sig(hash[i]);
+		prim_index = hash[i] & bitmask;
+		sec_index = (prim_index ^ sig[i]) & bitmask;
+
+		primary_bkt[i] = &buckets[prim_index];
+		secondary_bkt[i] = &buckets[sec_index];
+
+		rte_prefetch0(primary_bkt[i]);
+		rte_prefetch0(secondary_bkt[i]);
+	}
+
+	if (h->readwrite_concur_lf_support)
+		__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig,
+			num_keys, positions, &hits, data);
+	else
+		__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig,
+			num_keys, positions, &hits, data);
+
+	/* Keys missed might not be migrated yet or might have been moved by
+	 * a resize started after the bucket array was loaded.
+	 */
+	if (hits != (UINT64_MAX >> (64 - num_keys)) &&
+			(__atomic_load_n(&h->old_buckets, __ATOMIC_ACQUIRE) !=
+				NULL ||
+			 __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE) !=
+				buckets)) {
+		for (i = 0; i < num_keys; i++) {
+			if ((hits & (1ULL << i)) != 0)
+				continue;
+			positions[i] = __rte_hash_lookup_with_hash_rs(h,
+					keys[i], hash[i],
+					data != NULL ? &data[i] : NULL);
+			if (positions[i] >= 0)
+				hits |= 1ULL << i;
+		}
+	}
+
+out:
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resize_support))
+		__rte_hash_lookup_bulk_rs(h, keys, NULL, num_keys, positions,
+					  hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2424,7 +3497,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resize_support))
+		__rte_hash_lookup_bulk_rs(h, keys, prim_hash, num_keys,
+				positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2465,6 +3541,46 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/* Iterate the buckets of a resizable table not migrated yet, they follow
+ * the current bucket array in the iterator space.
+ */
+static int32_t
+__rte_hash_iterate_old(const struct rte_hash *h, const void **key,
+		void **data, uint32_t *next, uint32_t total_entries_main)
+{
+	uint32_t bucket_idx, idx, position, total_entries;
+	struct rte_hash_key *next_key;
+
+	if (h->old_buckets == NULL)
+		return -ENOENT;
+
+	total_entries = total_entries_main +
+			h->old_num_buckets * RTE_HASH_BUCKET_ENTRIES;
+
+	for (; *next < total_entries; (*next)++) {
+		bucket_idx = (*next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+		position = h->old_buckets[bucket_idx].key_idx[idx];
+		if (position == EMPTY_SLOT)
+			continue;
+
+		__hash_rw_reader_lock(h);
+		next_key = get_key_slot(h, position);
+		/* Return key and data */
+		*key = next_key->key;
+		*data = next_key->pdata;
+
+		__hash_rw_reader_unlock(h);
+
+		/* Increment iterator */
+		(*next)++;
+		return position - 1;
+	}
+
+	return -ENOENT;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2497,8 +3613,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	}
 
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = get_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2512,6 +3627,10 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	if (h->resize_support)
+		return __rte_hash_iterate_old(h, key, data, next,
+					      total_entries_main);
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -2528,8 +3647,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 	}
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = get_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2540,3 +3658,147 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+int32_t
+rte_hash_lookup_touch(const struct rte_hash *h, const void *key, uint64_t now)
+{
+	int32_t ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL) || (now == 0)), -EINVAL);
+	if (h->age_offset == 0)
+		return -ENOTSUP;
+
+	ret = __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), NULL);
+	if (ret >= 0)
+		__atomic_store_n(get_key_age(h, get_key_slot(h, ret + 1)), now,
+				 __ATOMIC_RELAXED);
+
+	return ret;
+}
+
+int
+rte_hash_lookup_bulk_touch(const struct rte_hash *h, const void **keys,
+			   uint32_t num_keys, int32_t *positions, uint64_t now)
+{
+	uint32_t i;
+	int hits = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL) || (now == 0)), -EINVAL);
+	if (h->age_offset == 0)
+		return -ENOTSUP;
+
+	__rte_hash_lookup_bulk(h, keys, num_keys, positions, NULL, NULL);
+
+	for (i = 0; i < num_keys; i++) {
+		if (positions[i] < 0)
+			continue;
+		__atomic_store_n(get_key_age(h, get_key_slot(h,
+				positions[i] + 1)), now, __ATOMIC_RELAXED);
+		hits++;
+	}
+
+	return hits;
+}
+
+int
+rte_hash_touch(const struct rte_hash *h, int32_t position, uint64_t now)
+{
+	RETURN_IF_TRUE(((h == NULL) || (position < 0) || (now == 0) ||
+			((uint32_t)position >= rte_hash_max_key_id(h))), -EINVAL);
+	if (h->age_offset == 0)
+		return -ENOTSUP;
+
+	__atomic_store_n(get_key_age(h, get_key_slot(h, position + 1)), now,
+			 __ATOMIC_RELAXED);
+	return 0;
+}
+
+int
+rte_hash_age_scan(const struct rte_hash *h, uint64_t now, uint64_t timeout,
+		  uint32_t *next, uint32_t num_buckets, int32_t *positions,
+		  uint32_t max_positions)
+{
+	const struct rte_hash_bucket *bkt;
+	uint32_t total_entries, end, cur, position;
+	uint64_t *age, ts;
+	int n = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (next == NULL) || (positions == NULL) ||
+			(now == 0)), -EINVAL);
+	if (h->age_offset == 0)
+		return -ENOTSUP;
+
+	__hash_rw_reader_lock(h);
+
+	/* Same entry space as rte_hash_iterate(): the main buckets followed
+	 * by the extendable buckets or the buckets not migrated yet.
+	 */
+	const uint32_t total_entries_main = h->num_buckets *
+						RTE_HASH_BUCKET_ENTRIES;
+	if (h->ext_table_support)
+		total_entries = total_entries_main << 1;
+	else if (h->resize_support && h->old_buckets != NULL)
+		total_entries = total_entries_main +
+			h->old_num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	else
+		total_entries = total_entries_main;
+
+	/* The table may have shrunk its entry space since the last call */
+	if (*next >= total_entries)
+		*next = 0;
+	cur = *next;
+	end = RTE_MIN((uint64_t)total_entries,
+		      RTE_ALIGN_FLOOR(cur, RTE_HASH_BUCKET_ENTRIES) +
+		      (uint64_t)num_buckets * RTE_HASH_BUCKET_ENTRIES);
+
+	for (; cur < end && (uint32_t)n < max_positions; cur++) {
+		if (cur < total_entries_main)
+			bkt = &h->buckets[cur / RTE_HASH_BUCKET_ENTRIES];
+		else if (h->ext_table_support)
+			bkt = &h->buckets_ext[(cur - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES];
+		else
+			bkt = &h->old_buckets[(cur - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES];
+
+		position = __atomic_load_n(
+				&bkt->key_idx[cur % RTE_HASH_BUCKET_ENTRIES],
+				__ATOMIC_ACQUIRE);
+		if (position == EMPTY_SLOT)
+			continue;
+
+		age = get_key_age(h, get_key_slot(h, position));
+		ts = __atomic_load_n(age, __ATOMIC_RELAXED);
+		if (ts == 0) {
+			/* First scan since the key was added */
+			__atomic_store_n(age, now, __ATOMIC_RELAXED);
+			continue;
+		}
+		/* Signed compare, as a lookup may have stored a time
+		 * read after now.
+		 */
+		if ((int64_t)(now - ts) > (int64_t)timeout)
+			positions[n++] = position - 1;
+	}
+
+	__hash_rw_reader_unlock(h);
+
+	*next = (cur >= total_entries) ? 0 : cur;
+	return n;
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t n_buckets)
+{
+	if (h == NULL)
+		return -EINVAL;
+
+	if (!h->resize_support)
+		return -ENOTSUP;
+
+	__rte_hash_resize_reclaim(h);
+
+	return __rte_hash_resize_migrate(h, n_buckets);
+}
@@ -128,6 +128,9 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Number of buckets migrated by each writer call while a resize is ongoing */
+#define RTE_HASH_RESIZE_MIGRATE_STEP	4
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -148,6 +151,8 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX2,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -157,7 +162,8 @@ struct rte_hash_bucket {
 
 	uint32_t key_idx[RTE_HASH_BUCKET_ENTRIES];
 
-	uint8_t flag[RTE_HASH_BUCKET_ENTRIES];
+	rte_spinlock_t lock;
+	/**< Taken by the writers when writer_bucket_lock is set */
 
 	void *next;
 } __rte_cache_aligned;
@@ -202,6 +208,9 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t writer_bucket_lock;
+	/**< Indicates if the writer threads lock only the updated buckets */
+	uint8_t resize_support;        /**< Enable table resizing */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -213,6 +222,10 @@ struct rte_hash {
 	uint32_t bucket_bitmask;
 	/**< Bitmask for getting bucket index from hash signature. */
 	uint32_t key_entry_size;         /**< Size of each key entry. */
+	uint32_t age_offset;
+	/**< Offset of the last access timestamp in a key entry, 0 if the
+	 * table does not keep timestamps.
+	 */
 
 	void *key_store;                /**< Table storing all keys and data */
 	struct rte_hash_bucket *buckets;
@@ -231,6 +244,29 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+
+	/* Fields used by resizable tables */
+	struct rte_hash_bucket *old_buckets;
+	/**< Bucket array being migrated to buckets, NULL if not resizing */
+	uint32_t old_bucket_bitmask;    /**< Bucket bitmask of old_buckets */
+	uint32_t old_num_buckets;       /**< Number of buckets in old_buckets */
+	uint32_t migrate_cursor;
+	/**< Index of the next bucket of old_buckets to migrate. All the buckets
+	 * below it are empty.
+	 */
+	struct rte_hash_bucket *retired_buckets;
+	/**< Migrated bucket array waiting for readers to quiesce */
+	uint64_t retired_token;         /**< RCU QSBR token of retired_buckets */
+	struct rte_rcu_qsbr_dq *retired_dq;
+	/**< Defer queue replaced by a resize, waiting to be drained */
+	uint32_t dq_gen;                /**< Number of defer queues created */
+	int socket_id;                  /**< NUMA socket of the table memory */
+	uint32_t key_seg_shift;         /**< Log2 of key slots per segment */
+	uint32_t key_seg_mask;          /**< Key slots per segment minus 1 */
+	uint32_t num_key_segs;          /**< Number of key store segments */
+	uint32_t max_key_segs;          /**< Maximum number of segments */
+	void *key_segs[RTE_HASH_RESIZE_MAX_GROWTH];
+	/**< Key store segments, the first one is key_store */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_x86.h"
+
+/* Load the signatures of two buckets, one per 128-bit lane */
+static __rte_always_inline __m256i
+load_sigs_x2(const struct rte_hash_bucket *b0,
+	const struct rte_hash_bucket *b1)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(
+			_mm_load_si128((const __m128i *)(const void *)b0)),
+		_mm_load_si128((const __m128i *)(const void *)b1), 1);
+}
+
+void
+rte_hash_compare_sigs_avx2(const struct rte_hash_bucket **prim_bkt,
+	const struct rte_hash_bucket **sec_bkt, const uint16_t *sig,
+	int32_t num_keys, uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+	__m256i vsig;
+	__m128i ssig;
+	uint32_t pm, sm;
+	int32_t i;
+
+	/* Two keys per compare, one in each 128-bit lane */
+	for (i = 0; i + 2 <= num_keys; i += 2) {
+		vsig = _mm256_inserti128_si256(_mm256_castsi128_si256(
+				_mm_set1_epi16(sig[i])),
+			_mm_set1_epi16(sig[i + 1]), 1);
+
+		pm = _mm256_movemask_epi8(_mm256_cmpeq_epi16(vsig,
+			load_sigs_x2(prim_bkt[i], prim_bkt[i + 1])));
+		sm = _mm256_movemask_epi8(_mm256_cmpeq_epi16(vsig,
+			load_sigs_x2(sec_bkt[i], sec_bkt[i + 1])));
+
+		prim_hitmask[i] = pm & UINT16_MAX;
+		prim_hitmask[i + 1] = pm >> 16;
+		sec_hitmask[i] = sm & UINT16_MAX;
+		sec_hitmask[i + 1] = sm >> 16;
+	}
+
+	if (i < num_keys) {
+		ssig = _mm_set1_epi16(sig[i]);
+		prim_hitmask[i] = _mm_movemask_epi8(_mm_cmpeq_epi16(ssig,
+			_mm_load_si128((const __m128i *)(const void *)
+				prim_bkt[i])));
+		sec_hitmask[i] = _mm_movemask_epi8(_mm_cmpeq_epi16(ssig,
+			_mm_load_si128((const __m128i *)(const void *)
+				sec_bkt[i])));
+	}
+}
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_x86.h"
+
+/* Number of buckets whose signatures fit in one 512-bit register */
+#define SIGS_X4	4
+
+/* Broadcast signature n of the low 64 bits to the 128-bit lane n */
+static const uint16_t sig_lane_idx[32] __rte_aligned(64) = {
+	0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 1, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 3, 3,
+};
+
+/* Load the signatures of four buckets, one per 128-bit lane */
+static __rte_always_inline __m512i
+load_sigs_x4(const struct rte_hash_bucket **b)
+{
+	__m512i v;
+
+	v = _mm512_castsi128_si512(
+		_mm_load_si128((const __m128i *)(const void *)b[0]));
+	v = _mm512_inserti32x4(v,
+		_mm_load_si128((const __m128i *)(const void *)b[1]), 1);
+	v = _mm512_inserti32x4(v,
+		_mm_load_si128((const __m128i *)(const void *)b[2]), 2);
+	return _mm512_inserti32x4(v,
+		_mm_load_si128((const __m128i *)(const void *)b[3]), 3);
+}
+
+/* Compare the signatures of four keys, one 16-bit hit mask per key */
+static __rte_always_inline void
+compare_sigs_x4(const struct rte_hash_bucket **prim_bkt,
+	const struct rte_hash_bucket **sec_bkt, const uint16_t *sig,
+	uint32_t *prim_hitmask, uint32_t *sec_hitmask, uint32_t n)
+{
+	const __m512i idx = _mm512_load_si512((const void *)sig_lane_idx);
+	__m512i vsig;
+	__mmask32 pk, sk;
+	uint64_t pm, sm;
+	uint32_t i;
+
+	vsig = _mm512_permutexvar_epi16(idx, _mm512_castsi128_si512(
+			_mm_loadl_epi64((const __m128i *)(const void *)sig)));
+
+	pk = _mm512_cmpeq_epi16_mask(vsig, load_sigs_x4(prim_bkt));
+	sk = _mm512_cmpeq_epi16_mask(vsig, load_sigs_x4(sec_bkt));
+
+	/* Two bits per entry, as in the SSE byte mask */
+	pm = _mm512_movepi8_mask(_mm512_movm_epi16(pk));
+	sm = _mm512_movepi8_mask(_mm512_movm_epi16(sk));
+
+	for (i = 0; i < n; i++) {
+		prim_hitmask[i] = (pm >> (i * 16)) & UINT16_MAX;
+		sec_hitmask[i] = (sm >> (i * 16)) & UINT16_MAX;
+	}
+}
+
+void
+rte_hash_compare_sigs_avx512(const struct rte_hash_bucket **prim_bkt,
+	const struct rte_hash_bucket **sec_bkt, const uint16_t *sig,
+	int32_t num_keys, uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+	const struct rte_hash_bucket *pb[SIGS_X4], *sb[SIGS_X4];
+	uint16_t s[SIGS_X4];
+	int32_t i, j;
+
+	/* 16 keys use four compares on the primary and secondary buckets */
+	for (i = 0; i + SIGS_X4 <= num_keys; i += SIGS_X4)
+		compare_sigs_x4(&prim_bkt[i], &sec_bkt[i], &sig[i],
+			&prim_hitmask[i], &sec_hitmask[i], SIGS_X4);
+
+	if (i == num_keys)
+		return;
+
+	/* Pad the remaining lanes with the last key */
+	for (j = 0; j < SIGS_X4; j++) {
+		int32_t k = RTE_MIN(i + j, num_keys - 1);
+
+		pb[j] = prim_bkt[k];
+		sb[j] = sec_bkt[k];
+		s[j] = sig[k];
+	}
+	compare_sigs_x4(pb, sb, s, &prim_hitmask[i], &sec_hitmask[i],
+		num_keys - i);
+}
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _RTE_CUCKOO_HASH_X86_H_
+#define _RTE_CUCKOO_HASH_X86_H_
+
+#include <stdint.h>
+
+struct rte_hash_bucket;
+
+/*
+ * Compare the signatures of num_keys keys with all the entries of their
+ * primary and secondary buckets. The hit masks use the same format as
+ * the SSE compare: two bits per bucket entry, the first one set on match.
+ * The signature array must be the first field of the bucket.
+ */
+void
+rte_hash_compare_sigs_avx2(const struct rte_hash_bucket **prim_bkt,
+	const struct rte_hash_bucket **sec_bkt, const uint16_t *sig,
+	int32_t num_keys, uint32_t *prim_hitmask, uint32_t *sec_hitmask);
+
+void
+rte_hash_compare_sigs_avx512(const struct rte_hash_bucket **prim_bkt,
+	const struct rte_hash_bucket **sec_bkt, const uint16_t *sig,
+	int32_t num_keys, uint32_t *prim_hitmask, uint32_t *sec_hitmask);
+
+#endif /* _RTE_CUCKOO_HASH_X86_H_ */
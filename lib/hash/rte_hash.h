@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <rte_compat.h>
 #include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
@@ -55,6 +56,46 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the hash table grow on demand.
+ * The table starts with the number of entries given at creation time
+ * (rounded up to a power of 2) and doubles whenever a key cannot be
+ * inserted, up to RTE_HASH_RESIZE_MAX_GROWTH times its initial size.
+ * Buckets are migrated to the doubled table incrementally by the writer
+ * APIs and rte_hash_resize_step(), so lookups never wait for a rehash.
+ * The key IDs returned by the add APIs stay valid across resizes, while
+ * rte_hash_max_key_id() grows with the table.
+ * This flag cannot be combined with RTE_HASH_EXTRA_FLAGS_EXT_TABLE or
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD. With
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, the table grows only once
+ * an RCU QSBR variable is attached with rte_hash_rcu_qsbr_add(), which
+ * is used to release the bucket array replaced by a resize. The writer
+ * does not wait for the readers: until that bucket array is released,
+ * the next resize is not done and the insertion fails with -ENOSPC.
+ * A defer queue attached with RTE_HASH_QSBR_MODE_DQ doubles along with
+ * the table.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
+/** Flag to keep a last access timestamp with each key, for flow aging.
+ * The timestamp is updated by rte_hash_lookup_touch(),
+ * rte_hash_lookup_bulk_touch() and rte_hash_touch(), and
+ * rte_hash_age_scan() reports the keys not accessed for a given timeout.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x80
+
+/** Flag of extra_flag2 to let multiple writers lock only the buckets
+ * they update instead of the whole table, so that writers updating
+ * different buckets proceed in parallel.
+ * It requires RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD, and cannot be
+ * combined with RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY,
+ * RTE_HASH_EXTRA_FLAGS_EXT_TABLE or RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT.
+ * In that mode rte_hash_reset() is not serialized with the writers.
+ */
+#define RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK 0x01
+
+/** Maximum growth factor of a resizable hash table over its initial size. */
+#define RTE_HASH_RESIZE_MAX_GROWTH		64
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -81,7 +122,12 @@ typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
 struct rte_hash_parameters {
 	const char *name;		/**< Name of the hash. */
 	uint32_t entries;		/**< Total hash table entries. */
-	uint32_t reserved;		/**< Unused field. Should be set to 0 */
+	RTE_STD_C11
+	union {
+		uint32_t reserved;	/**< Unused field. Should be set to 0 */
+		uint32_t extra_flag2;
+		/**< More additional parameters, RTE_HASH_EXTRA_FLAGS2_* */
+	};
 	uint32_t key_len;		/**< Length of hash key. */
 	rte_hash_function hash_func;	/**< Primary Hash function used to calculate hash. */
 	uint32_t hash_func_init_val;	/**< Init value used by hash_func. */
@@ -187,6 +233,9 @@ rte_hash_free(struct rte_hash *h);
  * it is application's responsibility to make sure that
  * none of the readers are referencing the hash table
  * while calling this API.
+ * When RTE_HASH_EXTRA_FLAGS2_MULTI_WRITER_BUCKET_LOCK is enabled,
+ * the writers lock only the buckets they update, so no key must be
+ * added or deleted concurrently.
  *
  * @param h
  *   Hash table to reset
@@ -675,6 +724,153 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
  */
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Migrate buckets of a resizable hash table to its doubled bucket array.
+ * The writer APIs already migrate a few buckets on each call; this API
+ * allows a control thread to complete a resize when the table is idle.
+ * It has the same thread safety requirements as the add/delete APIs.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ * @param n_buckets
+ *   Maximum number of buckets to migrate.
+ * @return
+ *   - Number of buckets left to migrate, 0 if no resize is in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table is not resizable.
+ *   - -ENOSPC if an entry could not be placed in the new bucket array.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t n_buckets);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Find a key-value pair in the hash table and set the last access
+ * timestamp of the key.
+ * This operation is multi-thread safe with regarding to other lookup threads.
+ * Read-write concurrency can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param key
+ *   Key to find.
+ * @param now
+ *   Current time, in the unit used for rte_hash_age_scan(). Must not be 0.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table does not keep timestamps.
+ *   - -ENOENT if the key is not found.
+ *   - A non negative value that can be used by the caller as an offset
+ *     into an array of user data. This value is unique for this key, and
+ *     is the same value that was returned when the key was added.
+ */
+__rte_experimental
+int32_t
+rte_hash_lookup_touch(const struct rte_hash *h, const void *key, uint64_t now);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Find multiple keys in the hash table and set the last access timestamp
+ * of the keys found.
+ * This operation is multi-thread safe with regarding to other lookup threads.
+ * Read-write concurrency can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param keys
+ *   A pointer to a list of keys to look for.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, as returned by rte_hash_lookup_bulk().
+ * @param now
+ *   Current time, in the unit used for rte_hash_age_scan(). Must not be 0.
+ * @return
+ *   - -EINVAL if there's an error.
+ *   - -ENOTSUP if the table does not keep timestamps.
+ *   - Otherwise the number of keys found.
+ */
+__rte_experimental
+int
+rte_hash_lookup_bulk_touch(const struct rte_hash *h, const void **keys,
+			   uint32_t num_keys, int32_t *positions, uint64_t now);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the last access timestamp of the key at a given position,
+ * for applications which keep the position of a flow and do not look
+ * its key up again.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param position
+ *   Position returned when the key was added or looked up.
+ * @param now
+ *   Current time, in the unit used for rte_hash_age_scan(). Must not be 0.
+ * @return
+ *   - 0 if successful.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table does not keep timestamps.
+ */
+__rte_experimental
+int
+rte_hash_touch(const struct rte_hash *h, int32_t position, uint64_t now);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Scan a bounded number of buckets of the hash table for keys not
+ * accessed since a timeout. The scan resumes where the previous call
+ * stopped, so that calling it once per burst spreads the aging of the
+ * whole table over many calls with a predictable cost.
+ *
+ * A key added since its bucket was last scanned gets the time of the
+ * scan as initial timestamp, it expires at the earliest one timeout
+ * later. The expired keys are only reported, the caller deletes them
+ * with the usual APIs, e.g. after rte_hash_get_key_with_position().
+ *
+ * The scan is multi-thread safe with regarding to lookup threads and
+ * follows the same rules as rte_hash_iterate() with regard to writers.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param now
+ *   Current time, in any unit, e.g. TSC cycles.
+ * @param timeout
+ *   Time, in the same unit as now, after which a key not accessed expires.
+ * @param next
+ *   Pointer to the scan cursor. Should be 0 to start scanning the table.
+ *   It is reset to 0 when the scan reaches the end of the table.
+ * @param num_buckets
+ *   Maximum number of buckets to scan.
+ * @param positions
+ *   Output containing the positions of the expired keys.
+ * @param max_positions
+ *   Size of the positions array. The scan stops when it is full.
+ * @return
+ *   - Number of expired keys written in positions.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table does not keep timestamps.
+ */
+__rte_experimental
+int
+rte_hash_age_scan(const struct rte_hash *h, uint64_t now, uint64_t timeout,
+		  uint32_t *next, uint32_t num_buckets, int32_t *positions,
+		  uint32_t max_positions);
+
 #ifdef __cplusplus
 }
 #endif
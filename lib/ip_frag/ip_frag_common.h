@@ -23,6 +23,12 @@
 /* helper macros */
 #define	IP_FRAG_MBUF2DR(dr, mb)	((dr)->row[(dr)->cnt++] = (mb))
 
+/* tag of a table entry */
+#define	IP_FRAG_TBL_TAG(tbl, fp)	((tbl)->tag + ((fp) - (tbl)->pkt))
+
+/* signature stored in the tag of an entry, never 0 */
+#define	IP_FRAG_TAG_SIG(sig)	((sig) | 1)
+
 #define IPv6_KEY_BYTES(key) \
 	(key)[0], (key)[1], (key)[2], (key)[3]
 #define IPv6_KEY_BYTES_FMT \
@@ -43,9 +49,19 @@ struct ip_frag_pkt * ip_frag_find(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		const struct ip_frag_key *key, uint64_t tms);
 
+struct ip_frag_pkt * ip_frag_find_hashed(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr,
+		const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+		uint64_t tms);
+
 struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
-	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
+
+void ip_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2);
+
+uint32_t ip_frag_tbl_expire(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, uint64_t tms, uint32_t max_num);
 
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf *ipv4_frag_reassemble(struct ip_frag_pkt *fp);
@@ -130,6 +146,7 @@ static inline void
 ip_frag_inuse(struct rte_ip_frag_tbl *tbl, const struct  ip_frag_pkt *fp)
 {
 	if (ip_frag_key_is_empty(&fp->key)) {
+		IP_FRAG_TBL_TAG(tbl, fp)->sig = 0;
 		TAILQ_REMOVE(&tbl->lru, fp, lru);
 		tbl->use_entries--;
 	}
@@ -160,6 +177,7 @@ ip_frag_tbl_del(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 {
 	ip_frag_free(fp, dr);
 	ip_frag_key_invalidate(&fp->key);
+	IP_FRAG_TBL_TAG(tbl, fp)->sig = 0;
 	TAILQ_REMOVE(&tbl->lru, fp, lru);
 	tbl->use_entries--;
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, del_num, 1);
@@ -14,12 +14,19 @@
 #define	IP_FRAG_TBL_POS(tbl, sig)	\
 	((tbl)->pkt + ((sig) & (tbl)->entry_mask))
 
+#define	IP_FRAG_TBL_TAG_POS(tbl, sig)	\
+	((tbl)->tag + ((sig) & (tbl)->entry_mask))
+
 static inline void
 ip_frag_tbl_add(struct rte_ip_frag_tbl *tbl,  struct ip_frag_pkt *fp,
-	const struct ip_frag_key *key, uint64_t tms)
+	const struct ip_frag_key *key, uint32_t sig, uint64_t tms)
 {
+	struct ip_frag_tag *tag = IP_FRAG_TBL_TAG(tbl, fp);
+
 	fp->key = key[0];
 	ip_frag_reset(fp, tms);
+	tag->start = tms;
+	tag->sig = IP_FRAG_TAG_SIG(sig);
 	TAILQ_INSERT_TAIL(&tbl->lru, fp, lru);
 	tbl->use_entries++;
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, add_num, 1);
@@ -31,6 +38,7 @@ ip_frag_tbl_reuse(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 {
 	ip_frag_free(fp, dr);
 	ip_frag_reset(fp, tms);
+	IP_FRAG_TBL_TAG(tbl, fp)->start = tms;
 	TAILQ_REMOVE(&tbl->lru, fp, lru);
 	TAILQ_INSERT_TAIL(&tbl->lru, fp, lru);
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, reuse_num, 1);
@@ -87,6 +95,16 @@ ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
 	*v2 = (v << 7) + (v >> 14);
 }
 
+/* different hashing methods for IPv4 and IPv6 */
+void
+ip_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
+{
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, v1, v2);
+	else
+		ipv6_frag_hash(key, v1, v2);
+}
+
 struct rte_mbuf *
 ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 	struct rte_mbuf *mb, uint16_t ofs, uint16_t len, uint16_t more_frags)
@@ -221,6 +239,20 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 struct ip_frag_pkt *
 ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 	const struct ip_frag_key *key, uint64_t tms)
+{
+	uint32_t sig1, sig2;
+
+	ip_frag_hash(key, &sig1, &sig2);
+	return ip_frag_find_hashed(tbl, dr, key, sig1, sig2, tms);
+}
+
+/*
+ * Same as ip_frag_find(), for a key whose signatures are already known.
+ */
+struct ip_frag_pkt *
+ip_frag_find_hashed(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, const struct ip_frag_key *key,
+	uint32_t sig1, uint32_t sig2, uint64_t tms)
 {
 	struct ip_frag_pkt *pkt, *free, *stale, *lru;
 	uint64_t max_cycles;
@@ -235,7 +267,8 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
 
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	if ((pkt = ip_frag_lookup(tbl, key, sig1, sig2, tms, &free,
+			&stale)) == NULL) {
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
@@ -261,7 +294,7 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 		/* found a free entry to reuse. */
 		if (free != NULL) {
-			ip_frag_tbl_add(tbl,  free, key, tms);
+			ip_frag_tbl_add(tbl,  free, key, sig1, tms);
 			pkt = free;
 		}
 
@@ -282,13 +315,14 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 struct ip_frag_pkt *
 ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
-	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
+	const struct ip_frag_tag *t1, *t2;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc, sig;
 
 	empty = NULL;
 	old = NULL;
@@ -299,14 +333,11 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
 		return tbl->last;
 
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
-
 	p1 = IP_FRAG_TBL_POS(tbl, sig1);
 	p2 = IP_FRAG_TBL_POS(tbl, sig2);
+	t1 = IP_FRAG_TBL_TAG_POS(tbl, sig1);
+	t2 = IP_FRAG_TBL_TAG_POS(tbl, sig2);
+	sig = IP_FRAG_TAG_SIG(sig1);
 
 	for (i = 0; i != assoc; i++) {
 		if (p1->key.key_len == IPV4_KEYLEN)
@@ -328,11 +359,11 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					p1, i, assoc,
 			IPv6_KEY_BYTES(p1[i].key.src_dst), p1[i].key.id, p1[i].start);
 
-		if (ip_frag_key_cmp(key, &p1[i].key) == 0)
+		if (t1[i].sig == sig && ip_frag_key_cmp(key, &p1[i].key) == 0)
 			return p1 + i;
-		else if (ip_frag_key_is_empty(&p1[i].key))
+		else if (t1[i].sig == 0)
 			empty = (empty == NULL) ? (p1 + i) : empty;
-		else if (max_cycles + p1[i].start < tms)
+		else if (max_cycles + t1[i].start < tms)
 			old = (old == NULL) ? (p1 + i) : old;
 
 		if (p2->key.key_len == IPV4_KEYLEN)
@@ -354,11 +385,11 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					p2, i, assoc,
 			IPv6_KEY_BYTES(p2[i].key.src_dst), p2[i].key.id, p2[i].start);
 
-		if (ip_frag_key_cmp(key, &p2[i].key) == 0)
+		if (t2[i].sig == sig && ip_frag_key_cmp(key, &p2[i].key) == 0)
 			return p2 + i;
-		else if (ip_frag_key_is_empty(&p2[i].key))
+		else if (t2[i].sig == 0)
 			empty = (empty == NULL) ?( p2 + i) : empty;
-		else if (max_cycles + p2[i].start < tms)
+		else if (max_cycles + t2[i].start < tms)
 			old = (old == NULL) ? (p2 + i) : old;
 	}
 
@@ -366,3 +397,33 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	*stale = old;
 	return NULL;
 }
+
+/*
+ * Delete up to max_num expired entries, oldest first.
+ * The LRU list is ordered by creation time, as all the entries have
+ * the same lifetime, so it stops at the first entry still alive.
+ */
+uint32_t
+ip_frag_tbl_expire(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, uint64_t tms, uint32_t max_num)
+{
+	struct ip_frag_pkt *fp;
+	uint64_t max_cycles;
+	uint32_t n;
+
+	max_cycles = tbl->max_cycles;
+
+	for (n = 0; n != max_num; n++) {
+		fp = TAILQ_FIRST(&tbl->lru);
+		if (fp == NULL || max_cycles + fp->start >= tms)
+			break;
+
+		/* check that death row has enough space */
+		if (RTE_IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt < fp->last_idx)
+			break;
+
+		ip_frag_tbl_del(tbl, dr, fp);
+	}
+
+	return n;
+}
@@ -61,6 +61,15 @@ struct ip_frag_pkt {
  /* fragments tailq */
 RTE_TAILQ_HEAD(ip_pkt_list, ip_frag_pkt);
 
+/*
+ * Tag of a table entry, kept apart from the entries, so the search of a
+ * bucket only reads the tags and compares the key of the matching entries.
+ */
+struct ip_frag_tag {
+	uint64_t start; /* creation timestamp of the entry */
+	uint32_t sig;   /* key signature, 0 for an empty entry */
+};
+
 /* fragmentation table statistics */
 struct ip_frag_tbl_stat {
 	uint64_t find_num;     /* total # of find/insert attempts. */
@@ -83,6 +92,7 @@ struct rte_ip_frag_tbl {
 	struct ip_frag_pkt *last;     /* last used entry. */
 	struct ip_pkt_list lru;       /* LRU list for table entries. */
 	struct ip_frag_tbl_stat stat; /* statistics counters. */
+	struct ip_frag_tag *tag;      /* tags of the hash table entries. */
 	__extension__ struct ip_frag_pkt pkt[]; /* hash table. */
 };
 
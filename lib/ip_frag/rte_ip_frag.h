@@ -236,6 +236,42 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv4_hdr *ip_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function implements reassembly of a burst of IPv4 packets.
+ * Incoming mbufs should have its l2_len/l3_len fields setup correctly.
+ * The fragments of the burst are hashed and their table buckets are
+ * prefetched, before they are processed in order.
+ *
+ * Packets, which are not fragments, and reassembled packets are returned
+ * at the start of the pkts array, in arrival order. Other fragments are
+ * kept in the table or put on the death row.
+ *
+ * Up to nb_pkts expired entries are deleted from the table by each call,
+ * so the table doesn't have to be scanned with
+ * rte_ip_frag_table_del_expired_entries(). The death row is freed when
+ * it gets short of room, so it doesn't overflow on large bursts.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param pkts
+ *   Array of incoming mbufs, updated with the returned mbufs.
+ * @param nb_pkts
+ *   Number of mbufs in the pkts array.
+ * @param tms
+ *   Arrival timestamp of the burst.
+ * @return
+ *   Number of mbufs returned in the pkts array.
+ */
+__rte_experimental
+uint16_t rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+		uint16_t nb_pkts, uint64_t tms);
+
 /**
  * Check if the IPv4 packet is fragmented
  *
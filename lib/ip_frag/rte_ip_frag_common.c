@@ -56,7 +56,8 @@ rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
 		return NULL;
 	}
 
-	sz = sizeof (*tbl) + nb_entries * sizeof (tbl->pkt[0]);
+	sz = sizeof (*tbl) + nb_entries * sizeof (tbl->pkt[0]) +
+		nb_entries * sizeof (tbl->tag[0]);
 	if ((tbl = rte_zmalloc_socket(__func__, sz, RTE_CACHE_LINE_SIZE,
 			socket_id)) == NULL) {
 		RTE_LOG(ERR, USER1,
@@ -74,6 +75,7 @@ rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
 	tbl->nb_buckets = bucket_num;
 	tbl->bucket_entries = bucket_entries;
 	tbl->entry_mask = (tbl->nb_entries - 1) & ~(tbl->bucket_entries  - 1);
+	tbl->tag = (struct ip_frag_tag *)(tbl->pkt + nb_entries);
 
 	TAILQ_INIT(&(tbl->lru));
 	return tbl;
@@ -126,19 +128,5 @@ void
 rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, uint64_t tms)
 {
-	uint64_t max_cycles;
-	struct ip_frag_pkt *fp;
-
-	max_cycles = tbl->max_cycles;
-
-	TAILQ_FOREACH(fp, &tbl->lru, lru)
-		if (max_cycles + fp->start < tms) {
-			/* check that death row has enough space */
-			if (RTE_IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt >=
-					fp->last_idx)
-				ip_frag_tbl_del(tbl, dr, fp);
-			else
-				return;
-		} else
-			return;
+	ip_frag_tbl_expire(tbl, dr, tms, UINT32_MAX);
 }
@@ -5,9 +5,16 @@
 #include <stddef.h>
 
 #include <rte_debug.h>
+#include <rte_prefetch.h>
 
 #include "ip_frag_common.h"
 
+/* Number of packets hashed and prefetched together by the bulk API. */
+#define	IPV4_FRAG_BULK_SIZE	32
+
+/* Number of mbufs prefetched when the bulk API frees the death row. */
+#define	IPV4_FRAG_DR_PREFETCH	3
+
 /*
  * Reassemble fragments into one packet.
  */
@@ -78,30 +85,29 @@ ipv4_frag_reassemble(struct ip_frag_pkt *fp)
 	return m;
 }
 
+/* fill the key of an IPv4 fragment. */
+static inline void
+ipv4_frag_key(struct ip_frag_key *key, const struct rte_ipv4_hdr *ip_hdr)
+{
+	const unaligned_uint64_t *psd;
+
+	psd = (const unaligned_uint64_t *)&ip_hdr->src_addr;
+	/* use first 8 bytes only */
+	key->src_dst[0] = psd[0];
+	key->id = ip_hdr->packet_id;
+	key->key_len = IPV4_KEYLEN;
+}
+
 /*
- * Process new mbuf with fragment of IPV4 packet.
- * Incoming mbuf should have it's l2_len/l3_len fields setup correctly.
- * @param tbl
- *   Table where to lookup/add the fragmented packet.
- * @param mb
- *   Incoming mbuf with IPV4 fragment.
- * @param tms
- *   Fragment arrival timestamp.
- * @param ip_hdr
- *   Pointer to the IPV4 header inside the fragment.
- * @return
- *   Pointer to mbuf for reassembled packet, or NULL if:
- *   - an error occurred.
- *   - not all fragments of the packet are collected yet.
+ * Process an IPv4 fragment, whose key and key signatures are known.
  */
-struct rte_mbuf *
-rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+static inline struct rte_mbuf *
+ipv4_frag_process_hashed(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
-	struct rte_ipv4_hdr *ip_hdr)
+	struct rte_ipv4_hdr *ip_hdr, const struct ip_frag_key *key,
+	uint32_t sig1, uint32_t sig2)
 {
 	struct ip_frag_pkt *fp;
-	struct ip_frag_key key;
-	const unaligned_uint64_t *psd;
 	uint16_t flag_offset, ip_ofs, ip_flag;
 	int32_t ip_len;
 	int32_t trim;
@@ -110,12 +116,6 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 	ip_ofs = (uint16_t)(flag_offset & RTE_IPV4_HDR_OFFSET_MASK);
 	ip_flag = (uint16_t)(flag_offset & RTE_IPV4_HDR_MF_FLAG);
 
-	psd = (unaligned_uint64_t *)&ip_hdr->src_addr;
-	/* use first 8 bytes only */
-	key.src_dst[0] = psd[0];
-	key.id = ip_hdr->packet_id;
-	key.key_len = IPV4_KEYLEN;
-
 	ip_ofs *= RTE_IPV4_HDR_OFFSET_UNITS;
 	ip_len = rte_be_to_cpu_16(ip_hdr->total_length) - mb->l3_len;
 	trim = mb->pkt_len - (ip_len + mb->l3_len + mb->l2_len);
@@ -126,7 +126,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		"tbl: %p, max_cycles: %" PRIu64 ", entry_mask: %#x, "
 		"max_entries: %u, use_entries: %u\n\n",
 		__func__, __LINE__,
-		mb, tms, key.src_dst[0], key.id, ip_ofs, ip_len, trim, ip_flag,
+		mb, tms, key->src_dst[0], key->id, ip_ofs, ip_len, trim, ip_flag,
 		tbl, tbl->max_cycles, tbl->entry_mask, tbl->max_entries,
 		tbl->use_entries);
 
@@ -140,7 +140,8 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		rte_pktmbuf_trim(mb, trim);
 
 	/* try to find/add entry into the fragment's table. */
-	if ((fp = ip_frag_find(tbl, dr, &key, tms)) == NULL) {
+	fp = ip_frag_find_hashed(tbl, dr, key, sig1, sig2, tms);
+	if (fp == NULL) {
 		IP_FRAG_MBUF2DR(dr, mb);
 		return NULL;
 	}
@@ -171,3 +172,101 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Process new mbuf with fragment of IPV4 packet.
+ * Incoming mbuf should have it's l2_len/l3_len fields setup correctly.
+ * @param tbl
+ *   Table where to lookup/add the fragmented packet.
+ * @param mb
+ *   Incoming mbuf with IPV4 fragment.
+ * @param tms
+ *   Fragment arrival timestamp.
+ * @param ip_hdr
+ *   Pointer to the IPV4 header inside the fragment.
+ * @return
+ *   Pointer to mbuf for reassembled packet, or NULL if:
+ *   - an error occurred.
+ *   - not all fragments of the packet are collected yet.
+ */
+struct rte_mbuf *
+rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
+	struct rte_ipv4_hdr *ip_hdr)
+{
+	struct ip_frag_key key;
+	uint32_t sig1, sig2;
+
+	ipv4_frag_key(&key, ip_hdr);
+	ip_frag_hash(&key, &sig1, &sig2);
+
+	return ipv4_frag_process_hashed(tbl, dr, mb, tms, ip_hdr, &key,
+		sig1, sig2);
+}
+
+uint16_t
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t tms)
+{
+	struct rte_ipv4_hdr *ip_hdr[IPV4_FRAG_BULK_SIZE];
+	struct ip_frag_key key[IPV4_FRAG_BULK_SIZE];
+	uint32_t sig1[IPV4_FRAG_BULK_SIZE], sig2[IPV4_FRAG_BULK_SIZE];
+	struct rte_mbuf *mb;
+	uint16_t i, j, k, nb_out;
+
+	nb_out = 0;
+
+	for (i = 0; i != nb_pkts; i += k) {
+		k = RTE_MIN(nb_pkts - i, IPV4_FRAG_BULK_SIZE);
+
+		/* prefetch the IPv4 headers. */
+		for (j = 0; j != k; j++) {
+			mb = pkts[i + j];
+			ip_hdr[j] = rte_pktmbuf_mtod_offset(mb,
+				struct rte_ipv4_hdr *, mb->l2_len);
+			rte_prefetch0(ip_hdr[j]);
+		}
+
+		/* hash the fragments and prefetch their table buckets. */
+		for (j = 0; j != k; j++) {
+			if (!rte_ipv4_frag_pkt_is_fragmented(ip_hdr[j])) {
+				ip_frag_key_invalidate(&key[j]);
+				continue;
+			}
+			ipv4_frag_key(&key[j], ip_hdr[j]);
+			ip_frag_hash(&key[j], &sig1[j], &sig2[j]);
+			rte_prefetch0(tbl->tag + (sig1[j] & tbl->entry_mask));
+			rte_prefetch0(tbl->tag + (sig2[j] & tbl->entry_mask));
+		}
+
+		/*
+		 * Each fragment adds at most one entry, delete as many
+		 * expired entries, so the table doesn't fill up with them.
+		 */
+		ip_frag_tbl_expire(tbl, dr, tms, k);
+
+		for (j = 0; j != k; j++) {
+			mb = pkts[i + j];
+
+			/* pass the non-fragmented packets through. */
+			if (ip_frag_key_is_empty(&key[j])) {
+				pkts[nb_out++] = mb;
+				continue;
+			}
+
+			/* make room for the mbufs freed by one fragment. */
+			if (RTE_IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt <
+					RTE_LIBRTE_IP_FRAG_MAX_FRAG + 1)
+				rte_ip_frag_free_death_row(dr,
+					IPV4_FRAG_DR_PREFETCH);
+
+			mb = ipv4_frag_process_hashed(tbl, dr, mb, tms,
+				ip_hdr[j], &key[j], sig1[j], sig2[j]);
+			if (mb != NULL)
+				pkts[nb_out++] = mb;
+		}
+	}
+
+	return nb_out;
+}
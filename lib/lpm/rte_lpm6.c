@@ -18,17 +18,16 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
 
 #include "rte_lpm6.h"
+#include "rte_lpm6_vec.h"
 
 #define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
 #define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
 #define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
 
-#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
-#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
-#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
-
 #define ADD_FIRST_BYTE                            3
 #define LOOKUP_FIRST_BYTE                         4
 #define BYTE_SIZE                                 8
@@ -39,6 +38,14 @@
 
 #define lpm6_tbl8_gindex next_hop
 
+/** Bulk lookup implementations. */
+enum lpm6_lookup_fn {
+	LPM6_LOOKUP_SCALAR = 0,
+	LPM6_LOOKUP_SSE,
+	LPM6_LOOKUP_AVX2,
+	LPM6_LOOKUP_AVX512
+};
+
 /** Flags for setting an entry as valid/invalid. */
 enum valid_flag {
 	INVALID = 0,
@@ -94,6 +101,7 @@ struct rte_lpm6 {
 	uint32_t max_rules;              /**< Max number of rules. */
 	uint32_t used_rules;             /**< Used rules so far. */
 	uint32_t number_tbl8s;           /**< Number of tbl8s to allocate. */
+	enum lpm6_lookup_fn lookup_fn;   /**< Bulk lookup implementation. */
 
 	/* LPM Tables. */
 	struct rte_hash *rules_tbl; /**< LPM rules. */
@@ -105,6 +113,11 @@ struct rte_lpm6 {
 
 	struct rte_lpm_tbl8_hdr *tbl8_hdrs; /* array of tbl8 headers */
 
+	/* RCU config. */
+	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
+	enum rte_lpm6_qsbr_mode rcu_mode;/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+
 	struct rte_lpm6_tbl_entry tbl8[0]
 			__rte_cache_aligned; /**< LPM tbl8 table. */
 };
@@ -206,6 +219,66 @@ tbl8_available(struct rte_lpm6 *lpm)
 	return lpm->number_tbl8s - lpm->tbl8_pool_pos;
 }
 
+/*
+ * Release a tbl8 which is already unlinked from the tree.
+ * With RCU the tbl8 goes back to the pool only once the readers
+ * can no longer reference it.
+ */
+static void
+tbl8_free(struct rte_lpm6 *lpm, uint32_t tbl8_ind)
+{
+	if (lpm->v != NULL && lpm->rcu_mode == RTE_LPM6_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(lpm->dq, &tbl8_ind) == 0)
+			return;
+		RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+	}
+
+	if (lpm->v != NULL)
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+
+	tbl8_put(lpm, tbl8_ind);
+}
+
+/*
+ * Return all the tbl8s held in the defer queue to the pool,
+ * waiting for the readers if needed
+ */
+static void
+tbl8_reclaim_all(struct rte_lpm6 *lpm)
+{
+	if (lpm->dq == NULL)
+		return;
+
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s, NULL, NULL, NULL);
+}
+
+/*
+ * Select the fastest bulk lookup supported by the CPU
+ */
+static enum lpm6_lookup_fn
+lookup_fn_select(void)
+{
+#if defined(RTE_ARCH_X86)
+#ifdef CC_LPM6_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512)
+		return LPM6_LOOKUP_AVX512;
+#endif
+#ifdef CC_LPM6_AVX2_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		return LPM6_LOOKUP_AVX2;
+#endif
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
+		return LPM6_LOOKUP_SSE;
+#endif
+	return LPM6_LOOKUP_SCALAR;
+}
+
 /*
  * Init a rule key.
  *	  note that ip must be already masked
@@ -352,6 +425,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	lpm->rules_tbl = rules_tbl;
 	lpm->tbl8_pool = tbl8_pool;
 	lpm->tbl8_hdrs = tbl8_hdrs;
+	lpm->lookup_fn = lookup_fn_select();
 
 	/* init the stack */
 	tbl8_pool_init(lpm);
@@ -429,6 +503,8 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (lpm->dq != NULL)
+		rte_rcu_qsbr_dq_delete(lpm->dq);
 	rte_free(lpm->tbl8_hdrs);
 	rte_free(lpm->tbl8_pool);
 	rte_hash_free(lpm->rules_tbl);
@@ -436,6 +512,67 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 	rte_free(te);
 }
 
+static void
+__lpm6_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	uint32_t tbl8_ind = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	/* return the table to the pool */
+	tbl8_put((struct rte_lpm6 *)p, tbl8_ind);
+}
+
+/* Associate QSBR variable with an LPM6 object.
+ */
+int
+rte_lpm6_rcu_qsbr_add(struct rte_lpm6 *lpm, struct rte_lpm6_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (lpm == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (lpm->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_LPM6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_LPM6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"LPM6_RCU_%s", lpm->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = lpm->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_LPM6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 index */
+		params.free_fn = __lpm6_rcu_qsbr_free_resource;
+		params.p = lpm;
+		params.v = cfg->v;
+		lpm->dq = rte_rcu_qsbr_dq_create(&params);
+		if (lpm->dq == NULL) {
+			RTE_LOG(ERR, LPM, "LPM6 defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	lpm->rcu_mode = cfg->mode;
+	lpm->v = cfg->v;
+
+	return 0;
+}
+
 /* Find a rule */
 static inline int
 rule_find_with_key(struct rte_lpm6 *lpm,
@@ -538,7 +675,8 @@ expand_rule(struct rte_lpm6 *lpm, uint32_t tbl8_gindex, uint8_t old_depth,
 		if (!lpm->tbl8[j].valid || (lpm->tbl8[j].ext_entry == 0
 				&& lpm->tbl8[j].depth <= old_depth)) {
 
-			lpm->tbl8[j] = new_tbl8_entry;
+			__atomic_store(&lpm->tbl8[j], &new_tbl8_entry,
+					__ATOMIC_RELAXED);
 
 		} else if (lpm->tbl8[j].ext_entry == 1) {
 
@@ -684,7 +822,8 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 					.ext_entry = 0,
 				};
 
-				tbl[i] = new_tbl_entry;
+				__atomic_store(&tbl[i], &new_tbl_entry,
+						__ATOMIC_RELAXED);
 
 			} else if (tbl[i].ext_entry == 1) {
 
@@ -738,7 +877,11 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 				.ext_entry = 1,
 			};
 
-			tbl[entry_ind] = new_tbl_entry;
+			/* The tbl8 must be initialized before it is
+			 * visible to the readers.
+			 */
+			__atomic_store(&tbl[entry_ind], &new_tbl_entry,
+					__ATOMIC_RELEASE);
 
 			/* update the current table's reference counter */
 			if (tbl_ind != TBL24_IND)
@@ -789,7 +932,11 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 				.ext_entry = 1,
 			};
 
-			tbl[entry_ind] = new_tbl_entry;
+			/* The tbl8 must be initialized before it is
+			 * visible to the readers.
+			 */
+			__atomic_store(&tbl[entry_ind], &new_tbl_entry,
+					__ATOMIC_RELEASE);
 
 			/* update the current table's reference counter */
 			if (tbl_ind != TBL24_IND)
@@ -838,6 +985,12 @@ simulate_add(struct rte_lpm6 *lpm, const uint8_t *masked_ip, uint8_t depth)
 		total_need_tbl_nb += need_tbl_nb;
 	}
 
+	if (tbl8_available(lpm) < total_need_tbl_nb && lpm->dq != NULL)
+		/* try to reclaim the tbl8s released by the readers */
+		rte_rcu_qsbr_dq_reclaim(lpm->dq,
+			total_need_tbl_nb - tbl8_available(lpm),
+			NULL, NULL, NULL);
+
 	if (tbl8_available(lpm) < total_need_tbl_nb)
 		/* not enough tbl8 to add a rule */
 		return -ENOSPC;
@@ -985,7 +1138,31 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
-	for (i = 0; i < n; i++) {
+	switch (lpm->lookup_fn) {
+#if defined(RTE_ARCH_X86)
+#ifdef CC_LPM6_AVX512_SUPPORT
+	case LPM6_LOOKUP_AVX512:
+		i = rte_lpm6_lookup_bulk_avx512((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, n);
+		break;
+#endif
+#ifdef CC_LPM6_AVX2_SUPPORT
+	case LPM6_LOOKUP_AVX2:
+		i = rte_lpm6_lookup_bulk_avx2((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, n);
+		break;
+#endif
+	case LPM6_LOOKUP_SSE:
+		i = rte_lpm6_lookup_bulk_sse((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, n);
+		break;
+#endif
+	default:
+		i = 0;
+	}
+
+	/* look up the remaining addresses one by one */
+	for (; i < n; i++) {
 		first_byte = LOOKUP_FIRST_BYTE;
 		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
 				(ips[i][1] << BYTE_SIZE) | ips[i][2];
@@ -1088,6 +1265,7 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
 	memset(lpm->tbl8, 0, sizeof(lpm->tbl8[0])
 			* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
+	tbl8_reclaim_all(lpm);
 	tbl8_pool_init(lpm);
 
 	/*
@@ -1116,6 +1294,7 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 			RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
 
 	/* init pool of free tbl8 indexes */
+	tbl8_reclaim_all(lpm);
 	tbl8_pool_init(lpm);
 
 	/* Delete all rules form the rules table. */
@@ -1265,7 +1444,8 @@ remove_tbl(struct rte_lpm6 *lpm, struct rte_lpm_tbl8_hdr *tbl_hdr,
 			.ext_entry = 0
 		};
 
-		*owner_entry = new_tbl_entry;
+		__atomic_store(owner_entry, &new_tbl_entry,
+				__ATOMIC_RELAXED);
 	} else {
 		struct rte_lpm6_tbl_entry new_tbl_entry = {
 			.next_hop = 0,
@@ -1275,11 +1455,12 @@ remove_tbl(struct rte_lpm6 *lpm, struct rte_lpm_tbl8_hdr *tbl_hdr,
 			.ext_entry = 0
 		};
 
-		*owner_entry = new_tbl_entry;
+		__atomic_store(owner_entry, &new_tbl_entry,
+				__ATOMIC_RELAXED);
 	}
 
 	/* return the table to the pool */
-	tbl8_put(lpm, tbl_ind);
+	tbl8_free(lpm, tbl_ind);
 }
 
 /*
@@ -1364,7 +1545,8 @@ rte_lpm6_delete(struct rte_lpm6 *lpm, const uint8_t *ip, uint8_t depth)
 					.ext_entry = 0
 				};
 
-				*from = new_tbl_entry;
+				__atomic_store(from, &new_tbl_entry,
+						__ATOMIC_RELAXED);
 			} else {
 				struct rte_lpm6_tbl_entry new_tbl_entry = {
 					.next_hop = 0,
@@ -1374,7 +1556,8 @@ rte_lpm6_delete(struct rte_lpm6 *lpm, const uint8_t *ip, uint8_t depth)
 					.ext_entry = 0
 				};
 
-				*from = new_tbl_entry;
+				__atomic_store(from, &new_tbl_entry,
+						__ATOMIC_RELAXED);
 			}
 		}
 
@@ -11,6 +11,9 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +24,17 @@ extern "C" {
 /** Max number of characters in LPM name. */
 #define RTE_LPM6_NAMESIZE                 32
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_LPM6_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_lpm6_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_LPM6_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_LPM6_QSBR_MODE_SYNC
+};
+
 /** LPM structure. */
 struct rte_lpm6;
 
@@ -31,6 +45,22 @@ struct rte_lpm6_config {
 	int flags;               /**< This field is currently unused. */
 };
 
+/** LPM6 RCU QSBR configuration structure. */
+struct rte_lpm6_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_LPM6_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_lpm6_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: lpm->number_tbl8s.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_LPM6_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Create an LPM object.
  *
@@ -77,6 +107,35 @@ rte_lpm6_find_existing(const char *name);
 void
 rte_lpm6_free(struct rte_lpm6 *lpm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with an LPM6 object.
+ *
+ * Once added, tbl8 groups released by rte_lpm6_delete() are not reused
+ * until all the reader threads registered with the QSBR variable have
+ * reported a quiescent state, which allows lookups to run concurrently
+ * with rule additions and deletions.
+ * rte_lpm6_delete_all() and rte_lpm6_delete_bulk_func() rebuild the
+ * tables in place and are still not safe against concurrent lookups.
+ *
+ * @param lpm
+ *   the lpm object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int rte_lpm6_rcu_qsbr_add(struct rte_lpm6 *lpm,
+		struct rte_lpm6_rcu_config *cfg);
+
 /**
  * Add a rule to the LPM table.
  *
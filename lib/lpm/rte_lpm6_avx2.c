@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_lpm6_vec.h"
+
+/* Byte b of the eight addresses, one per 32-bit lane */
+static __rte_always_inline __m256i
+addr_byte_x8(const __m256i *chunk, unsigned int b)
+{
+	return _mm256_and_si256(_mm256_srl_epi32(chunk[b / 4],
+			_mm_cvtsi32_si128((b % 4) * 8)),
+		_mm256_set1_epi32(UINT8_MAX));
+}
+
+static __rte_always_inline void
+lpm6_lookup_x8(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[8][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	const __m256i ext_msk =
+		_mm256_set1_epi32(RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m256i hit_msk = _mm256_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	const __m256i nh_msk = _mm256_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m256i byte_msk = _mm256_set1_epi32(UINT8_MAX);
+	/* lanes hold the addresses in the order 0, 4, 2, 6, 1, 5, 3, 7 */
+	const __m256i perm_idxes = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+	__m256i a0, a1, a2, a3, t0, t1, t2, t3;
+	__m256i chunk[4];
+	__m256i idx, res, ext, hit;
+	unsigned int b;
+
+	/* transpose 4 byte chunks of the 8 addresses, two per load */
+	a0 = _mm256_loadu_si256((const __m256i *)ips[0]);
+	a1 = _mm256_loadu_si256((const __m256i *)ips[2]);
+	a2 = _mm256_loadu_si256((const __m256i *)ips[4]);
+	a3 = _mm256_loadu_si256((const __m256i *)ips[6]);
+	t0 = _mm256_unpacklo_epi32(a0, a1);
+	t1 = _mm256_unpacklo_epi32(a2, a3);
+	t2 = _mm256_unpackhi_epi32(a0, a1);
+	t3 = _mm256_unpackhi_epi32(a2, a3);
+	chunk[0] = _mm256_unpacklo_epi32(t0, t1);
+	chunk[1] = _mm256_unpackhi_epi32(t0, t1);
+	chunk[2] = _mm256_unpacklo_epi32(t2, t3);
+	chunk[3] = _mm256_unpackhi_epi32(t2, t3);
+
+	/* tbl24 index is made of the first three bytes, in network order */
+	idx = _mm256_or_si256(_mm256_or_si256(
+			_mm256_slli_epi32(_mm256_and_si256(chunk[0], byte_msk),
+				16),
+			_mm256_and_si256(chunk[0], _mm256_set1_epi32(0xff00))),
+		_mm256_and_si256(_mm256_srli_epi32(chunk[0], 16), byte_msk));
+	res = _mm256_i32gather_epi32((const int *)tbl24, idx, 4);
+	ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, ext_msk), ext_msk);
+
+	/* walk down the tbl8s until no lane has an extended entry */
+	for (b = RTE_LPM6_TBL8_FIRST_BYTE; b < RTE_LPM6_IPV6_ADDR_SIZE &&
+			_mm256_movemask_ps(_mm256_castsi256_ps(ext)) != 0;
+			b++) {
+		idx = _mm256_slli_epi32(_mm256_and_si256(res, nh_msk), 8);
+		idx = _mm256_add_epi32(idx, addr_byte_x8(chunk, b));
+		res = _mm256_mask_i32gather_epi32(res, (const int *)tbl8, idx,
+			ext, 4);
+		ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, ext_msk),
+			ext_msk);
+	}
+
+	hit = _mm256_cmpeq_epi32(_mm256_and_si256(res, hit_msk), hit_msk);
+	res = _mm256_blendv_epi8(_mm256_set1_epi32(-1),
+		_mm256_and_si256(res, nh_msk), hit);
+	res = _mm256_permutevar8x32_epi32(res, perm_idxes);
+	_mm256_storeu_si256((__m256i *)next_hops, res);
+}
+
+unsigned int
+rte_lpm6_lookup_bulk_avx2(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+		lpm6_lookup_x8(tbl24, tbl8, &ips[i], &next_hops[i]);
+
+	return i;
+}
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_lpm6_vec.h"
+
+/* Byte b of the sixteen addresses, one per 32-bit lane */
+static __rte_always_inline __m512i
+addr_byte_x16(const __m512i *chunk, unsigned int b)
+{
+	return _mm512_and_si512(_mm512_srl_epi32(chunk[b / 4],
+			_mm_cvtsi32_si128((b % 4) * 8)),
+		_mm512_set1_epi32(UINT8_MAX));
+}
+
+static __rte_always_inline void
+lpm6_lookup_x16(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[16][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	const __m512i ext_msk =
+		_mm512_set1_epi32(RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m512i hit_msk = _mm512_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	const __m512i nh_msk = _mm512_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m512i byte_msk = _mm512_set1_epi32(UINT8_MAX);
+	/* lanes hold the addresses in the order 0, 8, 4, 12, 1, 9, ... */
+	const __m512i perm_idxes = _mm512_setr_epi32(0, 4, 8, 12, 2, 6, 10, 14,
+			1, 5, 9, 13, 3, 7, 11, 15);
+	__m512i a0, a1, a2, a3, t0, t1, t2, t3;
+	__m512i chunk[4];
+	__m512i idx, res;
+	__mmask16 ext, hit;
+	unsigned int b;
+
+	/* transpose 4 byte chunks of the 16 addresses, four per load */
+	a0 = _mm512_loadu_si512(ips[0]);
+	a1 = _mm512_loadu_si512(ips[4]);
+	a2 = _mm512_loadu_si512(ips[8]);
+	a3 = _mm512_loadu_si512(ips[12]);
+	t0 = _mm512_unpacklo_epi32(a0, a1);
+	t1 = _mm512_unpacklo_epi32(a2, a3);
+	t2 = _mm512_unpackhi_epi32(a0, a1);
+	t3 = _mm512_unpackhi_epi32(a2, a3);
+	chunk[0] = _mm512_unpacklo_epi32(t0, t1);
+	chunk[1] = _mm512_unpackhi_epi32(t0, t1);
+	chunk[2] = _mm512_unpacklo_epi32(t2, t3);
+	chunk[3] = _mm512_unpackhi_epi32(t2, t3);
+
+	/* tbl24 index is made of the first three bytes, in network order */
+	idx = _mm512_or_si512(_mm512_or_si512(
+			_mm512_slli_epi32(_mm512_and_si512(chunk[0], byte_msk),
+				16),
+			_mm512_and_si512(chunk[0], _mm512_set1_epi32(0xff00))),
+		_mm512_and_si512(_mm512_srli_epi32(chunk[0], 16), byte_msk));
+	res = _mm512_i32gather_epi32(idx, (const int *)tbl24, 4);
+	ext = _mm512_cmpeq_epi32_mask(_mm512_and_si512(res, ext_msk),
+		ext_msk);
+
+	/* walk down the tbl8s until no lane has an extended entry */
+	for (b = RTE_LPM6_TBL8_FIRST_BYTE;
+			b < RTE_LPM6_IPV6_ADDR_SIZE && ext != 0; b++) {
+		idx = _mm512_slli_epi32(_mm512_and_si512(res, nh_msk), 8);
+		idx = _mm512_add_epi32(idx, addr_byte_x16(chunk, b));
+		res = _mm512_mask_i32gather_epi32(res, ext, idx,
+			(const int *)tbl8, 4);
+		ext = _mm512_mask_cmpeq_epi32_mask(ext,
+			_mm512_and_si512(res, ext_msk), ext_msk);
+	}
+
+	hit = _mm512_cmpeq_epi32_mask(_mm512_and_si512(res, hit_msk), hit_msk);
+	res = _mm512_mask_blend_epi32(hit, _mm512_set1_epi32(-1),
+		_mm512_and_si512(res, nh_msk));
+	res = _mm512_permutexvar_epi32(perm_idxes, res);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+unsigned int
+rte_lpm6_lookup_bulk_avx512(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + 16 <= n; i += 16)
+		lpm6_lookup_x16(tbl24, tbl8, &ips[i], &next_hops[i]);
+
+	return i;
+}
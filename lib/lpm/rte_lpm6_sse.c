@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_lpm6_vec.h"
+
+/* SSE has no gather, load the entries of the four lanes one by one */
+static __rte_always_inline __m128i
+tbl_load_x4(const uint32_t *tbl, __m128i idx)
+{
+	return _mm_setr_epi32(tbl[_mm_cvtsi128_si32(idx)],
+		tbl[_mm_extract_epi32(idx, 1)],
+		tbl[_mm_extract_epi32(idx, 2)],
+		tbl[_mm_extract_epi32(idx, 3)]);
+}
+
+/* Byte b of the four addresses, one per 32-bit lane */
+static __rte_always_inline __m128i
+addr_byte_x4(const __m128i *chunk, unsigned int b)
+{
+	return _mm_and_si128(_mm_srl_epi32(chunk[b / 4],
+			_mm_cvtsi32_si128((b % 4) * 8)),
+		_mm_set1_epi32(UINT8_MAX));
+}
+
+/* Transpose 4 byte chunks of the 4 addresses */
+static __rte_always_inline void
+transpose_x4(uint8_t ips[4][RTE_LPM6_IPV6_ADDR_SIZE], __m128i *chunk)
+{
+	__m128i a0, a1, a2, a3, t0, t1, t2, t3;
+
+	a0 = _mm_loadu_si128((const __m128i *)ips[0]);
+	a1 = _mm_loadu_si128((const __m128i *)ips[1]);
+	a2 = _mm_loadu_si128((const __m128i *)ips[2]);
+	a3 = _mm_loadu_si128((const __m128i *)ips[3]);
+	t0 = _mm_unpacklo_epi32(a0, a1);
+	t1 = _mm_unpacklo_epi32(a2, a3);
+	t2 = _mm_unpackhi_epi32(a0, a1);
+	t3 = _mm_unpackhi_epi32(a2, a3);
+	chunk[0] = _mm_unpacklo_epi64(t0, t1);
+	chunk[1] = _mm_unpackhi_epi64(t0, t1);
+	chunk[2] = _mm_unpacklo_epi64(t2, t3);
+	chunk[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+/* tbl24 index is made of the first three bytes, in network order */
+static __rte_always_inline __m128i
+tbl24_idx_x4(__m128i chunk)
+{
+	const __m128i byte_msk = _mm_set1_epi32(UINT8_MAX);
+
+	return _mm_or_si128(_mm_or_si128(
+			_mm_slli_epi32(_mm_and_si128(chunk, byte_msk), 16),
+			_mm_and_si128(chunk, _mm_set1_epi32(0xff00))),
+		_mm_and_si128(_mm_srli_epi32(chunk, 16), byte_msk));
+}
+
+/* Next hops of the 4 addresses, -1 on a miss */
+static __rte_always_inline __m128i
+next_hops_x4(__m128i res)
+{
+	const __m128i hit_msk = _mm_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	__m128i hit;
+
+	hit = _mm_cmpeq_epi32(_mm_and_si128(res, hit_msk), hit_msk);
+	return _mm_blendv_epi8(_mm_set1_epi32(-1),
+		_mm_and_si128(res, _mm_set1_epi32(RTE_LPM6_TBL8_BITMASK)),
+		hit);
+}
+
+/*
+ * Look up two groups of 4 addresses, interleaving the table loads
+ * of both groups
+ */
+static __rte_always_inline void
+lpm6_lookup_x4x2(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[8][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	const __m128i ext_msk = _mm_set1_epi32(RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m128i nh_msk = _mm_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	__m128i chunk_1[4], chunk_2[4];
+	__m128i idx_1, res_1, ext_1;
+	__m128i idx_2, res_2, ext_2;
+	unsigned int b;
+
+	transpose_x4(ips, chunk_1);
+	transpose_x4(ips + 4, chunk_2);
+
+	res_1 = tbl_load_x4(tbl24, tbl24_idx_x4(chunk_1[0]));
+	res_2 = tbl_load_x4(tbl24, tbl24_idx_x4(chunk_2[0]));
+	ext_1 = _mm_cmpeq_epi32(_mm_and_si128(res_1, ext_msk), ext_msk);
+	ext_2 = _mm_cmpeq_epi32(_mm_and_si128(res_2, ext_msk), ext_msk);
+
+	/* walk down the tbl8s until no lane has an extended entry */
+	for (b = RTE_LPM6_TBL8_FIRST_BYTE; b < RTE_LPM6_IPV6_ADDR_SIZE &&
+			_mm_movemask_ps(_mm_castsi128_ps(
+				_mm_or_si128(ext_1, ext_2))) != 0; b++) {
+		idx_1 = _mm_slli_epi32(_mm_and_si128(res_1, nh_msk), 8);
+		idx_2 = _mm_slli_epi32(_mm_and_si128(res_2, nh_msk), 8);
+		idx_1 = _mm_add_epi32(idx_1, addr_byte_x4(chunk_1, b));
+		idx_2 = _mm_add_epi32(idx_2, addr_byte_x4(chunk_2, b));
+		/* the finished lanes read the first entry, then drop it */
+		idx_1 = _mm_and_si128(idx_1, ext_1);
+		idx_2 = _mm_and_si128(idx_2, ext_2);
+		res_1 = _mm_blendv_epi8(res_1, tbl_load_x4(tbl8, idx_1), ext_1);
+		res_2 = _mm_blendv_epi8(res_2, tbl_load_x4(tbl8, idx_2), ext_2);
+		ext_1 = _mm_cmpeq_epi32(_mm_and_si128(res_1, ext_msk), ext_msk);
+		ext_2 = _mm_cmpeq_epi32(_mm_and_si128(res_2, ext_msk), ext_msk);
+	}
+
+	_mm_storeu_si128((__m128i *)next_hops, next_hops_x4(res_1));
+	_mm_storeu_si128((__m128i *)&next_hops[4], next_hops_x4(res_2));
+}
+
+unsigned int
+rte_lpm6_lookup_bulk_sse(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+		lpm6_lookup_x4x2(tbl24, tbl8, &ips[i], &next_hops[i]);
+
+	return i;
+}
@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _RTE_LPM6_VEC_H_
+#define _RTE_LPM6_VEC_H_
+
+#include <stdint.h>
+
+#include "rte_lpm6.h"
+
+/* Bits of a table entry, see struct rte_lpm6_tbl_entry */
+#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
+#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
+#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
+
+/* Byte of the address used to index the first tbl8 level */
+#define RTE_LPM6_TBL8_FIRST_BYTE         3
+
+/*
+ * Look up the addresses in groups of 4, 8 or 16, walking the tables of
+ * all the addresses of a group in lockstep. The next hop of an address
+ * is set to -1 on a miss, as done by rte_lpm6_lookup_bulk_func().
+ * Return the number of addresses looked up, the remaining ones
+ * (less than a group) are left to the caller.
+ */
+unsigned int
+rte_lpm6_lookup_bulk_sse(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n);
+
+unsigned int
+rte_lpm6_lookup_bulk_avx2(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n);
+
+unsigned int
+rte_lpm6_lookup_bulk_avx512(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	unsigned int n);
+
+#endif /* _RTE_LPM6_VEC_H_ */
@@ -19,6 +19,7 @@
 #include <rte_hexdump.h>
 #include <rte_errno.h>
 #include <rte_memcpy.h>
+#include <rte_prefetch.h>
 
 /*
  * pktmbuf pool constructor, given as a callback function to
@@ -441,70 +442,122 @@ int rte_mbuf_check(const struct rte_mbuf *m, int is_header,
 	return 0;
 }
 
+/**
+ * Size of the array holding mbufs from the same mempool pending to be freed
+ * in bulk.
+ */
+#define RTE_PKTMBUF_FREE_PENDING_SZ 64
+
+/**
+ * Number of mempools whose mbufs can be pending to be freed at the same
+ * time, when freeing a bulk of mbufs from different mempools.
+ */
+#define RTE_PKTMBUF_FREE_POOLS 4
+
+/* Number of mbufs ahead to prefetch when freeing a bulk of mbufs. */
+#define RTE_PKTMBUF_FREE_PREFETCH 4
+
+/** @internal Packet mbuf segments pending to be freed, grouped by mempool. */
+struct rte_pktmbuf_free_pending {
+	unsigned int nb_pools;
+	struct rte_mempool *pool[RTE_PKTMBUF_FREE_POOLS];
+	unsigned int nb[RTE_PKTMBUF_FREE_POOLS];
+	struct rte_mbuf *mbufs[RTE_PKTMBUF_FREE_POOLS]
+		[RTE_PKTMBUF_FREE_PENDING_SZ];
+};
+
 /**
  * @internal helper function for freeing a bulk of packet mbuf segments
- * via an array holding the packet mbuf segments from the same mempool
- * pending to be freed.
+ * via arrays holding the packet mbuf segments pending to be freed, one
+ * per mempool.
+ *
+ * When the mbufs come from more mempools than there are arrays, the
+ * array holding the most segments is flushed to make room for the new
+ * mempool, so interleaved mempools still give large bulk puts.
  *
  * @param m
- *  The packet mbuf segment to be freed.
+ *  The packet mbuf segment to be freed, already prefreed.
  * @param pending
- *  Pointer to the array of packet mbuf segments pending to be freed.
- * @param nb_pending
- *  Pointer to the number of elements held in the array.
- * @param pending_sz
- *  Number of elements the array can hold.
- *  Note: The compiler should optimize this parameter away when using a
- *  constant value, such as RTE_PKTMBUF_FREE_PENDING_SZ.
+ *  Pointer to the arrays of packet mbuf segments pending to be freed.
  */
-static void
-__rte_pktmbuf_free_seg_via_array(struct rte_mbuf *m,
-	struct rte_mbuf ** const pending, unsigned int * const nb_pending,
-	const unsigned int pending_sz)
+static __rte_always_inline void
+__rte_pktmbuf_free_seg_via_pools(struct rte_mbuf *m,
+	struct rte_pktmbuf_free_pending * const pending)
 {
-	m = rte_pktmbuf_prefree_seg(m);
-	if (likely(m != NULL)) {
-		if (*nb_pending == pending_sz ||
-		    (*nb_pending > 0 && m->pool != pending[0]->pool)) {
-			rte_mempool_put_bulk(pending[0]->pool,
-					(void **)pending, *nb_pending);
-			*nb_pending = 0;
+	struct rte_mempool *mp = m->pool;
+	unsigned int i, victim;
+
+	for (i = 0; i < pending->nb_pools; i++)
+		if (pending->pool[i] == mp)
+			break;
+
+	if (unlikely(i == pending->nb_pools)) {
+		if (pending->nb_pools < RTE_PKTMBUF_FREE_POOLS) {
+			pending->nb_pools++;
+		} else {
+			for (i = 0, victim = 1; victim < RTE_PKTMBUF_FREE_POOLS;
+					victim++)
+				if (pending->nb[victim] > pending->nb[i])
+					i = victim;
+			rte_mempool_put_bulk(pending->pool[i],
+					(void **)pending->mbufs[i],
+					pending->nb[i]);
 		}
-
-		pending[(*nb_pending)++] = m;
+		pending->pool[i] = mp;
+		pending->nb[i] = 0;
+	} else if (pending->nb[i] == RTE_PKTMBUF_FREE_PENDING_SZ) {
+		rte_mempool_put_bulk(mp, (void **)pending->mbufs[i],
+				pending->nb[i]);
+		pending->nb[i] = 0;
 	}
-}
 
-/**
- * Size of the array holding mbufs from the same mempool pending to be freed
- * in bulk.
- */
-#define RTE_PKTMBUF_FREE_PENDING_SZ 64
+	pending->mbufs[i][pending->nb[i]++] = m;
+}
 
 /* Free a bulk of packet mbufs back into their original mempools. */
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 {
-	struct rte_mbuf *m, *m_next, *pending[RTE_PKTMBUF_FREE_PENDING_SZ];
-	unsigned int idx, nb_pending = 0;
+	struct rte_pktmbuf_free_pending pending;
+	struct rte_mbuf *m, *m_next;
+	unsigned int idx, i;
+
+	pending.nb_pools = 0;
 
 	for (idx = 0; idx < count; idx++) {
+		if (idx + RTE_PKTMBUF_FREE_PREFETCH < count)
+			rte_prefetch0(mbufs[idx + RTE_PKTMBUF_FREE_PREFETCH]);
+
 		m = mbufs[idx];
 		if (unlikely(m == NULL))
 			continue;
 
 		__rte_mbuf_sanity_check(m, 1);
 
+		/*
+		 * Fast path for the common case of a non-shared, direct,
+		 * single segment mbuf: all fields checked are in the first
+		 * cache line and nothing has to be reset before the put.
+		 */
+		if (likely(rte_mbuf_refcnt_read(m) == 1 && m->nb_segs == 1 &&
+				RTE_MBUF_DIRECT(m))) {
+			__rte_pktmbuf_free_seg_via_pools(m, &pending);
+			continue;
+		}
+
 		do {
 			m_next = m->next;
-			__rte_pktmbuf_free_seg_via_array(m,
-					pending, &nb_pending,
-					RTE_PKTMBUF_FREE_PENDING_SZ);
+			m = rte_pktmbuf_prefree_seg(m);
+			if (likely(m != NULL))
+				__rte_pktmbuf_free_seg_via_pools(m, &pending);
 			m = m_next;
 		} while (m != NULL);
 	}
 
-	if (nb_pending > 0)
-		rte_mempool_put_bulk(pending[0]->pool, (void **)pending, nb_pending);
+	for (i = 0; i < pending.nb_pools; i++)
+		if (pending.nb[i] > 0)
+			rte_mempool_put_bulk(pending.pool[i],
+					(void **)pending.mbufs[i],
+					pending.nb[i]);
 }
 
 /* Creates a shallow copy of mbuf */
@@ -754,6 +754,9 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->size = size;
 	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
 	cache->len = 0;
+	cache->nb_req = 0;
+	cache->nb_miss = 0;
+	cache->hit_ratio = 0;
 }
 
 /*
@@ -847,6 +850,12 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		return NULL;
 	}
 
+	/* adaptive caches need an upper bound */
+	if ((flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE) && cache_size == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
 	/*
 	 * No objects in the pool can be used for IO until it's populated
 	 * with at least some objects with valid IOVA.
@@ -922,11 +931,16 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	mp->local_cache = (struct rte_mempool_cache *)
 		RTE_PTR_ADD(mp, RTE_MEMPOOL_HEADER_SIZE(mp, 0));
 
-	/* Init all default caches. */
+	/* Init all default caches, adaptive ones start small. */
 	if (cache_size != 0) {
+		unsigned int init_size = cache_size;
+
+		if (flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE)
+			init_size = RTE_MIN(cache_size,
+				(unsigned int)RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE);
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
-					   cache_size);
+					   init_size);
 	}
 
 	te->data = mp;
@@ -1490,6 +1504,39 @@ struct mempool_info_cb_arg {
 	struct rte_tel_data *d;
 };
 
+/* report the size and hit ratio of the default caches, indexed by lcore */
+static void
+mempool_info_add_caches(const struct rte_mempool *mp, struct rte_tel_data *d)
+{
+	struct rte_tel_data *sizes, *ratios;
+	int lcore_id, last_lcore = -1;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		if (!rte_lcore_has_role(lcore_id, ROLE_OFF))
+			last_lcore = lcore_id;
+	if (last_lcore < 0)
+		return;
+
+	sizes = rte_tel_data_alloc();
+	ratios = rte_tel_data_alloc();
+	if (sizes == NULL || ratios == NULL) {
+		rte_tel_data_free(sizes);
+		rte_tel_data_free(ratios);
+		return;
+	}
+	rte_tel_data_start_array(sizes, RTE_TEL_UINT_VAL);
+	rte_tel_data_start_array(ratios, RTE_TEL_UINT_VAL);
+	for (lcore_id = 0; lcore_id <= last_lcore; lcore_id++) {
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+
+		rte_tel_data_add_array_uint(sizes, cache->size);
+		rte_tel_data_add_array_uint(ratios, cache->hit_ratio);
+	}
+	rte_tel_data_add_dict_container(d, "lcore_cache_size", sizes, 0);
+	rte_tel_data_add_dict_container(d, "lcore_cache_hit_ratio", ratios, 0);
+}
+
 static void
 mempool_info_cb(struct rte_mempool *mp, void *arg)
 {
@@ -1522,6 +1569,8 @@ mempool_info_cb(struct rte_mempool *mp, void *arg)
 			cache_count += mp->local_cache[lcore_id].len;
 	}
 	rte_tel_data_add_dict_uint(info->d, "total_cache_count", cache_count);
+	if (mp->cache_size > 0)
+		mempool_info_add_caches(mp, info->d);
 	common_count = rte_mempool_ops_get_count(mp);
 	if ((cache_count + common_count) > mp->size)
 		common_count = mp->size - cache_count;
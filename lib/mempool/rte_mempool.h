@@ -88,8 +88,10 @@ struct rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	uint32_t nb_req;      /**< Get and put requests in the sampling period */
+	uint32_t nb_miss;     /**< Requests which reached the backend */
+	uint32_t hit_ratio;   /**< Percentage of hits in the last period */
 #ifdef RTE_LIBRTE_MEMPOOL_STATS
-	uint32_t unused;
 	/*
 	 * Alternative location for the most frequently updated mempool statistics (per-lcore),
 	 * providing faster update access when using a mempool cache.
@@ -300,6 +302,8 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/** Resize the default caches at runtime, up to the cache size of the pool. */
+#define RTE_MEMPOOL_F_ADAPTIVE_CACHE	0x0080
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -309,8 +313,18 @@ struct rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_ADAPTIVE_CACHE \
 	)
 
+/** Number of cache requests over which the cache hit ratio is sampled. */
+#define RTE_MEMPOOL_CACHE_SAMPLE_PERIOD 1024
+/** Smallest size of an adaptive cache. */
+#define RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE 32
+/** Hit ratio, in percent, below which an adaptive cache grows. */
+#define RTE_MEMPOOL_CACHE_GROW_HIT_RATIO 90
+/** Hit ratio, in percent, above which an adaptive cache shrinks. */
+#define RTE_MEMPOOL_CACHE_SHRINK_HIT_RATIO 99
+
 /**
  * @internal When stats is enabled, store some statistics.
  *
@@ -1065,6 +1079,9 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - RTE_MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - RTE_MEMPOOL_F_ADAPTIVE_CACHE: If set, each default per-lcore cache
+ *     starts small and is grown or shrunk depending on its hit ratio,
+ *     up to *cache_size*, which must not be zero.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1346,6 +1363,80 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal End the sampling period of a cache.
+ *
+ * Record the hit ratio of the cache and, if the mempool was created with
+ * RTE_MEMPOOL_F_ADAPTIVE_CACHE and this is a default cache, double the cache
+ * size when the hit ratio is low or halve it when it is high.
+ * Objects above a reduced flush threshold are flushed by the next put.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ */
+static inline void
+rte_mempool_cache_sample(struct rte_mempool *mp,
+			 struct rte_mempool_cache *cache)
+{
+	uint32_t size, min_size;
+
+	cache->hit_ratio = (uint64_t)(cache->nb_req - cache->nb_miss) * 100 /
+		cache->nb_req;
+	cache->nb_req = 0;
+	cache->nb_miss = 0;
+
+	/* user-owned caches keep their size */
+	if (!(mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE) ||
+			cache < mp->local_cache ||
+			cache >= &mp->local_cache[RTE_MAX_LCORE])
+		return;
+
+	size = cache->size;
+	min_size = RTE_MIN(mp->cache_size,
+			(uint32_t)RTE_MEMPOOL_CACHE_ADAPTIVE_MIN_SIZE);
+	if (cache->hit_ratio < RTE_MEMPOOL_CACHE_GROW_HIT_RATIO)
+		size = RTE_MIN(size * 2, mp->cache_size);
+	else if (cache->hit_ratio > RTE_MEMPOOL_CACHE_SHRINK_HIT_RATIO)
+		size = RTE_MAX(size / 2, min_size);
+
+	/* same flush threshold as set at cache creation */
+	cache->size = size;
+	cache->flushthresh = size + size / 2;
+}
+
+/**
+ * @internal Account for a cache request served from the cache.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ */
+static __rte_always_inline void
+rte_mempool_cache_hit(struct rte_mempool *mp, struct rte_mempool_cache *cache)
+{
+	if (unlikely(++cache->nb_req >= RTE_MEMPOOL_CACHE_SAMPLE_PERIOD))
+		rte_mempool_cache_sample(mp, cache);
+}
+
+/**
+ * @internal Account for a cache request which reached the backend.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ */
+static inline void
+rte_mempool_cache_miss(struct rte_mempool *mp, struct rte_mempool_cache *cache)
+{
+	/* a miss is accounted as a request too */
+	cache->nb_miss++;
+	rte_mempool_cache_hit(mp, cache);
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1373,8 +1464,11 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
 
 	/* The request itself is too big for the cache */
-	if (unlikely(n > cache->flushthresh))
+	if (unlikely(n > cache->flushthresh)) {
+		/* so that an adaptive cache grows to hold it */
+		rte_mempool_cache_miss(mp, cache);
 		goto driver_enqueue_stats_incremented;
+	}
 
 	/*
 	 * The cache follows the following algorithm:
@@ -1386,7 +1480,9 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	if (cache->len + n <= cache->flushthresh) {
 		cache_objs = &cache->objs[cache->len];
 		cache->len += n;
+		rte_mempool_cache_hit(mp, cache);
 	} else {
+		rte_mempool_cache_miss(mp, cache);
 		cache_objs = &cache->objs[0];
 		rte_mempool_ops_enqueue_bulk(mp, cache_objs, cache->len);
 		cache->len = n;
@@ -1510,6 +1606,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	if (remaining == 0) {
 		/* The entire request is satisfied from the cache. */
+		rte_mempool_cache_hit(mp, cache);
 
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
@@ -1517,6 +1614,8 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		return 0;
 	}
 
+	rte_mempool_cache_miss(mp, cache);
+
 	/* if dequeue below would overflow mem allocated for cache */
 	if (unlikely(remaining > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto driver_dequeue;
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <stdlib.h>
+
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+
+#include "rte_node_eventdev_api.h"
+
+#include "eventdev_priv.h"
+#include "node_private.h"
+
+int
+rte_node_eventdev_config(struct rte_node_eventdev_config *conf,
+			 uint16_t nb_confs)
+{
+	struct eventdev_node_main *node_data;
+	struct rte_node_register *rx_node;
+	struct rte_node_register *tx_node;
+	char name[RTE_NODE_NAMESIZE];
+	eventdev_node_elem_t *elem;
+	uint32_t nb_ports;
+	uint32_t vector_sz;
+	rte_node_t rx_id;
+	rte_node_t tx_id;
+	int i;
+
+	node_data = eventdev_node_data_get();
+	rx_node = eventdev_rx_node_get();
+	tx_node = eventdev_tx_node_get();
+	for (i = 0; i < nb_confs; i++) {
+		if (conf[i].dev_id >= rte_event_dev_count())
+			return -EINVAL;
+
+		if (rte_event_dev_attr_get(conf[i].dev_id,
+					   RTE_EVENT_DEV_ATTR_PORT_COUNT,
+					   &nb_ports) < 0 ||
+		    conf[i].port_id >= nb_ports)
+			return -EINVAL;
+
+		/* Get the vector size from the vector pool object size */
+		vector_sz = 0;
+		if (conf[i].vector_pool != NULL) {
+			if (conf[i].vector_pool->elt_size >
+			    sizeof(struct rte_event_vector))
+				vector_sz = (conf[i].vector_pool->elt_size -
+					     sizeof(struct rte_event_vector)) /
+					    sizeof(void *);
+			if (vector_sz == 0) {
+				node_err("eventdev",
+					 "Invalid event vector pool %s",
+					 conf[i].vector_pool->name);
+				return -EINVAL;
+			}
+			vector_sz = RTE_MIN(vector_sz, (uint32_t)UINT16_MAX);
+		}
+
+		/* Clone a new rx and tx node with same edges as parent */
+		snprintf(name, sizeof(name), "%u-%u", conf[i].dev_id,
+			 conf[i].port_id);
+		rx_id = rte_node_clone(rx_node->id, name);
+		if (rx_id == RTE_NODE_ID_INVALID)
+			return -EIO;
+		tx_id = rte_node_clone(tx_node->id, name);
+		if (tx_id == RTE_NODE_ID_INVALID)
+			return -EIO;
+
+		/* Add it to list of eventdev nodes for lookup */
+		elem = malloc(sizeof(eventdev_node_elem_t));
+		if (elem == NULL)
+			return -ENOMEM;
+		memset(elem, 0, sizeof(eventdev_node_elem_t));
+		elem->ctx.vector_pool = conf[i].vector_pool;
+		elem->ctx.vector_sz = vector_sz;
+		elem->ctx.dev_id = conf[i].dev_id;
+		elem->ctx.port_id = conf[i].port_id;
+		elem->ctx.queue_id = conf[i].queue_id;
+		elem->ctx.sched_type = conf[i].sched_type;
+		elem->ctx.priority = conf[i].priority;
+		elem->rx_nid = rx_id;
+		elem->tx_nid = tx_id;
+		elem->next = node_data->head;
+		node_data->head = elem;
+
+		node_dbg("eventdev", "Rx node %s-%s: is at %u, Tx node at %u",
+			 rx_node->name, name, rx_id, tx_id);
+	}
+
+	return 0;
+}
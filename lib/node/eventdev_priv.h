@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+#ifndef __INCLUDE_EVENTDEV_PRIV_H__
+#define __INCLUDE_EVENTDEV_PRIV_H__
+
+#include <rte_common.h>
+#include <rte_mempool.h>
+
+/* Maximum number of events dequeued or enqueued at once */
+#define EVENTDEV_NODE_BURST_SIZE 32
+/* Maximum number of objects moved to the stream by the Rx node at once */
+#define EVENTDEV_RX_STREAM_MAX UINT16_MAX
+
+struct eventdev_node_elem;
+struct eventdev_node_ctx;
+struct eventdev_rx_node_ctx;
+typedef struct eventdev_node_elem eventdev_node_elem_t;
+typedef struct eventdev_node_ctx eventdev_node_ctx_t;
+typedef struct eventdev_rx_node_ctx eventdev_rx_node_ctx_t;
+
+/**
+ * @internal
+ *
+ * Event device Rx node context structure.
+ */
+struct eventdev_rx_node_ctx {
+	struct rte_event *pending;
+	/**< Events dequeued and not yet moved to the stream. */
+	uint16_t nb_pending; /**< Number of pending events. */
+	uint8_t dev_id;	     /**< Event device identifier. */
+	uint8_t port_id;     /**< Event port identifier. */
+};
+
+/**
+ * @internal
+ *
+ * Event device node configuration, and Tx node context structure.
+ */
+struct eventdev_node_ctx {
+	struct rte_mempool *vector_pool;
+	/**< Event vector pool of the Tx node. */
+	uint16_t vector_sz;
+	/**< Maximum number of objects of an event vector. */
+	uint8_t dev_id;	    /**< Event device identifier. */
+	uint8_t port_id;    /**< Event port identifier. */
+	uint8_t queue_id;   /**< Event queue identifier of Tx events. */
+	uint8_t sched_type; /**< Scheduling type of Tx events. */
+	uint8_t priority;   /**< Priority of Tx events. */
+};
+
+/**
+ * @internal
+ *
+ * Event device node list element structure.
+ */
+struct eventdev_node_elem {
+	struct eventdev_node_elem *next;
+	/**< Pointer to the next node element. */
+	struct eventdev_node_ctx ctx;
+	/**< Rx and Tx node context. */
+	rte_node_t rx_nid;
+	/**< Node identifier of the Rx node. */
+	rte_node_t tx_nid;
+	/**< Node identifier of the Tx node. */
+};
+
+enum eventdev_rx_next_nodes {
+	EVENTDEV_RX_NEXT_PKT_CLS,
+	EVENTDEV_RX_NEXT_MAX,
+};
+
+enum eventdev_tx_next_nodes {
+	EVENTDEV_TX_NEXT_PKT_DROP,
+	EVENTDEV_TX_NEXT_MAX,
+};
+
+/**
+ * @internal
+ *
+ * Event device node main structure.
+ */
+struct eventdev_node_main {
+	eventdev_node_elem_t *head;
+	/**< Pointer to the head node element. */
+};
+
+/**
+ * @internal
+ *
+ * Get the event device node data.
+ *
+ * @return
+ *   Pointer to event device node data.
+ */
+struct eventdev_node_main *eventdev_node_data_get(void);
+
+/**
+ * @internal
+ *
+ * Get the event device Rx node.
+ *
+ * @return
+ *   Pointer to the event device Rx node.
+ */
+struct rte_node_register *eventdev_rx_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the event device Tx node.
+ *
+ * @return
+ *   Pointer to the event device Tx node.
+ */
+struct rte_node_register *eventdev_tx_node_get(void);
+
+#endif /* __INCLUDE_EVENTDEV_PRIV_H__ */
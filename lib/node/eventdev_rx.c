@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <rte_debug.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_malloc.h>
+
+#include "eventdev_priv.h"
+#include "node_private.h"
+
+static struct eventdev_node_main eventdev_main;
+
+static __rte_always_inline uint16_t
+eventdev_rx_node_process_inline(struct rte_graph *graph, struct rte_node *node,
+				eventdev_rx_node_ctx_t *ctx)
+{
+	struct rte_event *ev = ctx->pending;
+	struct rte_event_vector *vec;
+	uint16_t count = 0;
+	uint32_t total = 0;
+	uint16_t nb, i;
+	uint32_t n;
+	void **objs;
+
+	/* Events left by the previous call are moved first */
+	nb = ctx->nb_pending;
+	if (!nb)
+		nb = rte_event_dequeue_burst(ctx->dev_id, ctx->port_id, ev,
+					     EVENTDEV_NODE_BURST_SIZE, 0);
+	if (!nb)
+		return 0;
+
+	/* Keep the events which would overflow the stream for the next call,
+	 * a single vector always fits as it holds at most UINT16_MAX objects.
+	 */
+	for (i = 0; i < nb; i++) {
+		n = (ev[i].event_type & RTE_EVENT_TYPE_VECTOR) ?
+			ev[i].vec->nb_elem : 1;
+		if (total + n > EVENTDEV_RX_STREAM_MAX)
+			break;
+		total += n;
+	}
+	ctx->nb_pending = nb - i;
+	nb = i;
+
+	/* Grow the stream once for all the vectors */
+	if (unlikely(total > node->size))
+		__rte_node_stream_alloc_size(graph, node, total);
+
+	objs = node->objs;
+	for (i = 0; i < nb; i++) {
+		if (!(ev[i].event_type & RTE_EVENT_TYPE_VECTOR)) {
+			objs[count++] = ev[i].event_ptr;
+			continue;
+		}
+
+		/* Copy the object array of the vector at once */
+		vec = ev[i].vec;
+		rte_memcpy(&objs[count], &vec->ptrs[vec->elem_offset],
+			   vec->nb_elem * sizeof(void *));
+		count += vec->nb_elem;
+		rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	}
+
+	if (ctx->nb_pending)
+		memmove(ev, &ev[nb], ctx->nb_pending * sizeof(*ev));
+
+	if (!count)
+		return 0;
+	node->idx = count;
+	/* Enqueue to next node */
+	rte_node_next_stream_move(graph, node, EVENTDEV_RX_NEXT_PKT_CLS);
+
+	return count;
+}
+
+static uint16_t
+eventdev_rx_node_process(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t cnt)
+{
+	eventdev_rx_node_ctx_t *ctx = (eventdev_rx_node_ctx_t *)node->ctx;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(cnt);
+
+	return eventdev_rx_node_process_inline(graph, node, ctx);
+}
+
+static int
+eventdev_rx_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	eventdev_rx_node_ctx_t *ctx = (eventdev_rx_node_ctx_t *)node->ctx;
+	eventdev_node_elem_t *elem = eventdev_main.head;
+
+	RTE_BUILD_BUG_ON(sizeof(eventdev_node_ctx_t) > RTE_NODE_CTX_SZ);
+	RTE_BUILD_BUG_ON(sizeof(eventdev_rx_node_ctx_t) > RTE_NODE_CTX_SZ);
+
+	while (elem) {
+		if (elem->rx_nid == node->id) {
+			/* Update node specific context */
+			ctx->dev_id = elem->ctx.dev_id;
+			ctx->port_id = elem->ctx.port_id;
+			break;
+		}
+		elem = elem->next;
+	}
+
+	RTE_VERIFY(elem != NULL);
+
+	ctx->nb_pending = 0;
+	ctx->pending = rte_zmalloc_socket("eventdev_rx_pending",
+			EVENTDEV_NODE_BURST_SIZE * sizeof(struct rte_event),
+			RTE_CACHE_LINE_SIZE, graph->socket);
+	if (ctx->pending == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static void
+eventdev_rx_node_fini(const struct rte_graph *graph, struct rte_node *node)
+{
+	eventdev_rx_node_ctx_t *ctx = (eventdev_rx_node_ctx_t *)node->ctx;
+
+	RTE_SET_USED(graph);
+
+	rte_free(ctx->pending);
+	ctx->pending = NULL;
+}
+
+struct eventdev_node_main *
+eventdev_node_data_get(void)
+{
+	return &eventdev_main;
+}
+
+static struct rte_node_register eventdev_rx_node_base = {
+	.process = eventdev_rx_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "eventdev_rx",
+
+	.init = eventdev_rx_node_init,
+	.fini = eventdev_rx_node_fini,
+
+	.nb_edges = EVENTDEV_RX_NEXT_MAX,
+	.next_nodes = {
+		/* Default pkt classification node */
+		[EVENTDEV_RX_NEXT_PKT_CLS] = "pkt_cls",
+	},
+};
+
+struct rte_node_register *
+eventdev_rx_node_get(void)
+{
+	return &eventdev_rx_node_base;
+}
+
+RTE_NODE_REGISTER(eventdev_rx_node_base);
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <rte_debug.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_mbuf.h>
+
+#include "eventdev_priv.h"
+#include "node_private.h"
+
+static __rte_always_inline void
+eventdev_tx_event_prepare(eventdev_node_ctx_t *ctx, struct rte_event *ev,
+			  struct rte_mbuf *m)
+{
+	ev->event = 0;
+	ev->flow_id = m->hash.rss;
+	ev->op = RTE_EVENT_OP_NEW;
+	ev->sched_type = ctx->sched_type;
+	ev->queue_id = ctx->queue_id;
+	ev->priority = ctx->priority;
+}
+
+static uint16_t
+eventdev_tx_node_process(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	eventdev_node_ctx_t *ctx = (eventdev_node_ctx_t *)node->ctx;
+	struct rte_event_vector *vecs[EVENTDEV_NODE_BURST_SIZE];
+	struct rte_event ev[EVENTDEV_NODE_BURST_SIZE];
+	uint16_t nb_ev, sent, n, i;
+	uint16_t count = 0;
+
+	while (count < nb_objs) {
+		if (ctx->vector_pool == NULL) {
+			nb_ev = RTE_MIN(nb_objs - count,
+					EVENTDEV_NODE_BURST_SIZE);
+			for (i = 0; i < nb_ev; i++) {
+				eventdev_tx_event_prepare(ctx, &ev[i],
+							  objs[count + i]);
+				ev[i].event_type = RTE_EVENT_TYPE_CPU;
+				ev[i].event_ptr = objs[count + i];
+			}
+		} else {
+			nb_ev = RTE_MIN((nb_objs - count + ctx->vector_sz - 1) /
+					ctx->vector_sz,
+					EVENTDEV_NODE_BURST_SIZE);
+			if (rte_mempool_get_bulk(ctx->vector_pool,
+						 (void **)vecs, nb_ev) < 0)
+				break;
+
+			/* Pack objects in vectors, one copy per vector */
+			for (i = 0, n = count; i < nb_ev; i++) {
+				vecs[i]->nb_elem = RTE_MIN(nb_objs - n,
+							   ctx->vector_sz);
+				vecs[i]->elem_offset = 0;
+				vecs[i]->attr_valid = 0;
+				rte_memcpy(vecs[i]->ptrs, &objs[n],
+					   vecs[i]->nb_elem * sizeof(void *));
+				eventdev_tx_event_prepare(ctx, &ev[i], objs[n]);
+				ev[i].event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+				ev[i].vec = vecs[i];
+				n += vecs[i]->nb_elem;
+			}
+		}
+
+		sent = rte_event_enqueue_new_burst(ctx->dev_id, ctx->port_id,
+						   ev, nb_ev);
+		if (ctx->vector_pool == NULL) {
+			count += sent;
+		} else {
+			for (i = 0; i < sent; i++)
+				count += vecs[i]->nb_elem;
+			if (sent != nb_ev)
+				rte_mempool_put_bulk(ctx->vector_pool,
+						     (void **)&vecs[sent],
+						     nb_ev - sent);
+		}
+
+		if (sent != nb_ev)
+			break;
+	}
+
+	/* Redirect objects not enqueued to drop node */
+	if (count != nb_objs)
+		rte_node_enqueue(graph, node, EVENTDEV_TX_NEXT_PKT_DROP,
+				 &objs[count], nb_objs - count);
+
+	return count;
+}
+
+static int
+eventdev_tx_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	eventdev_node_ctx_t *ctx = (eventdev_node_ctx_t *)node->ctx;
+	eventdev_node_elem_t *elem = eventdev_node_data_get()->head;
+
+	RTE_SET_USED(graph);
+
+	while (elem) {
+		if (elem->tx_nid == node->id) {
+			/* Update node specific context */
+			memcpy(ctx, &elem->ctx, sizeof(eventdev_node_ctx_t));
+			break;
+		}
+		elem = elem->next;
+	}
+
+	RTE_VERIFY(elem != NULL);
+
+	return 0;
+}
+
+static struct rte_node_register eventdev_tx_node_base = {
+	.process = eventdev_tx_node_process,
+	.name = "eventdev_tx",
+
+	.init = eventdev_tx_node_init,
+
+	.nb_edges = EVENTDEV_TX_NEXT_MAX,
+	.next_nodes = {
+		[EVENTDEV_TX_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+eventdev_tx_node_get(void)
+{
+	return &eventdev_tx_node_base;
+}
+
+RTE_NODE_REGISTER(eventdev_tx_node_base);
@@ -0,0 +1,323 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib6.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+
+#define IPV6_L3FWD_FIB_MAX_RULES 1024
+#define IPV6_L3FWD_FIB_NUMBER_TBL8S (1 << 8)
+
+/* IP6 Lookup global data struct */
+struct ip6_lookup_node_main {
+	struct rte_fib6 *fib_tbl[RTE_MAX_NUMA_NODES];
+};
+
+struct ip6_lookup_node_ctx {
+	/* Socket's FIB table */
+	struct rte_fib6 *fib;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+static struct ip6_lookup_node_main ip6_lookup_nm;
+
+#define IP6_LOOKUP_NODE_FIB(ctx) \
+	(((struct ip6_lookup_node_ctx *)ctx)->fib)
+
+#define IP6_LOOKUP_NODE_PRIV1_OFF(ctx) \
+	(((struct ip6_lookup_node_ctx *)ctx)->mbuf_priv1_off)
+
+static uint16_t
+ip6_lookup_node_process(struct rte_graph *graph, struct rte_node *node,
+			void **objs, uint16_t nb_objs)
+{
+	uint8_t ips[RTE_GRAPH_BURST_SIZE][RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_fib6 *fib = IP6_LOOKUP_NODE_FIB(node->ctx);
+	const int dyn = IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	uint64_t next_hops[RTE_GRAPH_BURST_SIZE];
+	rte_edge_t next0, next1, next2, next3, next_index;
+	struct rte_mbuf *mbuf0, **pkts;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t n_left_from, n, i;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	uint16_t held = 0;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+
+	pkts = (struct rte_mbuf **)objs;
+	from = objs;
+	n_left_from = nb_objs;
+
+	for (i = 0; i < 4 && i < n_left_from; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+					sizeof(struct rte_ether_hdr)));
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	while (n_left_from > 0) {
+		n = RTE_MIN(n_left_from, RTE_GRAPH_BURST_SIZE);
+
+		for (i = 0; i < n; i++) {
+			/* Prefetch next mbuf data */
+			if (likely(i + 4 < n_left_from))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+					void *, sizeof(struct rte_ether_hdr)));
+
+			mbuf0 = pkts[i];
+
+			/* Extract DIP of mbuf0 */
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf0,
+					struct rte_ipv6_hdr *,
+					sizeof(struct rte_ether_hdr));
+			rte_memcpy(ips[i], ipv6_hdr->dst_addr,
+				   RTE_FIB6_IPV6_ADDR_SIZE);
+			/* Extract hop limit as ipv6 hdr is in cache */
+			node_mbuf_priv1(mbuf0, dyn)->ttl = ipv6_hdr->hop_limits;
+		}
+
+		/* Misses get the default next hop i.e. the drop node */
+		rte_fib6_lookup_bulk(fib, ips, next_hops, n);
+
+		for (i = 0; i + 4 <= n; i += 4) {
+			/* Extract next node id and NH */
+			node_mbuf_priv1(pkts[i], dyn)->nh =
+				next_hops[i] & 0xFFFF;
+			next0 = (next_hops[i] >> 16);
+
+			node_mbuf_priv1(pkts[i + 1], dyn)->nh =
+				next_hops[i + 1] & 0xFFFF;
+			next1 = (next_hops[i + 1] >> 16);
+
+			node_mbuf_priv1(pkts[i + 2], dyn)->nh =
+				next_hops[i + 2] & 0xFFFF;
+			next2 = (next_hops[i + 2] >> 16);
+
+			node_mbuf_priv1(pkts[i + 3], dyn)->nh =
+				next_hops[i + 3] & 0xFFFF;
+			next3 = (next_hops[i + 3] >> 16);
+
+			/* Enqueue four to next node */
+			rte_edge_t fix_spec =
+				(next_index ^ next0) | (next_index ^ next1) |
+				(next_index ^ next2) | (next_index ^ next3);
+
+			if (unlikely(fix_spec)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				/* Next0 */
+				if (next_index == next0) {
+					to_next[0] = from[0];
+					to_next++;
+					held++;
+				} else {
+					rte_node_enqueue_x1(graph, node, next0,
+							    from[0]);
+				}
+
+				/* Next1 */
+				if (next_index == next1) {
+					to_next[0] = from[1];
+					to_next++;
+					held++;
+				} else {
+					rte_node_enqueue_x1(graph, node, next1,
+							    from[1]);
+				}
+
+				/* Next2 */
+				if (next_index == next2) {
+					to_next[0] = from[2];
+					to_next++;
+					held++;
+				} else {
+					rte_node_enqueue_x1(graph, node, next2,
+							    from[2]);
+				}
+
+				/* Next3 */
+				if (next_index == next3) {
+					to_next[0] = from[3];
+					to_next++;
+					held++;
+				} else {
+					rte_node_enqueue_x1(graph, node, next3,
+							    from[3]);
+				}
+
+				from += 4;
+			} else {
+				last_spec += 4;
+			}
+		}
+
+		for (; i < n; i++) {
+			node_mbuf_priv1(pkts[i], dyn)->nh =
+				next_hops[i] & 0xFFFF;
+			next0 = (next_hops[i] >> 16);
+
+			if (unlikely(next_index ^ next0)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next0, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+
+		pkts += n;
+		n_left_from -= n;
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+
+	held += last_spec;
+	/* Copy things successfully speculated till now */
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+		       enum rte_node_ip6_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	uint8_t socket;
+	uint32_t val;
+	int ret;
+
+	inet_ntop(AF_INET6, ip, abuf, sizeof(abuf));
+	/* Embedded next node id into 24 bit next hop */
+	val = ((next_node << 16) | next_hop) & ((1ull << 24) - 1);
+	node_dbg("ip6_lookup", "FIB: Adding route %s / %d nh (0x%x)", abuf,
+		 depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip6_lookup_nm.fib_tbl[socket])
+			continue;
+
+		ret = rte_fib6_add(ip6_lookup_nm.fib_tbl[socket], ip, depth,
+				   val);
+		if (ret < 0) {
+			node_err("ip6_lookup",
+				 "Unable to add entry %s / %d nh (%x) to FIB table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+setup_fib(struct ip6_lookup_node_main *nm, int socket)
+{
+	struct rte_fib6_conf config_ipv6;
+	char s[RTE_MEMZONE_NAMESIZE];
+
+	/* One FIB table per socket */
+	if (nm->fib_tbl[socket])
+		return 0;
+
+	/* create the FIB table, misses are sent to the drop node */
+	memset(&config_ipv6, 0, sizeof(config_ipv6));
+	config_ipv6.type = RTE_FIB6_TRIE;
+	config_ipv6.default_nh =
+		((uint32_t)RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP) << 16;
+	config_ipv6.max_routes = IPV6_L3FWD_FIB_MAX_RULES;
+	config_ipv6.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config_ipv6.trie.num_tbl8 = IPV6_L3FWD_FIB_NUMBER_TBL8S;
+	snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socket);
+	nm->fib_tbl[socket] = rte_fib6_create(s, socket, &config_ipv6);
+	if (nm->fib_tbl[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
+static int
+ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	uint16_t socket, lcore_id;
+	static uint8_t init_once;
+	int rc;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(struct ip6_lookup_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+
+		/* Setup FIB tables for all sockets */
+		RTE_LCORE_FOREACH(lcore_id)
+		{
+			socket = rte_lcore_to_socket_id(lcore_id);
+			rc = setup_fib(&ip6_lookup_nm, socket);
+			if (rc) {
+				node_err("ip6_lookup",
+					 "Failed to setup fib tbl for sock %u, rc=%d",
+					 socket, rc);
+				return rc;
+			}
+		}
+		init_once = 1;
+	}
+
+	/* Update socket's FIB and mbuf dyn priv1 offset in node ctx */
+	IP6_LOOKUP_NODE_FIB(node->ctx) = ip6_lookup_nm.fib_tbl[graph->socket];
+	IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+
+	node_dbg("ip6_lookup", "Initialized ip6_lookup node");
+
+	return 0;
+}
+
+static struct rte_node_register ip6_lookup_node = {
+	.process = ip6_lookup_node_process,
+	.name = "ip6_lookup",
+
+	.init = ip6_lookup_node_init,
+
+	.nb_edges = RTE_NODE_IP6_LOOKUP_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "ip6_rewrite",
+		[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_lookup_node);
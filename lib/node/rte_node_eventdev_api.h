@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_EVENTDEV_API_H__
+#define __INCLUDE_RTE_NODE_EVENTDEV_API_H__
+
+/**
+ * @file rte_node_eventdev_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to setup eventdev_rx and eventdev_tx nodes
+ * and their event port associations.
+ *
+ * The eventdev_rx node dequeues events from an event port and moves
+ * the objects they carry to the next node stream. Event vectors are
+ * unpacked with a single copy of their object array, and are freed
+ * back to their mempool.
+ *
+ * The eventdev_tx node enqueues the objects of its stream to an event
+ * port as new events, packed in event vectors when a vector pool is
+ * given. Objects which could not be enqueued are sent to pkt_drop node.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+/**
+ * Event port config for eventdev_rx and eventdev_tx node.
+ */
+struct rte_node_eventdev_config {
+	uint8_t dev_id;
+	/**< Event device identifier. */
+	uint8_t port_id;
+	/**< Event port identifier used by the Rx and Tx nodes. */
+	uint8_t queue_id;
+	/**< Event queue identifier of the events enqueued by the Tx node. */
+	uint8_t sched_type;
+	/**< Scheduling type of the events enqueued by the Tx node. */
+	uint8_t priority;
+	/**< Priority of the events enqueued by the Tx node. */
+	struct rte_mempool *vector_pool;
+	/**< Event vector pool created with rte_event_vector_pool_create(),
+	 * used by the Tx node to pack its objects in event vectors.
+	 * Each object is enqueued as a single event when NULL.
+	 */
+};
+
+/**
+ * Initializes eventdev nodes.
+ *
+ * For each config, an ``eventdev_rx-X-Y`` and an ``eventdev_tx-X-Y`` node
+ * is cloned for the event device X and its event port Y. As event ports
+ * are not thread safe, these nodes must be used by a single graph.
+ * The next node of ``eventdev_rx-X-Y`` is ``pkt_cls`` node, which can be
+ * replaced with rte_node_edge_update().
+ *
+ * @param cfg
+ *   Array of eventdev config that identifies which event ports
+ *   eventdev_rx and eventdev_tx nodes need to be created for.
+ * @param cnt
+ *   Size of cfg array.
+ *
+ * @return
+ *   0 on successful initialization, negative otherwise.
+ */
+__rte_experimental
+int rte_node_eventdev_config(struct rte_node_eventdev_config *cfg,
+			     uint16_t cnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_EVENTDEV_API_H__ */
@@ -50,6 +50,7 @@ struct rte_reorder_buffer {
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
 	int is_initialized;
+	int is_mp; /**< mbufs may be inserted by multiple threads */
 } __rte_cache_aligned;
 
 static void
@@ -99,8 +100,9 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 	return b;
 }
 
-struct rte_reorder_buffer*
-rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+static struct rte_reorder_buffer *
+reorder_create(const char *name, unsigned int socket_id, unsigned int size,
+		int is_mp)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te;
@@ -145,8 +147,15 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		if (strncmp(name, b->name, RTE_REORDER_NAMESIZE) == 0)
 			break;
 	}
-	if (te != NULL)
+	if (te != NULL) {
+		if (b->is_mp != is_mp) {
+			RTE_LOG(ERR, REORDER, "Reorder buffer %s already "
+				"exists with another producer mode\n", name);
+			rte_errno = EEXIST;
+			b = NULL;
+		}
 		goto exit;
+	}
 
 	/* allocate tailq entry */
 	te = rte_zmalloc("REORDER_TAILQ_ENTRY", sizeof(*te), 0);
@@ -165,6 +174,13 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_free(te);
 	} else {
 		rte_reorder_init(b, bufsize, name, size);
+		/*
+		 * Producers can't set the window start concurrently, so with
+		 * multiple producers it is 0 unless set with
+		 * rte_reorder_min_seqn_set().
+		 */
+		b->is_mp = is_mp;
+		b->is_initialized = is_mp;
 		te->data = (void *)b;
 		TAILQ_INSERT_TAIL(reorder_list, te, next);
 	}
@@ -174,15 +190,31 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	return b;
 }
 
+struct rte_reorder_buffer*
+rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 0);
+}
+
+struct rte_reorder_buffer *
+rte_reorder_create_mp(const char *name, unsigned int socket_id,
+		unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 1);
+}
+
 void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
 	char name[RTE_REORDER_NAMESIZE];
+	int is_mp = b->is_mp;
 
 	rte_reorder_free_mbufs(b);
 	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
 	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	b->is_mp = is_mp;
+	b->is_initialized = is_mp;
 }
 
 static void
@@ -312,6 +344,86 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	return order_head_adv;
 }
 
+/*
+ * Multi-producer insert.
+ * The mbuf of sequence number seqn goes to the order buffer entry
+ * seqn & mask, so producers don't share any index with the consumer:
+ * they only read the window start and claim their entry with a CAS.
+ * The consumer empties entries before moving the window start with a
+ * release store, so an entry whose sequence number just entered the
+ * window is already empty, unless it still holds a late mbuf.
+ */
+static int
+rte_reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	struct rte_mbuf *expected = NULL;
+	uint32_t seqn, offset;
+
+	seqn = *rte_reorder_seqn(mbuf);
+	offset = seqn - __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+
+	/*
+	 * Producers can't move the window, so early mbufs are not
+	 * accommodated: the caller retries them once the window moved.
+	 */
+	if (offset >= order_buf->size) {
+		rte_errno = (offset < 2 * order_buf->size) ? ENOSPC : ERANGE;
+		return -1;
+	}
+
+	/*
+	 * The entry may still hold a late mbuf of the previous window,
+	 * not drained yet.
+	 */
+	if (!__atomic_compare_exchange_n(
+			&order_buf->entries[seqn & order_buf->mask], &expected,
+			mbuf, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Multi-producer drain: return mbufs in order up to sequence number
+ * end (exclusive), stopping at the first gap unless skip_gaps is set.
+ * A mbuf, whose sequence number was skipped before it got inserted,
+ * is returned as soon as it is found, without moving the window.
+ */
+static unsigned int
+rte_reorder_drain_mp(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs, uint32_t end, int skip_gaps)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	struct rte_mbuf **entry, *mbuf;
+	unsigned int drain_cnt = 0;
+	uint32_t seqn = b->min_seqn;
+
+	while (drain_cnt < max_mbufs && seqn != end) {
+		entry = &order_buf->entries[seqn & order_buf->mask];
+		mbuf = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+		if (mbuf == NULL) {
+			if (!skip_gaps)
+				break;
+			seqn++;
+			continue;
+		}
+
+		/* only the consumer empties entries */
+		__atomic_store_n(entry, NULL, __ATOMIC_RELAXED);
+		mbufs[drain_cnt++] = mbuf;
+		if (*rte_reorder_seqn(mbuf) == seqn)
+			seqn++;
+	}
+
+	/* publish the emptied entries along with the new window start */
+	__atomic_store_n(&b->min_seqn, seqn, __ATOMIC_RELEASE);
+
+	return drain_cnt;
+}
+
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 {
@@ -323,6 +435,9 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 		return -1;
 	}
 
+	if (b->is_mp)
+		return rte_reorder_insert_mp(b, mbuf);
+
 	order_buf = &b->order_buf;
 	if (!b->is_initialized) {
 		b->min_seqn = *rte_reorder_seqn(mbuf);
@@ -387,6 +502,10 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->is_mp)
+		return rte_reorder_drain_mp(b, mbufs, max_mbufs,
+				b->min_seqn + order_buf->size, 0);
+
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
@@ -446,6 +565,16 @@ rte_reorder_drain_up_to_seqn(struct rte_reorder_buffer *b, struct rte_mbuf **mbu
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->is_mp) {
+		/* Nothing to skip if seqn isn't after the window start */
+		offset = seqn - b->min_seqn;
+		if ((int32_t)offset <= 0)
+			return 0;
+		offset = RTE_MIN(offset, order_buf->size);
+		return rte_reorder_drain_mp(b, mbufs, max_mbufs,
+				b->min_seqn + offset, 1);
+	}
+
 	/* Seqn in Ready buffer */
 	if (seqn < b->min_seqn) {
 		/* All sequence numbers are higher then given */
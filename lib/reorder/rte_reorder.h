@@ -67,6 +67,39 @@ rte_reorder_seqn(struct rte_mbuf *mbuf)
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new reorder buffer instance, which multiple threads can
+ * insert mbufs into concurrently.
+ *
+ * A single thread drains the buffer. Unlike with rte_reorder_create(),
+ * rte_reorder_insert() doesn't move the window to accommodate early
+ * mbufs: it fails with ENOSPC, and the mbuf can be inserted again once
+ * the window moved. The window starts at sequence number 0,
+ * rte_reorder_min_seqn_set() sets another start before any insert.
+ * Gaps are skipped by rte_reorder_drain_up_to_seqn() only.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ *    - EEXIST - a single producer buffer with the same name exists
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_mp(const char *name, unsigned int socket_id,
+		unsigned int size);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -130,6 +163,9 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  * packets can later be taken from the buffer using the rte_reorder_drain()
  * API.
  *
+ * If the buffer was created with rte_reorder_create_mp(), multiple threads
+ * can insert mbufs concurrently, and early mbufs are not accommodated.
+ *
  * @param b
  *   Reorder buffer where the mbuf has to be inserted.
  * @param mbuf
@@ -140,6 +176,8 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  *   On error case, rte_errno will be set appropriately:
  *    - ENOSPC - Cannot move existing mbufs from reorder buffer to accommodate
  *      early mbuf, but it can be accommodated by performing drain and then insert.
+ *      With multiple producers, the mbuf is early, or its entry still holds
+ *      a late mbuf, and it can be inserted again after a drain.
  *    - ERANGE - Too early or late mbuf which is vastly out of range of expected
  *      window should be ignored without any handling.
  */
@@ -176,6 +214,10 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
  * Returns a set of in-order packets from the reorder buffer structure.
  * Gaps may be present since reorder buffer will try to fetch
  * all possible packets up to given sequence number.
+ * With multiple producers, up to one window of sequence numbers is skipped
+ * by a call. Inserting a mbuf with a skipped sequence number fails with
+ * ERANGE, unless the insert raced with the drain: the mbuf is then returned
+ * out of order by a later drain.
  *
  * @param b
  *   Reorder buffer instance from which packets are to be drained.
@@ -36,7 +36,8 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ |	       \
+		     RING_F_MP_CHUNK_ENQ)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -44,6 +45,9 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* by default set head/tail distance as 1/8 of ring capacity */
 #define HTD_MAX_DEF	8
 
+/* by default stage at most 1/8 of ring capacity per lcore */
+#define CHUNK_MAX_DEF	8
+
 /* return the size of memory occupied by a ring */
 ssize_t
 rte_ring_get_memsize_elem(unsigned int esize, unsigned int count)
@@ -95,6 +99,7 @@ reset_headtail(void *p)
 	switch (ht->sync_type) {
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_ST:
+	case RTE_RING_SYNC_MT_CHUNK:
 		ht->head = 0;
 		ht->tail = 0;
 		break;
@@ -111,11 +116,32 @@ reset_headtail(void *p)
 	}
 }
 
+/*
+ * internal helper function to drop the objects staged by all lcores.
+ */
+static void
+reset_chunk_stages(struct rte_ring *r)
+{
+	struct rte_ring_chunk_stage *stage;
+	unsigned int lcore_id;
+
+	if (r->prod.sync_type != RTE_RING_SYNC_MT_CHUNK ||
+			r->chunk_prod.stages == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		stage = RTE_PTR_ADD(r->chunk_prod.stages,
+			(size_t)lcore_id * r->chunk_prod.stage_size);
+		stage->len = 0;
+	}
+}
+
 void
 rte_ring_reset(struct rte_ring *r)
 {
 	reset_headtail(&r->prod);
 	reset_headtail(&r->cons);
+	reset_chunk_stages(r);
 }
 
 /*
@@ -128,7 +154,8 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	enum rte_ring_sync_type *cons_st)
 {
 	static const uint32_t prod_st_flags =
-		(RING_F_SP_ENQ | RING_F_MP_RTS_ENQ | RING_F_MP_HTS_ENQ);
+		(RING_F_SP_ENQ | RING_F_MP_RTS_ENQ | RING_F_MP_HTS_ENQ |
+		 RING_F_MP_CHUNK_ENQ);
 	static const uint32_t cons_st_flags =
 		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
 
@@ -145,6 +172,9 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	case RING_F_MP_HTS_ENQ:
 		*prod_st = RTE_RING_SYNC_MT_HTS;
 		break;
+	case RING_F_MP_CHUNK_ENQ:
+		*prod_st = RTE_RING_SYNC_MT_CHUNK;
+		break;
 	default:
 		return -EINVAL;
 	}
@@ -193,6 +223,13 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
 		offsetof(struct rte_ring_rts_headtail, tail.val.pos));
 
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_chunk_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, head) !=
+		offsetof(struct rte_ring_chunk_headtail, head));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_chunk_headtail, tail));
+
 	/* future proof flags, only allow supported values */
 	if (flags & ~RING_F_MASK) {
 		RTE_LOG(ERR, RING,
@@ -232,6 +269,12 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	if (flags & RING_F_MC_RTS_DEQ)
 		rte_ring_set_cons_htd_max(r, r->capacity / HTD_MAX_DEF);
 
+	/* stages are only allocated by rte_ring_create_elem() */
+	if (flags & RING_F_MP_CHUNK_ENQ)
+		r->chunk_prod.chunk_size = RTE_MAX(1U, RTE_MIN(
+			(uint32_t)RTE_RING_CHUNK_SIZE,
+			r->capacity / CHUNK_MAX_DEF));
+
 	return 0;
 }
 
@@ -248,6 +291,8 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	int mz_flags = 0;
 	struct rte_ring_list* ring_list = NULL;
 	const unsigned int requested_count = count;
+	struct rte_ring_chunk_stage *stages = NULL;
+	size_t stage_size = 0;
 	int ret;
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
@@ -276,6 +321,23 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		return NULL;
 	}
 
+	/* one stage per lcore, each on its own cache lines */
+	if (flags & RING_F_MP_CHUNK_ENQ) {
+		stage_size = RTE_ALIGN_CEIL(sizeof(struct rte_ring_chunk_stage) +
+			(size_t)RTE_RING_CHUNK_SIZE * esize,
+			RTE_CACHE_LINE_SIZE);
+		stages = rte_zmalloc_socket("RING_CHUNK_STAGES",
+			stage_size * RTE_MAX_LCORE, RTE_CACHE_LINE_SIZE,
+			socket_id);
+		if (stages == NULL) {
+			RTE_LOG(ERR, RING,
+				"Cannot reserve memory for chunk stages\n");
+			rte_free(te);
+			rte_errno = ENOMEM;
+			return NULL;
+		}
+	}
+
 	rte_mcfg_tailq_write_lock();
 
 	/* reserve a memory zone for this ring. If we can't get rte_config or
@@ -292,11 +354,16 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 
 		te->data = (void *) r;
 		r->memzone = mz;
+		if (stages != NULL) {
+			r->chunk_prod.stages = stages;
+			r->chunk_prod.stage_size = stage_size;
+		}
 
 		TAILQ_INSERT_TAIL(ring_list, te, next);
 	} else {
 		r = NULL;
 		RTE_LOG(ERR, RING, "Cannot reserve memory\n");
+		rte_free(stages);
 		rte_free(te);
 	}
 	rte_mcfg_tailq_write_unlock();
@@ -318,6 +385,7 @@ void
 rte_ring_free(struct rte_ring *r)
 {
 	struct rte_ring_list *ring_list = NULL;
+	struct rte_ring_chunk_stage *stages = NULL;
 	struct rte_tailq_entry *te;
 
 	if (r == NULL)
@@ -333,10 +401,14 @@ rte_ring_free(struct rte_ring *r)
 		return;
 	}
 
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_CHUNK)
+		stages = r->chunk_prod.stages;
+
 	if (rte_memzone_free(r->memzone) != 0) {
 		RTE_LOG(ERR, RING, "Cannot free memory\n");
 		return;
 	}
+	rte_free(stages);
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
 	rte_mcfg_tailq_write_lock();
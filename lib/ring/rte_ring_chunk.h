@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _RTE_RING_CHUNK_H_
+#define _RTE_RING_CHUNK_H_
+
+/**
+ * @file rte_ring_chunk.h
+ * It is not recommended to include this file directly.
+ * Please include <rte_ring.h> instead.
+ *
+ * Contains functions for the multi-producer chunk (MP chunk) ring mode.
+ * In that mode each lcore stages the objects it enqueues, and moves the
+ * producer head only once per chunk of up to RTE_RING_CHUNK_SIZE objects.
+ * With many producers doing small enqueues, this amortizes the contention
+ * on the producer head and tail over the whole chunk.
+ * The staged objects of a lcore become visible to the consumers once its
+ * chunk is full, once it enqueues more objects than the chunk can hold,
+ * or when it calls rte_ring_chunk_flush().
+ * Enqueues from non-EAL threads and on rings initialized with
+ * rte_ring_init() are not staged and behave as in MP mode.
+ * Dequeue operations are not affected by this mode.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_ring_chunk_elem_pvt.h>
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue several objects on the MP chunk ring (multi-producers safe).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued or staged, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_mp_chunk_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
+	unsigned int esize, unsigned int n, unsigned int *free_space)
+{
+	return __rte_ring_do_chunk_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue several objects on the MP chunk ring (multi-producers safe).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued or staged.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_mp_chunk_enqueue_burst_elem(struct rte_ring *r, const void *obj_table,
+	unsigned int esize, unsigned int n, unsigned int *free_space)
+{
+	return __rte_ring_do_chunk_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue in the ring the objects staged by the calling lcore.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @return
+ *   The number of objects still staged, because the ring is full.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_chunk_flush_elem(struct rte_ring *r, unsigned int esize)
+{
+	return __rte_ring_do_chunk_flush_elem(r, esize);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue several objects on the MP chunk ring (multi-producers safe).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued or staged, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_mp_chunk_enqueue_bulk(struct rte_ring *r, void * const *obj_table,
+			 unsigned int n, unsigned int *free_space)
+{
+	return __rte_ring_do_chunk_enqueue_elem(r, obj_table,
+			sizeof(uintptr_t), n, RTE_RING_QUEUE_FIXED, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue several objects on the MP chunk ring (multi-producers safe).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued or staged.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_mp_chunk_enqueue_burst(struct rte_ring *r, void * const *obj_table,
+			 unsigned int n, unsigned int *free_space)
+{
+	return __rte_ring_do_chunk_enqueue_elem(r, obj_table,
+			sizeof(uintptr_t), n, RTE_RING_QUEUE_VARIABLE, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue in the ring the objects staged by the calling lcore.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @return
+ *   The number of objects still staged, because the ring is full.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_chunk_flush(struct rte_ring *r)
+{
+	return __rte_ring_do_chunk_flush_elem(r, sizeof(uintptr_t));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_CHUNK_H_ */
@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _RTE_RING_CHUNK_ELEM_PVT_H_
+#define _RTE_RING_CHUNK_ELEM_PVT_H_
+
+/**
+ * @file rte_ring_chunk_elem_pvt.h
+ * It is not recommended to include this file directly,
+ * include <rte_ring.h> instead.
+ * Contains internal helper functions for MP chunk ring mode.
+ * For more information please refer to <rte_ring_chunk.h>.
+ */
+
+/**
+ * @internal returns the stage of the calling lcore, or NULL if it has none.
+ */
+static __rte_always_inline struct rte_ring_chunk_stage *
+__rte_ring_chunk_get_stage(const struct rte_ring *r)
+{
+	const struct rte_ring_chunk_headtail *prod = &r->chunk_prod;
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (prod->stages == NULL || lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	return (struct rte_ring_chunk_stage *)RTE_PTR_ADD(prod->stages,
+			(size_t)lcore_id * prod->stage_size);
+}
+
+/**
+ * @internal returns the staged objects that follow a stage header.
+ */
+static __rte_always_inline void *
+__rte_ring_chunk_stage_objs(struct rte_ring_chunk_stage *stage)
+{
+	return RTE_PTR_ADD(stage, sizeof(*stage));
+}
+
+/**
+ * @internal enqueue as many staged objects as possible in the ring,
+ * with a single head update, and keep the remaining ones in order.
+ */
+static __rte_always_inline void
+__rte_ring_chunk_flush_stage(struct rte_ring *r,
+	struct rte_ring_chunk_stage *stage, uint32_t esize)
+{
+	uint8_t *objs = (uint8_t *)__rte_ring_chunk_stage_objs(stage);
+	uint32_t n;
+
+	n = __rte_ring_do_enqueue_elem(r, objs, esize, stage->len,
+			RTE_RING_QUEUE_VARIABLE, RTE_RING_SYNC_MT, NULL);
+	if (unlikely(n != stage->len))
+		memmove(objs, objs + (size_t)n * esize,
+			(size_t)(stage->len - n) * esize);
+	stage->len -= n;
+}
+
+/**
+ * @internal Enqueue several objects on the MP chunk ring.
+ *
+ * Small enqueues are copied to the stage of the calling lcore, which is
+ * enqueued in the ring once it holds chunk_size objects. Enqueues that
+ * do not fit in the stage go to the ring directly, after the objects
+ * already staged so that the order of the objects is kept.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
+ * @param free_space
+ *   returns the amount of space after the enqueue operation has finished
+ * @return
+ *   Actual number of objects enqueued or staged.
+ *   If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_chunk_enqueue_elem(struct rte_ring *r, const void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *free_space)
+{
+	const uint32_t chunk_size = r->chunk_prod.chunk_size;
+	struct rte_ring_chunk_stage *stage;
+	uint32_t head, room;
+
+	stage = __rte_ring_chunk_get_stage(r);
+	if (unlikely(stage == NULL))
+		return __rte_ring_do_enqueue_elem(r, obj_table, esize, n,
+				behavior, RTE_RING_SYNC_MT, free_space);
+
+	if (stage->len + n > chunk_size) {
+		if (stage->len != 0)
+			__rte_ring_chunk_flush_stage(r, stage, esize);
+		/* too big to be staged, nothing left ahead of it */
+		if (stage->len == 0 && n >= chunk_size)
+			return __rte_ring_do_enqueue_elem(r, obj_table, esize,
+					n, behavior, RTE_RING_SYNC_MT,
+					free_space);
+	}
+
+	/* the stage cannot be flushed when the ring is full */
+	room = chunk_size - stage->len;
+	if (unlikely(n > room))
+		n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : room;
+
+	if (n != 0) {
+		memcpy((uint8_t *)__rte_ring_chunk_stage_objs(stage) +
+			(size_t)stage->len * esize, obj_table,
+			(size_t)n * esize);
+		stage->len += n;
+		if (stage->len == chunk_size)
+			__rte_ring_chunk_flush_stage(r, stage, esize);
+	}
+
+	if (free_space != NULL) {
+		/* head first, it cannot get more than capacity ahead */
+		head = __atomic_load_n(&r->prod.head, __ATOMIC_ACQUIRE);
+		*free_space = r->capacity +
+			__atomic_load_n(&r->cons.tail, __ATOMIC_RELAXED) -
+			head;
+	}
+	return n;
+}
+
+/**
+ * @internal Enqueue in the ring the objects staged by the calling lcore.
+ *
+ * @return
+ *   The number of objects still staged, because the ring is full.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_chunk_flush_elem(struct rte_ring *r, uint32_t esize)
+{
+	struct rte_ring_chunk_stage *stage;
+
+	if (r->prod.sync_type != RTE_RING_SYNC_MT_CHUNK)
+		return 0;
+
+	stage = __rte_ring_chunk_get_stage(r);
+	if (stage == NULL || stage->len == 0)
+		return 0;
+
+	__rte_ring_chunk_flush_stage(r, stage, esize);
+	return stage->len;
+}
+
+#endif /* _RTE_RING_CHUNK_ELEM_PVT_H_ */
@@ -58,6 +58,7 @@ enum rte_ring_sync_type {
 	RTE_RING_SYNC_ST,     /**< single thread only */
 	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
 	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+	RTE_RING_SYNC_MT_CHUNK, /**< multi-thread with per-lcore chunks */
 };
 
 /**
@@ -107,6 +108,29 @@ struct rte_ring_hts_headtail {
 	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
+/**
+ * Header of the objects staged by one lcore before being enqueued as a
+ * chunk, the staged objects follow it.
+ */
+struct rte_ring_chunk_stage {
+	uint32_t len;       /**< number of staged objects */
+	uint32_t reserved;
+};
+
+/**
+ * Producer head/tail of a ring in MP chunk mode, with the per-lcore
+ * stages holding the objects not yet enqueued in the ring.
+ */
+struct rte_ring_chunk_headtail {
+	volatile uint32_t head;      /**< producer head, as for MP */
+	volatile uint32_t tail;      /**< producer tail, as for MP */
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod */
+	uint32_t chunk_size; /**< max number of objects staged per lcore */
+	uint32_t stage_size; /**< size in bytes of a per-lcore stage */
+	/** per-lcore stages, NULL if not allocated by rte_ring_create() */
+	struct rte_ring_chunk_stage *stages;
+};
+
 /**
  * An RTE ring structure.
  *
@@ -135,6 +159,7 @@ struct rte_ring {
 		struct rte_ring_headtail prod;
 		struct rte_ring_hts_headtail hts_prod;
 		struct rte_ring_rts_headtail rts_prod;
+		struct rte_ring_chunk_headtail chunk_prod;
 	}  __rte_cache_aligned;
 
 	char pad1 __rte_cache_aligned; /**< empty cache line */
@@ -169,6 +194,23 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The default enqueue is "MP chunk": each lcore stages its objects and
+ * enqueues them in the ring a chunk at a time.
+ * Only effective for rings allocated with rte_ring_create().
+ *
+ * @warning
+ * Small enqueues are only staged, so a FIXED (bulk) enqueue can return n
+ * while the ring is full: the objects wait in the stage of the lcore
+ * until there is room in the ring. Such callers lose the back-pressure
+ * of the ring, and can only see it once their stage is full, or through
+ * the return value of rte_ring_chunk_flush().
+ */
+#define RING_F_MP_CHUNK_ENQ 0x0080
+
+/** Default maximum number of objects staged per lcore in "MP chunk" mode. */
+#define RTE_RING_CHUNK_SIZE 32
+
 #ifdef __cplusplus
 }
 #endif
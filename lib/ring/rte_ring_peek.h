@@ -184,6 +184,7 @@ rte_ring_enqueue_elem_finish(struct rte_ring *r, const void *obj_table,
 		break;
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+	case RTE_RING_SYNC_MT_CHUNK:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
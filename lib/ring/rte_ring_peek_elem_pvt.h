@@ -127,6 +127,7 @@ __rte_ring_do_enqueue_start(struct rte_ring *r, uint32_t n,
 		break;
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+	case RTE_RING_SYNC_MT_CHUNK:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
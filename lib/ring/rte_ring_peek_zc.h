@@ -137,6 +137,7 @@ __rte_ring_do_enqueue_zc_elem_start(struct rte_ring *r, unsigned int esize,
 		break;
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+	case RTE_RING_SYNC_MT_CHUNK:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -301,6 +302,7 @@ rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
 		break;
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+	case RTE_RING_SYNC_MT_CHUNK:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -13,14 +13,43 @@
 #include <rte_eal_memconfig.h>
 #include <rte_memory.h>
 #include <rte_lcore.h>
+#include <rte_malloc.h>
 #include <rte_branch_prediction.h>
 #include <rte_spinlock.h>
 #include <rte_random.h>
 #include <rte_pause.h>
+#include <rte_prefetch.h>
 #include <rte_memzone.h>
 
 #include "rte_timer.h"
 
+#define TIMER_WHEEL_LEVELS	4
+#define TIMER_WHEEL_BITS	8
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+/* ticks covered by the wheel, later timers are moved down from its end */
+#define TIMER_WHEEL_RANGE	\
+	(UINT64_C(1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS))
+
+/**
+ * Hierarchical timer wheel of an lcore.
+ * A timer expiring in tick t, at a distance d from the current tick, is
+ * put in the level where d is less than the level range, at the slot given
+ * by the bits of t for the level. When the current tick goes through a
+ * multiple of the slot size of a level, the timers of its slot are moved
+ * down to the lower levels.
+ */
+struct timer_wheel {
+	uint64_t cur_tick;	/**< next tick to process */
+	uint64_t next_tick;	/**< no timer to process before this tick */
+	uint32_t shift;		/**< log2 of the timer cycles per tick */
+	uint32_t count;		/**< number of timers in the wheel */
+	/** non-empty slots */
+	uint64_t bmap[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS / 64];
+	/** timers, linked with sl_next[0] */
+	struct rte_timer *slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -40,6 +69,12 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** expired timers not returned yet by rte_timer_alt_manage_burst() */
+	struct rte_timer *expired_tim;
+
+	/** timer wheel, NULL when the pending timers are in the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -49,6 +84,7 @@ struct priv_timer {
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	struct timer_wheel *wheels; /**< timer wheels of all lcores */
 	uint8_t internal_flags;
 };
 
@@ -108,12 +144,96 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+static int
+timer_data_wheel_init(struct rte_timer_data *timer_data, uint64_t resolution)
+{
+	struct timer_wheel *wheels;
+	uint64_t cur_tick;
+	uint32_t shift;
+	unsigned int lcore_id;
+
+	wheels = rte_zmalloc("timer_wheel", sizeof(*wheels) * RTE_MAX_LCORE,
+			RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL)
+		return -ENOMEM;
+
+	if (resolution == 0)
+		resolution = rte_get_timer_hz() / US_PER_S;
+	shift = (resolution == 0) ? 0 : rte_fls_u64(resolution) - 1;
+	cur_tick = rte_get_timer_cycles() >> shift;
+
+	timer_data->wheels = wheels;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].cur_tick = cur_tick;
+		wheels[lcore_id].next_tick = UINT64_MAX;
+		wheels[lcore_id].shift = shift;
+		timer_data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+	}
+
+	return 0;
+}
+
+static void
+timer_data_wheel_free(struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+	rte_free(timer_data->wheels);
+	timer_data->wheels = NULL;
+}
+
+int
+rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			 const struct rte_timer_data_conf *conf)
+{
+	uint32_t id;
+	int ret;
+
+	if (conf == NULL)
+		return -EINVAL;
+
+	switch (conf->backend) {
+	case RTE_TIMER_BACKEND_SKIPLIST:
+		return rte_timer_data_alloc(id_ptr);
+	case RTE_TIMER_BACKEND_WHEEL:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret != 0)
+		return ret;
+
+	ret = timer_data_wheel_init(&rte_timer_data_arr[id],
+			conf->wheel_resolution);
+	if (ret != 0) {
+		rte_timer_data_dealloc(id);
+		return ret;
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
+	unsigned int lcore_id;
+
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].expired_tim = NULL;
+
+	if (timer_data->wheels != NULL)
+		timer_data_wheel_free(timer_data);
+
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -187,6 +307,8 @@ rte_timer_subsystem_init(void)
 void
 rte_timer_subsystem_finalize(void)
 {
+	int i;
+
 	rte_mcfg_timer_lock();
 
 	if (!rte_timer_subsystem_initialized) {
@@ -194,8 +316,12 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			if (rte_timer_data_arr[i].wheels != NULL)
+				timer_data_wheel_free(&rte_timer_data_arr[i]);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -382,6 +508,254 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/*
+ * In a timer wheel, sl_next[1] holds the address of the pointer to the
+ * timer in its slot, to unlink it in constant time. It is NULL once the
+ * timer is taken out of the wheel to run.
+ */
+static inline struct rte_timer **
+timer_wheel_pprev(const struct rte_timer *tim)
+{
+	return (struct rte_timer **)(uintptr_t)tim->sl_next[1];
+}
+
+static inline void
+timer_wheel_set_pprev(struct rte_timer *tim, struct rte_timer **pprev)
+{
+	tim->sl_next[1] = (struct rte_timer *)(uintptr_t)pprev;
+}
+
+/*
+ * Find the first non-empty slot of a wheel level in [from, to),
+ * return TIMER_WHEEL_SLOTS if there is none.
+ */
+static uint32_t
+timer_wheel_find(const struct timer_wheel *w, uint32_t lvl, uint32_t from,
+		 uint32_t to)
+{
+	const uint64_t *bmap = &w->bmap[lvl * TIMER_WHEEL_SLOTS / 64];
+	uint64_t bits;
+	uint32_t i;
+
+	for (i = from / 64; i * 64 < to; i++) {
+		bits = bmap[i];
+		if (i == from / 64)
+			bits &= UINT64_MAX << (from % 64);
+		if (bits != 0) {
+			i = i * 64 + rte_bsf64(bits);
+			return (i < to) ? i : TIMER_WHEEL_SLOTS;
+		}
+	}
+
+	return TIMER_WHEEL_SLOTS;
+}
+
+/* Get the tick of the next timer to run or slot to move down. */
+static uint64_t
+timer_wheel_next_tick(const struct timer_wheel *w)
+{
+	uint64_t base, tick, next_tick = UINT64_MAX;
+	uint32_t lvl, idx, pos, lvl_shift;
+
+	if (w->count == 0)
+		return UINT64_MAX;
+
+	for (lvl = 0; lvl != TIMER_WHEEL_LEVELS; lvl++) {
+		lvl_shift = lvl * TIMER_WHEEL_BITS;
+		base = (w->cur_tick >> lvl_shift) & ~(uint64_t)TIMER_WHEEL_MASK;
+		idx = (w->cur_tick >> lvl_shift) & TIMER_WHEEL_MASK;
+
+		/*
+		 * Once the current tick went through the start of the
+		 * current slot of an upper level, the slot was moved down,
+		 * and timers in it are for the next turn of the level.
+		 */
+		if (lvl != 0 &&
+		    (w->cur_tick & ((UINT64_C(1) << lvl_shift) - 1)) != 0)
+			idx++;
+
+		pos = timer_wheel_find(w, lvl, idx, TIMER_WHEEL_SLOTS);
+		if (pos == TIMER_WHEEL_SLOTS) {
+			pos = timer_wheel_find(w, lvl, 0, idx);
+			if (pos == TIMER_WHEEL_SLOTS)
+				continue;
+			base += TIMER_WHEEL_SLOTS;
+		}
+
+		tick = (base + pos) << lvl_shift;
+		if (tick < next_tick)
+			next_tick = tick;
+	}
+
+	return next_tick;
+}
+
+/* Link a timer in the slot of its expiry tick. */
+static void
+timer_wheel_insert(struct timer_wheel *w, struct rte_timer *tim)
+{
+	uint64_t tick, delta;
+	uint32_t lvl, lvl_shift, n;
+	struct rte_timer **head;
+
+	/* round up, not to run the timer before its expiry time */
+	tick = (tim->expire >> w->shift) +
+		((tim->expire & ((UINT64_C(1) << w->shift) - 1)) != 0);
+	if (tick < w->cur_tick)
+		tick = w->cur_tick;
+
+	delta = tick - w->cur_tick;
+	if (delta >= TIMER_WHEEL_RANGE) {
+		delta = TIMER_WHEEL_RANGE - 1;
+		tick = w->cur_tick + delta;
+	}
+
+	lvl = (delta == 0) ? 0 : (rte_fls_u64(delta) - 1) / TIMER_WHEEL_BITS;
+	lvl_shift = lvl * TIMER_WHEEL_BITS;
+	n = lvl * TIMER_WHEEL_SLOTS + ((tick >> lvl_shift) & TIMER_WHEEL_MASK);
+
+	head = &w->slots[n];
+	tim->sl_next[0] = *head;
+	if (*head != NULL)
+		timer_wheel_set_pprev(*head, &tim->sl_next[0]);
+	timer_wheel_set_pprev(tim, head);
+	*head = tim;
+
+	w->bmap[n / 64] |= UINT64_C(1) << (n % 64);
+	w->count++;
+
+	tick = (tick >> lvl_shift) << lvl_shift;
+	if (tick < w->next_tick)
+		w->next_tick = tick;
+}
+
+/* Unlink a timer from its slot, if it is still in the wheel. */
+static void
+timer_wheel_unlink(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = timer_wheel_pprev(tim);
+	struct rte_timer *next = tim->sl_next[0];
+	uint32_t n;
+
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL)
+		timer_wheel_set_pprev(next, pprev);
+	else if (pprev >= w->slots && pprev < w->slots + RTE_DIM(w->slots)) {
+		/* last timer of the slot */
+		n = pprev - w->slots;
+		w->bmap[n / 64] &= ~(UINT64_C(1) << (n % 64));
+	}
+
+	timer_wheel_set_pprev(tim, NULL);
+	w->count--;
+}
+
+/* Take all timers out of a slot, return the first one. */
+static struct rte_timer *
+timer_wheel_take_slot(struct timer_wheel *w, uint32_t n)
+{
+	struct rte_timer *tim, *first;
+
+	first = w->slots[n];
+	if (first == NULL)
+		return NULL;
+
+	w->slots[n] = NULL;
+	w->bmap[n / 64] &= ~(UINT64_C(1) << (n % 64));
+
+	for (tim = first; tim != NULL; tim = tim->sl_next[0]) {
+		timer_wheel_set_pprev(tim, NULL);
+		w->count--;
+	}
+
+	return first;
+}
+
+/*
+ * Called when the current tick is a multiple of the level 0 size:
+ * move the timers of the current slot of the upper levels down.
+ */
+static void
+timer_wheel_cascade(struct timer_wheel *w)
+{
+	struct rte_timer *tim, *next_tim;
+	uint32_t lvl, idx;
+
+	for (lvl = 1; lvl != TIMER_WHEEL_LEVELS; lvl++) {
+		idx = (w->cur_tick >> (lvl * TIMER_WHEEL_BITS)) &
+			TIMER_WHEEL_MASK;
+
+		tim = timer_wheel_take_slot(w, lvl * TIMER_WHEEL_SLOTS + idx);
+		for (; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			timer_wheel_insert(w, tim);
+		}
+
+		/* the upper level only moves when this one wraps around */
+		if (idx != 0)
+			break;
+	}
+}
+
+/*
+ * Go through the ticks up to the given time, mark the expired timers as
+ * running and return them linked with sl_next[0].
+ */
+static struct rte_timer *
+timer_wheel_expired(struct timer_wheel *w, uint64_t cur_time)
+{
+	struct rte_timer *tim, *next_tim, *first = NULL, **last = &first;
+	uint64_t now = cur_time >> w->shift;
+
+	while (w->next_tick <= now) {
+		/* skip the ticks without timer */
+		if (w->cur_tick < w->next_tick)
+			w->cur_tick = w->next_tick;
+
+		if ((w->cur_tick & TIMER_WHEEL_MASK) == 0)
+			timer_wheel_cascade(w);
+
+		tim = timer_wheel_take_slot(w, w->cur_tick & TIMER_WHEEL_MASK);
+		for (; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+
+			/* another core is trying to re-config this one,
+			 * leave it out of the expired list
+			 */
+			if (timer_set_running_state(tim) < 0)
+				continue;
+
+			*last = tim;
+			last = &tim->sl_next[0];
+		}
+
+		w->cur_tick++;
+		w->next_tick = timer_wheel_next_tick(w);
+	}
+
+	if (w->cur_tick <= now)
+		w->cur_tick = now + 1;
+
+	*last = NULL;
+	return first;
+}
+
+static void
+timer_wheel_add(struct timer_wheel *w, struct rte_timer *tim)
+{
+	/* keep the ticks close to the time when there is no timer */
+	if (w->count == 0) {
+		w->cur_tick = RTE_MAX(w->cur_tick,
+				rte_get_timer_cycles() >> w->shift);
+		w->next_tick = UINT64_MAX;
+	}
+
+	timer_wheel_insert(w, tim);
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -394,6 +768,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(priv_timer[tim_lcore].wheel, tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -439,6 +818,11 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
 
+	if (priv_timer[prev_owner].wheel != NULL) {
+		timer_wheel_unlink(priv_timer[prev_owner].wheel, tim);
+		goto unlock;
+	}
+
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -459,6 +843,7 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		else
 			break;
 
+unlock:
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
@@ -650,60 +1035,95 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Take the expired timers out of the skiplist of an lcore,
+ * and return them linked with sl_next[0]. Call with lock held.
+ */
+static struct rte_timer *
+timer_list_get_expired(unsigned int lcore_id, uint64_t cur_time,
+		       struct priv_timer *priv_timer)
 {
-	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim;
-	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *privp = &priv_timer[lcore_id];
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct rte_timer *tim;
+	int i;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	/* if nothing to do just return */
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time)
+		return NULL;
 
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
-	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
-	cur_time = rte_get_timer_cycles();
+	/* save start of list of expired timers */
+	tim = privp->pending_head.sl_next[0];
 
+	/* break the existing list at current time point */
+	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
+			continue;
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
+		if (prev[i]->sl_next[i] == NULL)
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
+	}
+
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
+
+	return tim;
+}
+
+/*
+ * Take the expired timers out of the pending list of an lcore,
+ * mark them as running and return them linked with sl_next[0].
+ */
+static struct rte_timer *
+timer_get_expired(unsigned int lcore_id, struct priv_timer *priv_timer)
+{
+	struct priv_timer *privp = &priv_timer[lcore_id];
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim, **pprev;
+	uint64_t cur_time;
+	int ret;
+
+	if (privp->wheel != NULL) {
+		/* optimize for the case where the wheel is empty */
+		if (privp->wheel->count == 0)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
 #ifdef RTE_ARCH_64
-	/* on 64-bit the value cached in the pending_head.expired will be
-	 * updated atomically, so we can consult that for a quick check here
-	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+		/* quick check outside the lock, as done for the skiplist */
+		if (likely(privp->wheel->next_tick >
+				cur_time >> privp->wheel->shift))
+			return NULL;
 #endif
+	} else {
+		/* optimize for the case where per-cpu list is empty */
+		if (privp->pending_head.sl_next[0] == NULL)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
+#ifdef RTE_ARCH_64
+		/* on 64-bit the value cached in the pending_head.expired will
+		 * be updated atomically, so we can consult that for a quick
+		 * check here outside the lock
+		 */
+		if (likely(privp->pending_head.expire > cur_time))
+			return NULL;
+#endif
+	}
 
 	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_lock(&privp->list_lock);
 
-	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+	if (privp->wheel != NULL) {
+		run_first_tim = timer_wheel_expired(privp->wheel, cur_time);
+		rte_spinlock_unlock(&privp->list_lock);
+		return run_first_tim;
 	}
 
-	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
-
-	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
-			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
-		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
-	}
+	tim = timer_list_get_expired(lcore_id, cur_time, priv_timer);
 
 	/* transition run-list from PENDING to RUNNING */
 	run_first_tim = tim;
@@ -723,12 +1143,29 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	rte_spinlock_unlock(&privp->list_lock);
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+
+	run_first_tim = timer_get_expired(lcore_id, priv_timer);
+	if (run_first_tim == NULL)
+		return;
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -797,16 +1234,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -821,75 +1254,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_expired(poll_lcores[i], data->priv_timer);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -969,6 +1336,117 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* take expired timers without running them, re-arm the periodic ones */
+static unsigned int
+__rte_timer_manage_burst(struct rte_timer_data *timer_data,
+			 struct rte_timer **timers, unsigned int nb_timers)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim;
+	unsigned int lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct priv_timer *privp;
+	unsigned int i, n = 0, nb_periodic = 0;
+	bool fetched = false;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+
+	privp = &priv_timer[lcore_id];
+
+	/* the timers left by the previous call expired first */
+	tim = privp->expired_tim;
+	if (tim == NULL) {
+		tim = timer_get_expired(lcore_id, priv_timer);
+		fetched = true;
+	}
+
+	for (;;) {
+		for (; tim != NULL && n < nb_timers; tim = tim->sl_next[0]) {
+			rte_prefetch0(tim->sl_next[0]);
+			timers[n++] = tim;
+		}
+		if (tim != NULL || n == nb_timers || fetched)
+			break;
+		tim = timer_get_expired(lcore_id, priv_timer);
+		fetched = true;
+	}
+
+	/* the remaining timers stay in running state until the next call */
+	privp->expired_tim = tim;
+
+	if (n == 0)
+		return 0;
+
+	/* one-shot timers are stopped as they are returned */
+	for (i = 0; i < n; i++) {
+		tim = timers[i];
+		if (tim->period != 0) {
+			nb_periodic++;
+			continue;
+		}
+		status.state = RTE_TIMER_STOP;
+		status.owner = RTE_TIMER_NO_OWNER;
+		/* The "RELEASE" ordering guarantees the memory
+		 * operations above the status update are observed
+		 * before the update by all threads
+		 */
+		__atomic_store_n(&tim->status.u32, status.u32,
+			__ATOMIC_RELEASE);
+	}
+	__TIMER_STAT_ADD(priv_timer, pending, -(int)(n - nb_periodic));
+
+	if (nb_periodic == 0)
+		return n;
+
+	/* periodic timers are put back in the pending list in one go,
+	 * they are in running state so nobody else can update them
+	 */
+	rte_spinlock_lock(&privp->list_lock);
+	for (i = 0; i < n; i++) {
+		tim = timers[i];
+		if (tim->period == 0)
+			continue;
+
+		tim->expire += tim->period;
+		timer_add(tim, lcore_id, priv_timer);
+
+		status.state = RTE_TIMER_PENDING;
+		status.owner = (int16_t)lcore_id;
+		/* The "RELEASE" ordering guarantees the memory
+		 * operations above the status update are observed
+		 * before the update by all threads
+		 */
+		__atomic_store_n(&tim->status.u32, status.u32,
+			__ATOMIC_RELEASE);
+	}
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return n;
+}
+
+int
+rte_timer_manage_burst(struct rte_timer **timers, unsigned int nb_timers)
+{
+	return rte_timer_alt_manage_burst(default_data_id, timers, nb_timers);
+}
+
+int
+rte_timer_alt_manage_burst(uint32_t timer_data_id, struct rte_timer **timers,
+			   unsigned int nb_timers)
+{
+	struct rte_timer_data *timer_data;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	if (timers == NULL && nb_timers != 0)
+		return -EINVAL;
+
+	return __rte_timer_manage_burst(timer_data, timers, nb_timers);
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -976,6 +1454,8 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		   rte_timer_stop_all_cb_t f, void *f_arg)
 {
 	int i;
+	uint32_t n;
+	union rte_timer_status status;
 	struct priv_timer *priv_timer;
 	uint32_t walk_lcore;
 	struct rte_timer *tim, *next_tim;
@@ -987,6 +1467,39 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		/* expired timers not returned by the burst manage yet */
+		for (tim = priv_timer->expired_tim; tim != NULL;
+		     tim = next_tim) {
+			next_tim = tim->sl_next[0];
+
+			status.state = RTE_TIMER_STOP;
+			status.owner = RTE_TIMER_NO_OWNER;
+			__atomic_store_n(&tim->status.u32, status.u32,
+				__ATOMIC_RELEASE);
+			__TIMER_STAT_ADD(timer_data->priv_timer, pending, -1);
+
+			if (f)
+				f(tim, f_arg);
+		}
+		priv_timer->expired_tim = NULL;
+
+		if (priv_timer->wheel != NULL) {
+			for (n = 0; n != RTE_DIM(priv_timer->wheel->slots);
+			     n++) {
+				for (tim = priv_timer->wheel->slots[n];
+				     tim != NULL;
+				     tim = next_tim) {
+					next_tim = tim->sl_next[0];
+
+					__rte_timer_stop(tim, timer_data);
+
+					if (f)
+						f(tim, f_arg);
+				}
+			}
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
@@ -145,6 +145,58 @@ struct rte_timer
  */
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * Implementation of the pending timer lists of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Skiplist sorted by expiry time, used by rte_timer_data_alloc(). */
+	RTE_TIMER_BACKEND_SKIPLIST,
+	/**
+	 * Hierarchical timer wheel: timers are started and stopped in
+	 * constant time, but expire with the resolution of the wheel, and
+	 * the ones expiring in the same wheel tick run in no given order.
+	 */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Parameters of a timer data instance.
+ */
+struct rte_timer_data_conf {
+	enum rte_timer_backend backend; /**< Pending timer lists. */
+	/**
+	 * Resolution of the timer wheel, in timer cycles
+	 * (see rte_get_timer_hz()), rounded down to a power of 2.
+	 * If 0, the resolution is about a microsecond.
+	 */
+	uint64_t wheel_resolution;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance in shared memory to track a set of pending
+ * timer lists, implemented as given in the configuration.
+ *
+ * @see rte_timer_data_alloc()
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param conf
+ *   Configuration of the timer data instance.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid configuration
+ *   - -ENOMEM: unable to allocate the timer wheels
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			     const struct rte_timer_data_conf *conf);
+
 /**
  * Deallocate a timer data instance.
  *
@@ -469,6 +521,63 @@ int
 rte_timer_alt_manage(uint32_t timer_data_id, unsigned int *poll_lcores,
 		     int n_poll_lcores, rte_timer_alt_manage_cb_t f);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve up to nb_timers expired timers from the timer list of the
+ * calling lcore, without executing their callback functions.
+ *
+ * The returned one-shot timers are stopped, and the returned periodic
+ * timers are re-armed for their next period all at once. The caller is
+ * then responsible for processing the returned timers. Timers that expired
+ * but did not fit in the array stay in the running state and are returned
+ * first by the next call. rte_timer_stop_all() also stops them.
+ *
+ * A timer list processed with this function must not be processed with
+ * rte_timer_manage() or rte_timer_alt_manage() as well.
+ *
+ * @see rte_timer_manage()
+ *
+ * @param timers
+ *   An array of pointers to be filled with the expired timers.
+ * @param nb_timers
+ *   The size of the timers array.
+ * @return
+ *   - >=0: the number of expired timers written in the array
+ *   - -EINVAL: timer subsystem not yet initialized or timers is NULL
+ */
+__rte_experimental
+int
+rte_timer_manage_burst(struct rte_timer **timers, unsigned int nb_timers);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve up to nb_timers expired timers from the timer list of the
+ * calling lcore in the specified timer data instance. This function is
+ * similar to rte_timer_manage_burst(), except that it allows a caller to
+ * specify the timer_data instance that should be operated on.
+ *
+ * @see rte_timer_manage_burst()
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param timers
+ *   An array of pointers to be filled with the expired timers.
+ * @param nb_timers
+ *   The size of the timers array.
+ * @return
+ *   - >=0: the number of expired timers written in the array
+ *   - -EINVAL: invalid timer_data_id or timers is NULL
+ */
+__rte_experimental
+int
+rte_timer_alt_manage_burst(uint32_t timer_data_id, struct rte_timer **timers,
+			   unsigned int nb_timers);
+
 /**
  * Callback function type for rte_timer_stop_all().
  */